@@ -6,6 +6,7 @@
 #pragma  once 
 
 #include "../SGDLib/MASGD.h"
+#include <array>
 
 
 
@@ -21,11 +22,12 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     class BlockMomentumSGD : public IMASGD<ElemType>
     {
         typedef IMASGD<ElemType> Base;
+
+     protected:
         using Base::m_pMPI;
         using Base::m_deviceId;
         using Base::DownCast;
-    
-     protected:
+
         bool m_resetSGDMomentumAfterAggregation; 
         bool m_useNesterovMomentum;
         double m_blockLearningRate; 
@@ -150,31 +152,8 @@ namespace Microsoft { namespace MSR { namespace CNTK {
                                    px.get()
                                    ); 
                 // 2.2. model update 
-                {
-                    // alias for better readability 
-                    Matrix<ElemType>& smoothedGradientUpdate = *m_blockLevelSmoothedGradient[name];       // smoothed gradient                   
-                    // 2.2.1 update block level smoothed gradient; 
-                    // This is essentially a first-order infinite impulse response (IIR) filter with the gain (1 - blockMomentum)*m_blockLearningRate:
-                    // smoothedGradientUpdate(t)=blockMomentum * smoothedGradients(t-1) + (1 - blockMomentum)*m_blockLearningRate*blockGrad(t)
-                    Matrix<ElemType>::ScaleAndAdd((ElemType)((1 - blockMomentum)*m_blockLearningRate), blockGrad, (ElemType)blockMomentum, smoothedGradientUpdate); 
-                    // 2.2.2 update parameters; 
-                    currentWeight.SetValue(prevWeight);
-                    currentWeight -= smoothedGradientUpdate;
-                    // 2.2.3 Nesterov Momentum 
-                    // A Nesterov momentum here is to do a partial weight update before calculating the gradient, i.e., 
-                    // (step 1) w(t) <-- w(t) - \eta* v(t) 
-                    // (step 2) g(t+1) <-- forwardbackward on minibatches with initial model as w(t)
-                    // (step 3) v(t+1) <-- \eta*v(t) + (1-\eta)*learningRate*g(t+1)
-                    // (step 4) w(t+1) <-- w(t)-v(t)
-                    // (step 5) t      <-- t+1
-                    // without step 1, this becomes stanard momentum
-                    if (m_useNesterovMomentum)
-                    {
-                        Matrix<ElemType>::ScaleAndAdd((ElemType)-blockMomentum, smoothedGradientUpdate, currentWeight);
-                    }
-                    // 2.2.4 update bookkeeping
-                    prevWeight.SetValue(currentWeight);
-                }
+                UpdateModelWithBlockGradient(blockGrad, *m_blockLevelSmoothedGradient[name], prevWeight, blockMomentum);
+                currentWeight.SetValue(prevWeight);
             }
             //----------------------------------------
             // 3. reset SGD momentum if necessary 
@@ -237,6 +216,31 @@ namespace Microsoft { namespace MSR { namespace CNTK {
                 fstream.GetMarker(FileMarker::fileMarkerEndSection, L"EMACKP");
             }
         }
+    protected:
+        // updates the model at the last aggregation point with the aggregated block gradient; prevWeight becomes the
+        // model the next block starts from
+        void UpdateModelWithBlockGradient(const Matrix<ElemType>& blockGrad, Matrix<ElemType>& smoothedGradientUpdate, Matrix<ElemType>& prevWeight, ElemType blockMomentum)
+        {
+            // 1. update block level smoothed gradient; 
+            // This is essentially a first-order infinite impulse response (IIR) filter with the gain (1 - blockMomentum)*m_blockLearningRate:
+            // smoothedGradientUpdate(t)=blockMomentum * smoothedGradients(t-1) + (1 - blockMomentum)*m_blockLearningRate*blockGrad(t)
+            Matrix<ElemType>::ScaleAndAdd((ElemType)((1 - blockMomentum)*m_blockLearningRate), blockGrad, (ElemType)blockMomentum, smoothedGradientUpdate); 
+            // 2. update parameters; 
+            prevWeight -= smoothedGradientUpdate;
+            // 3. Nesterov Momentum 
+            // A Nesterov momentum here is to do a partial weight update before calculating the gradient, i.e., 
+            // (step 1) w(t) <-- w(t) - \eta* v(t) 
+            // (step 2) g(t+1) <-- forwardbackward on minibatches with initial model as w(t)
+            // (step 3) v(t+1) <-- \eta*v(t) + (1-\eta)*learningRate*g(t+1)
+            // (step 4) w(t+1) <-- w(t)-v(t)
+            // (step 5) t      <-- t+1
+            // without step 1, this becomes stanard momentum
+            if (m_useNesterovMomentum)
+            {
+                Matrix<ElemType>::ScaleAndAdd((ElemType)-blockMomentum, smoothedGradientUpdate, prevWeight);
+            }
+        }
+
     private:
        // helper function to save/load map<wstring, shared_ptr<Matrix<ElemType>> structure 
        void SaveParameters(File& f, const map<wstring, shared_ptr<Matrix<ElemType>>>& parameters) const
@@ -295,4 +299,198 @@ namespace Microsoft { namespace MSR { namespace CNTK {
            return -(double)syncPeroid / log(bm); 
        }
     };
+    // Pipelined variant of BlockMomentumSGD: the block gradients of a block are aggregated in the background with a
+    // nonblocking allreduce while the workers train the next block, and the block-level model update is applied one
+    // block late, at the next sync point. Each block thus starts from a model which misses the contribution of the
+    // block just before it. At the end of an epoch the aggregations in flight are completed, so the model is
+    // identical on all workers again, as in the non-pipelined version.
+    template<typename ElemType>
+    class PipelinedBlockMomentumSGD : public BlockMomentumSGD<ElemType>
+    {
+        typedef BlockMomentumSGD<ElemType> Base;
+        using Base::m_pMPI;
+        using Base::m_perfReporter;
+        using Base::DownCast;
+        using Base::m_resetSGDMomentumAfterAggregation;
+        using Base::m_blockMomentumAsTimeConstantPerWorker;
+        using Base::m_syncPeriodPerWorker;
+        using Base::m_prevParameters;
+        using Base::m_blockLevelSmoothedGradient;
+        using Base::UpdateModelWithBlockGradient;
+
+        // double buffer of block gradients on the CPU: the aggregation of one block is in flight while the next block is trained
+        std::array<map<wstring, vector<ElemType>>, 2> m_blockGradients;
+        std::array<vector<MPI_Request>, 2>           m_requests;
+        std::array<Timer, 2>                         m_inFlightTimers;
+        size_t m_nextBuffer;
+        size_t m_numBlocksInFlight;
+        bool   m_completeAllBlocks;     // set at the end of an epoch
+
+    public:
+        PipelinedBlockMomentumSGD(const MPIWrapperPtr& pMPI, size_t reportFreq, DEVICEID_TYPE devID, 
+                                  bool useNestrovMomentum, bool resetSGDM, 
+                                  double blockLearningRate, 
+                                  double blockMomentumAsTimeConstant, size_t syncPeriod)
+            : Base(pMPI, reportFreq, devID, useNestrovMomentum, resetSGDM, blockLearningRate, blockMomentumAsTimeConstant, syncPeriod),
+            m_nextBuffer(0), m_numBlocksInFlight(0), m_completeAllBlocks(false)
+        {
+            fprintf(stderr, "Parallel training: the block gradients are aggregated in the background while the next block is trained (pipelined BlockMomentumSGD).\n");
+        }
+
+        /*virtual*/ void OnEpochStart(const std::list<ComputationNodeBasePtr>& LearnableNodes) override
+        {
+            if (m_numBlocksInFlight > 0)
+                LogicError("PipelinedBlockMomentumSGD: %d block(s) still in flight at the start of an epoch.", (int)m_numBlocksInFlight);
+
+            Base::OnEpochStart(LearnableNodes);
+        }
+        /*virtual*/ void OnEpochEnd(const std::list<ComputationNodeBasePtr>& LearnableNodes, 
+            std::list<Matrix<ElemType>>&                smoothedGradient,
+            size_t                                      samplesSinceLastSync) override
+        {
+            // apply the block in flight before the epoch statistics are finished, keeping the local progress of the
+            // last block, which is then aggregated without pipelining
+            float secondsOnCommunication = 0.0f;
+            while (m_numBlocksInFlight > 0)
+                CompleteOldestBlock(LearnableNodes, secondsOnCommunication, /*keepLocalProgress=*/ true);
+
+            m_completeAllBlocks = true;
+            Base::OnEpochEnd(LearnableNodes, smoothedGradient, samplesSinceLastSync);
+            m_completeAllBlocks = false;
+        }
+        /*virtual*/ void ModelAggregationProcessing(
+            size_t samplesSinceLastSync,
+            const std::list<ComputationNodeBasePtr>& learnableNodes,
+            std::list<Matrix<ElemType>>& smoothedGradient,
+            size_t& totalSamplesProcessed,
+            float& secondsOnCommunication
+            ) override
+        {
+            //----------------------------------------
+            // 1. communicate with other nodes to negotiate contribution weights
+            //----------------------------------------
+            int   nTotalSamples = samplesSinceLastSync;
+            Timer commTimer;
+            secondsOnCommunication = 0.0f;
+            commTimer.Start();
+            m_pMPI->AllReduce(&nTotalSamples, 1);
+            commTimer.Stop();
+            secondsOnCommunication += (float)commTimer.ElapsedSeconds();
+            totalSamplesProcessed = nTotalSamples;
+
+            //----------------------------------------
+            // 2. start the aggregation of the block that just finished 
+            //----------------------------------------
+            StartBlock(learnableNodes);
+
+            //----------------------------------------
+            // 3. apply the block that was aggregated while this one was trained; at the end of an epoch also the one just started
+            //----------------------------------------
+            while (m_numBlocksInFlight > (m_completeAllBlocks ? 0 : 1))
+                CompleteOldestBlock(learnableNodes, secondsOnCommunication, /*keepLocalProgress=*/ false);
+
+            ContinueFromAggregatedModel(learnableNodes, smoothedGradient);
+        }
+
+        /*virtual*/ void SaveToCheckPoint(File& fstream) override
+        {
+            if (m_numBlocksInFlight > 0)
+                LogicError("PipelinedBlockMomentumSGD: cannot save a checkpoint while %d block(s) are in flight.", (int)m_numBlocksInFlight);
+
+            Base::SaveToCheckPoint(fstream);
+        }
+
+    private:
+        // copies the local block gradients (model at the last sync point - current model) to the next buffer and starts their aggregation
+        void StartBlock(const std::list<ComputationNodeBasePtr>& learnableNodes)
+        {
+            assert(m_numBlocksInFlight < 2);
+            auto& blockGradients = m_blockGradients[m_nextBuffer];
+            auto& requests = m_requests[m_nextBuffer];
+            requests.clear();
+            for (auto& pBaseNode : learnableNodes)
+            {
+                if (!pBaseNode->IsParameterUpdateRequired())
+                {
+                    continue;
+                }
+                wstring name = pBaseNode->NodeName();
+                auto pNode = DownCast(pBaseNode);
+                Matrix<ElemType>  blockGrad(m_prevParameters[name]->DeepClone());
+                blockGrad -= pNode->Value();
+
+                vector<ElemType>& buffer = blockGradients[name];
+                buffer.resize(blockGrad.GetNumElements());
+                blockGrad.CopySection(blockGrad.GetNumRows(), blockGrad.GetNumCols(), buffer.data(), blockGrad.GetNumRows());
+
+                requests.push_back(MPI_Request());
+                m_pMPI->AllReduceAsync(buffer.data(), buffer.size(), &requests.back());
+            }
+            m_inFlightTimers[m_nextBuffer].Start();
+            m_nextBuffer = 1 - m_nextBuffer;
+            m_numBlocksInFlight++;
+        }
+
+        // waits for the aggregation of the oldest block in flight and applies it to the model at the last sync point;
+        // with keepLocalProgress the current model is moved along, so its block gradient stays the same
+        void CompleteOldestBlock(const std::list<ComputationNodeBasePtr>& learnableNodes, float& secondsOnCommunication, bool keepLocalProgress)
+        {
+            assert(m_numBlocksInFlight > 0);
+            size_t oldest = (m_nextBuffer + 2 - m_numBlocksInFlight) % 2;
+
+            Timer waitTimer;
+            waitTimer.Start();
+            m_pMPI->WaitAll(m_requests[oldest]);
+            waitTimer.Stop();
+            m_inFlightTimers[oldest].Stop();
+            secondsOnCommunication += (float)waitTimer.ElapsedSeconds();
+            m_perfReporter.OnPipelinedBlockAggregated(m_inFlightTimers[oldest].ElapsedSeconds(), waitTimer.ElapsedSeconds());
+
+            ElemType blockMomentum = (ElemType)Base::TimeConstant2Momentum(m_blockMomentumAsTimeConstantPerWorker, m_syncPeriodPerWorker);
+            for (auto& pBaseNode : learnableNodes)
+            {
+                if (!pBaseNode->IsParameterUpdateRequired())
+                {
+                    continue;
+                }
+                wstring name = pBaseNode->NodeName();
+                Matrix<ElemType>& prevWeight = *m_prevParameters[name];
+                Matrix<ElemType>  blockGrad(prevWeight.GetDeviceId());
+                blockGrad.SetValue(prevWeight.GetNumRows(), prevWeight.GetNumCols(), prevWeight.GetDeviceId(), m_blockGradients[oldest][name].data());
+                if (keepLocalProgress)
+                {
+                    Matrix<ElemType>& currentWeight = DownCast(pBaseNode)->Value();
+                    currentWeight -= prevWeight;
+                    UpdateModelWithBlockGradient(blockGrad, *m_blockLevelSmoothedGradient[name], prevWeight, blockMomentum);
+                    currentWeight += prevWeight;
+                }
+                else
+                {
+                    UpdateModelWithBlockGradient(blockGrad, *m_blockLevelSmoothedGradient[name], prevWeight, blockMomentum);
+                }
+            }
+            m_numBlocksInFlight--;
+        }
+
+        // the next block starts from the model at the last sync point, the local progress is contained in the block in flight
+        void ContinueFromAggregatedModel(const std::list<ComputationNodeBasePtr>& learnableNodes, std::list<Matrix<ElemType>>& smoothedGradient)
+        {
+            for (auto& pBaseNode : learnableNodes)
+            {
+                if (!pBaseNode->IsParameterUpdateRequired())
+                {
+                    continue;
+                }
+                auto pNode = DownCast(pBaseNode);
+                pNode->Value().SetValue(*m_prevParameters[pBaseNode->NodeName()]);
+            }
+            if (m_resetSGDMomentumAfterAggregation)
+            {
+                for (Matrix<ElemType>& x : smoothedGradient)
+                {
+                    x.SetValue((ElemType)0);
+                }
+            }
+        }
+    };
 } } }
@@ -16,6 +16,7 @@
 #include "Config.h"
 #include "ScriptableObjects.h"
 #include "BrainScriptEvaluator.h"
+#include "MPIWrapper.h"
 
 #include <string>
 #include <chrono>
@@ -112,6 +113,25 @@ void DoCreateLabelMap(const ConfigParameters& config)
 template void DoCreateLabelMap<float>(const ConfigParameters& config);
 template void DoCreateLabelMap<double>(const ConfigParameters& config);
 
+// ===========================================================================
+// DoConvertToCBF() - implements CNTK "convertToCBF" command
+// ===========================================================================
+
+// Converts the data of the deserializers in the 'reader' section into the CNTK binary format,
+// see CBFConverter in the CompositeDataReader for the parameters.
+void DoConvertToCBF(const ConfigParameters& config)
+{
+    // All workers would write the same files.
+    auto mpi = MPIWrapper::GetInstance();
+    if (mpi && !mpi->IsMainNode())
+        return;
+
+    typedef void (*ConvertToCBFProc)(const ConfigParameters* config);
+    Plugin plugin;
+    auto convert = (ConvertToCBFProc)plugin.Load(L"CompositeDataReader", "ConvertToCBF");
+    convert(&config);
+}
+
 // ===========================================================================
 // DoParameterSVD() - implements CNTK "SVD" command
 // ===========================================================================
@@ -333,6 +333,10 @@ void DoCommands(const ConfigParameters& config, const shared_ptr<MPIWrapper>& mp
                 {
                     DoWriteWordAndClassInfo<ElemType>(commandParams);
                 }
+                else if (thisAction == "convertToCBF")
+                {
+                    DoConvertToCBF(commandParams);
+                }
                 else if (thisAction == "plot")
                 {
                     DoTopologyPlot<ElemType>(commandParams);
@@ -512,6 +516,9 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
 
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
+    Globals::SetParallelNodeExecutionThreads(config(L"parallelNodeExecutionThreads", (size_t)0));
+    Globals::SetMemoryArenaMinibatchColumns(config(L"memoryArenaMinibatchColumns", (size_t)0));
+    Globals::SetElementwiseNodeFusion(config(L"fuseElementwiseNodes", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -664,6 +671,9 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
 
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
+    Globals::SetParallelNodeExecutionThreads(config(L"parallelNodeExecutionThreads", (size_t)0));
+    Globals::SetMemoryArenaMinibatchColumns(config(L"memoryArenaMinibatchColumns", (size_t)0));
+    Globals::SetElementwiseNodeFusion(config(L"fuseElementwiseNodes", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
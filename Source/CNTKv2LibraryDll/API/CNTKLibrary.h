@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <mutex>
 #include <future>
+#include <condition_variable>
 #include <cstddef>
 #include <cmath>
 
@@ -668,6 +669,7 @@ namespace CNTK
         friend class BlockMomentumDistributedLearner;
         friend class Internal::VariableResolver;
         friend class Trainer;
+        friend class Serializer;
 
         template <typename T, typename ...CtorArgTypes>
         friend inline std::shared_ptr<T> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
@@ -1023,6 +1025,9 @@ namespace CNTK
         bool m_isReadOnly;
 
         std::shared_ptr<void> m_tensorView; // Microsoft::MSR::CNTK::TensorView<ElemType>*
+
+        // Owner of the external storage (e.g. a memory-mapped model file) backing this view and the views aliasing it, if any.
+        std::shared_ptr<void> m_externalStorage;
     };
 
     enum class MaskKind : char
@@ -5404,6 +5409,20 @@ namespace CNTK
 
     CNTK_API DistributedLearnerPtr CreateQuantizedDataParallelDistributedLearner(QuantizedDistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, bool useAsyncBufferedParameterUpdate = false);
 
+    ///
+    /// Creates a data parallel distributed learner that exchanges only the entries of the gradients with the largest magnitude.
+    /// Every gradient is split into buckets of bucketSize elements, of every bucket the ceil(density * bucketSize) entries with the
+    /// largest magnitude are sent; with a positive threshold only those of them with a magnitude of at least the threshold.
+    /// The entries that are not sent are accumulated locally and added to the next gradients (error feedback).
+    ///
+    CNTK_API DistributedLearnerPtr CreateSparsifiedDataParallelDistributedLearner(
+        DistributedCommunicatorPtr communicator,
+        LearnerPtr learner,
+        size_t distributeAfterSamples,
+        double density,
+        double threshold = 0.0,
+        size_t bucketSize = 64 * 1024);
+
     CNTK_API DistributedLearnerPtr CreateBlockMomentumDistributedLearner(
         DistributedCommunicatorPtr communicator,
         LearnerPtr learner,
@@ -5535,6 +5554,79 @@ namespace CNTK
     ///
     CNTK_API EvaluatorPtr CreateEvaluator(const FunctionPtr& evaluationFunction, const std::vector<ProgressWriterPtr>& progressWriters = {});
 
+    ///
+    /// ConcurrentEvaluator serves forward evaluation requests for a Function from multiple threads at the same time.
+    /// Requests are executed on a bounded pool of evaluation instances of the Function; each instance is a clone that shares the
+    /// Parameters and Constants of the Function (a single copy of the weights per process) and owns a compiled
+    /// computation network whose activation buffers are reused across the requests that instance serves.
+    /// The compiled network is not shared between instances: every instance is compiled once, on its first request, and
+    /// holds its own activation buffers, so the activation memory grows with the number of instances, bounded by MaxConcurrency().
+    /// Instances are created on demand, up to the specified maximum concurrency, and are never recompiled afterwards.
+    ///
+    class ConcurrentEvaluator : public std::enable_shared_from_this<ConcurrentEvaluator>
+    {
+    public:
+        ///
+        /// Evaluates the outputs of the Function for the specified argument values, like Function::Evaluate does.
+        /// The keys of both maps are the Arguments and Outputs of the Function specified during construction.
+        /// This method is thread-safe: concurrent calls are executed in parallel on different evaluation instances,
+        /// and block while all of the MaxConcurrency() instances are busy.
+        ///
+        CNTK_API void Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputs);
+
+        ///
+        /// Function evaluated by this evaluator.
+        ///
+        FunctionPtr EvaluationFunction() const { return m_evaluationFunction; }
+
+        ///
+        /// Device the evaluation instances are bound to.
+        ///
+        const DeviceDescriptor& Device() const { return m_device; }
+
+        ///
+        /// Maximum number of requests evaluated in parallel.
+        ///
+        size_t MaxConcurrency() const { return m_maxConcurrency; }
+
+        ///
+        /// Number of evaluation instances created so far.
+        ///
+        CNTK_API size_t NumInstances() const;
+
+        CNTK_API virtual ~ConcurrentEvaluator();
+
+    private:
+        template <typename T1, typename ...CtorArgTypes>
+        friend std::shared_ptr<T1> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
+
+        ConcurrentEvaluator(const FunctionPtr& evaluationFunction, size_t maxConcurrency, const DeviceDescriptor& device);
+
+        struct Instance;
+        typedef std::shared_ptr<Instance> InstancePtr;
+
+        InstancePtr AcquireInstance();
+        void ReleaseInstance(const InstancePtr& instance);
+
+        FunctionPtr m_evaluationFunction;
+        DeviceDescriptor m_device;
+        size_t m_maxConcurrency;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_instanceReleased;
+        std::vector<InstancePtr> m_instances;
+        std::vector<InstancePtr> m_idleInstances;
+
+        // Serializes the construction and compilation of new evaluation instances.
+        std::mutex m_compileMutex;
+    };
+
+    ///
+    /// Construct a ConcurrentEvaluator for the specified Function.
+    /// A 'maxConcurrency' of 0 stands for the number of hardware threads.
+    ///
+    CNTK_API ConcurrentEvaluatorPtr CreateConcurrentEvaluator(const FunctionPtr& evaluationFunction, size_t maxConcurrency = 0, const DeviceDescriptor& device = DeviceDescriptor::UseDefaultDevice());
+
     enum class DataUnit : unsigned int
     {
         ///Indiciate that the frequency of action is counted by sweep.
@@ -6054,6 +6146,23 @@ namespace CNTK
         std::unordered_map<StreamInformation, std::pair<NDArrayViewPtr, NDArrayViewPtr>>& computedMeanAndVariances,
         const DeviceDescriptor& device = DeviceDescriptor::CPUDevice());
 
+    ///
+    /// Converts the specified Function for post-training quantized int8 inference on the CPU, and returns the converted Function.
+    /// Every Times and Convolution in the Function whose weight (first operand) is a Parameter or Constant and whose dense
+    /// second operand is of DataType::Float or DataType::Double is computed with int8 operands and int32 accumulation:
+    /// the weight is quantized with one scale per output channel when the Function is first evaluated, and the second operand
+    /// with the range observed for it on numCalibrationMinibatches minibatches from calibrationSource, fed to the Function
+    /// as specified by inputVarToStream; second operands computed inside of a block Function are quantized with the range of
+    /// each minibatch instead. Transposed and group convolutions are not converted.
+    /// The converted Function shares its Parameters and Constants with the specified Function, which must not be trained further.
+    ///
+    CNTK_API FunctionPtr QuantizeForInt8Inference(const FunctionPtr& function,
+        const MinibatchSourcePtr& calibrationSource,
+        const std::unordered_map<Variable, StreamInformation>& inputVarToStream,
+        size_t numCalibrationMinibatches,
+        size_t calibrationMinibatchSizeInSamples,
+        const DeviceDescriptor& device = DeviceDescriptor::CPUDevice());
+
     ///
     /// Set the process-wide setting for maximum number of CPU threads to be used by any individual compute operation
     /// Note that this is a per compute operation limit and if the user performs multiple compute operations concurrently
@@ -6189,6 +6298,13 @@ namespace CNTK
     ///
     CNTK_API DistributedCommunicatorPtr MPICommunicator(size_t packThresholdSizeInBytes = Internal::GetMPIPackThreshold());
 
+    ///
+    /// Built-in MPI-based communicator that aggregates hierarchically: the workers of a host reduce through shared memory
+    /// and only one worker per host communicates over the network. With ranksPerHost = 0 the workers are grouped by the host
+    /// they run on, any other value groups that many workers of a host, e.g. to emulate several hosts on a single machine.
+    ///
+    CNTK_API DistributedCommunicatorPtr HierarchicalMPICommunicator(size_t ranksPerHost = 0, size_t packThresholdSizeInBytes = Internal::GetMPIPackThreshold());
+
     ///
     /// Distributed communicator that allows quantized aggregations.
     ///
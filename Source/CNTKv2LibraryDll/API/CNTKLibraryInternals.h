@@ -214,6 +214,9 @@ namespace CNTK
     class Evaluator;
     typedef std::shared_ptr<Evaluator> EvaluatorPtr;
 
+    class ConcurrentEvaluator;
+    typedef std::shared_ptr<ConcurrentEvaluator> ConcurrentEvaluatorPtr;
+
     class Trainer;
     typedef std::shared_ptr<Trainer> TrainerPtr;
 
@@ -321,6 +324,18 @@ namespace CNTK
         CNTK_API void SetMPIPackThreshold(size_t packThesholdInBytes);
         CNTK_API size_t GetMPIPackThreshold();
 
+        CNTK_API void SetParallelNodeExecutionThreads(size_t numThreads);
+        CNTK_API size_t GetParallelNodeExecutionThreads();
+
+        CNTK_API void SetMemoryArenaMinibatchColumns(size_t numColumns);
+        CNTK_API size_t GetMemoryArenaMinibatchColumns();
+
+        // When enabled, models are saved with their tensors in aligned raw sections, and model files in that
+        // layout are loaded through a memory mapping that directly backs the CPU Parameters and Constants.
+        CNTK_API void EnableMemoryMappedModels();
+        CNTK_API void DisableMemoryMappedModels();
+        CNTK_API bool AreMemoryMappedModelsEnabled();
+
         CNTK_API bool AreEquivalent(const ::CNTK::FunctionPtr& f1, const ::CNTK::FunctionPtr& f2);
         CNTK_API bool AreEquivalent(const ::CNTK::Variable& v1, const ::CNTK::Variable& v2, bool allowParameterAndConstantsEquivalence = false);
 
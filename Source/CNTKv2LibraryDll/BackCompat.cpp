@@ -540,6 +540,27 @@ namespace CNTK
                 {
                     opType = PrimitiveOpType::Crop;
                 }
+                else if (node->OperationName() == OperationNameOf(FusedElementwiseNode))
+                {
+                    // saved from a network that was compiled with elementwise node fusion; split it up again
+                    auto fusedNode = node->As<FusedElementwiseNode<ElementType>>();
+
+                    std::wstring uid, name;
+                    std::tie(uid, name) = UidAndNameFromCNTKInternalNodeName(node->NodeName());
+
+                    Variable binaryResult;
+                    if (fusedNode->BinaryOperation() == OperationNameOf(PlusNode))
+                        binaryResult = ::CNTK::Plus(inputVars[0], inputVars[1]);
+                    else
+                        binaryResult = ::CNTK::ElementTimes(inputVars[0], inputVars[1]);
+
+                    if (fusedNode->Activation() == OperationNameOf(RectifiedLinearNode))
+                        return ::CNTK::ReLU(binaryResult, name);
+                    else if (fusedNode->Activation() == OperationNameOf(SigmoidNode))
+                        return ::CNTK::Sigmoid(binaryResult, name);
+                    else
+                        return ::CNTK::Tanh(binaryResult, name);
+                }
                 else
                     InvalidArgument("Unsupported ComputationNode with OperationName='%S' found when loading legacy CNTK model.\n"
                                     "This is likely a deprecated operation; loading Brainscript/NDL models that contain deprecated operations, is not supported in Python/C++ API.\n"
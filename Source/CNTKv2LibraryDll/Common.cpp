@@ -151,6 +151,22 @@ namespace CNTK
             return s_disableAutomaticUnpackingOfPackedValues.load();
         }
 
+        std::atomic<bool> s_memoryMappedModels(false);
+        void EnableMemoryMappedModels()
+        {
+            s_memoryMappedModels.store(true);
+        }
+
+        void DisableMemoryMappedModels()
+        {
+            s_memoryMappedModels.store(false);
+        }
+
+        bool AreMemoryMappedModelsEnabled()
+        {
+            return s_memoryMappedModels.load();
+        }
+
         void EnableForwardValuesSharing()
         {
             Microsoft::MSR::CNTK::Globals::SetShareNodeValueMatrices(/* enable = */ true);
@@ -224,14 +240,14 @@ namespace CNTK
         {
             // optimization is only for float
             int flags = Microsoft::MSR::CNTK::CPUMatrix<float>::GetOptimizationFlags();
-            flags |= Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_EVAL_WITH_MKL;
-            Microsoft::MSR::CNTK::CPUMatrix<float>::SetOptimizationFlags(Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_EVAL_WITH_MKL);
+            flags |= Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_EVAL_WITH_MKL | Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS;
+            Microsoft::MSR::CNTK::CPUMatrix<float>::SetOptimizationFlags(flags);
         }
 
         void DisableCPUEvalOptimization()
         {
             int flags = Microsoft::MSR::CNTK::CPUMatrix<float>::GetOptimizationFlags();
-            flags &= ~Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_EVAL_WITH_MKL;
+            flags &= ~(Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_EVAL_WITH_MKL | Microsoft::MSR::CNTK::CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS);
             Microsoft::MSR::CNTK::CPUMatrix<float>::SetOptimizationFlags(flags);
         }
 
@@ -245,6 +261,26 @@ namespace CNTK
             return Microsoft::MSR::CNTK::Globals::GetMPIPackThreshold();
         }
 
+        void SetParallelNodeExecutionThreads(size_t numThreads)
+        {
+            Microsoft::MSR::CNTK::Globals::SetParallelNodeExecutionThreads(numThreads);
+        }
+
+        size_t GetParallelNodeExecutionThreads()
+        {
+            return Microsoft::MSR::CNTK::Globals::GetParallelNodeExecutionThreads();
+        }
+
+        void SetMemoryArenaMinibatchColumns(size_t numColumns)
+        {
+            Microsoft::MSR::CNTK::Globals::SetMemoryArenaMinibatchColumns(numColumns);
+        }
+
+        size_t GetMemoryArenaMinibatchColumns()
+        {
+            return Microsoft::MSR::CNTK::Globals::GetMemoryArenaMinibatchColumns();
+        }
+
         bool AreEquivalent(const Variable& var1, const Variable& var2, bool allowParameterAndConstantsEquivalence)
         {
             bool areDynamicAxesCompatible = (var1.DynamicAxes().size() == var2.DynamicAxes().size());
@@ -608,12 +644,7 @@ namespace CNTK
             return SyncGuard::IsSyncEnabled();
         }
 
-#ifdef CPUONLY
-        // CPU SBC aggregation not implemented yet, so fall back to conversion of sparse to dense 
-        std::atomic<bool> s_useSparseGradientAggregationInDataParallelSGD(false);
-#else
         std::atomic<bool> s_useSparseGradientAggregationInDataParallelSGD(true);
-#endif
 
         void UseSparseGradientAggregationInDataParallelSGD(bool enable)
         {
@@ -1064,6 +1064,11 @@ namespace CNTK
                     size_t outputRank = functionConfig[PrimitiveFunction::AttributeNameOutputRank].Value<size_t>();
                     auto inferInputRankToMap = functionConfig[PrimitiveFunction::AttributeNameInferInputRankToMap].Value<int>();
                     ASSIGN_NEW_NODE(TimesNode, network->GetDeviceId(), internalNodeName, outputRank, inferInputRankToMap);
+                    if (functionConfig.Contains(PrimitiveFunction::AttributeNameInt8ActivationRange))
+                    {
+                        auto activationRange = functionConfig[PrimitiveFunction::AttributeNameInt8ActivationRange].Value<float>();
+                        SMART_NODE_INVOKE(TimesNode, computationNodePtr, EnableInt8Inference, activationRange);
+                    }
                     break;
                 }
                 case PrimitiveOpType::TransposeTimes:
@@ -1097,6 +1102,11 @@ namespace CNTK
                                                                            sharing, autoPadding, AsTensorShape(lowerPad), AsTensorShape(upperPad), transpose,
                                                                            outputShape.IsUnknown() ? TensorShape(0) : AsTensorShape(outputShape),
                                                                            ImageLayoutKind::CHW, maxTempMemSizeInSamples, AsTensorShape(dilation), groups);
+                    if (functionConfig.Contains(PrimitiveFunction::AttributeNameInt8ActivationRange))
+                    {
+                        auto activationRange = functionConfig[PrimitiveFunction::AttributeNameInt8ActivationRange].Value<float>();
+                        SMART_NODE_INVOKE(ConvolutionNode, computationNodePtr, EnableInt8Inference, activationRange);
+                    }
                     break;
                 }
                 case PrimitiveOpType::CosDistance:
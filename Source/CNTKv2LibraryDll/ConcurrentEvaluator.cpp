@@ -0,0 +1,176 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Utils.h"
+#include <thread>
+
+namespace CNTK
+{
+    // An evaluation instance is a clone of the evaluated Function that shares all of its Parameters and Constants.
+    // The clone lazily builds and compiles its own computation network on its first evaluation; afterwards the network,
+    // and with it all intermediate activation buffers, is reused for every request executed on this instance.
+    // The V1 ComputationNetwork keeps the activations inside its nodes, so one compiled network cannot serve two requests
+    // at the same time; each instance therefore pays for its own compilation and activation buffers.
+    struct ConcurrentEvaluator::Instance
+    {
+        FunctionPtr m_function;
+        std::unordered_map<Variable, Variable> m_argumentMap; // Function argument -> instance argument
+        std::unordered_map<Variable, Variable> m_outputMap;   // Function output -> instance output
+        bool m_compiled = false;
+    };
+
+    ConcurrentEvaluatorPtr CreateConcurrentEvaluator(const FunctionPtr& evaluationFunction, size_t maxConcurrency, const DeviceDescriptor& device)
+    {
+        return MakeSharedObject<ConcurrentEvaluator>(evaluationFunction, maxConcurrency, device);
+    }
+
+    ConcurrentEvaluator::ConcurrentEvaluator(const FunctionPtr& evaluationFunction, size_t maxConcurrency, const DeviceDescriptor& device)
+        : m_evaluationFunction(evaluationFunction),
+          m_device(device),
+          m_maxConcurrency(maxConcurrency)
+    {
+        if (!m_evaluationFunction)
+            InvalidArgument("ConcurrentEvaluator: Eval function is not allowed to be null.");
+
+        if (m_maxConcurrency == 0)
+            m_maxConcurrency = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+        m_instances.reserve(m_maxConcurrency);
+        m_idleInstances.reserve(m_maxConcurrency);
+    }
+
+    ConcurrentEvaluator::~ConcurrentEvaluator()
+    {
+    }
+
+    size_t ConcurrentEvaluator::NumInstances() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_instances.size();
+    }
+
+    ConcurrentEvaluator::InstancePtr ConcurrentEvaluator::AcquireInstance()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_instanceReleased.wait(lock, [this]() { return !m_idleInstances.empty() || m_instances.size() < m_maxConcurrency; });
+
+            if (!m_idleInstances.empty())
+            {
+                auto instance = m_idleInstances.back();
+                m_idleInstances.pop_back();
+                return instance;
+            }
+
+            // Reserve the slot of the new instance before creating it outside of the lock.
+            m_instances.push_back(nullptr);
+        }
+
+        auto instance = std::make_shared<Instance>();
+        try
+        {
+            {
+                std::lock_guard<std::mutex> compileLock(m_compileMutex);
+                instance->m_function = m_evaluationFunction->Clone(ParameterCloningMethod::Share);
+            }
+
+            // The clone has the same graph structure as the original, so arguments and outputs correspond by position.
+            auto arguments = m_evaluationFunction->Arguments();
+            auto instanceArguments = instance->m_function->Arguments();
+            auto outputs = m_evaluationFunction->Outputs();
+            auto instanceOutputs = instance->m_function->Outputs();
+            if ((arguments.size() != instanceArguments.size()) || (outputs.size() != instanceOutputs.size()))
+                LogicError("ConcurrentEvaluator: The evaluation instance of Function '%S' does not match its arguments or outputs.", m_evaluationFunction->AsString().c_str());
+
+            for (size_t i = 0; i < arguments.size(); ++i)
+                instance->m_argumentMap.insert({ arguments[i], instanceArguments[i] });
+            for (size_t i = 0; i < outputs.size(); ++i)
+                instance->m_outputMap.insert({ outputs[i], instanceOutputs[i] });
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_instances.erase(std::find(m_instances.begin(), m_instances.end(), nullptr));
+            }
+            m_instanceReleased.notify_one();
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            *std::find(m_instances.begin(), m_instances.end(), nullptr) = instance;
+        }
+        return instance;
+    }
+
+    void ConcurrentEvaluator::ReleaseInstance(const InstancePtr& instance)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_idleInstances.push_back(instance);
+        }
+        m_instanceReleased.notify_one();
+    }
+
+    void ConcurrentEvaluator::Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputs)
+    {
+        auto instance = AcquireInstance();
+        try
+        {
+            std::unordered_map<Variable, ValuePtr> instanceArguments;
+            for (const auto& argumentValuePair : arguments)
+            {
+                auto iter = instance->m_argumentMap.find(argumentValuePair.first);
+                if (iter == instance->m_argumentMap.end())
+                    InvalidArgument("ConcurrentEvaluator: Variable '%S' is not an argument of the Function '%S'.",
+                                    argumentValuePair.first.AsString().c_str(), m_evaluationFunction->AsString().c_str());
+
+                instanceArguments.insert({ iter->second, argumentValuePair.second });
+            }
+
+            std::unordered_map<Variable, ValuePtr> instanceOutputs;
+            for (const auto& outputValuePair : outputs)
+            {
+                auto iter = instance->m_outputMap.find(outputValuePair.first);
+                if (iter == instance->m_outputMap.end())
+                    InvalidArgument("ConcurrentEvaluator: Variable '%S' is not an output of the Function '%S'.",
+                                    outputValuePair.first.AsString().c_str(), m_evaluationFunction->AsString().c_str());
+
+                instanceOutputs.insert({ iter->second, outputValuePair.second });
+            }
+
+            if (instance->m_compiled)
+                instance->m_function->Evaluate(instanceArguments, instanceOutputs, m_device);
+            else
+            {
+                // The first evaluation builds and compiles the computation network of the instance.
+                std::lock_guard<std::mutex> compileLock(m_compileMutex);
+                instance->m_function->Evaluate(instanceArguments, instanceOutputs, m_device);
+                instance->m_compiled = true;
+            }
+
+            for (auto& outputValuePair : outputs)
+            {
+                const auto& instanceOutputValue = instanceOutputs.at(instance->m_outputMap.at(outputValuePair.first));
+
+                // Values allocated by the instance alias its network storage, which is invalidated by the next request
+                // executed on the instance; copy them out while the instance is still ours. Callers that supply
+                // their own output Values avoid this copy and the allocation.
+                if (!outputValuePair.second)
+                    outputValuePair.second = instanceOutputValue->DeepClone();
+            }
+        }
+        catch (...)
+        {
+            ReleaseInstance(instance);
+            throw;
+        }
+
+        ReleaseInstance(instance);
+    }
+}
@@ -153,11 +153,6 @@ namespace CNTK
                     if (storageFormat != StorageFormat::SparseBlockCol)
                         LogicError("Unsupported sparse gradient format");
 
-                    // NOTE: CPU sparse block column stores block Ids in size_t and it's different from GPU SBC
-                    // We should refactor the CPU SBC code to align with GPU in future
-                    if (i.second->Device().Type() == DeviceKind::CPU)
-                        LogicError("Unsupported CPU sparse block column aggregation");
-
                     sparseValuesToAggregate.push_back(i.second);
                 }
             }
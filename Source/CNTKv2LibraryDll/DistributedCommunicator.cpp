@@ -34,6 +34,11 @@ namespace CNTK
         return std::make_shared<MPICommunicatorImpl>(packThresholdSizeInBytes);
     }
 
+    DistributedCommunicatorPtr HierarchicalMPICommunicator(size_t ranksPerHost, size_t packThresholdSizeInBytes)
+    {
+        return std::make_shared<MPICommunicatorImpl>(packThresholdSizeInBytes, true, ranksPerHost);
+    }
+
     void DistributedCommunicator::Finalize()
     {
         auto mpi = MPIWrapper::GetInstance(false);
@@ -71,7 +76,8 @@ namespace CNTK
         return nullptr; // Make compiler happy.
     }
 
-    MPICommunicatorImpl::MPICommunicatorImpl(size_t packThresholdSizeInBytes)
+    MPICommunicatorImpl::MPICommunicatorImpl(size_t packThresholdSizeInBytes, bool useHierarchicalAllReduce, size_t ranksPerHost)
+        : m_useHierarchicalAllReduce(useHierarchicalAllReduce), m_ranksPerHost(ranksPerHost)
     {
         m_mpi = MPIWrapper::GetInstance();
         if (m_mpi == nullptr)
@@ -367,6 +373,7 @@ namespace CNTK
         CopyDataFromGPUToCPU(valuesToAggregate);
 
         std::vector<MPI_Request> allReduceRequests;
+        std::vector<size_t> allReduceRequestValues; // index of the value each request reduces
         for (auto i = 0; i < numValues; ++i)
         {
             auto inputValue = valuesToAggregate[i];
@@ -406,6 +413,16 @@ namespace CNTK
             }
             else
                 LogicError("MPICommunicator: Unknown DataType.");
+
+            if (allReduceRequests.size() > allReduceRequestValues.size())
+                allReduceRequestValues.push_back(i);
+            else if (ShouldCopyDataToCPU(inputValue))
+            {
+                // The value has been reduced synchronously in its cpu buffer (hierarchical all reduce), so there is
+                // no request to wait for, initiate the cpu-to-gpu transfer right away.
+                auto view = valuesAfterAggregate[i];
+                m_gpuDataTransferers[i]->CopyCPUToGPUAsync(m_intermediateCPUBuffers[i].data.get(), GetBufferSize(view), GetDataBuffer(view));
+            }
         }
 
         if (m_nccl->IsSupported())
@@ -427,15 +444,16 @@ namespace CNTK
 
             numAllReduceRequestsCompleted++;
 
-            assert(idx < valuesToAggregate.size());
-            auto value = valuesToAggregate[idx];
+            assert(idx < allReduceRequestValues.size());
+            auto valueIndex = allReduceRequestValues[idx];
+            auto value = valuesToAggregate[valueIndex];
 
             if (ShouldCopyDataToCPU(value))
             {
-                auto view = valuesAfterAggregate[idx];
+                auto view = valuesAfterAggregate[valueIndex];
                 auto size = GetBufferSize(view);
-                auto& transferer = m_gpuDataTransferers[idx];
-                auto& buffer = m_intermediateCPUBuffers[idx];
+                auto& transferer = m_gpuDataTransferers[valueIndex];
+                auto& buffer = m_intermediateCPUBuffers[valueIndex];
                 transferer->CopyCPUToGPUAsync(buffer.data.get(), size, GetDataBuffer(view));
             }
         }
@@ -452,13 +470,64 @@ namespace CNTK
         UnpackFromContinuousBuffer(m_aggregationBufferDouble.get(), outputValues, packedDoubleGradientsIndex);
     }
 
+    // Assigns consecutive block ids to the columns that have a block in the all-reduced (max) col2BlockId, in column order,
+    // such that the blocks line up on all workers. Returns the number of blocks.
+    static size_t RenumberAggregatedBlocks(SparseIndexType* aggregatedCol2BlockId, size_t numCols)
+    {
+        size_t numBlocks = 0;
+        for (size_t col = 0; col < numCols; col++)
+        {
+            if (aggregatedCol2BlockId[col] != SparseIndex_NotAssigned)
+            {
+                aggregatedCol2BlockId[col] = (SparseIndexType)numBlocks;
+                numBlocks++;
+            }
+        }
+        return numBlocks;
+    }
+
+    template <typename ElemType>
+    void MPICommunicatorImpl::AllReduceCPUSparseBlockColumn(const NDArrayViewPtr& sbc)
+    {
+        auto matrix = GetMatrix<ElemType>(sbc);
+        size_t numCols = matrix->GetNumCols();
+        std::vector<SparseIndexType> col2BlockId(numCols);
+        matrix->GetSparseBlockColumnCol2BlockId(col2BlockId.data());
+
+        // the union of the columns touched on any worker, then only their blocks are reduced
+        AllReduceData<SparseIndexType>(col2BlockId.data(), col2BlockId.data(), numCols, nullptr, /*dataOnCPU=*/ true, MPI_MAX, true);
+        size_t numBlocks = RenumberAggregatedBlocks(col2BlockId.data(), numCols);
+        sbc->AdjustSparseBlockColumn(col2BlockId.data(), numBlocks, /*useBlockId2Col*/ false);
+
+        auto writableMatrix = GetWritableMatrix<ElemType>(sbc);
+        if (numBlocks > 0)
+            AllReduceData<ElemType>(writableMatrix->Data(), writableMatrix->Data(), writableMatrix->GetNumRows() * numBlocks, nullptr, /*dataOnCPU=*/ true, MPI_SUM, true);
+    }
+
     void MPICommunicatorImpl::AllReduceSparseBlockColumn(
         std::vector<NDArrayViewPtr>& sbcValues)
     {
         if (m_mpi->NumNodesInUse() == 1) // No need to aggregate anything.
             return;
+
+        // CPU sparse block column keeps its block ids in a different format, it is aggregated through the V1 matrix
+        std::vector<NDArrayViewPtr> gpuSBCValues;
+        for (const auto& sbc : sbcValues)
+        {
+            if (sbc->Device() != DeviceDescriptor::CPUDevice())
+                gpuSBCValues.push_back(sbc);
+            else if (sbc->GetDataType() == DataType::Float)
+                AllReduceCPUSparseBlockColumn<float>(sbc);
+            else if (sbc->GetDataType() == DataType::Double)
+                AllReduceCPUSparseBlockColumn<double>(sbc);
+            else
+                LogicError("MPICommunicator: Unsupported DataType %s for sparse block column aggregation on CPUDevice.", DataTypeName(sbc->GetDataType()));
+        }
+
+        if (gpuSBCValues.empty())
+            return;
 #if defined(CPUONLY) || HAS_MPI == 0
-        LogicError("Sparse block column aggregation on CPUDevice or non-MPI not implemented");
+        LogicError("Sparse block column aggregation on GPU or non-MPI not implemented");
 #else
         // a handy struct to access sparse block column matrix internal data
         struct SBCInfo
@@ -472,9 +541,6 @@ namespace CNTK
 
             SBCInfo(const NDArrayViewPtr& sbc)
             {
-                if (sbc->Device() == DeviceDescriptor::CPUDevice())
-                    LogicError("Unimplmented sparse block column aggregation on CPUDevice. Please cntk.cntk_py.use_sparse_gradient_aggregation_in_data_parallel_sgd(False) to avoid this error.");
-
                 if (sbc->GetDataType() == DataType::Float)
                 {
                     auto tuple = sbc->SparseBlockColumnDataBuffers<float>();
@@ -500,20 +566,20 @@ namespace CNTK
             }
         };
 
-        m_intermediateSBCIndexCPUBuffers.resize(sbcValues.size());
-        m_intermediateSBCValueCPUBuffers.resize(sbcValues.size());
+        m_intermediateSBCIndexCPUBuffers.resize(gpuSBCValues.size());
+        m_intermediateSBCValueCPUBuffers.resize(gpuSBCValues.size());
 
         // First, AllReduce(Max) to get the aggregated non-zero columns
         bool aggregateOnCPU = !(m_nccl->IsSupported() || m_mpi->UseGpuGdr());
 
         std::vector<SBCInfo> sbcInfos;
-        for (size_t idx = 0; idx < sbcValues.size(); idx++)
+        for (size_t idx = 0; idx < gpuSBCValues.size(); idx++)
         {
-            sbcInfos.emplace_back(SBCInfo(sbcValues[idx]));
+            sbcInfos.emplace_back(SBCInfo(gpuSBCValues[idx]));
             auto& sbcInfo = sbcInfos[idx];
             size_t requiredSize = sbcInfo.numCols * sizeof(SparseIndexType);
             if (m_intermediateSBCIndexCPUBuffers[idx].totalSize < requiredSize)
-                m_intermediateSBCIndexCPUBuffers[idx] = AllocateIntermediateBuffer(sbcValues[idx]->Device().Id(), requiredSize);
+                m_intermediateSBCIndexCPUBuffers[idx] = AllocateIntermediateBuffer(gpuSBCValues[idx]->Device().Id(), requiredSize);
 
             SparseIndexType* pCol2BlockId = nullptr;
             if (aggregateOnCPU)
@@ -539,7 +605,7 @@ namespace CNTK
 
         for (size_t idx = 0; idx < sbcInfos.size(); idx++)
         {
-            auto sbc = sbcValues[idx];
+            auto sbc = gpuSBCValues[idx];
             auto& sbcInfo = sbcInfos[idx];
 
             // copy to CPU to count aggregated columns and allocate space for values
@@ -552,16 +618,8 @@ namespace CNTK
             }
 
             // update col2blockId and count new blocks
-            size_t numBlocks = 0;
-            for (size_t col = 0; col < sbcInfo.numCols; col++)
-            {
-                if (aggregatedCol2BlockId[col] != SparseIndex_NotAssigned)
-                {
-                    // note that the order has been changed after aggregation. This is to make sure the indices are the same for all workers
-                    aggregatedCol2BlockId[col] = numBlocks;
-                    numBlocks++;
-                }
-            }
+            // note that the order has been changed after aggregation. This is to make sure the indices are the same for all workers
+            size_t numBlocks = RenumberAggregatedBlocks(aggregatedCol2BlockId, sbcInfo.numCols);
 
             // adjust sbc with the new col2BlockId. old nz would be copied to the new nz buffer according to the new Col2BlockId,
             // and the rest of nz buffer would be filled with zero. BlockId2Col would be set accordingly too.
@@ -579,7 +637,7 @@ namespace CNTK
             {
                 // if aggregating on CPU, copy nz from GPU first
                 if (m_intermediateSBCValueCPUBuffers[idx].totalSize < requiredSize)
-                    m_intermediateSBCValueCPUBuffers[idx] = AllocateIntermediateBuffer(sbcValues[idx]->Device().Id(), requiredSize);
+                    m_intermediateSBCValueCPUBuffers[idx] = AllocateIntermediateBuffer(gpuSBCValues[idx]->Device().Id(), requiredSize);
                 void* nzCPU = m_intermediateSBCValueCPUBuffers[idx].data.get();
                 cudaMemcpy(nzCPU, nz, requiredSize, cudaMemcpyDeviceToHost);
                 nz = nzCPU;
@@ -711,6 +769,15 @@ namespace CNTK
             return;
         }
 
+        // The hierarchical allreduce shares the data through host memory, it does not take GPU buffers. GPU values without
+        // GPUDirect RDMA have already been copied to their cpu buffer; the caller copies them back as no request is issued.
+        if (m_useHierarchicalAllReduce && (dataOnCPU || !m_mpi->UseGpuGdr()))
+        {
+            m_mpi->HierarchicalAllReduce(inputData == outputData ? static_cast<ElemType*>(MPI_IN_PLACE) : inputData, outputData, numElements, op, m_ranksPerHost);
+
+            return;
+        }
+
         if (m_mpi->UseGpuGdr() || forceSync)
         {
             if (inputData == outputData)
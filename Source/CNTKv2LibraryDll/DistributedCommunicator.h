@@ -23,7 +23,7 @@ namespace CNTK
     class MPICommunicatorImpl : public DistributedCommunicator, public std::enable_shared_from_this<MPICommunicatorImpl>
     {
     public:
-        MPICommunicatorImpl(size_t packThresholdSizeInBytes = DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES);
+        MPICommunicatorImpl(size_t packThresholdSizeInBytes = DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES, bool useHierarchicalAllReduce = false, size_t ranksPerHost = 0);
 
         virtual const std::unordered_set<DistributedWorkerDescriptor>& Workers() const override;
 
@@ -90,6 +90,10 @@ namespace CNTK
 
         // Threshold size of a gradient to be packed
         size_t m_packThresholdSizeInBytes;
+
+        // Aggregate values in CPU memory with the hierarchical allreduce of the MPIWrapper, see HierarchicalMPICommunicator().
+        bool m_useHierarchicalAllReduce;
+        size_t m_ranksPerHost;
         std::unique_ptr<Microsoft::MSR::CNTK::Matrix<float>> m_aggregationBufferFloat;
         std::unique_ptr<Microsoft::MSR::CNTK::Matrix<double>> m_aggregationBufferDouble;
 
@@ -144,6 +148,9 @@ namespace CNTK
         template <typename ElemType>
         void AllReduceData(ElemType* inputData, ElemType* outputData, size_t numElements, std::vector<MPI_Request>* pAllReduceRequests, bool dataOnCPU, MPI_Op op = MPI_SUM, bool forceSync = false);
 
+        template <typename ElemType>
+        void AllReduceCPUSparseBlockColumn(const NDArrayViewPtr& sbc);
+
         void AllReduceDataHalf(half* inputData, half* outputData, size_t numElements, std::vector<MPI_Request>* pAllReduceRequests, bool dataOnCPU, MPI_Op op = MPI_SUM, bool forceSync = false);
     };
 }
@@ -498,6 +498,12 @@ namespace CNTK
             auto stream = GetFstream(filepath, true);
             if (!Internal::IsLegacyModel(*stream))
             {
+                if (Internal::AreMemoryMappedModelsEnabled())
+                {
+                    stream.reset();
+                    return Function::Deserialize(Dictionary::Load(filepath), computeDevice);
+                }
+
                 Dictionary model;
                 *stream >> model;
                 return Function::Deserialize(model, computeDevice);
@@ -0,0 +1,232 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Utils.h"
+#include "PrimitiveFunction.h"
+
+namespace CNTK
+{
+    // A Times or Convolution Function to be computed in int8, and the Variable its activation (second operand) is bound to
+    // in the graph of the converted Function, i.e. block arguments are resolved to the Variables they are mapped to.
+    // Activations computed inside of a block cannot be evaluated on their own and are not calibrated.
+    struct Int8Candidate
+    {
+        FunctionPtr m_function;
+        Variable m_activation;
+        bool m_calibrated;
+    };
+
+    // Block argument -> (bound Variable, whether the bound Variable belongs to the graph of the converted Function)
+    typedef std::unordered_map<Variable, std::pair<Variable, bool>> BlockArgumentBindings;
+
+    static bool IsInt8Candidate(const FunctionPtr& function)
+    {
+        auto primitiveFunction = std::dynamic_pointer_cast<PrimitiveFunction>(function);
+        if (!primitiveFunction)
+            return false;
+
+        auto op = primitiveFunction->OpType();
+        if ((op != PrimitiveOpType::Times) && (op != PrimitiveOpType::Convolution))
+            return false;
+
+        const auto& inputs = function->Inputs();
+        const auto& weight = inputs[0];
+        const auto& activation = inputs[1];
+        if ((!weight.IsParameter() && !weight.IsConstant()) || activation.IsSparse())
+            return false;
+
+        if ((activation.GetDataType() != DataType::Float) && (activation.GetDataType() != DataType::Double))
+            return false;
+
+        if (op == PrimitiveOpType::Convolution)
+        {
+            const auto& attributes = function->Attributes();
+            if (attributes[PrimitiveFunction::AttributeNameTranspose].Value<bool>())
+                return false;
+            if (attributes.Contains(PrimitiveFunction::AttributeNameGroups) &&
+                (attributes[PrimitiveFunction::AttributeNameGroups].Value<size_t>() != PrimitiveFunction::convolutionOpDefaultValueForGroups))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Collects the int8 candidates of the graph, including those inside of blocks, in an order that only depends on the graph structure.
+    static void CollectInt8Candidates(const FunctionPtr& function, bool isInsideBlock, const BlockArgumentBindings& blockArgumentBindings,
+                                      std::unordered_set<FunctionPtr>& visitedFunctions, std::vector<Int8Candidate>& candidates)
+    {
+        if (!visitedFunctions.insert(function).second)
+            return;
+
+        auto resolve = [isInsideBlock, &blockArgumentBindings](const Variable& variable) {
+            auto iter = blockArgumentBindings.find(variable);
+            return (iter == blockArgumentBindings.end()) ? std::make_pair(variable, !isInsideBlock) : iter->second;
+        };
+
+        if (function->IsBlock())
+        {
+            BlockArgumentBindings innerBlockArgumentBindings;
+            for (const auto& argumentMapping : function->BlockArgumentsMapping())
+                innerBlockArgumentBindings.insert({ argumentMapping.first, resolve(argumentMapping.second) });
+
+            CollectInt8Candidates(function->BlockRoot(), /*isInsideBlock=*/true, innerBlockArgumentBindings, visitedFunctions, candidates);
+        }
+        else if (IsInt8Candidate(function))
+        {
+            auto activation = resolve(function->Inputs()[1]);
+            candidates.push_back({ function, activation.first, activation.second });
+        }
+
+        for (const auto& input : function->Inputs())
+        {
+            if (input.IsOutput())
+                CollectInt8Candidates(input.Owner(), isInsideBlock, blockArgumentBindings, visitedFunctions, candidates);
+        }
+    }
+
+    static std::vector<Int8Candidate> CollectInt8Candidates(const FunctionPtr& function)
+    {
+        std::unordered_set<FunctionPtr> visitedFunctions;
+        std::vector<Int8Candidate> candidates;
+        CollectInt8Candidates(function->RootFunction(), /*isInsideBlock=*/false, {}, visitedFunctions, candidates);
+        return candidates;
+    }
+
+    // Absolute max of the valid (not masked) samples of the value.
+    template <typename ElementType>
+    static float AbsMax(const ValuePtr& value)
+    {
+        auto data = value->Data()->DeepClone(DeviceDescriptor::CPUDevice(), /*readOnly=*/true);
+        const ElementType* buffer = data->DataBuffer<ElementType>();
+        size_t numElements = data->Shape().TotalSize();
+
+        const MaskKind* maskBuffer = nullptr;
+        size_t sampleSize = numElements;
+        NDMaskPtr mask = value->Mask();
+        if (mask)
+        {
+            mask = mask->DeepClone(DeviceDescriptor::CPUDevice());
+            maskBuffer = mask->DataBuffer();
+            sampleSize = numElements / mask->Shape().TotalSize();
+        }
+
+        float absMax = 0;
+        for (size_t i = 0; i < numElements; ++i)
+        {
+            if (maskBuffer && (maskBuffer[i / sampleSize] == MaskKind::Invalid))
+                continue;
+
+            absMax = std::max(absMax, (float)std::abs(buffer[i]));
+        }
+
+        return absMax;
+    }
+
+    static float AbsMax(const ValuePtr& value)
+    {
+        if (value->GetDataType() == DataType::Float)
+            return AbsMax<float>(value);
+        else if (value->GetDataType() == DataType::Double)
+            return AbsMax<double>(value);
+        else
+            LogicError("QuantizeForInt8Inference: Unsupported DataType %s.", DataTypeName(value->GetDataType()));
+    }
+
+    FunctionPtr QuantizeForInt8Inference(const FunctionPtr& function,
+                                         const MinibatchSourcePtr& calibrationSource,
+                                         const std::unordered_map<Variable, StreamInformation>& inputVarToStream,
+                                         size_t numCalibrationMinibatches,
+                                         size_t calibrationMinibatchSizeInSamples,
+                                         const DeviceDescriptor& device /*= DeviceDescriptor::CPUDevice()*/)
+    {
+        if (!function)
+            InvalidArgument("QuantizeForInt8Inference: The Function to be converted must not be null.");
+        if (!calibrationSource || (numCalibrationMinibatches == 0) || (calibrationMinibatchSizeInSamples == 0))
+            InvalidArgument("QuantizeForInt8Inference: A calibration MinibatchSource and a non-zero number and size of calibration minibatches are required.");
+
+        auto candidates = CollectInt8Candidates(function);
+
+        // Activations that are arguments of the Function are read from the minibatch data directly,
+        // the others are computed by evaluating them as outputs.
+        std::unordered_map<Variable, float> activationRanges;
+        std::vector<Variable> computedActivations;
+        for (const auto& candidate : candidates)
+        {
+            if (!candidate.m_calibrated || !activationRanges.insert({ candidate.m_activation, 0.0f }).second)
+                continue;
+
+            if (candidate.m_activation.IsOutput())
+                computedActivations.push_back(candidate.m_activation);
+            else if (inputVarToStream.find(candidate.m_activation) == inputVarToStream.end())
+                InvalidArgument("QuantizeForInt8Inference: No calibration stream is specified for the input '%S' of '%S'.",
+                                candidate.m_activation.AsString().c_str(), candidate.m_function->AsString().c_str());
+        }
+
+        FunctionPtr calibrationFunction;
+        if (!computedActivations.empty())
+            calibrationFunction = Combine(computedActivations);
+
+        for (size_t i = 0; i < numCalibrationMinibatches; ++i)
+        {
+            const auto& minibatch = calibrationSource->GetNextMinibatch(calibrationMinibatchSizeInSamples, device);
+            if (minibatch.empty())
+                break;
+
+            std::unordered_map<Variable, ValuePtr> arguments;
+            for (const auto& inputStreamPair : inputVarToStream)
+            {
+                auto iter = minibatch.find(inputStreamPair.second);
+                if (iter == minibatch.end())
+                    InvalidArgument("QuantizeForInt8Inference: The calibration minibatch has no data for the stream '%S'.", inputStreamPair.second.AsString().c_str());
+
+                arguments.insert({ inputStreamPair.first, iter->second.data });
+            }
+
+            std::unordered_map<Variable, ValuePtr> outputs;
+            if (calibrationFunction)
+            {
+                std::unordered_map<Variable, ValuePtr> calibrationArguments;
+                for (const auto& argument : calibrationFunction->Arguments())
+                {
+                    auto iter = arguments.find(argument);
+                    if (iter == arguments.end())
+                        InvalidArgument("QuantizeForInt8Inference: No calibration stream is specified for the argument '%S' of Function '%S'.",
+                                        argument.AsString().c_str(), function->AsString().c_str());
+
+                    calibrationArguments.insert(*iter);
+                }
+
+                for (const auto& activation : computedActivations)
+                    outputs.insert({ activation, nullptr });
+
+                calibrationFunction->Evaluate(calibrationArguments, outputs, device);
+            }
+
+            for (auto& activationRange : activationRanges)
+            {
+                const auto& activation = activationRange.first;
+                const auto& value = activation.IsOutput() ? outputs.at(activation) : arguments.at(activation);
+                activationRange.second = std::max(activationRange.second, AbsMax(value));
+            }
+        }
+
+        // The clone has the same graph structure, so its candidates correspond to those of the Function by position.
+        auto quantizedFunction = function->Clone(ParameterCloningMethod::Share);
+        auto quantizedCandidates = CollectInt8Candidates(quantizedFunction);
+        if (quantizedCandidates.size() != candidates.size())
+            LogicError("QuantizeForInt8Inference: The clone of Function '%S' does not match its structure.", function->AsString().c_str());
+
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            // A range of 0 makes the activation be quantized with the range of each minibatch.
+            auto primitiveFunction = std::dynamic_pointer_cast<PrimitiveFunction>(quantizedCandidates[i].m_function);
+            primitiveFunction->SetInt8ActivationRange(candidates[i].m_calibrated ? activationRanges.at(candidates[i].m_activation) : 0.0f);
+        }
+
+        return quantizedFunction;
+    }
+}
@@ -1519,4 +1519,13 @@ namespace CNTK
         m_attributes[AttributeNameRngSeed] = seed;
         m_dirtyAttributes.insert(AttributeNameRngSeed);
     }
+
+    void PrimitiveFunction::SetInt8ActivationRange(float activationRange)
+    {
+        if ((OpType() != PrimitiveOpType::Times) && (OpType() != PrimitiveOpType::Convolution))
+            LogicError("Cannot enable int8 inference on '%S' function.", OpName().c_str());
+
+        // Takes effect when the computation network of the Function is built.
+        m_attributes[AttributeNameInt8ActivationRange] = activationRange;
+    }
 }
@@ -319,6 +319,7 @@ namespace CNTK
         static const std::wstring AttributeNameDoVarianceScaling;
         static const std::wstring AttributeNameGroups;
         static const std::wstring AttributeNameCustomOp;
+        static const std::wstring AttributeNameInt8ActivationRange;
 
         static const size_t convolutionOpDefaultValueForGroups = 1;
 
@@ -374,6 +375,9 @@ namespace CNTK
 
         void SetState(const Dictionary& state);
 
+        // Marks a Times or Convolution function for int8 inference, see QuantizeForInt8Inference.
+        void SetInt8ActivationRange(float activationRange);
+
     private:
 
         // The following helper functions are used to determine the output shape for different
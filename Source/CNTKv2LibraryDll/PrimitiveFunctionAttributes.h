@@ -120,4 +120,5 @@ namespace CNTK
     /*static*/ const std::wstring PrimitiveFunction::AttributeNameDoVarianceScaling = L"doVarianceScaling";
     /*static*/ const std::wstring PrimitiveFunction::AttributeNameGroups = L"groups";
     /*static*/ const std::wstring PrimitiveFunction::AttributeNameCustomOp = L"customOp";
+    /*static*/ const std::wstring PrimitiveFunction::AttributeNameInt8ActivationRange = L"int8ActivationRange";
 }
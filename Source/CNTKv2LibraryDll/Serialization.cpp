@@ -14,6 +14,10 @@
 
 #ifdef _MSC_VER
 #include <io.h>
+#include "Windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 #pragma warning(push)
@@ -29,7 +33,15 @@ namespace CNTK
     using namespace ::google::protobuf;
 
     static const uint32 MAGIC_NUMBER = 0x636e746bU;
+    // Prefix of messages whose NDArrayView payloads are stored in raw, aligned sections after the metadata.
+    static const uint32 ALIGNED_MAGIC_NUMBER = 0x636e746dU;
     static const uint32 BLOCK_SIZE = 8 << 10; // 8Kb;
+    static const size_t TENSOR_SECTION_ALIGNMENT = 64;
+
+    static inline size_t AlignTensorSection(size_t offset)
+    {
+        return (offset + TENSOR_SECTION_ALIGNMENT - 1) / TENSOR_SECTION_ALIGNMENT * TENSOR_SECTION_ALIGNMENT;
+    }
 
     static void SetUTF8Locale()
     {
@@ -113,6 +125,79 @@ namespace CNTK
     };
 
 
+    // A whole file mapped into memory. The pages are mapped copy-on-write, so that NDArrayViews backed
+    // by the mapping stay writable without ever modifying the file, and are only read in when touched.
+    class MemoryMappedFile
+    {
+    public:
+        explicit MemoryMappedFile(const std::wstring& filename)
+        {
+#ifdef _MSC_VER
+            m_file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (m_file == INVALID_HANDLE_VALUE)
+                RuntimeError("Cannot open file '%S' for reading.", filename.c_str());
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(m_file, &fileSize))
+            {
+                CloseHandle(m_file);
+                RuntimeError("Cannot retrieve the size of file '%S'.", filename.c_str());
+            }
+            m_size = (size_t)fileSize.QuadPart;
+
+            m_mapping = (m_size > 0) ? CreateFileMappingW(m_file, NULL, PAGE_WRITECOPY, 0, 0, NULL) : NULL;
+            m_data = (m_mapping != NULL) ? (char*)MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+            if (m_data == nullptr)
+            {
+                if (m_mapping != NULL)
+                    CloseHandle(m_mapping);
+                CloseHandle(m_file);
+                RuntimeError("Cannot memory map file '%S'.", filename.c_str());
+            }
+#else
+            auto fd = GetFileDescriptor(filename, true);
+            struct stat fileStat;
+            if (fstat(fd, &fileStat) == -1)
+            {
+                close(fd);
+                RuntimeError("Cannot retrieve the size of file '%S'.", filename.c_str());
+            }
+            m_size = (size_t)fileStat.st_size;
+
+            // The mapping stays valid after the descriptor is closed.
+            void* data = (m_size > 0) ? mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+            close(fd);
+            if (data == MAP_FAILED)
+                RuntimeError("Cannot memory map file '%S'.", filename.c_str());
+            m_data = (char*)data;
+#endif
+        }
+
+        ~MemoryMappedFile()
+        {
+#ifdef _MSC_VER
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+            CloseHandle(m_file);
+#else
+            munmap(m_data, m_size);
+#endif
+        }
+
+        char* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+
+    private:
+        MemoryMappedFile(const MemoryMappedFile&) = delete; MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        char* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _MSC_VER
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = NULL;
+#endif
+    };
+
     class Serializer
     {
         friend std::ostream& operator<<(std::ostream&, const Dictionary&);
@@ -141,6 +226,7 @@ namespace CNTK
 
         void CopyNDArrayViewDataToProtos();
         void WriteNDArrayViewData(io::CodedOutputStream& output);
+        void WriteWithAlignedNDArrayViewData(io::CodedOutputStream& output);
 
         std::ostream& Write(std::ostream& stream);
         void Write(const std::wstring& filename);
@@ -155,8 +241,13 @@ namespace CNTK
 
         bool Read(std::wstring filename, const std::function<bool(io::ZeroCopyInputStream& input)>& callback);
         bool Read(std::istream& stream, const std::function<bool(io::ZeroCopyInputStream& input)>& callback);
+        bool ReadMapped(const std::wstring& filename, const std::function<bool(io::ZeroCopyInputStream& input)>& callback);
+
+        bool ParseMessage(io::ZeroCopyInputStream& input);
 
         bool ReadNDArrayViewData(io::ZeroCopyInputStream& input);
+        bool ReadExternalNDArrayViewData(io::ZeroCopyInputStream& input);
+        NDArrayView* CreateFromExternalValues(const proto::NDArrayView& src, const NDShape& shape);
 
         size_t GetTotalByteSize()
         {
@@ -344,11 +435,83 @@ namespace CNTK
             memcpy(buffer, src.data(), size * sizeof(int8_t));
         }
 
+        static const void* RawDataBuffer(const NDArrayView& src)
+        {
+            switch (src.GetDataType())
+            {
+            case DataType::Float:
+                return src.DataBuffer<float>();
+            case DataType::Double:
+                return src.DataBuffer<double>();
+            case DataType::Float16:
+                return src.DataBuffer<float16>();
+            case DataType::Int8:
+                return src.DataBuffer<int8_t>();
+            case DataType::Int16:
+                return src.DataBuffer<int16_t>();
+            default:
+                LogicError("Unsupported DataType %s", DataTypeName(src.GetDataType()));
+            }
+        }
+
+        static void* WritableRawDataBuffer(NDArrayView& dst)
+        {
+            switch (dst.GetDataType())
+            {
+            case DataType::Float:
+                return dst.WritableDataBuffer<float>();
+            case DataType::Double:
+                return dst.WritableDataBuffer<double>();
+            case DataType::Float16:
+                return dst.WritableDataBuffer<float16>();
+            case DataType::Int8:
+                return dst.WritableDataBuffer<int8_t>();
+            case DataType::Int16:
+                return dst.WritableDataBuffer<int16_t>();
+            default:
+                LogicError("Unsupported DataType %s", DataTypeName(dst.GetDataType()));
+            }
+        }
+
+        static void WriteRawData(const char* buffer, size_t size, io::CodedOutputStream& output)
+        {
+            // WriteRaw takes an int size.
+            const size_t maxChunkSize = INT_MAX / 2;
+            for (size_t offset = 0; offset < size; offset += maxChunkSize)
+                output.WriteRaw(buffer + offset, (int)std::min(size - offset, maxChunkSize));
+        }
+
+        static bool ReadRawData(io::ZeroCopyInputStream& input, char* buffer, size_t size)
+        {
+            while (size > 0)
+            {
+                const void* data;
+                int readSize;
+                if (!input.Next(&data, &readSize))
+                    return false;
+
+                auto copySize = std::min(size, (size_t)readSize);
+                memcpy(buffer, data, copySize);
+                buffer += copySize;
+                size -= copySize;
+                if (copySize < (size_t)readSize)
+                    input.BackUp(readSize - (int)copySize);
+            }
+            return true;
+        }
+
         UsingUTF8 m_locale;
         Arena m_arena;
         Message* m_proto;
         std::vector<std::pair<NDArrayView*, proto::NDArrayView*>> m_arrayViews;
         size_t m_byteSize {0};
+
+        // Aligned layout only: NDArrayViews whose values are read from the tensor section after the metadata,
+        // and the offsets of the end of the metadata and of the start of the tensor section.
+        std::vector<std::pair<NDArrayView*, const proto::NDArrayView*>> m_externalArrayViews;
+        size_t m_metadataEnd {0};
+        size_t m_tensorSectionOffset {0};
+        std::shared_ptr<MemoryMappedFile> m_mappedFile;
     };
 
 
@@ -424,6 +587,9 @@ namespace CNTK
 
     bool Serializer::ReadNDArrayViewData(io::ZeroCopyInputStream& input)
     {
+        if (!m_externalArrayViews.empty())
+            return ReadExternalNDArrayViewData(input);
+
         if (m_arrayViews.size() == 0)
             return true;
 
@@ -460,6 +626,69 @@ namespace CNTK
         return true;
     }
 
+    bool Serializer::ReadExternalNDArrayViewData(io::ZeroCopyInputStream& input)
+    {
+        // The stream is positioned at the end of the metadata; the tensor sections follow in the order of their offsets.
+        std::vector<std::pair<NDArrayView*, const proto::NDArrayView*>> arrayViews(m_externalArrayViews);
+        std::sort(arrayViews.begin(), arrayViews.end(), [](const std::pair<NDArrayView*, const proto::NDArrayView*>& a, const std::pair<NDArrayView*, const proto::NDArrayView*>& b) {
+            return a.second->external_values().offset() < b.second->external_values().offset();
+        });
+
+        size_t position = m_metadataEnd;
+        for (auto& pair : arrayViews)
+        {
+            const auto& values = pair.second->external_values();
+            auto sectionOffset = m_tensorSectionOffset + values.offset();
+            if ((sectionOffset < position) || (sectionOffset - position > INT_MAX) || !input.Skip((int)(sectionOffset - position)))
+                return false;
+
+            if (!ReadRawData(input, static_cast<char*>(WritableRawDataBuffer(*pair.first)), values.byte_size()))
+                return false;
+            position = sectionOffset + values.byte_size();
+        }
+        return true;
+    }
+
+    void Serializer::WriteWithAlignedNDArrayViewData(io::CodedOutputStream& output)
+    {
+        // Store every NDArrayView payload as raw little-endian values in its own aligned section after the metadata,
+        // so that a memory-mapped model file can directly back the deserialized NDArrayViews.
+        // The metadata references the sections through offsets relative to the (aligned) start of the tensor section.
+        size_t sectionsSize = 0;
+        for (auto& pair : m_arrayViews)
+        {
+            const auto& src = *(pair.first);
+            if (src.IsSparse())
+                InvalidArgument("Sparse NDArrayViews cannot be saved with aligned tensor sections.");
+
+            sectionsSize = AlignTensorSection(sectionsSize);
+            auto values = pair.second->mutable_external_values();
+            values->set_offset(sectionsSize);
+            values->set_byte_size(src.Shape().TotalSize() * DataTypeSize(src.GetDataType()));
+            sectionsSize += values->byte_size();
+        }
+
+        auto metadataSize = m_proto->ByteSizeLong();
+        if (metadataSize > INT_MAX)
+            RuntimeError("The metadata size (%zu) exceeds the protobuf limit of %d bytes.", metadataSize, INT_MAX);
+
+        output.WriteLittleEndian32(ALIGNED_MAGIC_NUMBER);
+        output.WriteLittleEndian32((uint32)metadataSize);
+        m_proto->SerializeToCodedStream(&output);
+
+        const char padding[TENSOR_SECTION_ALIGNMENT] = {};
+        size_t position = 2 * sizeof(uint32) + metadataSize;
+        auto tensorSectionOffset = AlignTensorSection(position);
+        for (auto& pair : m_arrayViews)
+        {
+            const auto& values = pair.second->external_values();
+            auto sectionOffset = tensorSectionOffset + values.offset();
+            output.WriteRaw(padding, (int)(sectionOffset - position));
+            WriteRawData(static_cast<const char*>(RawDataBuffer(*pair.first)), values.byte_size(), output);
+            position = sectionOffset + values.byte_size();
+        }
+    }
+
     proto::NDShape* Serializer::CreateProto(const NDShape& src, Arena* arena)
     {
         proto::NDShape* dst = (arena != nullptr) ? 
@@ -534,6 +763,9 @@ namespace CNTK
         }
 
         std::unique_ptr<NDShape> shape(CreateFromProto(src.shape()));
+        if (src.values_case() == proto::NDArrayView::kExternalValues)
+            return CreateFromExternalValues(src, *shape);
+
         auto dataType = FromProtoType(src.data_type());
         auto storageFormat = FromProtoType(src.storage_format());
         NDArrayView* dst = new NDArrayView(dataType, storageFormat, *shape, DeviceDescriptor::CPUDevice());
@@ -576,6 +808,35 @@ namespace CNTK
         return dst;
     }
 
+    NDArrayView* Serializer::CreateFromExternalValues(const proto::NDArrayView& src, const NDShape& shape)
+    {
+        auto dataType = FromProtoType(src.data_type());
+        if (FromProtoType(src.storage_format()) != StorageFormat::Dense)
+            RuntimeError("Only dense NDArrayViews can be stored in a tensor section.");
+
+        const auto& values = src.external_values();
+        if (values.byte_size() != shape.TotalSize() * DataTypeSize(dataType))
+            RuntimeError("The size (%zu) of the tensor section at offset %zu does not match the NDArrayView shape '%S'.",
+                         (size_t)values.byte_size(), (size_t)values.offset(), shape.AsString().c_str());
+
+        if (!m_mappedFile)
+        {
+            // Values are read from the stream once the whole metadata is deserialized.
+            NDArrayView* dst = new NDArrayView(dataType, StorageFormat::Dense, shape, DeviceDescriptor::CPUDevice());
+            m_externalArrayViews.push_back({ dst, &src });
+            return dst;
+        }
+
+        auto sectionOffset = m_tensorSectionOffset + values.offset();
+        if ((sectionOffset < m_tensorSectionOffset) || (sectionOffset > m_mappedFile->Size()) || (values.byte_size() > m_mappedFile->Size() - sectionOffset))
+            RuntimeError("The tensor section at offset %zu exceeds the size (%zu) of the memory-mapped model file.", (size_t)values.offset(), m_mappedFile->Size());
+
+        // Back the view directly by the mapped pages, which keep the mapping alive for as long as any view aliases them.
+        NDArrayView* dst = new NDArrayView(dataType, shape, m_mappedFile->Data() + sectionOffset, (size_t)values.byte_size(), DeviceDescriptor::CPUDevice());
+        dst->m_externalStorage = m_mappedFile;
+        return dst;
+    }
+
     proto::Vector* Serializer::CreateProto(const std::vector<DictionaryValue>& src, Arena* arena)
     {
         proto::Vector* dst = (arena != nullptr) ? 
@@ -738,6 +999,12 @@ namespace CNTK
     void Serializer::Write(io::ZeroCopyOutputStream& stream) {
         io::CodedOutputStream output(&stream);
 
+        if (Internal::AreMemoryMappedModelsEnabled())
+        {
+            WriteWithAlignedNDArrayViewData(output);
+            return;
+        }
+
         // Protobufs have a hard limit on the maximum message size(INT_MAX = 2GBs). 
         // Check if we fit into a single protobuf message.
         if (FitsIntoProtobuf())
@@ -778,8 +1045,9 @@ namespace CNTK
 #endif
     }
 
-    bool ParseMessage(io::ZeroCopyInputStream& input, Message& msg)
+    bool Serializer::ParseMessage(io::ZeroCopyInputStream& input)
     {
+        auto& msg = *m_proto;
         uint32 prefix = 0, limit = INT_MAX;;
         const void* temp;
         int size;
@@ -797,8 +1065,8 @@ namespace CNTK
         }
 
         // the message is only prefixed with a magic number + message length,
-        // if its size exceeds 2GBs.
-        if (prefix == MAGIC_NUMBER) 
+        // if its size exceeds 2GBs or its NDArrayView payloads are stored in aligned tensor sections.
+        if (prefix == MAGIC_NUMBER || prefix == ALIGNED_MAGIC_NUMBER) 
         {
             io::CodedInputStream::ReadLittleEndian32FromArray(
                 reinterpret_cast<const uint8*>(temp) + sizeof(prefix), &limit);
@@ -808,6 +1076,13 @@ namespace CNTK
         else 
             input.BackUp(size);
 
+        if (prefix == ALIGNED_MAGIC_NUMBER)
+        {
+            m_metadataEnd = sizeof(prefix) + sizeof(limit) + limit;
+            m_tensorSectionOffset = AlignTensorSection(m_metadataEnd);
+            return msg.ParseFromBoundedZeroCopyStream(&input, (int)limit);
+        }
+
         io::CodedInputStream codedInput(&input);
         codedInput.SetTotalBytesLimit(limit, limit);
         return msg.ParseFromCodedStream(&codedInput) && codedInput.ConsumedEntireMessage();
@@ -834,19 +1109,21 @@ namespace CNTK
     bool Serializer::Read(const std::wstring& filename, Dictionary& dict)
     {
         m_proto = Arena::CreateMessage<proto::Dictionary>(&m_arena);
-        return Read(filename, [this, &dict](io::ZeroCopyInputStream& input) {
+        auto callback = [this, &dict](io::ZeroCopyInputStream& input) {
             Copy(*dynamic_cast<proto::Dictionary*>(m_proto), dict);
             return ReadNDArrayViewData(input);
-        });
+        };
+        return Internal::AreMemoryMappedModelsEnabled() ? ReadMapped(filename, callback) : Read(filename, callback);
     }
 
     bool Serializer::Read(const std::wstring& filename, DictionaryValue& value)
     {
         m_proto = Arena::CreateMessage<proto::DictionaryValue>(&m_arena);
-        return Read(filename, [this, &value](io::ZeroCopyInputStream& input) {
+        auto callback = [this, &value](io::ZeroCopyInputStream& input) {
             Copy(*dynamic_cast<proto::DictionaryValue*>(m_proto), value);
             return ReadNDArrayViewData(input);
-        });
+        };
+        return Internal::AreMemoryMappedModelsEnabled() ? ReadMapped(filename, callback) : Read(filename, callback);
     }
 
     bool Serializer::Read(std::wstring filename, const std::function<bool(io::ZeroCopyInputStream& input)>& callback)
@@ -855,7 +1132,7 @@ namespace CNTK
         auto fd = GetFileDescriptor(filename, true);
         {
             io::FileInputStream input(fd, BLOCK_SIZE);
-            result = ParseMessage(input, *m_proto);
+            result = ParseMessage(input);
             result = result && callback(input);
         }
 #ifdef _MSC_VER
@@ -869,13 +1146,31 @@ namespace CNTK
     bool Serializer::Read(std::istream& stream, const std::function<bool(io::ZeroCopyInputStream& input)>& callback)
     {
         io::IstreamInputStream input(&stream, BLOCK_SIZE);
-        if (ParseMessage(input, *m_proto))
+        if (ParseMessage(input))
         {
             return callback(input);
         }
         return false;
     }
 
+    bool Serializer::ReadMapped(const std::wstring& filename, const std::function<bool(io::ZeroCopyInputStream& input)>& callback)
+    {
+        auto mappedFile = std::make_shared<MemoryMappedFile>(filename);
+
+        uint32 prefix = 0;
+        if (mappedFile->Size() >= 2 * sizeof(uint32))
+            io::CodedInputStream::ReadLittleEndian32FromArray(reinterpret_cast<const uint8*>(mappedFile->Data()), &prefix);
+
+        // Only the aligned layout can back NDArrayViews by the mapping; read everything else the usual way.
+        if (prefix != ALIGNED_MAGIC_NUMBER)
+            return Read(filename, callback);
+
+        m_mappedFile = mappedFile;
+        // The metadata precedes the tensor sections and does not exceed 2GBs.
+        io::ArrayInputStream input(m_mappedFile->Data(), (int)std::min<size_t>(m_mappedFile->Size(), INT_MAX));
+        return ParseMessage(input) && callback(input);
+    }
+
     std::ostream& operator<<(std::ostream& stream, const Dictionary& dictionary)
     {
         return Serializer(dictionary).Write(stream);
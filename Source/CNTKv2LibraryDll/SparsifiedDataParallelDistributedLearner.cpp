@@ -0,0 +1,322 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include "SparsifiedDataParallelDistributedLearner.h"
+#include "Learner.h"
+#include "PerformanceProfiler.h"
+
+namespace CNTK
+{
+    namespace
+    {
+        // The index of a selected entry is sent bitwise in an element of the gradient type, followed by its value.
+        template <typename ElemType> struct EntryIndex;
+        template <> struct EntryIndex<float> { typedef uint32_t Type; };
+        template <> struct EntryIndex<double> { typedef uint64_t Type; };
+
+        template <typename ElemType>
+        inline ElemType EncodeIndex(size_t index)
+        {
+            static_assert(sizeof(typename EntryIndex<ElemType>::Type) == sizeof(ElemType), "The index has to fit into an element.");
+            auto bits = static_cast<typename EntryIndex<ElemType>::Type>(index);
+            ElemType result;
+            memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        template <typename ElemType>
+        inline size_t DecodeIndex(ElemType value)
+        {
+            typename EntryIndex<ElemType>::Type bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return static_cast<size_t>(bits);
+        }
+    }
+
+    DistributedLearnerPtr CreateSparsifiedDataParallelDistributedLearner(
+        DistributedCommunicatorPtr communicator,
+        LearnerPtr learner,
+        size_t distributeAfterSamples,
+        double density,
+        double threshold,
+        size_t bucketSize)
+    {
+        return MakeSharedObject<SparsifiedDataParallelDistributedLearner>(communicator, learner, distributeAfterSamples, density, threshold, bucketSize);
+    }
+
+    SparsifiedDataParallelDistributedLearner::SparsifiedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, double density, double threshold, size_t bucketSize)
+        : DistributedLearnerBase(communicator, learner, distributeAfterSamples),
+          m_density(density), m_threshold(threshold), m_bucketSize(bucketSize)
+    {
+        if (!(density > 0 && density <= 1))
+            InvalidArgument("The density of a sparsified distributed learner has to be in (0, 1], got %f.", density);
+        if (threshold < 0)
+            InvalidArgument("The threshold of a sparsified distributed learner cannot be negative, got %f.", threshold);
+        if (bucketSize == 0)
+            InvalidArgument("The bucket size of a sparsified distributed learner has to be positive.");
+    }
+
+    bool SparsifiedDataParallelDistributedLearner::Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info)
+    {
+        std::unordered_map<Parameter, NDArrayViewPtr> convertedGradientValues = gradientValues;
+
+        if (m_sampleCount >= m_distributeAfterSamples && m_communicator->Workers().size() > 1)
+        {
+#ifndef  CNTK_UWP
+            auto profGradientAgg = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainGradient);
+#endif
+
+            if (info.IsEmpty())
+                PrepaireZeroGradients(gradientValues);
+
+            ConvertToOrdered(gradientValues, m_gradientBuffer, &convertedGradientValues);
+
+            std::vector<NDArrayViewPtr> headerToAggregate;
+            headerToAggregate.push_back(info.evalCriterionValue);
+            headerToAggregate.push_back(info.trainingLossValue);
+
+            auto value = MakeSharedObject<NDArrayView>(static_cast<double>(info.numberOfSamples), NDShape{}, DeviceDescriptor::CPUDevice());
+            headerToAggregate.push_back(value);
+
+            m_communicator->AggregateInPlace(headerToAggregate, m_communicator->Workers());
+            info.numberOfSamples = static_cast<size_t>(*headerToAggregate.back()->DataBuffer<double>());
+
+            std::vector<NDArrayViewPtr> gradients;
+            for (const auto& i : m_gradientBuffer)
+                gradients.push_back(i.second);
+
+            SparseAggregateInPlace(gradients);
+        }
+
+#ifndef  CNTK_UWP
+        auto profWeights = Microsoft::MSR::CNTK::ScopeProfile(Microsoft::MSR::CNTK::profilerEvtMainWeights);
+#endif
+
+        m_sampleCount += info.numberOfSamples;
+        m_gradientBuffer.clear();
+
+        if (info.IsEmpty())
+            return false;
+
+        return m_learner->Update(convertedGradientValues, info.numberOfSamples, info.atEndOfSweep);
+    }
+
+    Dictionary SparsifiedDataParallelDistributedLearner::CreateCheckpoint()
+    {
+        // Resetting the residuals.
+        // We do this to make sure that the returned checkpoint state is consistent with the in - memory state, since we do not checkpoint the residues.
+        for (size_t i = 0; i < m_residuals.size(); ++i)
+            if (m_residuals[i]->GetDataType() == DataType::Double)
+                m_residuals[i]->SetValue(0.0);
+            else
+                m_residuals[i]->SetValue(0.0f);
+
+        return DistributedLearnerBase::CreateCheckpoint();
+    }
+
+    void SparsifiedDataParallelDistributedLearner::SparseAggregateInPlace(const std::vector<NDArrayViewPtr>& gradients)
+    {
+        if (m_residuals.empty())
+        {
+            for (const auto& g : gradients)
+                m_residuals.push_back(MakeSharedObject<NDArrayView>(0, g->GetDataType(), g->Shape(), DeviceDescriptor::CPUDevice()));
+        }
+
+        if (m_residuals.size() != gradients.size())
+            LogicError("SparsifiedDataParallelDistributedLearner: the number of gradients changed from %zu to %zu.", m_residuals.size(), gradients.size());
+
+        // The selection runs on the CPU, gradients on the GPU are copied.
+        std::vector<NDArrayViewPtr> cpuGradients;
+        for (const auto& g : gradients)
+        {
+            if (g->Device() == DeviceDescriptor::CPUDevice())
+            {
+                cpuGradients.push_back(g);
+                continue;
+            }
+
+            auto cpuGradient = MakeSharedObject<NDArrayView>(g->GetDataType(), g->Shape(), DeviceDescriptor::CPUDevice());
+            cpuGradient->CopyFrom(*g);
+            cpuGradients.push_back(cpuGradient);
+        }
+
+        // Entries of all float and all double gradients, indexed by the position in the concatenation of the gradients of the type.
+        std::vector<float> floatEntries;
+        std::vector<double> doubleEntries;
+        std::vector<size_t> offsets(gradients.size());
+        size_t numberOfFloats = 0, numberOfDoubles = 0, denseSizeInBytes = 0;
+        for (size_t i = 0; i < gradients.size(); ++i)
+        {
+            auto size = gradients[i]->Shape().TotalSize();
+            if (gradients[i]->GetDataType() == DataType::Float)
+            {
+                offsets[i] = numberOfFloats;
+                SelectEntries(*cpuGradients[i], *m_residuals[i], numberOfFloats, floatEntries);
+                numberOfFloats += size;
+                denseSizeInBytes += size * sizeof(float);
+            }
+            else if (gradients[i]->GetDataType() == DataType::Double)
+            {
+                offsets[i] = numberOfDoubles;
+                SelectEntries(*cpuGradients[i], *m_residuals[i], numberOfDoubles, doubleEntries);
+                numberOfDoubles += size;
+                denseSizeInBytes += size * sizeof(double);
+            }
+            else
+                LogicError("SparsifiedDataParallelDistributedLearner: only float and double gradients are supported.");
+        }
+
+        if (numberOfFloats > std::numeric_limits<uint32_t>::max())
+            LogicError("SparsifiedDataParallelDistributedLearner: the float gradients have too many elements (%zu).", numberOfFloats);
+
+        // The workers exchange their number of entries first, all of them send as many entries as the worker with the most.
+        auto counts = MakeSharedObject<NDArrayView>(DataType::Double, NDShape{ 2 }, DeviceDescriptor::CPUDevice());
+        counts->WritableDataBuffer<double>()[0] = static_cast<double>(floatEntries.size() / 2);
+        counts->WritableDataBuffer<double>()[1] = static_cast<double>(doubleEntries.size() / 2);
+
+        std::vector<NDArrayViewPtr> gatheredCounts;
+        m_communicator->Concatenate(std::vector<NDArrayViewPtr>{ counts }, gatheredCounts, m_communicator->Workers());
+
+        auto numberOfWorkers = m_communicator->Workers().size();
+        std::vector<size_t> floatCounts(numberOfWorkers), doubleCounts(numberOfWorkers);
+        for (size_t w = 0; w < numberOfWorkers; ++w)
+        {
+            floatCounts[w] = static_cast<size_t>(gatheredCounts[0]->DataBuffer<double>()[2 * w]);
+            doubleCounts[w] = static_cast<size_t>(gatheredCounts[0]->DataBuffer<double>()[2 * w + 1]);
+        }
+        size_t maxFloatCount = *std::max_element(floatCounts.begin(), floatCounts.end());
+        size_t maxDoubleCount = *std::max_element(doubleCounts.begin(), doubleCounts.end());
+
+        std::vector<NDArrayViewPtr> entries;
+        if (maxFloatCount > 0)
+        {
+            floatEntries.resize(2 * maxFloatCount, 0.0f);
+            entries.push_back(MakeSharedObject<NDArrayView>(NDShape{ floatEntries.size() }, floatEntries.data(), floatEntries.size(), DeviceDescriptor::CPUDevice()));
+        }
+        if (maxDoubleCount > 0)
+        {
+            doubleEntries.resize(2 * maxDoubleCount, 0.0);
+            entries.push_back(MakeSharedObject<NDArrayView>(NDShape{ doubleEntries.size() }, doubleEntries.data(), doubleEntries.size(), DeviceDescriptor::CPUDevice()));
+        }
+
+        std::vector<NDArrayViewPtr> gatheredEntries;
+        if (!entries.empty())
+            m_communicator->Concatenate(entries, gatheredEntries, m_communicator->Workers());
+
+        // Sums of the entries of all workers, every worker adds them up in the same order.
+        std::vector<float> floatSum;
+        std::vector<double> doubleSum;
+        size_t gatheredIndex = 0;
+        if (maxFloatCount > 0)
+        {
+            floatSum.assign(numberOfFloats, 0.0f);
+            AccumulateEntries(gatheredEntries[gatheredIndex++], floatCounts, maxFloatCount, floatSum);
+        }
+        if (maxDoubleCount > 0)
+        {
+            doubleSum.assign(numberOfDoubles, 0.0);
+            AccumulateEntries(gatheredEntries[gatheredIndex++], doubleCounts, maxDoubleCount, doubleSum);
+        }
+
+        for (size_t i = 0; i < gradients.size(); ++i)
+        {
+            auto size = gradients[i]->Shape().TotalSize();
+            if (gradients[i]->GetDataType() == DataType::Float)
+            {
+                auto target = cpuGradients[i]->WritableDataBuffer<float>();
+                if (floatSum.empty())
+                    std::fill(target, target + size, 0.0f);
+                else
+                    std::copy(floatSum.begin() + offsets[i], floatSum.begin() + offsets[i] + size, target);
+            }
+            else
+            {
+                auto target = cpuGradients[i]->WritableDataBuffer<double>();
+                if (doubleSum.empty())
+                    std::fill(target, target + size, 0.0);
+                else
+                    std::copy(doubleSum.begin() + offsets[i], doubleSum.begin() + offsets[i] + size, target);
+            }
+
+            if (cpuGradients[i] != gradients[i])
+                gradients[i]->CopyFrom(*cpuGradients[i]);
+        }
+
+        if (GetTraceLevel() >= TraceLevel::Info)
+        {
+            // The sizes of the buffers handed to the communicator, including the padding to the largest number of entries.
+            auto sizeInBytes = [](const std::vector<NDArrayViewPtr>& buffers)
+            {
+                size_t result = 0;
+                for (const auto& b : buffers)
+                    result += b->Shape().TotalSize() * DataTypeSize(b->GetDataType());
+                return result;
+            };
+            size_t sentSizeInBytes = counts->Shape().TotalSize() * DataTypeSize(counts->GetDataType()) + sizeInBytes(entries);
+            size_t receivedSizeInBytes = sizeInBytes(gatheredCounts) + sizeInBytes(gatheredEntries);
+            size_t selected = std::accumulate(floatCounts.begin(), floatCounts.end(), (size_t)0) + std::accumulate(doubleCounts.begin(), doubleCounts.end(), (size_t)0);
+            fprintf(stderr, "SparsifiedDataParallelDistributedLearner: %zu of %zu gradient entries selected by %zu workers, %zu bytes sent and %zu bytes gathered per worker, compression ratio %.1f\n",
+                selected, (numberOfFloats + numberOfDoubles) * numberOfWorkers, numberOfWorkers, sentSizeInBytes, receivedSizeInBytes,
+                (double)denseSizeInBytes / sentSizeInBytes);
+        }
+    }
+
+    template <typename ElemType>
+    void SparsifiedDataParallelDistributedLearner::SelectEntries(const NDArrayView& gradient, NDArrayView& residual, size_t offset, std::vector<ElemType>& entries)
+    {
+        auto size = gradient.Shape().TotalSize();
+        auto g = gradient.DataBuffer<ElemType>();
+        auto r = residual.WritableDataBuffer<ElemType>();
+
+        // Error feedback: the residual collects the gradient, the selected entries are taken out of it.
+        for (size_t i = 0; i < size; ++i)
+            r[i] += g[i];
+
+        for (size_t begin = 0; begin < size; begin += m_bucketSize)
+        {
+            size_t bucketSize = std::min(m_bucketSize, size - begin);
+            size_t k = std::min(bucketSize, static_cast<size_t>(std::ceil(m_density * bucketSize)));
+
+            m_bucketIndices.resize(bucketSize);
+            std::iota(m_bucketIndices.begin(), m_bucketIndices.end(), begin);
+            if (k < bucketSize)
+                std::nth_element(m_bucketIndices.begin(), m_bucketIndices.begin() + k, m_bucketIndices.end(),
+                    [r](size_t a, size_t b) { return std::abs(r[a]) > std::abs(r[b]); });
+
+            for (size_t j = 0; j < k; ++j)
+            {
+                size_t index = m_bucketIndices[j];
+                if (r[index] == 0 || std::abs(r[index]) < m_threshold)
+                    continue;
+
+                entries.push_back(EncodeIndex<ElemType>(offset + index));
+                entries.push_back(r[index]);
+                r[index] = 0;
+            }
+        }
+    }
+
+    template <typename ElemType>
+    void SparsifiedDataParallelDistributedLearner::AccumulateEntries(const NDArrayViewPtr& gathered, const std::vector<size_t>& counts, size_t maxCount, std::vector<ElemType>& sum)
+    {
+        auto data = gathered->DataBuffer<ElemType>();
+        for (size_t w = 0; w < counts.size(); ++w)
+        {
+            auto workerEntries = data + 2 * maxCount * w;
+            for (size_t j = 0; j < counts[w]; ++j)
+            {
+                size_t index = DecodeIndex(workerEntries[2 * j]);
+                if (index >= sum.size())
+                    LogicError("SparsifiedDataParallelDistributedLearner: received an entry with an invalid index %zu.", index);
+                sum[index] += workerEntries[2 * j + 1];
+            }
+        }
+    }
+}
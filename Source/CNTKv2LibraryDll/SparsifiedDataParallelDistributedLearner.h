@@ -0,0 +1,49 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma  once
+
+#include <vector>
+#include "CNTKLibrary.h"
+#include "DistributedLearnerBase.h"
+
+namespace CNTK
+{
+    ///
+    /// Distributed Trainer that exchanges only the entries of the gradients with the largest magnitude.
+    /// Every gradient is split into buckets, of every bucket the ceil(density * bucket size) largest entries are selected,
+    /// with a positive threshold only those of them with a magnitude of at least the threshold. The selected entries of all
+    /// workers are exchanged with an all-gather and summed up. The entries that are not sent stay in the residuals and are
+    /// added to the gradients of the next minibatch (error feedback).
+    ///
+    class SparsifiedDataParallelDistributedLearner : public DistributedLearnerBase
+    {
+    public:
+        SparsifiedDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, double density, double threshold, size_t bucketSize);
+
+        // Optional override that gets called per minibatch after finishing gradient computation but before updating model parameters
+        bool Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info) override;
+
+        // Optionally overridable method to get checkpoint state associated with this Distributed train method
+        Dictionary CreateCheckpoint() override;
+
+    private:
+        void SparseAggregateInPlace(const std::vector<NDArrayViewPtr>& gradients);
+
+        template <typename ElemType>
+        void SelectEntries(const NDArrayView& gradient, NDArrayView& residual, size_t offset, std::vector<ElemType>& entries);
+
+        template <typename ElemType>
+        void AccumulateEntries(const NDArrayViewPtr& gathered, const std::vector<size_t>& counts, size_t maxCount, std::vector<ElemType>& sum);
+
+        double m_density;
+        double m_threshold;
+        size_t m_bucketSize;
+
+        // Residuals of the gradient entries that were not sent, on the CPU.
+        std::vector<NDArrayViewPtr> m_residuals;
+        std::vector<size_t> m_bucketIndices;
+    };
+}
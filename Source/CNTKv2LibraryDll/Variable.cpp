@@ -548,7 +548,9 @@ namespace CNTK
 
             // TODO: this copying here is redundant, value should be moved from the dictionary to the variable.
             // Also, the correct device should be used upfront when deserializing NDArrayView.
-            Variable var(shape, kind, dataType, value.DeepClone(device, value.IsReadOnly()), needsGradient, dynamicAxis, isSparse, name, uid);
+            // Values backed by a memory-mapped model file are used in place when they are already on the target device.
+            bool useInPlace = (value.m_externalStorage != nullptr) && (value.Device() == device);
+            Variable var(shape, kind, dataType, useInPlace ? value.Alias(value.IsReadOnly()) : value.DeepClone(device, value.IsReadOnly()), needsGradient, dynamicAxis, isSparse, name, uid);
             if (var.IsParameter())
                 return Parameter(var);
             else
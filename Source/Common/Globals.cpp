@@ -18,4 +18,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     std::atomic<bool> Globals::m_optimizeGradientAccumulation(true);
     std::atomic<bool> Globals::m_enableNodeTiming(false);
     std::atomic<std::size_t> Globals::m_mpiPackThresholdInBytes(DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES);
+    std::atomic<std::size_t> Globals::m_parallelNodeExecutionThreads(0);
+    std::atomic<std::size_t> Globals::m_memoryArenaMinibatchColumns(0);
+    std::atomic<bool> Globals::m_fuseElementwiseNodes(false);
 }}}
@@ -33,6 +33,18 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
         static void SetMPIPackThreshold(std::size_t packThreholdInBytes) { m_mpiPackThresholdInBytes = packThreholdInBytes; }
         static std::size_t GetMPIPackThreshold() { return m_mpiPackThresholdInBytes; }
+
+        // number of threads used to execute independent nodes of a network concurrently on the CPU; 0 or 1 means serial execution
+        static void SetParallelNodeExecutionThreads(std::size_t numThreads) { m_parallelNodeExecutionThreads = numThreads; }
+        static std::size_t GetParallelNodeExecutionThreads() { return m_parallelNodeExecutionThreads; }
+
+        // number of minibatch columns the memory arena of a network is sized for (see MatrixPool::SetArenaMinibatchColumns()); 0 means no arena
+        static void SetMemoryArenaMinibatchColumns(std::size_t numColumns) { m_memoryArenaMinibatchColumns = numColumns; }
+        static std::size_t GetMemoryArenaMinibatchColumns() { return m_memoryArenaMinibatchColumns; }
+
+        // fuse elementwise binary nodes into the activation node consuming them when compiling a network (see ComputationNetwork::FuseElementwiseNodes())
+        static void SetElementwiseNodeFusion(bool enable) { m_fuseElementwiseNodes = enable; }
+        static bool ShouldFuseElementwiseNodes() { return m_fuseElementwiseNodes; }
     private:
         static std::atomic<bool> m_forceDeterministicAlgorithms;
         // The global flag to enable matrices values in forward and backward prop
@@ -41,5 +53,8 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static std::atomic<bool> m_optimizeGradientAccumulation;
         static std::atomic<bool> m_enableNodeTiming;
         static std::atomic<std::size_t> m_mpiPackThresholdInBytes;
+        static std::atomic<std::size_t> m_parallelNodeExecutionThreads;
+        static std::atomic<std::size_t> m_memoryArenaMinibatchColumns;
+        static std::atomic<bool> m_fuseElementwiseNodes;
     };
 }}}
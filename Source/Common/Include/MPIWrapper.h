@@ -27,6 +27,7 @@ typedef void *MPI_Comm;
 typedef enum _MPI_Datatype { MPI_CHAR, MPI_INT, MPI_FLOAT, MPI_DOUBLE, MPI_UNSIGNED, MPI_LONG_LONG_INT } MPI_Datatype;
 
 #define MPI_IN_PLACE          ((void*)(int)-1)
+#define MPI_MAX               ((MPI_Op)0x58000001)
 #define MPI_SUM               ((MPI_Op)0x58000003)
 
 #define MPI_STATUSES_IGNORE  (MPI_Status*)1
@@ -142,6 +143,15 @@ public:
     virtual void AllReduceAsync(double* sendData, double* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const = 0;
     virtual void AllReduceAsync(float* sendData, float* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const = 0;
 
+    // hierarchical allreduce: the ranks of a host reduce through shared memory, one leader per host reduces the partial
+    // results of the hosts over the network, and all ranks of the host read the result from shared memory.
+    // ranksPerHost = 0 groups the ranks by the host they run on, any other value splits every host into groups of that
+    // many ranks, e.g. to emulate several hosts with local processes. Pass MPI_IN_PLACE as sendData to reduce in place.
+    virtual void HierarchicalAllReduce(size_t* sendData, size_t* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const = 0;
+    virtual void HierarchicalAllReduce(int* sendData, int* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const = 0;
+    virtual void HierarchicalAllReduce(double* sendData, double* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const = 0;
+    virtual void HierarchicalAllReduce(float* sendData, float* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const = 0;
+
     virtual void Bcast(size_t* sendData, size_t numElements, size_t srcRank) = 0;
     virtual void Bcast(double* sendData, size_t numElements, size_t srcRank) = 0;
     virtual void Bcast(float* sendData, size_t numElements, size_t srcRank) = 0;
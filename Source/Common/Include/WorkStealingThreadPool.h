@@ -0,0 +1,153 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// WorkStealingThreadPool -- fixed set of worker threads with one task deque per worker.
+// A worker pops from the back of its own deque (the most recently enabled task, whose inputs
+// are most likely still in cache) and, when that runs dry, steals from the front of the others.
+// Tasks pushed from a worker thread go to that worker's own deque; tasks pushed from any other
+// thread are distributed round-robin.
+// Kept in a separate header because it pulls in some large headers that are not super-commonly needed otherwise.
+// -----------------------------------------------------------------------
+
+class WorkStealingThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // 'onThreadStart' is invoked once on every worker thread before it processes any task, e.g. to set thread-local state
+    explicit WorkStealingThreadPool(size_t numThreads, std::function<void(size_t workerIndex)> onThreadStart = nullptr)
+        : m_queues(numThreads == 0 ? 1 : numThreads), m_numPending(0), m_nextQueue(0), m_stop(false)
+    {
+        for (size_t i = 0; i < m_queues.size(); i++)
+            m_queues[i].reset(new WorkerQueue());
+        for (size_t i = 0; i < m_queues.size(); i++)
+        {
+            m_threads.emplace_back([this, i, onThreadStart]()
+            {
+                CurrentWorkerIndex() = i;
+                CurrentPool() = this;
+                if (onThreadStart)
+                    onThreadStart(i);
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    ~WorkStealingThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stop = true;
+        }
+        m_wakeCondition.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    size_t NumThreads() const { return m_queues.size(); }
+
+    // enqueue a task; it will be executed by one of the workers at some later point
+    void Push(Task&& task)
+    {
+        size_t queueIndex = (CurrentPool() == this) ? CurrentWorkerIndex() : (m_nextQueue++ % m_queues.size());
+        {
+            std::lock_guard<std::mutex> lock(m_queues[queueIndex]->m_mutex);
+            m_queues[queueIndex]->m_tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_numPending++;
+        }
+        m_wakeCondition.notify_one();
+    }
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex m_mutex;
+        std::deque<Task> m_tasks;
+    };
+
+    static size_t& CurrentWorkerIndex() { static thread_local size_t index = SIZE_MAX; return index; }
+    static WorkStealingThreadPool*& CurrentPool() { static thread_local WorkStealingThreadPool* pool = nullptr; return pool; }
+
+    bool TryPop(size_t workerIndex, Task& task)
+    {
+        // own queue first, LIFO
+        {
+            auto& own = *m_queues[workerIndex];
+            std::lock_guard<std::mutex> lock(own.m_mutex);
+            if (!own.m_tasks.empty())
+            {
+                task = std::move(own.m_tasks.back());
+                own.m_tasks.pop_back();
+                return true;
+            }
+        }
+        // then steal FIFO from the others, starting with the right neighbor to spread contention
+        for (size_t k = 1; k < m_queues.size(); k++)
+        {
+            auto& victim = *m_queues[(workerIndex + k) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.m_mutex);
+            if (!victim.m_tasks.empty())
+            {
+                task = std::move(victim.m_tasks.front());
+                victim.m_tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t workerIndex)
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_wakeCondition.wait(lock, [this]() { return m_stop || m_numPending > 0; });
+                if (m_numPending == 0) // only possible when stopping
+                    return;
+                m_numPending--; // claim one task; it is guaranteed to be found in one of the queues
+            }
+
+            Task task;
+            while (!TryPop(workerIndex, task))
+                std::this_thread::yield(); // cannot happen since every claim is backed by a queued task, but stay safe against spurious misses
+            task();
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    size_t m_numPending;             // number of tasks pushed but not yet claimed by a worker; guarded by m_wakeMutex
+    std::atomic<size_t> m_nextQueue; // round-robin counter for pushes from non-worker threads
+    bool m_stop;
+
+public:
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+};
+
+}}}
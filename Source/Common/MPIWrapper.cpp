@@ -5,6 +5,9 @@
 #include "Include/Basics.h"
 #include "Include/MPIWrapper.h"
 #include "Include/EnvironmentUtil.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
 
 #if HAS_MPI
 #pragma comment(lib, "msmpi.lib")
@@ -16,6 +19,9 @@
 
 #define FFLUSH_SUCCESS          0
 
+// Size of the shared memory segment of every rank for the hierarchical allreduce, larger data is reduced in pieces.
+static const size_t HIERARCHICAL_SEGMENT_SIZE_IN_BYTES = 16 * 1024 * 1024;
+
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 // -----------------------------------------------------------------------
@@ -61,6 +67,29 @@ private:
 
     void RequestNodes(const char *msg, size_t requestednodes = SIZE_MAX /*default: all*/);
 
+    // Communicators and shared memory of the hierarchical allreduce for one grouping of the ranks into hosts.
+    struct HostTopology
+    {
+        MPI_Comm m_hostComm;            // ranks of the same host
+        MPI_Comm m_leaderComm;          // first rank of every host, MPI_COMM_NULL on the other ranks
+        int m_hostRank;
+        int m_hostSize;
+        int m_numberOfHosts;
+
+        // Shared memory of the host: a segment per rank for its contribution, followed by the result behind the leader's one.
+        MPI_Win m_window;
+        std::vector<char*> m_segments;
+        char* m_result;
+    };
+
+    // Created on first use, the creation is collective over all ranks in use.
+    HostTopology& GetHostTopology(size_t ranksPerHost) const;
+    void HostBarrier(const HostTopology& host) const;
+    void HierarchicalAllReduceImpl(const void* sendData, void* receiveData, size_t numElements, MPI_Datatype datatype, MPI_Op op, size_t ranksPerHost) const;
+    void FreeHostTopologies();
+
+    mutable std::map<size_t, std::unique_ptr<HostTopology>> m_hostTopologies;
+
 public:
 
     size_t NumNodesInUse() const;
@@ -117,6 +146,11 @@ public:
     virtual void AllReduceAsync(double* sendData, double* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
     virtual void AllReduceAsync(float* sendData, float* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
 
+    virtual void HierarchicalAllReduce(size_t* sendData, size_t* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+    virtual void HierarchicalAllReduce(int* sendData, int* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+    virtual void HierarchicalAllReduce(double* sendData, double* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+    virtual void HierarchicalAllReduce(float* sendData, float* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+
     virtual void Bcast(size_t* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(double* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(float* sendData, size_t numElements, size_t srcRank);
@@ -214,6 +248,11 @@ public:
     virtual void AllReduceAsync(double* sendData, double* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
     virtual void AllReduceAsync(float* sendData, float* receiveData, size_t numElements, MPI_Request* request, MPI_Op op = MPI_SUM) const;
 
+    virtual void HierarchicalAllReduce(size_t* sendData, size_t* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+    virtual void HierarchicalAllReduce(int* sendData, int* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+    virtual void HierarchicalAllReduce(double* sendData, double* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+    virtual void HierarchicalAllReduce(float* sendData, float* receiveData, size_t numElements, MPI_Op op = MPI_SUM, size_t ranksPerHost = 0) const;
+
     virtual void Bcast(size_t* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(double* sendData, size_t numElements, size_t srcRank);
     virtual void Bcast(float* sendData, size_t numElements, size_t srcRank);
@@ -597,6 +636,7 @@ MPI_Comm MPIWrapperMpi::Communicator() const
 
 int MPIWrapperMpi::Finalize(void)
 {
+    FreeHostTopologies();
     return MPI_Finalize();
 }
 
@@ -823,6 +863,161 @@ void MPIWrapperMpi::AllReduceAsync(float *sendData, float *receiveData, size_t n
     MPI_Iallreduce(sendData, receiveData, (int)numElements, GetDataType(sendData), op, Communicator(), request) || MpiFail("AllReduceAsync: MPI_Iallreduce");
 }
 
+void MPIWrapperMpi::HierarchicalAllReduce(size_t* sendData, size_t* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+    HierarchicalAllReduceImpl(sendData, receiveData, numElements, GetDataType(receiveData), op, ranksPerHost);
+}
+
+void MPIWrapperMpi::HierarchicalAllReduce(int* sendData, int* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+    HierarchicalAllReduceImpl(sendData, receiveData, numElements, GetDataType(receiveData), op, ranksPerHost);
+}
+
+void MPIWrapperMpi::HierarchicalAllReduce(double* sendData, double* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+    HierarchicalAllReduceImpl(sendData, receiveData, numElements, GetDataType(receiveData), op, ranksPerHost);
+}
+
+void MPIWrapperMpi::HierarchicalAllReduce(float* sendData, float* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+    HierarchicalAllReduceImpl(sendData, receiveData, numElements, GetDataType(receiveData), op, ranksPerHost);
+}
+
+MPIWrapperMpi::HostTopology& MPIWrapperMpi::GetHostTopology(size_t ranksPerHost) const
+{
+    auto existing = m_hostTopologies.find(ranksPerHost);
+    if (existing != m_hostTopologies.end())
+        return *existing->second;
+
+    std::unique_ptr<HostTopology> host(new HostTopology());
+
+    // The ranks that share memory form a host, with ranksPerHost they are split further into groups of consecutive ranks.
+    MPI_Comm sharedComm;
+    MPI_Comm_split_type(Communicator(), MPI_COMM_TYPE_SHARED, m_myRank, MPI_INFO_NULL, &sharedComm) || MpiFail("HierarchicalAllReduce: MPI_Comm_split_type");
+    if (ranksPerHost > 0)
+    {
+        int sharedRank;
+        MPI_Comm_rank(sharedComm, &sharedRank) || MpiFail("HierarchicalAllReduce: MPI_Comm_rank");
+        MPI_Comm_split(sharedComm, (int)(sharedRank / ranksPerHost), sharedRank, &host->m_hostComm) || MpiFail("HierarchicalAllReduce: MPI_Comm_split");
+        MPI_Comm_free(&sharedComm) || MpiFail("HierarchicalAllReduce: MPI_Comm_free");
+    }
+    else
+        host->m_hostComm = sharedComm;
+
+    MPI_Comm_rank(host->m_hostComm, &host->m_hostRank) || MpiFail("HierarchicalAllReduce: MPI_Comm_rank");
+    MPI_Comm_size(host->m_hostComm, &host->m_hostSize) || MpiFail("HierarchicalAllReduce: MPI_Comm_size");
+
+    MPI_Comm_split(Communicator(), host->m_hostRank == 0 ? 0 : MPI_UNDEFINED, m_myRank, &host->m_leaderComm) || MpiFail("HierarchicalAllReduce: MPI_Comm_split");
+    host->m_numberOfHosts = 0;
+    if (host->m_leaderComm != MPI_COMM_NULL)
+        MPI_Comm_size(host->m_leaderComm, &host->m_numberOfHosts) || MpiFail("HierarchicalAllReduce: MPI_Comm_size");
+    MPI_Bcast(&host->m_numberOfHosts, 1, MPI_INT, 0, host->m_hostComm) || MpiFail("HierarchicalAllReduce: MPI_Bcast");
+
+    MPI_Aint windowSize = (MPI_Aint)(host->m_hostRank == 0 ? 2 * HIERARCHICAL_SEGMENT_SIZE_IN_BYTES : HIERARCHICAL_SEGMENT_SIZE_IN_BYTES);
+    void* base = nullptr;
+    MPI_Win_allocate_shared(windowSize, 1, MPI_INFO_NULL, host->m_hostComm, &base, &host->m_window) || MpiFail("HierarchicalAllReduce: MPI_Win_allocate_shared");
+
+    host->m_segments.resize(host->m_hostSize);
+    for (int i = 0; i < host->m_hostSize; ++i)
+    {
+        MPI_Aint size;
+        int displacementUnit;
+        void* segment;
+        MPI_Win_shared_query(host->m_window, i, &size, &displacementUnit, &segment) || MpiFail("HierarchicalAllReduce: MPI_Win_shared_query");
+        host->m_segments[i] = static_cast<char*>(segment);
+    }
+    host->m_result = host->m_segments[0] + HIERARCHICAL_SEGMENT_SIZE_IN_BYTES;
+
+    // The window stays in a passive epoch, the ranks synchronize with HostBarrier().
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, host->m_window) || MpiFail("HierarchicalAllReduce: MPI_Win_lock_all");
+
+    if (GetMathLibTraceLevel() > 0)
+    {
+        fprintf(stderr, "HierarchicalAllReduce: rank %d is rank %d of %d on its host, %d host(s) in total\n",
+            m_myRank, host->m_hostRank, host->m_hostSize, host->m_numberOfHosts);
+        fflush(stderr);
+    }
+
+    auto& result = *host;
+    m_hostTopologies[ranksPerHost] = std::move(host);
+    return result;
+}
+
+// Makes the writes of every rank of the host to the shared memory visible to the others.
+void MPIWrapperMpi::HostBarrier(const HostTopology& host) const
+{
+    MPI_Win_sync(host.m_window) || MpiFail("HierarchicalAllReduce: MPI_Win_sync");
+    MPI_Barrier(host.m_hostComm) || MpiFail("HierarchicalAllReduce: MPI_Barrier");
+    MPI_Win_sync(host.m_window) || MpiFail("HierarchicalAllReduce: MPI_Win_sync");
+}
+
+// Every piece of the data is reduced in three steps:
+//   1. every rank copies its contribution into its shared memory segment,
+//   2. every rank reduces its share of the elements over all segments of the host into the result,
+//   3. the leaders reduce the results of all hosts over the network, then all ranks copy the result.
+// Only the leaders use the network, with as many messages as there are hosts instead of ranks.
+void MPIWrapperMpi::HierarchicalAllReduceImpl(const void* sendData, void* receiveData, size_t numElements, MPI_Datatype datatype, MPI_Op op, size_t ranksPerHost) const
+{
+    if (numElements == 0)
+        return;
+
+    HostTopology& host = GetHostTopology(ranksPerHost);
+    if (host.m_numberOfHosts == (int)m_numNodesInUse) // A single rank on every host, nothing to share.
+    {
+        MPI_Allreduce(sendData, receiveData, (int)numElements, datatype, op, Communicator()) || MpiFail("HierarchicalAllReduce: MPI_Allreduce");
+        return;
+    }
+
+    int elementSize;
+    MPI_Type_size(datatype, &elementSize) || MpiFail("HierarchicalAllReduce: MPI_Type_size");
+
+    const char* source = static_cast<const char*>(sendData == MPI_IN_PLACE ? receiveData : sendData);
+    char* target = static_cast<char*>(receiveData);
+    size_t elementsPerPiece = HIERARCHICAL_SEGMENT_SIZE_IN_BYTES / elementSize;
+    for (size_t begin = 0; begin < numElements; begin += elementsPerPiece)
+    {
+        size_t count = std::min(elementsPerPiece, numElements - begin);
+        memcpy(host.m_segments[host.m_hostRank], source + begin * elementSize, count * elementSize);
+        HostBarrier(host);
+
+        size_t share = (count + host.m_hostSize - 1) / host.m_hostSize;
+        size_t first = std::min(count, share * host.m_hostRank);
+        size_t last = std::min(count, first + share);
+        if (first < last)
+        {
+            char* result = host.m_result + first * elementSize;
+            memcpy(result, host.m_segments[0] + first * elementSize, (last - first) * elementSize);
+            for (int i = 1; i < host.m_hostSize; ++i)
+                MPI_Reduce_local(host.m_segments[i] + first * elementSize, result, (int)(last - first), datatype, op) || MpiFail("HierarchicalAllReduce: MPI_Reduce_local");
+        }
+        HostBarrier(host);
+
+        if (host.m_numberOfHosts > 1)
+        {
+            if (host.m_leaderComm != MPI_COMM_NULL)
+                MPI_Allreduce(MPI_IN_PLACE, host.m_result, (int)count, datatype, op, host.m_leaderComm) || MpiFail("HierarchicalAllReduce: MPI_Allreduce");
+            HostBarrier(host);
+        }
+
+        // The next piece does not overwrite the result before all ranks passed its first barrier.
+        memcpy(target + begin * elementSize, host.m_result, count * elementSize);
+    }
+}
+
+void MPIWrapperMpi::FreeHostTopologies()
+{
+    for (auto& entry : m_hostTopologies)
+    {
+        auto& host = *entry.second;
+        MPI_Win_unlock_all(host.m_window) || MpiFail("FreeHostTopologies: MPI_Win_unlock_all");
+        MPI_Win_free(&host.m_window) || MpiFail("FreeHostTopologies: MPI_Win_free");
+        if (host.m_leaderComm != MPI_COMM_NULL)
+            MPI_Comm_free(&host.m_leaderComm) || MpiFail("FreeHostTopologies: MPI_Comm_free");
+        MPI_Comm_free(&host.m_hostComm) || MpiFail("FreeHostTopologies: MPI_Comm_free");
+    }
+    m_hostTopologies.clear();
+}
+
 
 void MPIWrapperMpi::Bcast(double* sendData, size_t numElements, size_t srcRank)
 {
@@ -1160,6 +1355,22 @@ void MPIWrapperEmpty::AllReduceAsync(float *sendData, float *receiveData, size_t
 {
 }
 
+void MPIWrapperEmpty::HierarchicalAllReduce(size_t* sendData, size_t* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+}
+
+void MPIWrapperEmpty::HierarchicalAllReduce(int* sendData, int* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+}
+
+void MPIWrapperEmpty::HierarchicalAllReduce(double* sendData, double* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+}
+
+void MPIWrapperEmpty::HierarchicalAllReduce(float* sendData, float* receiveData, size_t numElements, MPI_Op op, size_t ranksPerHost) const
+{
+}
+
 void MPIWrapperEmpty::Bcast(size_t* sendData, size_t numElements, size_t srcRank)
 {
 }
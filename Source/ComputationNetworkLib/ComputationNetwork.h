@@ -34,6 +34,8 @@
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+class ParallelNodeExecutor;
+
 inline std::wstring ToString(const ComputationNodeBasePtr& node)
 {
     return node->NodeName();
@@ -148,7 +150,10 @@ public:
     void PostForwardAndBackProp(const ComputationNodeBasePtr rootNode);
 
     // main entry point for backprop
-    void Backprop(const ComputationNodeBasePtr rootNode);
+    // If given, 'onNodeDone' is called for every top-level node right after its Backprop(), possibly concurrently
+    // with parallel execution. Since nodes are processed in reverse evaluation order, at that point the gradient
+    // of a node that is not part of a loop (e.g. a LearnableParameter) has received all contributions.
+    void Backprop(const ComputationNodeBasePtr rootNode, const std::function<void(const ComputationNodeBasePtr&)>& onNodeDone = nullptr);
 
     template <class NODESET> // version that takes multiple nodes
     void TravserseInSortedGlobalEvalOrder(const NODESET& nodes, const std::function<void(const ComputationNodeBasePtr&)>& action)
@@ -258,6 +263,7 @@ private:
     void ChangeNodeInputs(ComputationNodeBasePtr fromNode, ComputationNodeBasePtr toNode);
 
 private:
+    size_t FuseElementwiseNodes();
     void DetermineSetOfAllRoots();
     void CollectInputAndLearnableParameters(const ComputationNodeBasePtr& rootNode);
     void CollectInputAndLearnableParametersRec(const ComputationNodeBasePtr& node, set<ComputationNodeBasePtr>& visited, list<ComputationNodeBasePtr>& inputs, list<ComputationNodeBasePtr>& learnableParameters);
@@ -1185,6 +1191,7 @@ protected:
         }
 
         static void ForwardProp(const ComputationNodeBasePtr& node, const FrameRange& fr);
+        static void Backprop(const ComputationNodeBasePtr& node, const FrameRange& fr);
         static void PostForwardAndBackProp(const ComputationNodeBasePtr& node);
 
         virtual void BeginForwardProp() override {}
@@ -1201,6 +1208,8 @@ protected:
         virtual void EndBackprop() override {}
 
         virtual void Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) override;
+        // same, calling 'onNodeDone' after the Backprop() of every nested node
+        void Backprop(const FrameRange& fr, const std::function<void(const ComputationNodeBasePtr&)>& onNodeDone);
         virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool);
         virtual void ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool);
         virtual void AllocateGradientMatricesForInputs(MatrixPool& matrixPool);
@@ -1212,6 +1221,13 @@ protected:
         // There is currently no other constructor for inner nested PAR-traversed sub-networks, but there will be.
         PARTraversalFlowControlNode(const std::vector<shared_ptr<SEQTraversalFlowControlNode>>& recurrentInfo, const std::list<ComputationNodeBasePtr>& allNodes);
         // Base::m_nestedNodes contains all top-level nodes, in evaluation order
+
+        // switch from serial traversal to concurrent execution of independent nodes; requires the matrices to be allocated
+        void EnableParallelExecution(const MatrixPool& matrixPool, size_t numThreads);
+        const shared_ptr<ParallelNodeExecutor>& GetParallelExecutor() const { return m_parallelExecutor; }
+
+    private:
+        shared_ptr<ParallelNodeExecutor> m_parallelExecutor; // if set, ForwardProp() and Backprop() schedule m_nestedNodes through this
     };
 
 public:
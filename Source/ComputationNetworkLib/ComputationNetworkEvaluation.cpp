@@ -11,6 +11,9 @@
 #include "RecurrentNodes.h"
 #include "InputAndParamNodes.h"
 #include "LinearAlgebraNodes.h"
+#include "NonlinearityNodes.h"
+#include "ParallelNodeExecutor.h"
+#include "Globals.h"
 #include <string>
 #include <vector>
 #include <list>
@@ -72,7 +75,8 @@ static bool SetRootGradientToScalarOne(ComputationNodeBasePtr nodep)
 //  - ForwardProp() for eval nodes
 //  - ForwardProp() for the training criterion (which will reuse computation results from the previous step)
 //  - Backprop() for the training criterion
-void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // training criterion to compute the gradients for
+void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode, // training criterion to compute the gradients for
+                                  const std::function<void(const ComputationNodeBasePtr&)>& onNodeDone)
 {
     if (!Environment().IsTraining())
         LogicError("Backprop: Requires network is to be in training mode.");
@@ -85,7 +89,10 @@ void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // trai
     ZeroInputGradients(rootNode);
 
     // backpropagate through the network
-    GetNestedNetwork(rootNode)->Backprop(FrameRange(nullptr), true, true);
+    if (onNodeDone)
+        dynamic_pointer_cast<PARTraversalFlowControlNode>(GetNestedNetwork(rootNode))->Backprop(FrameRange(nullptr), onNodeDone);
+    else
+        GetNestedNetwork(rootNode)->Backprop(FrameRange(nullptr), true, true);
 }
 
 void ComputationNetwork::FormNestedNetwork(const ComputationNodeBasePtr& rootNode)
@@ -161,6 +168,12 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
 
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::ForwardProp(const FrameRange& fr) /*override*/
 {
+    if (m_parallelExecutor)
+    {
+        m_parallelExecutor->ForwardProp([&fr](const ComputationNodeBasePtr& node) { ForwardProp(node, fr); });
+        return;
+    }
+
     for (auto& node : m_nestedNodes)
         ForwardProp(node, fr);
 }
@@ -176,24 +189,57 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
         PostForwardAndBackProp(node);
 }
 
+/*static*/ void ComputationNetwork::PARTraversalFlowControlNode::Backprop(const ComputationNodeBasePtr& node, const FrameRange& fr)
+{
+    node->BeginBackprop();
+    node->BeginTiming(true /*backward*/);
+    node->Backprop(fr.WithLayout(node->GetMBLayout()), true /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
+    node->EndTiming(true /*backward*/);
+    node->EndBackprop();
+
+    // Extreme Tracing, part 2/4
+    if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode() && node->NeedsGradient())
+        DumpNode(node, /*dumpGradient=*/true);
+}
+
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) /*override*/
 {
     childrenInThisLoop, childrenInOuterLoop; // TODO: think through what these mean when coming from PAR mode
+    if (m_parallelExecutor)
+    {
+        m_parallelExecutor->Backprop([&fr](const ComputationNodeBasePtr& node) { Backprop(node, fr); });
+        return;
+    }
+
     // process nodes in pre-determined order
     for (auto pnode = m_nestedNodes.rbegin(); pnode != m_nestedNodes.rend(); pnode++) // iterate backwards over evaluation order
+        Backprop(*pnode, fr);
+}
+
+void ComputationNetwork::PARTraversalFlowControlNode::Backprop(const FrameRange& fr, const std::function<void(const ComputationNodeBasePtr&)>& onNodeDone)
+{
+    if (m_parallelExecutor)
     {
-        auto& node = *pnode;
+        m_parallelExecutor->Backprop([&fr, &onNodeDone](const ComputationNodeBasePtr& node) { Backprop(node, fr); onNodeDone(node); });
+        return;
+    }
 
-        node->BeginBackprop();
-        node->BeginTiming(true /*backward*/);
-        node->Backprop(fr.WithLayout(node->GetMBLayout()), true /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
-        node->EndTiming(true /*backward*/);
-        node->EndBackprop();
+    for (auto pnode = m_nestedNodes.rbegin(); pnode != m_nestedNodes.rend(); pnode++)
+    {
+        Backprop(*pnode, fr);
+        onNodeDone(*pnode);
+    }
+}
 
-        // Extreme Tracing, part 2/4
-        if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode() && node->NeedsGradient())
-            DumpNode(node, /*dumpGradient=*/true);
+void ComputationNetwork::PARTraversalFlowControlNode::EnableParallelExecution(const MatrixPool& matrixPool, size_t numThreads)
+{
+    // the scheduler reasons about CPU memory and host threads; GPU nodes keep the serial order
+    for (auto& node : m_nestedNodes)
+    {
+        if (!node->Is<FlowControlNode>() && node->GetDeviceId() != CPUDEVICE)
+            return;
     }
+    m_parallelExecutor = make_shared<ParallelNodeExecutor>(m_nestedNodes, matrixPool, numThreads);
 }
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) /*override*/
 {
@@ -548,7 +594,13 @@ void ComputationNetwork::CompileNetwork()
     ValidateNetwork();
 
     // STEP: Optimize the network.
-    // :)
+    // Fusion edits the graph, which invalidates everything above, so we just compile the result again.
+    // The V2 library is excluded since it keeps its own map from Variables to the nodes of the network.
+    if (Globals::ShouldFuseElementwiseNodes() && !GetIsV2Library() && FuseElementwiseNodes() > 0)
+    {
+        CompileNetwork();
+        return;
+    }
 
     // STEP: Some final details.
     ResetEvalTimeStamps(); // invalidate all m_value fields. Really belongs into StartEvaluateMinibatchLoop()
@@ -559,6 +611,83 @@ void ComputationNetwork::CompileNetwork()
     m_isCompiled = true;
 }
 
+// -----------------------------------------------------------------------
+// network optimization
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+static ComputationNodeBasePtr NewFusedElementwiseNode(const ComputationNodeBasePtr& binaryNode, const ComputationNodeBasePtr& activationNode)
+{
+    return New<FusedElementwiseNode<ElemType>>(activationNode->GetDeviceId(), activationNode->NodeName(), binaryNode->OperationName(), activationNode->OperationName());
+}
+
+// replace each pair of an elementwise binary node and an activation node that is its only consumer,
+// e.g. Plus -> RectifiedLinear, by a single FusedElementwiseNode that runs one tensor pass instead of two
+// and does not need to keep the intermediate result for backprop.
+// The fused node takes over the name, node groups, and consumers of the activation node.
+// The binary node must not be visible from outside: it must have no other consumer, must not be in any node
+// group (e.g. output or criterion), and must not be part of a recurrent loop, where it may be evaluated frame by frame.
+// Must be called on a validated network. Returns the number of fused pairs; if non-zero, the network needs to be compiled again.
+size_t ComputationNetwork::FuseElementwiseNodes()
+{
+    map<ComputationNodeBasePtr, size_t> numConsumers;
+    for (const auto& node : GetEvalOrder(nullptr))
+    {
+        for (const auto& input : node->GetInputs())
+            numConsumers[input]++;
+    }
+
+    set<ComputationNodeBasePtr> groupNodes;
+    for (const auto& group : GetAllNodeGroups())
+        groupNodes.insert(group->begin(), group->end());
+
+    vector<pair<ComputationNodeBasePtr, ComputationNodeBasePtr>> candidates; // (binary node, activation node)
+    for (const auto& node : GetEvalOrder(nullptr))
+    {
+        if (node->GetNumInputs() != 1 || node->IsPartOfLoop())
+            continue;
+        auto input = node->Input(0);
+        if (!FusedElementwiseNode<float>::CanFuse(input->OperationName(), node->OperationName()) ||
+            numConsumers[input] != 1 || groupNodes.find(input) != groupNodes.end() || input->IsPartOfLoop())
+            continue;
+        // the activation is a unary map, so this is just defensive
+        if (input->GetMBLayout() != node->GetMBLayout() || input->GetSampleLayout() != node->GetSampleLayout())
+            continue;
+        candidates.push_back(make_pair(input, node));
+    }
+
+    for (const auto& candidate : candidates)
+    {
+        const auto& binaryNode = candidate.first;
+        const auto& activationNode = candidate.second;
+
+        ComputationNodeBasePtr fusedNode;
+        if (dynamic_pointer_cast<ComputationNode<float>>(activationNode))
+            fusedNode = NewFusedElementwiseNode<float>(binaryNode, activationNode);
+        else if (dynamic_pointer_cast<ComputationNode<double>>(activationNode))
+            fusedNode = NewFusedElementwiseNode<double>(binaryNode, activationNode);
+        else if (dynamic_pointer_cast<ComputationNode<half>>(activationNode))
+            fusedNode = NewFusedElementwiseNode<half>(binaryNode, activationNode);
+        else
+            LogicError("FuseElementwiseNodes: Unknown ComputationNode type of %ls %ls operation.", activationNode->NodeName().c_str(), activationNode->OperationName().c_str());
+
+        if (TraceLevel() > 0)
+            fprintf(stderr, "FuseElementwiseNodes: Fusing %ls %ls operation into %ls %ls operation.\n",
+                    binaryNode->NodeName().c_str(), binaryNode->OperationName().c_str(), activationNode->NodeName().c_str(), activationNode->OperationName().c_str());
+
+        // this moves over the consumers and node groups of the activation, and connects its input (the binary node)
+        ReplaceNode(activationNode->NodeName(), fusedNode);
+        fusedNode->AttachInputs(binaryNode->GetInputs());
+
+        // both old nodes are now unreferenced
+        activationNode->DetachInputs();
+        binaryNode->DetachInputs();
+        RemoveNodeFromNet(binaryNode);
+    }
+
+    return candidates.size();
+}
+
 // determine the set of all root nodes
 // Roots are nodes that ForwardProp() may be called for.
 //  - training criterion, eval criteria
@@ -1264,19 +1393,40 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         }
     }
 
+    m_matrixPool.SetArenaMinibatchColumns(Globals::GetMemoryArenaMinibatchColumns());
     m_matrixPool.OptimizedMemoryAllocation(); 
     m_areMatricesAllocated = true;
 
+    // now that every node has its final matrices, derive the dependency graphs for concurrent execution if requested
+    size_t numParallelThreads = Globals::GetParallelNodeExecutionThreads();
+    if (numParallelThreads > 1)
+    {
+        for (auto& nestedNetwork : m_nestedNetworks)
+        {
+            auto parTraversalFlowControlNode = nestedNetwork.second->As<PARTraversalFlowControlNode>();
+            parTraversalFlowControlNode->EnableParallelExecution(m_matrixPool, numParallelThreads);
+            auto parallelExecutor = parTraversalFlowControlNode->GetParallelExecutor();
+            if (TraceLevel() > 0 && parallelExecutor)
+                fprintf(stderr, "Parallel node execution for %ls: %d nodes, critical path %d forward, %d backward, %d threads.\n",
+                        nestedNetwork.first->NodeName().c_str(), (int)parallelExecutor->NumNodes(),
+                        (int)parallelExecutor->ForwardCriticalPathLength(), (int)parallelExecutor->BackwardCriticalPathLength(), (int)numParallelThreads);
+        }
+    }
+
     // TO DO: At the time of AllocateAllMatrices we don't know the minibatch size. In theory one may allocate memory again once we start to receive
     // data from the reader (and the minibatch size is known). For some problems, minibatch size can change constantly, and there needs to be a 
     // tradeoff in deciding how frequent to run optimized memory allocation. For now, we do it only once at the very beginning for speed concerns. 
+    // If 'memoryArenaMinibatchColumns' is given, the buffers are instead laid out in one arena sized for that many columns (see MatrixPool).
 
     // TO DO: when some matrices are sparse, the memory size request may be wrong. One may need to call OptimizedMemoryAllocation later again 
     // if the requests of sparse allocation and release are re-processed correctly. Future work. 
 
     // print the memory sharing structure
     if (TraceLevel() > 0)
+    {
         PrintMemorySharingStructure(GetAllNodes());
+        m_matrixPool.PrintMemoryPlan();
+    }
 }
 
 void ComputationNetwork::ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap)
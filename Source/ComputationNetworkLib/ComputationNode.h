@@ -805,6 +805,11 @@ public:
         return false;
     }
 
+    // whether ForwardProp() and Backprop() of this node only touch its own matrices and those of its inputs (including
+    // temporaries obtained from the MatrixPool), so that it may run concurrently with nodes it shares no memory with.
+    // Nodes that update any other state, e.g. running statistics of their inputs or callbacks into user code, must return false.
+    virtual bool SupportsConcurrentExecution() const { return true; }
+
     // reset gradients of a node's inputs
     // This really only clears the lazy-init flags (LazyZeroGradient() actually clears the values lazily).
     void /*ComputationNodeBase::*/ ZeroGradientsOfInputs()
@@ -1962,7 +1967,7 @@ protected:
             if (aliasing)
                 matrixPool.RequestAliasedAllocate<ValueType>(m_deviceId, this, &matrixPtr, matrixSize, mbScale);
             else
-                matrixPool.RequestAllocate<ValueType>(m_deviceId, &matrixPtr, matrixSize, mbScale, isWorkSpace);
+                matrixPool.RequestAllocate<ValueType>(m_deviceId, &matrixPtr, matrixSize, mbScale, isWorkSpace, this);
         }
     }
 
@@ -2317,6 +2322,7 @@ public:
     virtual std::wstring ToString(void) const override { NOT_IMPLEMENTED; }
     // these are meant to be called during computation, so provide dummy implementations
     virtual bool RequiresPreCompute() const override { return false; } // return true if the node's value should be computed before the normal training. e.g., mean and invStd of input features.
+    virtual bool SupportsConcurrentExecution() const override { return false; } // nested traversals are scheduled as a whole
     virtual std::string FormatOperationPrototype(const std::string& extraArgs) const override { return ""; }
     virtual void DumpNodeInfo(const bool /*printValues*/, const bool /*printMetadata*/, File& fstream) const override {}
     virtual std::set<std::pair<const MatrixBase*, std::wstring>> GetMatrixInfo() const override { NOT_IMPLEMENTED; }
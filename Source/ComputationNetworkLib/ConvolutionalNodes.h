@@ -413,9 +413,28 @@ public:
         {
             auto node = dynamic_pointer_cast<ConvolutionNode<ElemType>>(nodeP);
             node->m_convolution2D = m_convolution2D;
+            // the copy gets its own multiplier, as the multiplier holds the quantized kernel
+            if (auto pInt8Multiplier = dynamic_pointer_cast<Int8QuantizedMultiplier<ElemType>>(m_pQuantizedMultiplier))
+                node->EnableInt8Inference(pInt8Multiplier->ActivationRange());
         }
     }
 
+    // Switches the forward convolution to calibrated int8 inference on CPU, computed by the GEMM convolution engine
+    // (see Int8QuantizedMultiplier). The kernel is quantized per output map on the first evaluation and must not change
+    // afterwards. activationRange is the calibrated absolute max of the input, or 0 to derive it from each minibatch.
+    // Must be called before the node is validated, as it determines the convolution engine.
+    void EnableInt8Inference(float activationRange)
+    {
+        if (m_deviceId != CPUDEVICE)
+            LogicError("%ls %ls operation: int8 inference is supported on CPU device only.", NodeName().c_str(), OperationName().c_str());
+        if (m_transpose || m_groups != 1)
+            InvalidArgument("%ls %ls operation: int8 inference is not supported for transposed or group convolution.", NodeName().c_str(), OperationName().c_str());
+        if (m_convEng != nullptr)
+            LogicError("%ls %ls operation: int8 inference must be enabled before the node is validated.", NodeName().c_str(), OperationName().c_str());
+
+        m_pQuantizedMultiplier = make_shared<Int8QuantizedMultiplier<ElemType>>(/*isAWeight=*/false, activationRange);
+    }
+
     void ForwardProp(const FrameRange& fr) override
     {
         Matrix<ElemType> sliceOutputValue = ValueFor(fr);
@@ -587,10 +606,13 @@ public:
                 auto geometry = std::make_shared<ConvolveGeometry>(!m_transpose ? inputShape : outputShape,
                                                                    m_kernelShape, m_mapCount, m_stride,
                                                                    m_sharing, m_autoPad, m_lowerPad, m_upperPad, m_dilation, false, m_groups);
+                // Only the GEMM engine implements quantized convolution.
                 m_convEng = ConvolutionEngine<ElemType>::Create(geometry, m_deviceId, m_imageLayout,
                                                                 m_maxTempMemSizeInSamples, m_poolKind,
-                                                                ConvolutionEngineKind::All, NodeName(), Globals::ShouldForceDeterministicAlgorithms(),
+                                                                m_pQuantizedMultiplier ? ConvolutionEngineKind::Gemm : ConvolutionEngineKind::All,
+                                                                NodeName(), Globals::ShouldForceDeterministicAlgorithms(),
                                                                 false, recomputeConvGeometry);
+                m_convEng->SetQuantizedMultiplier(m_pQuantizedMultiplier);
             }
 
             if (Input(0)->GetSampleLayout().GetNumElements() != m_kernelShape.GetNumElements() * m_convEng->Geometry()->KernelCount())
@@ -673,6 +695,9 @@ private:
     TensorShape m_dilation;
     size_t m_groups;
 
+    // Multiplier of the int8 inference path, null for full precision.
+    shared_ptr<QuantizedMultiplier<ElemType>> m_pQuantizedMultiplier;
+
 protected:
     // Flag that indicates whether the node is created using 2D-syntax.
     bool m_convolution2D;
@@ -405,6 +405,9 @@ public:
             auto node = dynamic_pointer_cast<TimesNodeBase<ElemType, m_transpose>>(nodeP);
             node->m_outputRank          = m_outputRank;
             node->m_inferInputRankToMap = m_inferInputRankToMap;
+            // the copy gets its own multiplier, as the multiplier holds the quantized weight
+            if (auto pInt8Multiplier = dynamic_pointer_cast<Int8QuantizedMultiplier<ElemType>>(m_pQuantizedMultiplier))
+                node->EnableInt8Inference(pInt8Multiplier->ActivationRange());
         }
     }
 
@@ -428,6 +431,17 @@ public:
             m_inferInputRankToMap = NoInferredInputRank;
     }
 
+    // Switches the forward product to calibrated int8 inference on CPU (see Int8QuantizedMultiplier). The left operand
+    // is quantized per output row on the first evaluation and must not change afterwards. activationRange is the
+    // calibrated absolute max of the right operand, or 0 to derive it from each minibatch.
+    void EnableInt8Inference(float activationRange)
+    {
+        if (m_deviceId != CPUDEVICE)
+            LogicError("%ls %ls operation: int8 inference is supported on CPU device only.", NodeName().c_str(), OperationName().c_str());
+
+        m_pQuantizedMultiplier = make_shared<Int8QuantizedMultiplier<ElemType>>(/*isAWeight=*/true, activationRange);
+    }
+
 protected:
     // if the left argument of the matrix product (A) has a time axis, it can only be applied sample by sample
     // where each sample is treated as a separate matrix object (as a consequence, it then also applies to B and the result as well)
@@ -919,6 +933,9 @@ public:
             InferMBLayoutFromInputsForStandardCase(isFinalValidationPass);
         }
 
+        if (isFinalValidationPass && Input(0)->HasMBLayout() && dynamic_pointer_cast<Int8QuantizedMultiplier<ElemType>>(m_pQuantizedMultiplier))
+            InvalidArgument("%ls %ls operation: int8 inference requires the left operand to be a weight, not minibatch data.", NodeName().c_str(), OperationName().c_str());
+
         bool transpose = m_transpose; // (assigning to a non-const variable avoids a compiler warning C4127: conditional expression is constant)
 
         // get tensor shapes
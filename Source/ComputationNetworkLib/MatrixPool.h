@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <vector>
 #include <set>
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -32,10 +33,12 @@ struct MemRequestInfo
     int allocStep;                              // at what step counter memory allocation is requested 
     int releaseStep;                            // at what step counter memory release is requested  
     int memoryId;                               // integer indexing the memory buffer ID 
-    MemRequestInfo(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, int allocStep)
+    std::vector<const void*> owners;            // nodes that issued the request (parallel to pMatrixPtrs), nullptr if unknown 
+    MemRequestInfo(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, int allocStep, const void* owner = nullptr)
         :deviceId(deviceId), matrixSize(matrixSize), mbScale(mbScale), isWorkSpace(isWorkSpace), allocStep(allocStep), releaseStep(INT_MAX), memoryId(-1)
     {
         pMatrixPtrs.push_back(pMatrixPtr);
+        owners.push_back(owner);
     }
     void SetReleaseStep(int step) { releaseStep = step; }
     void SetMemoryId(int id) { memoryId = id;  }
@@ -61,9 +64,28 @@ struct MemAllocInfo
     }
 };
 
+// summary of the memory plan for one device and element type, see MatrixPool::PrintMemoryPlan()
+struct MemoryPlanInfo
+{
+    DEVICEID_TYPE deviceId;
+    size_t elementSize;
+    size_t numRequests = 0;
+    size_t numBuffers = 0;          // after sharing
+    size_t numUnsizedBuffers = 0;   // buffers with a request of unknown size; these are neither counted nor placed in the arena
+    size_t separateBytes = 0;       // peak with one allocation per shared buffer
+    size_t arenaBytes = 0;          // peak with all buffers placed into one arena
+    size_t liveBytes = 0;           // largest total size of the requests live at the same step, a lower bound for any plan
+    MemoryPlanInfo(DEVICEID_TYPE deviceId, size_t elementSize)
+        : deviceId(deviceId), elementSize(elementSize)
+    {
+    }
+};
+
 // MatrixPool -- class to support memory sharing
 // Despite the gather general name of this class, it is specifically designed to support the memory sharing of ComputationNodes.
 // Note: see #define SUPRESS_MEMSHARING below as for how to temporarily disable memory sharing altogether, for debugging
+//
+// Optionally, all buffers of known size are additionally packed into one contiguous arena per device, see SetArenaMinibatchColumns().
 class MatrixPool
 {
 public:
@@ -95,6 +117,20 @@ protected:
     unordered_map<AliasNodePtr, AliasInfo> m_aliasGroups;
     unordered_map<AliasNodePtr, AliasNodePtr> m_aliasLookup;
 
+    // arena: where each shared buffer was placed, to know which buffers use the same memory (element ranges [begin, end) within an arena)
+    struct ArenaPlacement
+    {
+        const MatrixBase* matrix;
+        const void* arena;
+        size_t begin;
+        size_t end;
+    };
+    size_t m_arenaMinibatchColumns = 0;
+    vector<ArenaPlacement> m_arenaPlacements;
+    vector<MemoryPlanInfo> m_memoryPlan;
+
+    static const size_t ArenaAlignmentInBytes = 256; // start every buffer at an address that suits vectorized CPU and GPU kernels
+
 public:
 
     void Reset()
@@ -134,11 +170,12 @@ public:
     // global memory allocation optimziation is run to improve memory efficiency 
     // mbScale is another flag indicating if the size of the memory will scale w.r.t. the minibatch size. Unfortunately, at the time of memory
     // request and pointer assignment, we don't known the minibatch size. Thus our memory sharing algorithm is sub-optimal. 
+    // owner optionally identifies the node that issues the request; see GetMatricesRequestedBy().
     template <class ElemType>
-    void RequestAllocate(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace)
+    void RequestAllocate(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, AliasNodePtr owner = nullptr)
     {
         vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>(); 
-        MemRequestInfo<ElemType> memInfo(deviceId, pMatrixPtr, matrixSize, mbScale, isWorkSpace, m_stepCounter);
+        MemRequestInfo<ElemType> memInfo(deviceId, pMatrixPtr, matrixSize, mbScale, isWorkSpace, m_stepCounter, owner);
         memInfoVec.push_back(memInfo); 
         m_deviceIDSet.insert(deviceId); 
         m_stepCounter++; 
@@ -147,8 +184,16 @@ public:
         *pMatrixPtr = make_shared<Matrix<ElemType>>(deviceId);
     }
 
+    // Pack the shared buffers into one arena per device, with the buffers of minibatch-scaled requests sized for 'numColumns' columns.
+    // A matrix that later needs more than its arena slot moves to an allocation of its own. 0 (default) means no arena.
+    // Must be called before OptimizedMemoryAllocation().
+    void SetArenaMinibatchColumns(size_t numColumns) { m_arenaMinibatchColumns = numColumns; }
+
     void OptimizedMemoryAllocation()
     {
+        m_arenaPlacements.clear();
+        m_memoryPlan.clear();
+
         // MatrixPool is not templated, so we call both float and double versions here 
         OptimizedMemoryAllocationFunc<float>(); 
         OptimizedMemoryAllocationFunc<double>();
@@ -217,17 +262,77 @@ public:
         {
             // first allocation for the group
             aliasInfo.pMatrixPtr = pMatrixPtr;
-            RequestAllocate(deviceId, pMatrixPtr, matrixSize, mbScale, false);
+            RequestAllocate(deviceId, pMatrixPtr, matrixSize, mbScale, false, node);
         }
         else
         {
             auto aliasRootMatrixPtr = (shared_ptr<Matrix<ElemType>>*)aliasInfo.pMatrixPtr;
             *pMatrixPtr = *aliasRootMatrixPtr;
-            GetMemInfo<ElemType>(aliasRootMatrixPtr)->pMatrixPtrs.push_back(pMatrixPtr);
+            auto memInfo = GetMemInfo<ElemType>(aliasRootMatrixPtr);
+            memInfo->pMatrixPtrs.push_back(pMatrixPtr);
+            memInfo->owners.push_back(node);
+        }
+    }
+
+    // returns the matrix objects handed out for all requests issued by the given node, including its internal temporaries
+    // Since shared requests end up pointing to the same Matrix object, two nodes whose sets intersect touch the same memory.
+    // Only meaningful after OptimizedMemoryAllocation() has assigned the final pointers.
+    // With an arena, different matrix objects may use the same memory at different times, so those are included as well.
+    std::set<const MatrixBase*> GetMatricesRequestedBy(AliasNodePtr owner) const
+    {
+        std::set<const MatrixBase*> matrices;
+        CollectMatricesRequestedBy(m_memRequestInfoFloatVec, owner, matrices);
+        CollectMatricesRequestedBy(m_memRequestInfoDoubleVec, owner, matrices);
+        CollectMatricesRequestedBy(m_memRequestInfoHalfVec, owner, matrices);
+
+        std::set<const MatrixBase*> aliases;
+        for (const auto& placement : m_arenaPlacements)
+        {
+            if (matrices.find(placement.matrix) == matrices.end())
+                continue;
+            for (const auto& other : m_arenaPlacements)
+            {
+                if (other.arena == placement.arena && other.begin < placement.end && placement.begin < other.end)
+                    aliases.insert(other.matrix);
+            }
+        }
+        matrices.insert(aliases.begin(), aliases.end());
+        return matrices;
+    }
+
+    // print the peak memory of the plan per device: one allocation per shared buffer vs. the arena
+    void PrintMemoryPlan() const
+    {
+        const double MB = 1024.0 * 1024.0;
+        for (const auto& plan : m_memoryPlan)
+        {
+            fprintf(stderr, "\nMemory plan for device %d, %d-bit elements: %d requests share %d buffers (%d of unknown size not included)",
+                    (int)plan.deviceId, (int)(8 * plan.elementSize),
+                    (int)plan.numRequests, (int)plan.numBuffers, (int)plan.numUnsizedBuffers);
+            if (m_arenaMinibatchColumns > 0)
+                fprintf(stderr, ", sized for %d minibatch columns:\n", (int)m_arenaMinibatchColumns);
+            else
+                fprintf(stderr, ", per minibatch column:\n");
+            fprintf(stderr, "\tseparate buffers %10.2f MB\n", plan.separateBytes / MB);
+            fprintf(stderr, "\tarena            %10.2f MB%s\n", plan.arenaBytes / MB, m_arenaMinibatchColumns > 0 ? "" : " (not used)");
+            fprintf(stderr, "\tlive lower bound %10.2f MB\n", plan.liveBytes / MB);
         }
     }
 
 private: 
+    template <class ElemType>
+    static void CollectMatricesRequestedBy(const vector<MemRequestInfo<ElemType>>& memInfoVec, AliasNodePtr owner, std::set<const MatrixBase*>& matrices)
+    {
+        for (const auto& memInfo : memInfoVec)
+        {
+            for (size_t i = 0; i < memInfo.owners.size(); i++)
+            {
+                if (memInfo.owners[i] == owner && *memInfo.pMatrixPtrs[i])
+                    matrices.insert(memInfo.pMatrixPtrs[i]->get());
+            }
+        }
+    }
+
     bool CheckOverlap(pair<int, int>occ, vector<pair<int, int>>&occVec)
     {
         bool bRet = false;
@@ -247,6 +352,126 @@ private:
         return bRet;
     }
 
+    bool CheckOverlap(vector<pair<int, int>>& occVec1, vector<pair<int, int>>& occVec2)
+    {
+        for (auto& occ : occVec1)
+        {
+            if (CheckOverlap(occ, occVec2))
+                return true;
+        }
+        return false;
+    }
+
+    // Lay out the shared buffers of one device in a single arena. Buffers are placed from largest to smallest, each into the
+    // smallest gap that fits between those already placed buffers whose lifetime overlaps with its own (best fit), or else on top
+    // of them. Buffers that are never live at the same time may thus use the same addresses even if they were not merged above.
+    // The plan is always made for the report; memory is only laid out this way if m_arenaMinibatchColumns > 0.
+    template <class ElemType>
+    void PlanArena(vector<MemRequestInfo<ElemType>>& memInfoVec, DEVICEID_TYPE devId)
+    {
+        struct ArenaBuffer
+        {
+            shared_ptr<Matrix<ElemType>> matrix;
+            vector<pair<int, int>> occupancy;
+            size_t size = 0;
+            size_t offset = 0;
+            bool isSized = true;
+        };
+
+        const size_t numColumns = max(m_arenaMinibatchColumns, (size_t)1);
+        const size_t alignment = max(ArenaAlignmentInBytes / sizeof(ElemType), (size_t)1);
+        auto alignedSize = [alignment](size_t size) { return (size + alignment - 1) / alignment * alignment; };
+
+        MemoryPlanInfo plan(devId, sizeof(ElemType));
+        map<pair<bool, int>, ArenaBuffer> buffers; // (isWorkSpace, memoryId) -> buffer
+        vector<pair<int, ptrdiff_t>> liveChanges;  // (step, +/- size) for the live lower bound
+        for (auto& memInfo : memInfoVec)
+        {
+            if (memInfo.deviceId != devId)
+                continue;
+
+            auto& buffer = buffers[make_pair(memInfo.isWorkSpace, memInfo.memoryId)];
+            buffer.matrix = *memInfo.pMatrixPtrs[0];
+            buffer.occupancy.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+            plan.numRequests += memInfo.pMatrixPtrs.size();
+            if (memInfo.matrixSize == 0)
+            {
+                buffer.isSized = false;
+                continue;
+            }
+            size_t size = memInfo.matrixSize * (memInfo.mbScale ? numColumns : 1);
+            buffer.size = max(buffer.size, size);
+            liveChanges.push_back(make_pair(memInfo.allocStep, (ptrdiff_t)size));
+            if (memInfo.releaseStep != INT_MAX)
+                liveChanges.push_back(make_pair(memInfo.releaseStep + 1, -(ptrdiff_t)size)); // occupancy is inclusive
+        }
+
+        // a release sorts before an allocation at the same step
+        sort(liveChanges.begin(), liveChanges.end());
+        ptrdiff_t liveSize = 0;
+        for (const auto& change : liveChanges)
+        {
+            liveSize += change.second;
+            plan.liveBytes = max(plan.liveBytes, (size_t)liveSize * sizeof(ElemType));
+        }
+
+        vector<ArenaBuffer*> sizedBuffers;
+        for (auto& buffer : buffers)
+        {
+            if (buffer.second.isSized)
+                sizedBuffers.push_back(&buffer.second);
+            else
+                plan.numUnsizedBuffers++;
+        }
+        plan.numBuffers = buffers.size();
+        stable_sort(sizedBuffers.begin(), sizedBuffers.end(), [](const ArenaBuffer* a, const ArenaBuffer* b) { return a->size > b->size; });
+
+        size_t arenaSize = 0;
+        vector<ArenaBuffer*> placedBuffers;
+        for (auto buffer : sizedBuffers)
+        {
+            size_t size = alignedSize(buffer->size);
+            vector<pair<size_t, size_t>> conflicts;
+            for (auto placed : placedBuffers)
+            {
+                if (CheckOverlap(buffer->occupancy, placed->occupancy))
+                    conflicts.push_back(make_pair(placed->offset, placed->offset + alignedSize(placed->size)));
+            }
+            sort(conflicts.begin(), conflicts.end());
+
+            size_t bestOffset = SIZE_MAX;
+            size_t bestGap = SIZE_MAX;
+            size_t top = 0;
+            for (const auto& conflict : conflicts)
+            {
+                if (conflict.first > top && conflict.first - top >= size && conflict.first - top < bestGap)
+                {
+                    bestGap = conflict.first - top;
+                    bestOffset = top;
+                }
+                top = max(top, conflict.second);
+            }
+            buffer->offset = (bestOffset != SIZE_MAX) ? bestOffset : top;
+            placedBuffers.push_back(buffer);
+
+            arenaSize = max(arenaSize, buffer->offset + size);
+            plan.separateBytes += buffer->size * sizeof(ElemType);
+        }
+        plan.arenaBytes = arenaSize * sizeof(ElemType);
+        m_memoryPlan.push_back(plan);
+
+        if (m_arenaMinibatchColumns == 0 || arenaSize == 0)
+            return;
+
+        // the arena is kept alive by the matrices that borrow from it
+        auto arena = make_shared<Matrix<ElemType>>(arenaSize, 1, devId);
+        for (auto buffer : placedBuffers)
+        {
+            buffer->matrix->BorrowBufferFrom(arena, buffer->offset, buffer->size);
+            m_arenaPlacements.push_back(ArenaPlacement{ buffer->matrix.get(), arena.get(), buffer->offset, buffer->offset + buffer->size });
+        }
+    }
+
     template <class ElemType>
     void OptimizedMemoryAllocationFunc()
     {
@@ -386,6 +611,8 @@ private:
                     }
                 }
             }
+
+            PlanArena(memInfoVec, devId);
         }
     }
 };
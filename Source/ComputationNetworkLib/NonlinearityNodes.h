@@ -176,6 +176,156 @@ DeclareUnaryElementWiseWithOpCodeNode(StableSigmoid,         StableSigmoid,
 
 #pragma pop_macro("DeclareUnaryElementWiseWithOpCodeNode")
 
+// -----------------------------------------------------------------------
+// FusedElementwiseNode (input0, input1) -- an elementwise binary operation followed by an activation,
+// e.g. RectifiedLinear (Plus (Times (W, x), b)), computed in a single tensor pass.
+// This node is not meant to be created by users. ComputationNetwork::FuseElementwiseNodes() substitutes
+// it for a Plus or ElementTimes node and the RectifiedLinear, Sigmoid, or Tanh node that is its only consumer.
+// The fused node takes over the name of the activation node. Both operations are identified by the
+// operation names of the nodes they replace, which is also what gets serialized.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class FusedElementwiseNode : public BinaryElementWiseNode<ElemType>
+{
+    typedef BinaryElementWiseNode<ElemType> Base; UsingBinaryElementwiseNodeBaseMembers;
+    static const std::wstring TypeName() { return L"FusedElementwise"; }
+
+public:
+    FusedElementwiseNode(DEVICEID_TYPE deviceId, const wstring& name, const std::wstring& binaryOperation = std::wstring(), const std::wstring& activation = std::wstring())
+        : Base(deviceId, name), m_binaryOperation(binaryOperation), m_activation(activation)
+    {
+        if (!m_binaryOperation.empty() || !m_activation.empty()) // verify validity already here out of courtesy (would otherwise be caught in Validate())
+            ValidateOps();
+    }
+
+    FusedElementwiseNode(const ScriptableObjects::IConfigRecordPtr configp)
+        : FusedElementwiseNode(configp->Get(L"deviceId"), L"<placeholder>", configp->Get(L"binaryOperation"), configp->Get(L"activation"))
+    {
+        AttachInputsFromConfig(configp, this->GetExpectedNumInputs());
+    }
+
+    // whether nodes with these operation names can be fused into one FusedElementwiseNode
+    static bool CanFuse(const std::wstring& binaryOperation, const std::wstring& activation)
+    {
+        return (binaryOperation == L"Plus" || binaryOperation == L"ElementTimes") &&
+               (activation == L"RectifiedLinear" || activation == L"Sigmoid" || activation == L"Tanh");
+    }
+
+    const std::wstring& BinaryOperation() const { return m_binaryOperation; }
+    const std::wstring& Activation() const { return m_activation; }
+
+    virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
+    {
+        size_t rank = DetermineElementwiseTensorRank();
+        auto result =             ValueTensorFor(rank, fr);
+        auto input0 = InputRef(0).ValueTensorFor(rank, fr.AllowBroadcast());
+        auto input1 = InputRef(1).ValueTensorFor(rank, fr.AllowBroadcast());
+        result.DoBinaryOpOf(0, input0, input1, 1, m_opForward, opSum);
+    }
+
+    virtual void /*ComputationNode::*/ BackpropTo(const size_t inputIndex, const FrameRange& fr) override
+    {
+        size_t rank = DetermineElementwiseTensorRank();
+        auto gradient      =                    GradientTensorFor(rank, fr);
+        auto output        =                    ValueTensorFor(rank, fr);
+        auto inputGradient = Input(inputIndex)->GradientTensorFor(rank, fr.AllowBroadcast());
+
+        // if reduction then mask the respective input(s) (zero out the gaps)
+        if (Input(inputIndex)->ReducesInTimeWrt(shared_from_this()))
+            MaskMissingGradientColumnsToZero(fr);
+
+        ElemType beta = Input(inputIndex)->IsGradientInitializedBy(this) ? 0.0f : 1.0f;
+        if (IsElementwiseProduct())
+        {
+            if (Input(inputIndex)->ReducesInTimeWrt(Input(1 - inputIndex)))
+                Input(1 - inputIndex)->MaskMissingValueColumnsToZero(fr);
+
+            // d input = d output * activation'(output) * other input
+            auto otherInputValue = Input(1 - inputIndex)->ValueTensorFor(rank, fr.AllowBroadcast());
+            inputGradient.DoTernaryOpOf(beta, gradient, output, otherInputValue, 1, m_opBackwardWithFactor, opSum);
+        }
+        else // d input = d output * activation'(output)
+            inputGradient.DoBinaryOpOf(beta, gradient, output, 1, m_opBackward, opSum);
+    }
+
+    virtual bool OutputUsedInComputingInputNodesGradients() const override { return true; }
+    virtual bool InputUsedInComputingInputNodesGradients(size_t /*childIndex*/) const override { return IsElementwiseProduct(); }
+    virtual ParentGradientOptimization ImplementsGradientOptimization(const ComputationNodeBase*) const override { return ParentGradientOptimization::Overwrite; }
+
+    virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
+    {
+        ValidateOps(); // in case we got instantiated empty and never updated
+        Base::Validate(isFinalValidationPass);
+    }
+
+    virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
+    {
+        Base::CopyTo(nodeP, newName, flags);
+        if (flags & CopyNodeFlags::copyNodeValue)
+        {
+            auto node = dynamic_pointer_cast<FusedElementwiseNode<ElemType>>(nodeP);
+            node->m_binaryOperation = m_binaryOperation;
+            node->m_activation      = m_activation;
+            node->ValidateOps();
+        }
+    }
+
+    virtual void Save(File& fstream) const override
+    {
+        Base::Save(fstream);
+        fstream << m_binaryOperation << m_activation; // note: we serialize the names and not the opcodes, since opcodes may change
+    }
+
+    virtual void Load(File& fstream, size_t modelVersion) override
+    {
+        Base::Load(fstream, modelVersion);
+        fstream >> m_binaryOperation >> m_activation;
+        ValidateOps();
+    }
+
+private:
+    bool IsElementwiseProduct() const { return m_binaryOperation == L"ElementTimes"; }
+
+    // map the operation names to the opcodes for the forward pass and the gradients
+    void ValidateOps()
+    {
+        if (!CanFuse(m_binaryOperation, m_activation))
+            InvalidArgument("%ls %ls operation: Cannot fuse '%ls' and '%ls'. Allowed are 'Plus' or 'ElementTimes', followed by 'RectifiedLinear', 'Sigmoid', or 'Tanh'.",
+                            NodeName().c_str(), OperationName().c_str(), m_binaryOperation.c_str(), m_activation.c_str());
+
+        bool isProduct = IsElementwiseProduct();
+        if (m_activation == L"RectifiedLinear")
+        {
+            m_opForward            = isProduct ? opLinearRectifierOfElementwiseProduct : opLinearRectifierOfSum;
+            m_opBackward           = opElementwiseProductWithLinearRectifierDerivativeFromOutput;
+            m_opBackwardWithFactor = opElementwiseProductWithLinearRectifierDerivativeFromOutputAndFactor;
+        }
+        else if (m_activation == L"Sigmoid")
+        {
+            m_opForward            = isProduct ? opSigmoidOfElementwiseProduct : opSigmoidOfSum;
+            m_opBackward           = opElementwiseProductWithSigmoidDerivativeFromOutput;
+            m_opBackwardWithFactor = opElementwiseProductWithSigmoidDerivativeFromOutputAndFactor;
+        }
+        else // Tanh
+        {
+            m_opForward            = isProduct ? opTanhOfElementwiseProduct : opTanhOfSum;
+            m_opBackward           = opElementwiseProductWithTanhDerivativeFromOutput;
+            m_opBackwardWithFactor = opElementwiseProductWithTanhDerivativeFromOutputAndFactor;
+        }
+    }
+
+    std::wstring m_binaryOperation; // operation name of the fused binary node, e.g. "Plus"
+    std::wstring m_activation;      // operation name of the fused activation node, e.g. "RectifiedLinear"
+    ElementWiseOperator m_opForward            = opNone; // activation(a op b)
+    ElementWiseOperator m_opBackward           = opNone; // gradient * activation'(output)
+    ElementWiseOperator m_opBackwardWithFactor = opNone; // gradient * activation'(output) * other input (for ElementTimes)
+};
+
+template class FusedElementwiseNode<float>;
+template class FusedElementwiseNode<double>;
+template class FusedElementwiseNode<half>;
+
 // -----------------------------------------------------------------------
 // SoftmaxNodeBase (input) -- shared base of Softmax and LogSoftmax
 // -----------------------------------------------------------------------
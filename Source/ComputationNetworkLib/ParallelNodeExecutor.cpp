@@ -0,0 +1,249 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
+
+#include "Basics.h"
+#include "ParallelNodeExecutor.h"
+#include <map>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+static void InsertNonNull(set<const MatrixBase*>& matrices, const MatrixBase* matrix)
+{
+    if (matrix)
+        matrices.insert(matrix);
+}
+
+ParallelNodeExecutor::ParallelNodeExecutor(const vector<ComputationNodeBasePtr>& nodes, const MatrixPool& matrixPool, size_t numThreads)
+{
+    size_t numNodes = nodes.size();
+    vector<MatrixSet> forwardReads(numNodes), forwardWrites(numNodes), backwardWrites(numNodes);
+    vector<bool> isBarrier(numNodes);
+    for (size_t i = 0; i < numNodes; i++)
+    {
+        const auto& node = nodes[i];
+        isBarrier[i] = !node->SupportsConcurrentExecution();
+        if (isBarrier[i])
+            continue;
+
+        // Forward: a node writes its own value and any temporaries it obtained from the pool, and reads its inputs.
+        // For inputs we include everything they obtained from the pool since e.g. multi-output nodes hand out
+        // more than their ValuePtr(). This is conservative; extra reads only cost parallelism, not correctness.
+        auto ownMatrices = matrixPool.GetMatricesRequestedBy((MatrixPool::AliasNodePtr)&*node);
+        InsertNonNull(forwardWrites[i], node->ValuePtr().get());
+        forwardWrites[i].insert(ownMatrices.begin(), ownMatrices.end());
+        for (const auto& input : node->GetInputs())
+        {
+            InsertNonNull(forwardReads[i], input->ValuePtr().get());
+            auto inputMatrices = matrixPool.GetMatricesRequestedBy((MatrixPool::AliasNodePtr)&*input);
+            forwardReads[i].insert(inputMatrices.begin(), inputMatrices.end());
+        }
+
+        // Backward: a node reads its own value and gradient and reads/accumulates into its inputs' gradients.
+        // Siblings that share an input therefore always conflict on its gradient, so we do not bother to
+        // distinguish reads from writes here.
+        backwardWrites[i] = forwardWrites[i];
+        for (const auto& matrixInfo : node->GetMatrixInfo())
+            InsertNonNull(backwardWrites[i], matrixInfo.first);
+        for (const auto& input : node->GetInputs())
+        {
+            for (const auto& matrixInfo : input->GetMatrixInfo())
+                InsertNonNull(backwardWrites[i], matrixInfo.first);
+            auto inputMatrices = matrixPool.GetMatricesRequestedBy((MatrixPool::AliasNodePtr)&*input);
+            backwardWrites[i].insert(inputMatrices.begin(), inputMatrices.end());
+        }
+    }
+
+    m_forwardGraph.Build(nodes, forwardReads, forwardWrites, isBarrier);
+
+    vector<ComputationNodeBasePtr> reversedNodes(nodes.rbegin(), nodes.rend());
+    reverse(backwardWrites.begin(), backwardWrites.end());
+    reverse(isBarrier.begin(), isBarrier.end());
+    m_backwardGraph.Build(reversedNodes, vector<MatrixSet>(numNodes), backwardWrites, isBarrier);
+
+    m_threadPool = GetThreadPool(numThreads);
+}
+
+// turn a serial order into a DAG by classic read-after-write, write-after-read and write-after-write hazard analysis
+void ParallelNodeExecutor::DependencyGraph::Build(const vector<ComputationNodeBasePtr>& nodes, const vector<MatrixSet>& reads, const vector<MatrixSet>& writes, const vector<bool>& isBarrier)
+{
+    const size_t none = SIZE_MAX;
+    size_t numNodes = nodes.size();
+    m_nodes = nodes;
+    m_successors.assign(numNodes, vector<size_t>());
+    m_numPredecessors.assign(numNodes, 0);
+    m_criticalPathLength = 0;
+
+    map<const MatrixBase*, size_t> lastWriter;
+    map<const MatrixBase*, vector<size_t>> readersSinceLastWrite;
+    size_t lastBarrier = none;
+    vector<size_t> nodesSinceLastBarrier;
+    vector<size_t> depth(numNodes, 0);
+
+    for (size_t i = 0; i < numNodes; i++)
+    {
+        set<size_t> predecessors;
+        if (isBarrier[i])
+        {
+            // a barrier waits for everything before it, and everything after it waits for the barrier
+            predecessors.insert(nodesSinceLastBarrier.begin(), nodesSinceLastBarrier.end());
+            if (lastBarrier != none)
+                predecessors.insert(lastBarrier);
+            nodesSinceLastBarrier.clear();
+            lastWriter.clear();
+            readersSinceLastWrite.clear();
+            lastBarrier = i;
+        }
+        else
+        {
+            if (lastBarrier != none)
+                predecessors.insert(lastBarrier);
+            for (auto matrix : reads[i])
+            {
+                auto writer = lastWriter.find(matrix);
+                if (writer != lastWriter.end())
+                    predecessors.insert(writer->second);
+            }
+            for (auto matrix : writes[i])
+            {
+                auto writer = lastWriter.find(matrix);
+                if (writer != lastWriter.end())
+                    predecessors.insert(writer->second);
+                auto readers = readersSinceLastWrite.find(matrix);
+                if (readers != readersSinceLastWrite.end())
+                    predecessors.insert(readers->second.begin(), readers->second.end());
+            }
+            for (auto matrix : reads[i])
+            {
+                if (writes[i].find(matrix) == writes[i].end())
+                    readersSinceLastWrite[matrix].push_back(i);
+            }
+            for (auto matrix : writes[i])
+            {
+                lastWriter[matrix] = i;
+                readersSinceLastWrite.erase(matrix);
+            }
+            nodesSinceLastBarrier.push_back(i);
+        }
+
+        predecessors.erase(i);
+        for (auto predecessor : predecessors)
+        {
+            m_successors[predecessor].push_back(i);
+            depth[i] = max(depth[i], depth[predecessor]);
+        }
+        m_numPredecessors[i] = predecessors.size();
+        depth[i]++;
+        m_criticalPathLength = max(m_criticalPathLength, depth[i]);
+    }
+}
+
+// state of one execution of a dependency graph; shared by all tasks of that execution
+struct ParallelNodeExecutionState
+{
+    ParallelNodeExecutionState(size_t numNodes)
+        : m_numPending(new atomic<size_t>[numNodes]), m_numRemaining(numNodes), m_aborted(false), m_done(false)
+    {
+    }
+
+    unique_ptr<atomic<size_t>[]> m_numPending; // [i] -> number of predecessors of node i that have not completed yet
+    atomic<size_t> m_numRemaining;
+    atomic<bool> m_aborted;
+
+    mutex m_mutex;
+    condition_variable m_doneCondition;
+    bool m_done;
+    exception_ptr m_exception;
+};
+
+static void RunNode(const shared_ptr<ParallelNodeExecutionState>& state, WorkStealingThreadPool* threadPool,
+                    const vector<ComputationNodeBasePtr>& nodes, const vector<vector<size_t>>& successors, const ParallelNodeExecutor::NodeAction& action, size_t i)
+{
+    // after a failure we still walk the graph, without executing, so that the remaining count drains to zero
+    if (!state->m_aborted)
+    {
+        try
+        {
+            action(nodes[i]);
+        }
+        catch (...)
+        {
+            lock_guard<mutex> lock(state->m_mutex);
+            if (!state->m_exception)
+                state->m_exception = current_exception();
+            state->m_aborted = true;
+        }
+    }
+
+    for (auto successor : successors[i])
+    {
+        if (--state->m_numPending[successor] == 0)
+            threadPool->Push([state, threadPool, &nodes, &successors, &action, successor]() { RunNode(state, threadPool, nodes, successors, action, successor); });
+    }
+
+    if (--state->m_numRemaining == 0)
+    {
+        lock_guard<mutex> lock(state->m_mutex);
+        state->m_done = true;
+        state->m_doneCondition.notify_all();
+    }
+}
+
+void ParallelNodeExecutor::Execute(const DependencyGraph& graph, const NodeAction& action)
+{
+    size_t numNodes = graph.m_nodes.size();
+    if (numNodes == 0)
+        return;
+
+    auto state = make_shared<ParallelNodeExecutionState>(numNodes);
+    for (size_t i = 0; i < numNodes; i++)
+        state->m_numPending[i] = graph.m_numPredecessors[i];
+
+    // 'graph', 'action' and the pool are only referenced by tasks of this execution, which all finish before we return
+    auto threadPool = m_threadPool.get();
+    for (size_t i = 0; i < numNodes; i++)
+    {
+        if (graph.m_numPredecessors[i] == 0)
+            threadPool->Push([state, threadPool, &graph, &action, i]() { RunNode(state, threadPool, graph.m_nodes, graph.m_successors, action, i); });
+    }
+
+    unique_lock<mutex> lock(state->m_mutex);
+    state->m_doneCondition.wait(lock, [&state]() { return state->m_done; });
+    if (state->m_exception)
+        rethrow_exception(state->m_exception);
+}
+
+// all executors share one pool, so that several networks (or roots) do not each spin up their own threads
+/*static*/ shared_ptr<WorkStealingThreadPool> ParallelNodeExecutor::GetThreadPool(size_t numThreads)
+{
+    static mutex s_mutex;
+    static shared_ptr<WorkStealingThreadPool> s_threadPool;
+
+    lock_guard<mutex> lock(s_mutex);
+    if (!s_threadPool || s_threadPool->NumThreads() != numThreads)
+    {
+        s_threadPool = make_shared<WorkStealingThreadPool>(numThreads, [numThreads](size_t /*workerIndex*/)
+        {
+#ifdef _OPENMP
+            // split the intra-op threads among the workers to avoid oversubscribing the cores
+            omp_set_num_threads(max(1, omp_get_max_threads() / (int)numThreads));
+#endif
+        });
+    }
+    return s_threadPool;
+}
+
+}}}
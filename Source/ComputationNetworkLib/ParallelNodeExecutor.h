@@ -0,0 +1,71 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include "Basics.h"
+#include "ComputationNode.h"
+#include "MatrixPool.h"
+#include "WorkStealingThreadPool.h"
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// ParallelNodeExecutor -- dependency-aware (wavefront) execution of the top-level nodes of a PAR traversal
+//
+// The serial evaluation order is turned into a DAG by a read/write hazard analysis over the matrix
+// objects each node touches, including buffers handed out by the MatrixPool. Since shared buffers
+// are the same Matrix object, this automatically honors the memory sharing plan: two nodes that
+// use the same physical buffer are kept in their serial order, everything else may overlap.
+// Nodes that do not SupportsConcurrentExecution() (and nested SEQ loops) act as barriers.
+//
+// Ready nodes are executed on a process-wide WorkStealingThreadPool. This is CPU-only; on GPU the
+// kernels of all nodes go into the same stream anyway.
+// -----------------------------------------------------------------------
+
+class ParallelNodeExecutor
+{
+public:
+    typedef std::function<void(const ComputationNodeBasePtr&)> NodeAction;
+
+    // 'nodes' must be in evaluation order. Must be called after the matrix pool has assigned its final pointers.
+    ParallelNodeExecutor(const std::vector<ComputationNodeBasePtr>& nodes, const MatrixPool& matrixPool, size_t numThreads);
+
+    // run 'action' on all nodes, respecting the forward (evaluation order) dependencies
+    void ForwardProp(const NodeAction& action) { Execute(m_forwardGraph, action); }
+    // run 'action' on all nodes, respecting the backward (reverse evaluation order) dependencies
+    void Backprop(const NodeAction& action) { Execute(m_backwardGraph, action); }
+
+    // the length of the longest dependency chain vs. the number of nodes, a measure of the available parallelism
+    size_t NumNodes() const { return m_forwardGraph.m_nodes.size(); }
+    size_t ForwardCriticalPathLength() const { return m_forwardGraph.m_criticalPathLength; }
+    size_t BackwardCriticalPathLength() const { return m_backwardGraph.m_criticalPathLength; }
+
+private:
+    typedef std::set<const MatrixBase*> MatrixSet;
+
+    struct DependencyGraph
+    {
+        std::vector<ComputationNodeBasePtr> m_nodes;     // in the serial order of this direction
+        std::vector<std::vector<size_t>> m_successors;   // [i] -> nodes that must wait for node i
+        std::vector<size_t> m_numPredecessors;           // [i] -> number of nodes node i waits for
+        size_t m_criticalPathLength = 0;
+
+        void Build(const std::vector<ComputationNodeBasePtr>& nodes, const std::vector<MatrixSet>& reads, const std::vector<MatrixSet>& writes, const std::vector<bool>& isBarrier);
+    };
+
+    void Execute(const DependencyGraph& graph, const NodeAction& action);
+
+    static std::shared_ptr<WorkStealingThreadPool> GetThreadPool(size_t numThreads);
+
+    DependencyGraph m_forwardGraph;
+    DependencyGraph m_backwardGraph;
+    std::shared_ptr<WorkStealingThreadPool> m_threadPool;
+};
+
+}}}
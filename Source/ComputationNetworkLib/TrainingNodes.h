@@ -2427,6 +2427,9 @@ public:
         AttachInputsFromConfig(configp);
     }
 
+    // ForwardProp() updates the running statistics, which are inputs that may be shared with other nodes
+    virtual bool SupportsConcurrentExecution() const override { return false; }
+
     void Save(File& fstream) const override
     {
         Base::Save(fstream);
@@ -43,6 +43,9 @@ public:
         return std::any_of(outputs.begin(), outputs.end(), [](const ::CNTK::Variable& output) { return output.Shape().HasFreeDimension(); });
     }
 
+    // user code (e.g. Python) is not assumed to be thread-safe
+    virtual bool SupportsConcurrentExecution() const override { return false; }
+
     // This function is called in both PAR and SEQ modes of execution.
     // In PAR mode, all frames are included at once and the MBLayout of the
     // function defines the entire output.
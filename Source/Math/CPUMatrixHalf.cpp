@@ -4,47 +4,91 @@
 //
 #include "stdafx.h"
 #include "CPUMatrixImpl.h"
+#include "CPUMatrixTensorImpl.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
-// General conversion function with no performance optimization
-// this should only be used in CPU half precision
-// For performance on inference on CPU, user should convert fp16 model to fp32 first, unless MKL supports half precision
-template<typename SrcT, typename DstT>
-static void ConvertBuffer(DstT* dst, const SrcT* src, size_t count)
+// inner dimension of the float panels that a half-precision GEMM converts its operands into
+static const size_t HalfGemmPanelSize = 256;
+
+// convert rows [begin, begin + numRows) of all columns of a half matrix into a numRows x numCols float matrix
+static void ConvertRowPanel(CPUMatrix<float>& panel, const CPUMatrix<half>& a, size_t begin, size_t numRows)
 {
-    for (size_t i = 0; i < count; i++)
-    {
-        dst[i] = (DstT)src[i];
-    }
+    const size_t numCols = a.GetNumCols();
+    panel.Resize(numRows, numCols);
+    float* dst = panel.Data();
+    const half* src = a.Data() + begin;
+    const size_t lda = a.GetNumRows();
+#pragma omp parallel for if (numRows * numCols >= 32768)
+    for (int64_t j = 0; j < (int64_t)numCols; j++)
+        CPUMatrixConvertBuffer(dst + j * numRows, src + j * lda, numRows);
+}
+
+// convert columns [begin, begin + numCols) of a half matrix into a float matrix
+static void ConvertColumnPanel(CPUMatrix<float>& panel, const CPUMatrix<half>& a, size_t begin, size_t numCols)
+{
+    panel.Resize(a.GetNumRows(), numCols);
+    CPUMatrixConvertBuffer(panel.Data(), a.Data() + begin * a.GetNumRows(), a.GetNumRows() * numCols);
 }
 
-// specialization to convert from half to float for computation, and then store in half
+// specialization to compute in float and store in half
+// The inner dimension is processed in panels: only HalfGemmPanelSize rows (columns) of each operand are converted to float
+// at a time, while the result is accumulated in a float matrix, so that large half-precision weights are never held in float.
 template <>
 void CPUMatrix<half>::MultiplyAndWeightedAdd(half alpha, const CPUMatrix<half>& a, const bool transposeA, const CPUMatrix<half>& b, const bool transposeB,
     half beta, CPUMatrix<half>& c, shared_ptr<QuantizedMultiplier<half>> pQuantizedMultiplier)
 {
-    CPUMatrix<float> af(a.GetNumRows(), a.GetNumCols());
-    CPUMatrix<float> bf(b.GetNumRows(), b.GetNumCols());
-    CPUMatrix<float> cf(c.GetNumRows(), c.GetNumCols());
+    if (a.IsEmpty() || b.IsEmpty())
+        return;
 
-    if (alpha != 0)
-    {
-        ConvertBuffer<half, float>(af.Data(), a.Data(), a.GetNumElements());
-        ConvertBuffer<half, float>(bf.Data(), b.Data(), b.GetNumElements());
-    }
+    if (pQuantizedMultiplier)
+        RuntimeError("Quantized matrix multiply not supported for Half");
 
+    const size_t m = transposeA ? a.GetNumCols() : a.GetNumRows();
+    const size_t k = transposeA ? a.GetNumRows() : a.GetNumCols();
+    const size_t l = transposeB ? b.GetNumCols() : b.GetNumRows();
+    const size_t n = transposeB ? b.GetNumRows() : b.GetNumCols();
+    if (k != l)
+        InvalidArgument("CPUMatrix<half>::MultiplyAndWeightedAdd : The inner dimensions of a and b must match.");
+
+    if (beta == 0)
+        c.RequireSize(m, n);
+    else
+        c.VerifySize(m, n); // Can't resize if beta != 0
+
+    CPUMatrix<float> cf(m, n);
     if (beta != 0)
+        CPUMatrixConvertBuffer(cf.Data(), c.Data(), c.GetNumElements());
+
+    if (alpha == 0)
     {
-        ConvertBuffer<half, float>(cf.Data(), c.Data(), c.GetNumElements());
+        if (beta == 0)
+            cf.SetValue(0);
+        else
+            CPUMatrix<float>::Scale((float)beta, cf);
+    }
+    else
+    {
+        CPUMatrix<float> af, bf;
+        float panelBeta = (float)beta;
+        for (size_t begin = 0; begin < k; begin += HalfGemmPanelSize)
+        {
+            const size_t panelSize = min(HalfGemmPanelSize, k - begin);
+            if (transposeA)
+                ConvertRowPanel(af, a, begin, panelSize);
+            else
+                ConvertColumnPanel(af, a, begin, panelSize);
+            if (transposeB)
+                ConvertColumnPanel(bf, b, begin, panelSize);
+            else
+                ConvertRowPanel(bf, b, begin, panelSize);
+
+            CPUMatrix<float>::MultiplyAndWeightedAdd((float)alpha, af, transposeA, bf, transposeB, panelBeta, cf, nullptr);
+            panelBeta = 1;
+        }
     }
 
-    if (pQuantizedMultiplier)
-        RuntimeError("Quantized matrix multiply not supported for Half");
-
-    CPUMatrix<float>::MultiplyAndWeightedAdd((float)alpha, af, transposeA, bf, transposeB, (float)beta, cf, nullptr);
-
-    ConvertBuffer<float, half>(c.Data(), cf.Data(), c.GetNumElements());
+    CPUMatrixConvertBuffer(c.Data(), cf.Data(), c.GetNumElements());
 }
 
 // specialization to RunTimeError for now due to omp implementation only support build-in type
@@ -115,7 +159,7 @@ void CPUMatrix<half>::AveragePoolingBackward(const CPUMatrix<int>& mpRowCol, con
 
 // explicit instantiations, due to CPUMatrix being too big and causing VS2015 cl crash.
 template class MATH_API CPUMatrix<half>;
-template<> int CPUMatrix<half>::m_optimizationFlags = 0;
+template<> int CPUMatrix<half>::m_optimizationFlags = CPUMatrix<half>::OPT_VECTORIZED_TENSOR_OPS; // computes in float with F16C/AVX-512 conversions
 
 // instantiate templated methods
 template void CPUMatrix<float>::AdaDelta(CPUMatrix<float>& gradients, CPUMatrix<float>& functionValues, float learningRate, float rho, float epsilon);
@@ -0,0 +1,533 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Hand-vectorized (AVX2 and AVX-512) versions of the most common float tensor ops, selected at runtime by the
+// CPU's capabilities. These are tried before the generic lambda-based TensorOpWithFn() loops when
+// CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS is set, and fall back to them for any op or layout not covered here.
+// The same kernels serve half-precision storage: operands are converted to float on load (F16C or AVX-512F)
+// and rounded back to half on store, so that computation is done in float like for CPUMatrix<float>.
+//
+
+#include "stdafx.h"
+#include "CPUMatrixTensorImpl.h"
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define VECTORIZED_TENSOR_OPS_SUPPORTED
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+
+namespace VectorizedTensorOps {
+
+// ops that have a vectorized implementation in CPUMatrixTensorVectorizedKernels.h
+#define ForAllVectorizedUnaryOps(Macro) \
+    Macro(Copy);                        \
+    Macro(Negate);                      \
+    Macro(Abs);                         \
+    Macro(Reciprocal);                  \
+    Macro(Sigmoid);                     \
+    Macro(Tanh);                        \
+    Macro(Sqr);                         \
+    Macro(Sqrt);                        \
+    Macro(Exp);                         \
+    Macro(LinearRectifier);
+
+#define ForAllVectorizedBinaryOps(Macro)                              \
+    Macro(Sum);                                                       \
+    Macro(Difference);                                                \
+    Macro(ElementwiseProduct);                                        \
+    Macro(ElementwiseQuotient);                                       \
+    Macro(Max);                                                       \
+    Macro(Min);                                                       \
+    Macro(ElementwiseProductWithSigmoidDerivativeFromOutput);         \
+    Macro(ElementwiseProductWithTanhDerivativeFromOutput);            \
+    Macro(ElementwiseProductWithLinearRectifierDerivativeFromOutput); \
+    Macro(SqrOfDifference);                                           \
+    Macro(LinearRectifierOfSum);                                      \
+    Macro(SigmoidOfSum);                                              \
+    Macro(TanhOfSum);                                                 \
+    Macro(LinearRectifierOfElementwiseProduct);                       \
+    Macro(SigmoidOfElementwiseProduct);                               \
+    Macro(TanhOfElementwiseProduct);
+
+#define ForAllVectorizedTernaryOps(Macro)                                       \
+    Macro(Cond);                                                                \
+    Macro(CopyIfEqual);                                                         \
+    Macro(Clip);                                                                \
+    Macro(ElementwiseProductWithExpOfDiff);                                     \
+    Macro(ElementwiseProductWithSigmoidDerivativeFromOutputAndFactor);          \
+    Macro(ElementwiseProductWithTanhDerivativeFromOutputAndFactor);             \
+    Macro(ElementwiseProductWithLinearRectifierDerivativeFromOutputAndFactor);
+
+// work is split into tasks of at most this many elements of the innermost dimension
+static const size_t ChunkSize = 4096;
+// below this many elements, OpenMP costs more than it gains
+static const size_t ParallelThreshold = 32768;
+
+// product of dims[firstDim..]
+static inline size_t NumElements(const SmallVector<size_t>& dims, size_t firstDim)
+{
+    size_t numElements = 1;
+    for (size_t k = firstDim; k < dims.size(); k++)
+        numElements *= dims[k];
+    return numElements;
+}
+
+// offsets of all operands for a linear index into dims[firstDim..]
+template <size_t N>
+static inline array<ptrdiff_t, N> IndexToOffsets(size_t index, const SmallVector<size_t>& dims, const array<SmallVector<ptrdiff_t>, N>& strides, size_t firstDim)
+{
+    array<ptrdiff_t, N> offsets;
+    offsets.fill(0);
+    for (size_t k = firstDim; k < dims.size(); k++)
+    {
+        const size_t i = index % dims[k];
+        index /= dims[k];
+        for (size_t n = 0; n < N; n++)
+            offsets[n] += (ptrdiff_t)i * strides[n][k];
+    }
+    return offsets;
+}
+
+// the kernels require the innermost dimension to be long enough for at least one full vector,
+// contiguous for the output, and contiguous (or, if allowed, broadcasting) for the inputs
+template <size_t N>
+static bool IsContiguousInnermostDim(const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, N>& regularStrides, size_t minDim, bool allowBroadcast)
+{
+    if (regularOpDims.empty() || regularOpDims[0] < minDim || regularStrides[N - 1][0] != 1)
+        return false;
+    for (size_t i = 0; i < N - 1; i++)
+    {
+        if (regularStrides[i][0] != 1 && !(allowBroadcast && regularStrides[i][0] == 0))
+            return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------
+// AVX2
+// -----------------------------------------------------------------------
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2,f16c")
+#pragma GCC optimize("fp-contract=off") // no fused multiply-add, so that results match the generic loops
+#endif
+
+namespace AVX2 {
+
+struct Vec
+{
+    typedef __m256 Type;
+    typedef __m256 Mask;
+    typedef __m256d DoubleType;
+    static const size_t Width = 8;
+
+    static inline Type Load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void Store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+    static inline Type Load(const half* p) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+    static inline void Store(half* p, Type v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+    static inline Type Set1(float x) { return _mm256_set1_ps(x); }
+
+    static inline Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static inline Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static inline Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static inline Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+    static inline Type Max(Type a, Type b) { return _mm256_max_ps(a, b); } // a > b ? a : b, also for NaNs, like OpMax()
+    static inline Type Min(Type a, Type b) { return _mm256_min_ps(a, b); } // a < b ? a : b
+    static inline Type Sqrt(Type a) { return _mm256_sqrt_ps(a); }
+    static inline Type Floor(Type a) { return _mm256_floor_ps(a); }
+    static inline Type Abs(Type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static inline Type Negate(Type a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static inline Type CopySign(Type magnitude, Type sign) { return _mm256_or_ps(Abs(magnitude), _mm256_and_ps(sign, _mm256_set1_ps(-0.0f))); }
+    // 2^n for integral n in [-126, 127]
+    static inline Type Pow2(Type n) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23)); }
+
+    static inline Mask Greater(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline Mask Less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline Mask Equal(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static inline Mask NotEqual(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); } // true for NaNs, like 'a != b'
+    static inline Mask IsNaN(Type a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static inline Mask FirstLanes(size_t n) { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32((int)n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))); }
+    static inline Type Select(Mask m, Type ifTrue, Type ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, m); }
+
+    static inline DoubleType ToDoubleLow(Type a) { return _mm256_cvtps_pd(_mm256_castps256_ps128(a)); }
+    static inline DoubleType ToDoubleHigh(Type a) { return _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)); }
+    static inline Type FromDouble(DoubleType low, DoubleType high) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)), _mm256_cvtpd_ps(high), 1); }
+    static inline DoubleType DoubleAdd(DoubleType a, DoubleType b) { return _mm256_add_pd(a, b); }
+    static inline DoubleType DoubleMax(DoubleType a, DoubleType b) { return _mm256_max_pd(a, b); }
+    static inline DoubleType DoubleMin(DoubleType a, DoubleType b) { return _mm256_min_pd(a, b); }
+    static inline void DoubleStore(double* p, DoubleType v) { _mm256_storeu_pd(p, v); }
+};
+
+#include "CPUMatrixTensorVectorizedKernels.h"
+
+} // namespace AVX2
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+// -----------------------------------------------------------------------
+// AVX-512 (foundation instructions only)
+// -----------------------------------------------------------------------
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off") // no fused multiply-add, so that results match the generic loops
+#endif
+
+namespace AVX512 {
+
+struct Vec
+{
+    typedef __m512 Type;
+    typedef __mmask16 Mask;
+    typedef __m512d DoubleType;
+    static const size_t Width = 16;
+
+    static inline Type Load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void Store(float* p, Type v) { _mm512_storeu_ps(p, v); }
+    static inline Type Load(const half* p) { return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))); }
+    static inline void Store(half* p, Type v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+    static inline Type Set1(float x) { return _mm512_set1_ps(x); }
+
+    static inline Type Add(Type a, Type b) { return _mm512_add_ps(a, b); }
+    static inline Type Sub(Type a, Type b) { return _mm512_sub_ps(a, b); }
+    static inline Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+    static inline Type Div(Type a, Type b) { return _mm512_div_ps(a, b); }
+    static inline Type Max(Type a, Type b) { return _mm512_max_ps(a, b); }
+    static inline Type Min(Type a, Type b) { return _mm512_min_ps(a, b); }
+    static inline Type Sqrt(Type a) { return _mm512_sqrt_ps(a); }
+    static inline Type Floor(Type a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    // the floating-point logic instructions need AVX512DQ, so use the integer ones
+    static inline Type Abs(Type a) { return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(a), _mm512_set1_epi32(0x7fffffff))); }
+    static inline Type Negate(Type a) { return _mm512_castsi512_ps(_mm512_xor_epi32(_mm512_castps_si512(a), _mm512_set1_epi32(0x80000000))); }
+    static inline Type CopySign(Type magnitude, Type sign)
+    {
+        return _mm512_castsi512_ps(_mm512_or_epi32(_mm512_castps_si512(Abs(magnitude)), _mm512_and_epi32(_mm512_castps_si512(sign), _mm512_set1_epi32(0x80000000))));
+    }
+    static inline Type Pow2(Type n) { return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23)); }
+
+    static inline Mask Greater(Type a, Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static inline Mask Less(Type a, Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static inline Mask Equal(Type a, Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static inline Mask NotEqual(Type a, Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+    static inline Mask IsNaN(Type a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+    static inline Mask FirstLanes(size_t n) { return (Mask)((1u << n) - 1); }
+    static inline Type Select(Mask m, Type ifTrue, Type ifFalse) { return _mm512_mask_blend_ps(m, ifFalse, ifTrue); }
+
+    static inline DoubleType ToDoubleLow(Type a) { return _mm512_cvtps_pd(_mm512_castps512_ps256(a)); }
+    static inline DoubleType ToDoubleHigh(Type a) { return _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1))); }
+    static inline Type FromDouble(DoubleType low, DoubleType high)
+    {
+        return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(_mm512_cvtpd_ps(low))), _mm256_castps_pd(_mm512_cvtpd_ps(high)), 1));
+    }
+    static inline DoubleType DoubleAdd(DoubleType a, DoubleType b) { return _mm512_add_pd(a, b); }
+    static inline DoubleType DoubleMax(DoubleType a, DoubleType b) { return _mm512_max_pd(a, b); }
+    static inline DoubleType DoubleMin(DoubleType a, DoubleType b) { return _mm512_min_pd(a, b); }
+    static inline void DoubleStore(double* p, DoubleType v) { _mm512_storeu_pd(p, v); }
+};
+
+#include "CPUMatrixTensorVectorizedKernels.h"
+
+} // namespace AVX512
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+// -----------------------------------------------------------------------
+// runtime dispatch
+// -----------------------------------------------------------------------
+
+enum class InstructionSet
+{
+    None,
+    AVX2,
+    AVX512
+};
+
+static InstructionSet DetectInstructionSet()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return InstructionSet::None;
+    __cpuid(info, 1);
+    const bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+    const bool hasAVX = (info[2] & (1 << 28)) != 0;
+    if (!hasOSXSave || !hasAVX)
+        return InstructionSet::None;
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    // the OS must save the AVX (and, for AVX-512, the opmask and upper ZMM) registers on context switches
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6)
+        return InstructionSet::AVX512;
+    if ((info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6)
+        return InstructionSet::AVX2;
+    return InstructionSet::None;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return InstructionSet::AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return InstructionSet::AVX2;
+    return InstructionSet::None;
+#endif
+}
+
+static InstructionSet GetInstructionSet()
+{
+    static const InstructionSet instructionSet = DetectInstructionSet();
+    return instructionSet;
+}
+
+// half <-> float conversion instructions; AVX-512F has its own, but every AVX2 CPU known also has F16C
+static bool DetectF16C()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 29)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 29)) != 0;
+#endif
+}
+
+// instruction set to use for half-precision operands
+static InstructionSet GetHalfInstructionSet()
+{
+    static const InstructionSet instructionSet = (GetInstructionSet() == InstructionSet::AVX2 && !DetectF16C()) ? InstructionSet::None : GetInstructionSet();
+    return instructionSet;
+}
+
+} // namespace VectorizedTensorOps
+
+#endif // VECTORIZED_TENSOR_OPS_SUPPORTED
+
+template <>
+bool CPUMatrixVectorizedUnaryTensorOpImpl<float>(float beta, const CPUMatrix<float>& a, CPUMatrix<float>& o, float alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+    const array<size_t, 2>& offsets,
+    const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+    const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 2>& reducingStrides)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    array<float*, 2> pointers = { a.Data() + offsets[0], o.Data() + offsets[1] };
+    switch (GetInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::UnaryTensorOp(beta, pointers, alpha, op, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    case InstructionSet::AVX2:
+        return AVX2::UnaryTensorOp(beta, pointers, alpha, op, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    default:
+        break;
+    }
+#else
+    UNUSED(beta); UNUSED(a); UNUSED(o); UNUSED(alpha); UNUSED(op); UNUSED(reductionOp); UNUSED(offsets);
+    UNUSED(regularOpDims); UNUSED(regularStrides); UNUSED(reducingOpDims); UNUSED(reducingStrides);
+#endif
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedBinaryTensorOpImpl<float>(float beta, const CPUMatrix<float>& a, const CPUMatrix<float>& b, CPUMatrix<float>& o, float alpha, ElementWiseOperator op, ElementWiseOperator /*reductionOp*/,
+    const array<size_t, 3>& offsets,
+    const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 3>& regularStrides,
+    const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 3>& /*reducingStrides*/)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    array<float*, 3> pointers = { a.Data() + offsets[0], b.Data() + offsets[1], o.Data() + offsets[2] };
+    switch (GetInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::BinaryTensorOp(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    case InstructionSet::AVX2:
+        return AVX2::BinaryTensorOp(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    default:
+        break;
+    }
+#else
+    UNUSED(beta); UNUSED(a); UNUSED(b); UNUSED(o); UNUSED(alpha); UNUSED(op); UNUSED(offsets);
+    UNUSED(regularOpDims); UNUSED(regularStrides); UNUSED(reducingOpDims);
+#endif
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedTernaryTensorOpImpl<float>(float beta, const CPUMatrix<float>& a, const CPUMatrix<float>& b, const CPUMatrix<float>& c, CPUMatrix<float>& o, float alpha, ElementWiseOperator op, ElementWiseOperator /*reductionOp*/,
+    const array<size_t, 4>& offsets,
+    const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 4>& regularStrides,
+    const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 4>& /*reducingStrides*/)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    array<float*, 4> pointers = { a.Data() + offsets[0], b.Data() + offsets[1], c.Data() + offsets[2], o.Data() + offsets[3] };
+    switch (GetInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::TernaryTensorOp(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    case InstructionSet::AVX2:
+        return AVX2::TernaryTensorOp(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    default:
+        break;
+    }
+#else
+    UNUSED(beta); UNUSED(a); UNUSED(b); UNUSED(c); UNUSED(o); UNUSED(alpha); UNUSED(op); UNUSED(offsets);
+    UNUSED(regularOpDims); UNUSED(regularStrides); UNUSED(reducingOpDims);
+#endif
+    return false;
+}
+
+// double always takes the generic path
+
+template <>
+bool CPUMatrixVectorizedUnaryTensorOpImpl<double>(double, const CPUMatrix<double>&, CPUMatrix<double>&, double, ElementWiseOperator, ElementWiseOperator,
+    const array<size_t, 2>&,
+    const SmallVector<size_t>&, const array<SmallVector<ptrdiff_t>, 2>&,
+    const SmallVector<size_t>&, const array<SmallVector<ptrdiff_t>, 2>&)
+{
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedBinaryTensorOpImpl<double>(double, const CPUMatrix<double>&, const CPUMatrix<double>&, CPUMatrix<double>&, double, ElementWiseOperator, ElementWiseOperator,
+    const array<size_t, 3>&,
+    const SmallVector<size_t>&, const array<SmallVector<ptrdiff_t>, 3>&,
+    const SmallVector<size_t>&, const array<SmallVector<ptrdiff_t>, 3>&)
+{
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedTernaryTensorOpImpl<double>(double, const CPUMatrix<double>&, const CPUMatrix<double>&, const CPUMatrix<double>&, CPUMatrix<double>&, double, ElementWiseOperator, ElementWiseOperator,
+    const array<size_t, 4>&,
+    const SmallVector<size_t>&, const array<SmallVector<ptrdiff_t>, 4>&,
+    const SmallVector<size_t>&, const array<SmallVector<ptrdiff_t>, 4>&)
+{
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedUnaryTensorOpImpl<half>(half beta, const CPUMatrix<half>& a, CPUMatrix<half>& o, half alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+    const array<size_t, 2>& offsets,
+    const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+    const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 2>& reducingStrides)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    array<half*, 2> pointers = { a.Data() + offsets[0], o.Data() + offsets[1] };
+    switch (GetHalfInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::UnaryTensorOp((float)beta, pointers, (float)alpha, op, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    case InstructionSet::AVX2:
+        return AVX2::UnaryTensorOp((float)beta, pointers, (float)alpha, op, reductionOp, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    default:
+        break;
+    }
+#else
+    UNUSED(beta); UNUSED(a); UNUSED(o); UNUSED(alpha); UNUSED(op); UNUSED(reductionOp); UNUSED(offsets);
+    UNUSED(regularOpDims); UNUSED(regularStrides); UNUSED(reducingOpDims); UNUSED(reducingStrides);
+#endif
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedBinaryTensorOpImpl<half>(half beta, const CPUMatrix<half>& a, const CPUMatrix<half>& b, CPUMatrix<half>& o, half alpha, ElementWiseOperator op, ElementWiseOperator /*reductionOp*/,
+    const array<size_t, 3>& offsets,
+    const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 3>& regularStrides,
+    const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 3>& /*reducingStrides*/)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    array<half*, 3> pointers = { a.Data() + offsets[0], b.Data() + offsets[1], o.Data() + offsets[2] };
+    switch (GetHalfInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::BinaryTensorOp((float)beta, pointers, (float)alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    case InstructionSet::AVX2:
+        return AVX2::BinaryTensorOp((float)beta, pointers, (float)alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    default:
+        break;
+    }
+#else
+    UNUSED(beta); UNUSED(a); UNUSED(b); UNUSED(o); UNUSED(alpha); UNUSED(op); UNUSED(offsets);
+    UNUSED(regularOpDims); UNUSED(regularStrides); UNUSED(reducingOpDims);
+#endif
+    return false;
+}
+
+template <>
+bool CPUMatrixVectorizedTernaryTensorOpImpl<half>(half beta, const CPUMatrix<half>& a, const CPUMatrix<half>& b, const CPUMatrix<half>& c, CPUMatrix<half>& o, half alpha, ElementWiseOperator op, ElementWiseOperator /*reductionOp*/,
+    const array<size_t, 4>& offsets,
+    const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 4>& regularStrides,
+    const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 4>& /*reducingStrides*/)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    array<half*, 4> pointers = { a.Data() + offsets[0], b.Data() + offsets[1], c.Data() + offsets[2], o.Data() + offsets[3] };
+    switch (GetHalfInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::TernaryTensorOp((float)beta, pointers, (float)alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    case InstructionSet::AVX2:
+        return AVX2::TernaryTensorOp((float)beta, pointers, (float)alpha, op, regularOpDims, regularStrides, reducingOpDims);
+    default:
+        break;
+    }
+#else
+    UNUSED(beta); UNUSED(a); UNUSED(b); UNUSED(c); UNUSED(o); UNUSED(alpha); UNUSED(op); UNUSED(offsets);
+    UNUSED(regularOpDims); UNUSED(regularStrides); UNUSED(reducingOpDims);
+#endif
+    return false;
+}
+
+template <class SRC, class DST>
+static void CPUMatrixConvertBufferImpl(DST* dst, const SRC* src, size_t count)
+{
+#ifdef VECTORIZED_TENSOR_OPS_SUPPORTED
+    using namespace VectorizedTensorOps;
+    switch (GetHalfInstructionSet())
+    {
+    case InstructionSet::AVX512:
+        return AVX512::ConvertLoop(dst, src, count);
+    case InstructionSet::AVX2:
+        return AVX2::ConvertLoop(dst, src, count);
+    default:
+        break;
+    }
+#endif
+#pragma omp parallel for if (count >= 32768)
+    for (int64_t i = 0; i < (int64_t)count; i++)
+        dst[i] = (DST)src[i];
+}
+
+void CPUMatrixConvertBuffer(float* dst, const half* src, size_t count)
+{
+    CPUMatrixConvertBufferImpl(dst, src, count);
+}
+
+void CPUMatrixConvertBuffer(half* dst, const float* src, size_t count)
+{
+    CPUMatrixConvertBufferImpl(dst, src, count);
+}
+
+}}}
@@ -0,0 +1,469 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Instruction-set independent body of the vectorized tensor ops (see CPUMatrixTensorVectorized.cpp).
+// Operands are stored as float or half ('T'); all computation happens in float.
+// This file deliberately has no include guard: it is included once per instruction set, inside a namespace
+// that defines the traits struct 'Vec' for that instruction set, and is compiled with the matching target options.
+//
+
+typedef Vec::Type VecType;
+typedef Vec::DoubleType VecDoubleType;
+
+// -----------------------------------------------------------------------
+// helpers
+// -----------------------------------------------------------------------
+
+// load/store n <= Width elements; the remaining lanes are padded with zeroes
+template <class T>
+static inline VecType LoadPartial(const T* p, size_t n)
+{
+    if (n >= Vec::Width)
+        return Vec::Load(p);
+    float buffer[Vec::Width] = {};
+    for (size_t j = 0; j < n; j++)
+        buffer[j] = (float)p[j];
+    return Vec::Load(buffer);
+}
+
+template <class T>
+static inline void StorePartial(T* p, VecType v, size_t n)
+{
+    if (n >= Vec::Width)
+        return Vec::Store(p, v);
+    float buffer[Vec::Width];
+    Vec::Store(buffer, v);
+    for (size_t j = 0; j < n; j++)
+        p[j] = (T)buffer[j];
+}
+
+// scale and combine with the previous value of the target, in the same order as TensorOpIteration does
+template <class T>
+static inline VecType ScaleAndAdd(VecType val, const T* out, size_t n, float alpha, float beta)
+{
+    val = Vec::Mul(val, Vec::Set1(alpha));
+    if (beta != 0)
+        val = Vec::Add(val, Vec::Mul(Vec::Set1(beta), LoadPartial(out, n)));
+    return val;
+}
+
+// -----------------------------------------------------------------------
+// math functions
+// -----------------------------------------------------------------------
+
+// exp() following the Cephes expf() range reduction and polynomial; about 1 ulp off the CRT on average
+static inline VecType Exp(VecType x)
+{
+    const VecType input = x;
+    x = Vec::Min(x, Vec::Set1(88.7228393f));   // ln(FLT_MAX)
+    x = Vec::Max(x, Vec::Set1(-87.3365448f));  // ln(FLT_MIN)
+
+    // exp(x) = 2^n * exp(r), with n = round(x / ln 2) and |r| <= ln(2) / 2
+    VecType n = Vec::Floor(Vec::Add(Vec::Mul(x, Vec::Set1(1.44269504088896341f)), Vec::Set1(0.5f)));
+    x = Vec::Sub(x, Vec::Mul(n, Vec::Set1(0.693359375f)));
+    x = Vec::Sub(x, Vec::Mul(n, Vec::Set1(-2.12194440e-4f)));
+
+    VecType y = Vec::Set1(1.9875691500e-4f);
+    y = Vec::Add(Vec::Mul(y, x), Vec::Set1(1.3981999507e-3f));
+    y = Vec::Add(Vec::Mul(y, x), Vec::Set1(8.3334519073e-3f));
+    y = Vec::Add(Vec::Mul(y, x), Vec::Set1(4.1665795894e-2f));
+    y = Vec::Add(Vec::Mul(y, x), Vec::Set1(1.6666665459e-1f));
+    y = Vec::Add(Vec::Mul(y, x), Vec::Set1(5.0000001201e-1f));
+    y = Vec::Add(Vec::Mul(y, Vec::Mul(x, x)), Vec::Add(x, Vec::Set1(1.0f)));
+
+    // n can be 128 at the upper end, which is not a valid exponent; apply that last factor of 2 separately
+    VecType nClipped = Vec::Min(n, Vec::Set1(127.0f));
+    y = Vec::Mul(Vec::Mul(y, Vec::Pow2(nClipped)), Vec::Pow2(Vec::Sub(n, nClipped)));
+
+    // restore what the clipping above destroyed: overflow, underflow (we flush denormals to 0), and NaNs
+    y = Vec::Select(Vec::Greater(input, Vec::Set1(88.7228393f)), Vec::Set1(std::numeric_limits<float>::infinity()), y);
+    y = Vec::Select(Vec::Less(input, Vec::Set1(-87.3365448f)), Vec::Set1(0.0f), y);
+    return Vec::Select(Vec::IsNaN(input), input, y);
+}
+
+// a > 0 ? a : 0, which maps NaN to 0 like OpLinearRectifier()
+static inline VecType LinearRectifier(VecType x)
+{
+    return Vec::Select(Vec::Greater(x, Vec::Set1(0.0f)), x, Vec::Set1(0.0f));
+}
+
+// same formula as Sigmoid() in TensorOps.h
+static inline VecType Sigmoid(VecType x)
+{
+    const VecType one = Vec::Set1(1.0f);
+    return Vec::Div(one, Vec::Add(Exp(Vec::Negate(x)), one));
+}
+
+// tanh() using the Cephes tanhf() polynomial for small |x|, and 1 - 2 / (exp(2|x|) + 1) otherwise
+static inline VecType Tanh(VecType x)
+{
+    const VecType one = Vec::Set1(1.0f);
+    VecType absX = Vec::Abs(x);
+
+    VecType z = Vec::Mul(x, x);
+    VecType small = Vec::Set1(-5.70498872745e-3f);
+    small = Vec::Add(Vec::Mul(small, z), Vec::Set1(2.06390887954e-2f));
+    small = Vec::Add(Vec::Mul(small, z), Vec::Set1(-5.37397155531e-2f));
+    small = Vec::Add(Vec::Mul(small, z), Vec::Set1(1.33314422036e-1f));
+    small = Vec::Add(Vec::Mul(small, z), Vec::Set1(-3.33332819422e-1f));
+    small = Vec::Add(Vec::Mul(Vec::Mul(small, z), x), x);
+
+    VecType large = Vec::Sub(one, Vec::Div(Vec::Set1(2.0f), Vec::Add(Exp(Vec::Add(absX, absX)), one)));
+    large = Vec::CopySign(large, x);
+
+    return Vec::Select(Vec::Less(absX, Vec::Set1(0.625f)), small, large);
+}
+
+// -----------------------------------------------------------------------
+// elementwise ops, same semantics as the Op* functions in TensorOps.h
+// -----------------------------------------------------------------------
+
+#pragma push_macro("DefVectorizedOp")
+#define DefVectorizedOp(op, expr)                                  \
+    struct VecOp##op                                               \
+    {                                                              \
+        static inline VecType Apply(const VecType* x) { return expr; } \
+    }
+
+DefVectorizedOp(Copy, x[0]);
+DefVectorizedOp(Negate, Vec::Negate(x[0]));
+DefVectorizedOp(Abs, Vec::Abs(x[0]));
+DefVectorizedOp(Reciprocal, Vec::Select(Vec::Equal(x[0], Vec::Set1(0.0f)), Vec::Set1(0.0f), Vec::Div(Vec::Set1(1.0f), x[0])));
+DefVectorizedOp(Sigmoid, Sigmoid(x[0]));
+DefVectorizedOp(Tanh, Tanh(x[0]));
+DefVectorizedOp(Sqr, Vec::Mul(x[0], x[0]));
+DefVectorizedOp(Sqrt, Vec::Sqrt(Vec::Max(x[0], Vec::Set1(0.0f))));
+DefVectorizedOp(Exp, Exp(x[0]));
+DefVectorizedOp(LinearRectifier, LinearRectifier(x[0]));
+
+DefVectorizedOp(Sum, Vec::Add(x[0], x[1]));
+DefVectorizedOp(Difference, Vec::Sub(x[0], x[1]));
+DefVectorizedOp(ElementwiseProduct, Vec::Mul(x[0], x[1]));
+DefVectorizedOp(ElementwiseQuotient, Vec::Div(x[0], Vec::Select(Vec::Less(Vec::Abs(x[1]), Vec::Set1(EPS_IN_INVERSE)),
+                                                                Vec::Select(Vec::Greater(x[1], Vec::Set1(0.0f)), Vec::Set1(EPS_IN_INVERSE), Vec::Set1(-EPS_IN_INVERSE)),
+                                                                x[1])));
+DefVectorizedOp(Max, Vec::Max(x[0], x[1]));
+DefVectorizedOp(Min, Vec::Min(x[0], x[1]));
+DefVectorizedOp(ElementwiseProductWithSigmoidDerivativeFromOutput, Vec::Mul(x[0], Vec::Mul(x[1], Vec::Sub(Vec::Set1(1.0f), x[1]))));
+DefVectorizedOp(ElementwiseProductWithTanhDerivativeFromOutput, Vec::Mul(x[0], Vec::Sub(Vec::Set1(1.0f), Vec::Mul(x[1], x[1]))));
+DefVectorizedOp(ElementwiseProductWithLinearRectifierDerivativeFromOutput, Vec::Select(Vec::Greater(x[1], Vec::Set1(0.0f)), x[0], Vec::Set1(0.0f)));
+DefVectorizedOp(SqrOfDifference, Vec::Mul(Vec::Sub(x[0], x[1]), Vec::Sub(x[0], x[1])));
+DefVectorizedOp(LinearRectifierOfSum, LinearRectifier(Vec::Add(x[0], x[1])));
+DefVectorizedOp(SigmoidOfSum, Sigmoid(Vec::Add(x[0], x[1])));
+DefVectorizedOp(TanhOfSum, Tanh(Vec::Add(x[0], x[1])));
+DefVectorizedOp(LinearRectifierOfElementwiseProduct, LinearRectifier(Vec::Mul(x[0], x[1])));
+DefVectorizedOp(SigmoidOfElementwiseProduct, Sigmoid(Vec::Mul(x[0], x[1])));
+DefVectorizedOp(TanhOfElementwiseProduct, Tanh(Vec::Mul(x[0], x[1])));
+
+DefVectorizedOp(Cond, Vec::Select(Vec::NotEqual(x[0], Vec::Set1(0.0f)), x[1], x[2]));
+DefVectorizedOp(CopyIfEqual, Vec::Select(Vec::Equal(x[0], x[1]), x[2], Vec::Set1(0.0f)));
+DefVectorizedOp(Clip, Vec::Select(Vec::Less(x[2], x[0]), x[0], Vec::Select(Vec::Greater(x[2], x[1]), x[1], x[2])));
+DefVectorizedOp(ElementwiseProductWithExpOfDiff, Vec::Mul(x[0], Exp(Vec::Sub(x[1], x[2]))));
+DefVectorizedOp(ElementwiseProductWithSigmoidDerivativeFromOutputAndFactor, Vec::Mul(Vec::Mul(x[0], Vec::Mul(x[1], Vec::Sub(Vec::Set1(1.0f), x[1]))), x[2]));
+DefVectorizedOp(ElementwiseProductWithTanhDerivativeFromOutputAndFactor, Vec::Mul(Vec::Mul(x[0], Vec::Sub(Vec::Set1(1.0f), Vec::Mul(x[1], x[1]))), x[2]));
+DefVectorizedOp(ElementwiseProductWithLinearRectifierDerivativeFromOutputAndFactor, Vec::Select(Vec::Greater(x[1], Vec::Set1(0.0f)), Vec::Mul(x[0], x[2]), Vec::Set1(0.0f)));
+
+#pragma pop_macro("DefVectorizedOp")
+
+// reductions, aggregating in double like TensorOpReduction
+struct VecReduceSum
+{
+    static inline VecDoubleType Apply(VecDoubleType a, VecDoubleType b) { return Vec::DoubleAdd(a, b); }
+    static inline double Apply(double a, double b) { return a + b; }
+    static inline float Neutral() { return 0.0f; }
+};
+
+struct VecReduceMax
+{
+    static inline VecDoubleType Apply(VecDoubleType a, VecDoubleType b) { return Vec::DoubleMax(a, b); }
+    static inline double Apply(double a, double b) { return a > b ? a : b; }
+    static inline float Neutral() { return -std::numeric_limits<float>::infinity(); }
+};
+
+struct VecReduceMin
+{
+    static inline VecDoubleType Apply(VecDoubleType a, VecDoubleType b) { return Vec::DoubleMin(a, b); }
+    static inline double Apply(double a, double b) { return a < b ? a : b; }
+    static inline float Neutral() { return std::numeric_limits<float>::infinity(); }
+};
+
+// -----------------------------------------------------------------------
+// loops
+// -----------------------------------------------------------------------
+
+// elementwise op without reduction; the innermost dimension is contiguous for the output and contiguous or broadcasting for the inputs
+template <class OP, size_t N, class T>
+static void ElementwiseLoop(float beta, const array<T*, N>& pointers, float alpha,
+                            const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, N>& regularStrides)
+{
+    const size_t K = regularOpDims[0];
+    const size_t numRows = NumElements(regularOpDims, 1);
+    const size_t numChunks = (K + ChunkSize - 1) / ChunkSize;
+    const int64_t numTasks = (int64_t)(numRows * numChunks);
+#pragma omp parallel for if (numRows * K >= ParallelThreshold)
+    for (int64_t task = 0; task < numTasks; task++)
+    {
+        const size_t row = (size_t)task / numChunks;
+        const size_t begin = ((size_t)task % numChunks) * ChunkSize;
+        const size_t end = min(K, begin + ChunkSize);
+        const array<ptrdiff_t, N> offsets = IndexToOffsets(row, regularOpDims, regularStrides, 1);
+
+        const T* in[N - 1];
+        bool isBroadcast[N - 1];
+        VecType x[N - 1];
+        for (size_t i = 0; i < N - 1; i++)
+        {
+            in[i] = pointers[i] + offsets[i];
+            isBroadcast[i] = regularStrides[i][0] == 0;
+            if (isBroadcast[i])
+                x[i] = Vec::Set1((float)*in[i]);
+        }
+        T* out = pointers[N - 1] + offsets[N - 1];
+
+        for (size_t k = begin; k < end; k += Vec::Width)
+        {
+            const size_t n = min(end - k, Vec::Width);
+            for (size_t i = 0; i < N - 1; i++)
+            {
+                if (!isBroadcast[i])
+                    x[i] = LoadPartial(in[i] + k, n);
+            }
+            StorePartial(out + k, ScaleAndAdd(OP::Apply(x), out + k, n, alpha, beta), n);
+        }
+    }
+}
+
+// unary op with a single reduction dimension of arbitrary stride, where the innermost regular dimension
+// is contiguous for input and output. We vectorize across neighboring outputs, each lane reducing in the
+// same sequential order as TensorOpReduction, so that e.g. sums are bitwise identical to the generic path.
+template <class OP, class REDUCE, class T>
+static void ReduceStridedLoop(float beta, const array<T*, 2>& pointers, float alpha,
+                              const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+                              const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 2>& reducingStrides)
+{
+    const size_t K = regularOpDims[0];
+    const size_t numRows = NumElements(regularOpDims, 1);
+    const size_t numChunks = (K + ChunkSize - 1) / ChunkSize;
+    const int64_t numTasks = (int64_t)(numRows * numChunks);
+    const size_t R = reducingOpDims[0];
+    const ptrdiff_t reducingStride = reducingStrides[0][0];
+    const size_t BlockWidth = 4 * Vec::Width; // outputs reduced together, so that each pass over R touches whole cache lines
+#pragma omp parallel for if (numRows * K * R >= ParallelThreshold)
+    for (int64_t task = 0; task < numTasks; task++)
+    {
+        const size_t row = (size_t)task / numChunks;
+        const size_t begin = ((size_t)task % numChunks) * ChunkSize;
+        const size_t end = min(K, begin + ChunkSize);
+        const array<ptrdiff_t, 2> offsets = IndexToOffsets(row, regularOpDims, regularStrides, 1);
+        const T* in = pointers[0] + offsets[0];
+        T* out = pointers[1] + offsets[1];
+
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BlockWidth)
+        {
+            const size_t blockEnd = min(end, blockBegin + BlockWidth);
+            VecDoubleType aggregateLow[4], aggregateHigh[4];
+            for (size_t r = 0; r < R; r++)
+            {
+                const T* p = in + (ptrdiff_t)r * reducingStride;
+                for (size_t k = blockBegin, j = 0; k < blockEnd; k += Vec::Width, j++)
+                {
+                    VecType x = LoadPartial(p + k, blockEnd - k);
+                    VecType v = OP::Apply(&x);
+                    if (r == 0)
+                    {
+                        aggregateLow[j] = Vec::ToDoubleLow(v);
+                        aggregateHigh[j] = Vec::ToDoubleHigh(v);
+                    }
+                    else
+                    {
+                        aggregateLow[j] = REDUCE::Apply(aggregateLow[j], Vec::ToDoubleLow(v));
+                        aggregateHigh[j] = REDUCE::Apply(aggregateHigh[j], Vec::ToDoubleHigh(v));
+                    }
+                }
+            }
+            for (size_t k = blockBegin, j = 0; k < blockEnd; k += Vec::Width, j++)
+            {
+                const size_t n = min(blockEnd - k, Vec::Width);
+                StorePartial(out + k, ScaleAndAdd(Vec::FromDouble(aggregateLow[j], aggregateHigh[j]), out + k, n, alpha, beta), n);
+            }
+        }
+    }
+}
+
+// unary op with a single, contiguous reduction dimension, e.g. the sum over all elements or over each column.
+// Each output is reduced with Width lanes that are combined at the end, so the summation order differs from the generic path.
+template <class OP, class REDUCE, class T>
+static void ReduceContiguousLoop(float beta, const array<T*, 2>& pointers, float alpha,
+                                 const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+                                 const SmallVector<size_t>& reducingOpDims)
+{
+    const size_t numOutputs = NumElements(regularOpDims, 0);
+    const size_t R = reducingOpDims[0];
+#pragma omp parallel for if (numOutputs > 1 && numOutputs * R >= ParallelThreshold)
+    for (int64_t index = 0; index < (int64_t)numOutputs; index++)
+    {
+        const array<ptrdiff_t, 2> offsets = IndexToOffsets((size_t)index, regularOpDims, regularStrides, 0);
+        const T* in = pointers[0] + offsets[0];
+        T* out = pointers[1] + offsets[1];
+
+        VecType x = Vec::Load(in); // R >= Width
+        VecType v = OP::Apply(&x);
+        VecDoubleType aggregateLow = Vec::ToDoubleLow(v);
+        VecDoubleType aggregateHigh = Vec::ToDoubleHigh(v);
+        for (size_t r = Vec::Width; r < R; r += Vec::Width)
+        {
+            const size_t n = min(R - r, Vec::Width);
+            x = LoadPartial(in + r, n);
+            v = OP::Apply(&x);
+            if (n < Vec::Width)
+                v = Vec::Select(Vec::FirstLanes(n), v, Vec::Set1(REDUCE::Neutral()));
+            aggregateLow = REDUCE::Apply(aggregateLow, Vec::ToDoubleLow(v));
+            aggregateHigh = REDUCE::Apply(aggregateHigh, Vec::ToDoubleHigh(v));
+        }
+
+        double lanes[Vec::Width];
+        Vec::DoubleStore(lanes, aggregateLow);
+        Vec::DoubleStore(lanes + Vec::Width / 2, aggregateHigh);
+        double aggregate = lanes[0];
+        for (size_t j = 1; j < Vec::Width; j++)
+            aggregate = REDUCE::Apply(aggregate, lanes[j]);
+
+        float val = (float)aggregate * alpha;
+        if (beta != 0)
+            val += beta * (float)*out;
+        *out = (T)val;
+    }
+}
+
+// -----------------------------------------------------------------------
+// entry points; return false if the op or the layout is not covered, to fall back to the generic path
+// -----------------------------------------------------------------------
+
+template <class REDUCE, class T>
+static bool UnaryReduction(float beta, const array<T*, 2>& pointers, float alpha, ElementWiseOperator op,
+                           const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+                           const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 2>& reducingStrides)
+{
+    if (reducingOpDims.size() != 1)
+        return false;
+    const bool isStrided = IsContiguousInnermostDim(regularOpDims, regularStrides, Vec::Width, /*allowBroadcast=*/false);
+    const bool isContiguous = reducingStrides[0][0] == 1 && reducingOpDims[0] >= Vec::Width;
+
+#define CaseVectorizedReduction(oper)                                                                                                             \
+    case ElementWiseOperator::op##oper:                                                                                                           \
+        if (isStrided)                                                                                                                            \
+            ReduceStridedLoop<VecOp##oper, REDUCE>(beta, pointers, alpha, regularOpDims, regularStrides, reducingOpDims, reducingStrides);       \
+        else if (isContiguous)                                                                                                                    \
+            ReduceContiguousLoop<VecOp##oper, REDUCE>(beta, pointers, alpha, regularOpDims, regularStrides, reducingOpDims);                    \
+        else                                                                                                                                      \
+            return false;                                                                                                                         \
+        return true
+
+    switch (op)
+    {
+        ForAllVectorizedUnaryOps(CaseVectorizedReduction);
+    default:
+        return false;
+    }
+#undef CaseVectorizedReduction
+}
+
+template <class T>
+static bool UnaryTensorOp(float beta, const array<T*, 2>& pointers, float alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+                          const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+                          const SmallVector<size_t>& reducingOpDims, const array<SmallVector<ptrdiff_t>, 2>& reducingStrides)
+{
+    if (!reducingOpDims.empty())
+    {
+        switch (reductionOp)
+        {
+        case ElementWiseOperator::opSum:
+            return UnaryReduction<VecReduceSum>(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        case ElementWiseOperator::opMax:
+            return UnaryReduction<VecReduceMax>(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        case ElementWiseOperator::opMin:
+            return UnaryReduction<VecReduceMin>(beta, pointers, alpha, op, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+        default:
+            return false;
+        }
+    }
+
+    if (!IsContiguousInnermostDim(regularOpDims, regularStrides, Vec::Width, /*allowBroadcast=*/true))
+        return false;
+
+#define CaseVectorizedUnaryOp(oper)                                                                    \
+    case ElementWiseOperator::op##oper:                                                                \
+        ElementwiseLoop<VecOp##oper, 2>(beta, pointers, alpha, regularOpDims, regularStrides);         \
+        return true
+
+    switch (op)
+    {
+        ForAllVectorizedUnaryOps(CaseVectorizedUnaryOp);
+    default:
+        return false;
+    }
+#undef CaseVectorizedUnaryOp
+}
+
+template <class T>
+static bool BinaryTensorOp(float beta, const array<T*, 3>& pointers, float alpha, ElementWiseOperator op,
+                           const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 3>& regularStrides,
+                           const SmallVector<size_t>& reducingOpDims)
+{
+    if (!reducingOpDims.empty() || !IsContiguousInnermostDim(regularOpDims, regularStrides, Vec::Width, /*allowBroadcast=*/true))
+        return false;
+
+#define CaseVectorizedBinaryOp(oper)                                                                   \
+    case ElementWiseOperator::op##oper:                                                                \
+        ElementwiseLoop<VecOp##oper, 3>(beta, pointers, alpha, regularOpDims, regularStrides);         \
+        return true
+
+    switch (op)
+    {
+        ForAllVectorizedBinaryOps(CaseVectorizedBinaryOp);
+    default:
+        return false;
+    }
+#undef CaseVectorizedBinaryOp
+}
+
+template <class T>
+static bool TernaryTensorOp(float beta, const array<T*, 4>& pointers, float alpha, ElementWiseOperator op,
+                            const SmallVector<size_t>& regularOpDims, const array<SmallVector<ptrdiff_t>, 4>& regularStrides,
+                            const SmallVector<size_t>& reducingOpDims)
+{
+    if (!reducingOpDims.empty() || !IsContiguousInnermostDim(regularOpDims, regularStrides, Vec::Width, /*allowBroadcast=*/true))
+        return false;
+
+#define CaseVectorizedTernaryOp(oper)                                                                  \
+    case ElementWiseOperator::op##oper:                                                                \
+        ElementwiseLoop<VecOp##oper, 4>(beta, pointers, alpha, regularOpDims, regularStrides);         \
+        return true
+
+    switch (op)
+    {
+        ForAllVectorizedTernaryOps(CaseVectorizedTernaryOp);
+    default:
+        return false;
+    }
+#undef CaseVectorizedTernaryOp
+}
+
+// conversion between the storage types, e.g. to pack half-precision GEMM operands into float panels
+template <class SRC, class DST>
+static void ConvertLoop(DST* dst, const SRC* src, size_t count)
+{
+    const int64_t numChunks = (int64_t)((count + ChunkSize - 1) / ChunkSize);
+#pragma omp parallel for if (count >= ParallelThreshold)
+    for (int64_t chunk = 0; chunk < numChunks; chunk++)
+    {
+        const size_t begin = (size_t)chunk * ChunkSize;
+        const size_t end = min(count, begin + ChunkSize);
+        for (size_t i = begin; i < end; i += Vec::Width)
+        {
+            const size_t n = min(end - i, Vec::Width);
+            StorePartial(dst + i, LoadPartial(src + i, n), n);
+        }
+    }
+}
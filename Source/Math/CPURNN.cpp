@@ -0,0 +1,545 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "CPURNN.h"
+#include <assert.h>
+#include <cmath>
+#include <string.h>
+#include <algorithm>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+template <class T>
+static inline T Sigmoid(T x)
+{
+    return 1 / (1 + std::exp(-x));
+}
+
+template <class ElemType>
+CPURNNExecutor<ElemType>::CPURNNExecutor(size_t xDim, size_t yDim, const RnnAttributes& rnnAttributes)
+    : m_rnnAttributes(rnnAttributes),
+      m_hiddenSize(rnnAttributes.m_hiddenSize),
+      m_xDim(xDim), m_yDim(yDim),
+      m_numSamples(0),
+      m_BackwardDataCalledYet(false)
+{
+    if      (m_rnnAttributes.m_recurrentOp == wstring(L"lstm"))    { m_cellType = CellType::LSTM;    m_numGates = 4; }
+    else if (m_rnnAttributes.m_recurrentOp == wstring(L"gru"))     { m_cellType = CellType::GRU;     m_numGates = 3; }
+    else if (m_rnnAttributes.m_recurrentOp == wstring(L"rnnReLU")) { m_cellType = CellType::RNNReLU; m_numGates = 1; }
+    else if (m_rnnAttributes.m_recurrentOp == wstring(L"rnnTanh")) { m_cellType = CellType::RNNTanh; m_numGates = 1; }
+    else InvalidArgument("Unknown cell type '%ls'. Supported values are 'lstm', 'gru', 'rnnReLU', 'rnnTanh'.", m_rnnAttributes.m_recurrentOp.c_str());
+
+    if (m_yDim != NumDirections() * m_hiddenSize)
+        InvalidArgument("CPU RNN: Output leading dimension must be twice hidden size for bidirectional networks");
+
+    const size_t numLayers = m_rnnAttributes.m_numLayers;
+    const bool hasAux = m_cellType == CellType::LSTM || m_cellType == CellType::GRU;
+
+    // parameters: all weight matrices, followed by all biases (same as cudnnGetRNNLinLayerMatrixParams())
+    size_t offset = 0;
+    for (size_t layer = 0; layer < numLayers; layer++)
+    {
+        for (size_t dir = 0; dir < NumDirections(); dir++)
+        {
+            m_offsetW.push_back(offset);
+            offset += LayerInputDim(layer) * GateDim();
+            m_offsetR.push_back(offset);
+            offset += m_hiddenSize * GateDim();
+        }
+    }
+    for (size_t layer = 0; layer < numLayers; layer++)
+    {
+        for (size_t dir = 0; dir < NumDirections(); dir++)
+        {
+            m_offsetBiasW.push_back(offset);
+            offset += GateDim();
+            m_offsetBiasR.push_back(offset);
+            offset += GateDim();
+        }
+    }
+    m_numParameters = offset;
+
+    // reserve: per layer and direction the gate activations, the hidden state, and the cell state (LSTM)
+    // or the recurrent projection of the GRU candidate; plus the output of every layer that feeds another one
+    size_t rows = 0;
+    for (size_t ld = 0; ld < numLayers * NumDirections(); ld++)
+    {
+        m_reserveGates.push_back(rows);
+        rows += GateDim();
+        m_reserveHidden.push_back(rows);
+        rows += m_hiddenSize;
+        m_reserveAux.push_back(rows);
+        rows += hasAux ? m_hiddenSize : 0;
+    }
+    for (size_t layer = 0; layer + 1 < numLayers; layer++)
+    {
+        m_reserveLayerOutput.push_back(rows);
+        rows += m_yDim;
+    }
+    m_reserveRows = rows;
+
+    // workspace: per layer and direction the gate gradients, and for GRU the separate gradient that enters the
+    // recurrent projection; plus temporaries for the gradients that flow along time and between layers
+    rows = 0;
+    for (size_t ld = 0; ld < numLayers * NumDirections(); ld++)
+    {
+        m_workspaceDGates.push_back(rows);
+        rows += GateDim();
+        m_workspaceDRecurrent.push_back(m_cellType == CellType::GRU ? rows : m_workspaceDGates.back());
+        rows += m_cellType == CellType::GRU ? GateDim() : 0;
+    }
+    m_workspaceDHidden = rows;
+    rows += m_hiddenSize;
+    m_workspaceDRecurrentHidden = rows;
+    rows += m_hiddenSize;
+    m_workspaceDRecurrentCell = rows;
+    rows += m_cellType == CellType::LSTM ? m_hiddenSize : 0;
+    for (size_t i = 0; i < 2; i++)
+    {
+        m_workspaceDLayer[i] = rows;
+        rows += numLayers > 1 ? m_yDim : 0;
+    }
+    m_workspaceRows = rows;
+}
+
+template <class ElemType>
+size_t CPURNNExecutor<ElemType>::PreviousFrame(size_t t, bool backward, size_t& numWithPrevious) const
+{
+    // Sequences are sorted by decreasing length, so the sequences of a frame are a prefix of those of the frame
+    // before. Going forward, all sequences of frame t continue from frame t-1. Going backward, only the first
+    // numSequencesForFrame[t+1] do; the others start at frame t, with a zero state.
+    if (!backward)
+    {
+        numWithPrevious = t > 0 ? m_numSequencesForFrame[t] : 0;
+        return t - 1;
+    }
+    else
+    {
+        numWithPrevious = t + 1 < m_numSequencesForFrame.size() ? m_numSequencesForFrame[t + 1] : 0;
+        return t + 1;
+    }
+}
+
+template <class ElemType>
+CPUMatrix<ElemType> CPURNNExecutor<ElemType>::SampleBlock(const CPUMatrix<ElemType>& buffer, size_t rowOffset, size_t rows) const
+{
+    assert((rowOffset + rows) * m_numSamples <= buffer.GetNumElements());
+    return CPUMatrix<ElemType>(rows, m_numSamples, buffer.Data() + rowOffset * m_numSamples, matrixFlagDontOwnBuffer);
+}
+
+template <class ElemType>
+/*static*/ CPUMatrix<ElemType> CPURNNExecutor<ElemType>::FlatBlock(const CPUMatrix<ElemType>& params, size_t offset, size_t rows, size_t cols)
+{
+    assert(offset + rows * cols <= params.GetNumElements());
+    return CPUMatrix<ElemType>(rows, cols, params.Data() + offset, matrixFlagDontOwnBuffer);
+}
+
+template <class ElemType>
+/*static*/ void CPURNNExecutor<ElemType>::CopyRowsOut(const CPUMatrix<ElemType>& from, size_t rowOffset, CPUMatrix<ElemType>& to)
+{
+    const size_t rows = to.GetNumRows();
+    const ElemType* src = from.Data();
+    ElemType* dst = to.Data();
+#pragma omp parallel for
+    for (long j = 0; j < (long) to.GetNumCols(); j++)
+    {
+        const ElemType* col = src + j * from.GetNumRows() + rowOffset;
+        std::copy(col, col + rows, dst + j * rows);
+    }
+}
+
+template <class ElemType>
+/*static*/ void CPURNNExecutor<ElemType>::CopyRowsIn(const CPUMatrix<ElemType>& from, CPUMatrix<ElemType>& to, size_t rowOffset)
+{
+    const size_t rows = from.GetNumRows();
+    const ElemType* src = from.Data();
+    ElemType* dst = to.Data();
+#pragma omp parallel for
+    for (long j = 0; j < (long) from.GetNumCols(); j++)
+        std::copy(src + j * rows, src + (j + 1) * rows, dst + j * to.GetNumRows() + rowOffset);
+}
+
+// One frame of one layer/direction, all gates fused into a single pass over the data.
+// On entry, 'gates' holds the input projections (incl. bW), 'recurrent' the recurrent projections R^T h
+// of the first 'numWithPrevious' sequences. On exit, 'gates' holds the gate activations.
+template <class ElemType>
+void CPURNNExecutor<ElemType>::ForwardStep(ElemType* gates, const ElemType* recurrent, const ElemType* biasR, const ElemType* prevHidden, const ElemType* prevCell,
+                                           ElemType* hidden, ElemType* aux, size_t numSequences, size_t numWithPrevious) const
+{
+    const size_t H = m_hiddenSize;
+    const size_t G = GateDim();
+    const CellType cellType = m_cellType;
+
+#pragma omp parallel for if (numSequences * G >= 4096)
+    for (long s = 0; s < (long) numSequences; s++)
+    {
+        ElemType* x = gates + s * G;
+        const ElemType* r = (size_t) s < numWithPrevious ? recurrent + s * G : nullptr;
+        ElemType* h = hidden + s * H;
+        switch (cellType)
+        {
+        case CellType::LSTM:
+        {
+            ElemType* c = aux + s * H;
+            const ElemType* cPrev = r ? prevCell + s * H : nullptr;
+            for (size_t k = 0; k < H; k++)
+            {
+                ComputeType pi = (ComputeType) x[k]         + (ComputeType) biasR[k]         + (r ? (ComputeType) r[k]         : 0);
+                ComputeType pf = (ComputeType) x[k + H]     + (ComputeType) biasR[k + H]     + (r ? (ComputeType) r[k + H]     : 0);
+                ComputeType pg = (ComputeType) x[k + 2 * H] + (ComputeType) biasR[k + 2 * H] + (r ? (ComputeType) r[k + 2 * H] : 0);
+                ComputeType po = (ComputeType) x[k + 3 * H] + (ComputeType) biasR[k + 3 * H] + (r ? (ComputeType) r[k + 3 * H] : 0);
+                ComputeType i = Sigmoid(pi), f = Sigmoid(pf), g = std::tanh(pg), o = Sigmoid(po);
+                ComputeType ct = i * g + (cPrev ? f * (ComputeType) cPrev[k] : 0);
+                x[k] = (ElemType) i; x[k + H] = (ElemType) f; x[k + 2 * H] = (ElemType) g; x[k + 3 * H] = (ElemType) o;
+                c[k] = (ElemType) ct;
+                h[k] = (ElemType) (o * std::tanh(ct));
+            }
+            break;
+        }
+        case CellType::GRU:
+        {
+            ElemType* rh = aux + s * H;
+            const ElemType* hPrev = r ? prevHidden + s * H : nullptr;
+            for (size_t k = 0; k < H; k++)
+            {
+                ComputeType pr = (ComputeType) x[k]     + (ComputeType) biasR[k]     + (r ? (ComputeType) r[k]     : 0);
+                ComputeType pz = (ComputeType) x[k + H] + (ComputeType) biasR[k + H] + (r ? (ComputeType) r[k + H] : 0);
+                ComputeType rhk = (ComputeType) biasR[k + 2 * H] + (r ? (ComputeType) r[k + 2 * H] : 0);
+                ComputeType rt = Sigmoid(pr), zt = Sigmoid(pz);
+                ComputeType nt = std::tanh((ComputeType) x[k + 2 * H] + rt * rhk);
+                ComputeType ht = (1 - zt) * nt + (hPrev ? zt * (ComputeType) hPrev[k] : 0);
+                x[k] = (ElemType) rt; x[k + H] = (ElemType) zt; x[k + 2 * H] = (ElemType) nt;
+                rh[k] = (ElemType) rhk;
+                h[k] = (ElemType) ht;
+            }
+            break;
+        }
+        case CellType::RNNReLU:
+        case CellType::RNNTanh:
+        {
+            for (size_t k = 0; k < H; k++)
+            {
+                ComputeType p = (ComputeType) x[k] + (ComputeType) biasR[k] + (r ? (ComputeType) r[k] : 0);
+                ComputeType ht = cellType == CellType::RNNTanh ? std::tanh(p) : std::max(p, (ComputeType) 0);
+                x[k] = (ElemType) ht;
+                h[k] = (ElemType) ht;
+            }
+            break;
+        }
+        }
+    }
+}
+
+// Gradient of one frame of one layer/direction. 'dRecurrentHidden' and 'dRecurrentCell' are updated in place:
+// on entry they hold the gradients that flow back from the next frame for the first 'numValidRecurrent'
+// sequences; on exit, the cell gradient for the previous frame (first 'numWithPrevious' sequences), and,
+// for GRU, the direct (non-projected) part of the hidden gradient for the previous frame.
+template <class ElemType>
+void CPURNNExecutor<ElemType>::BackwardStep(const ElemType* gates, const ElemType* hidden, const ElemType* aux, const ElemType* prevHidden, const ElemType* prevCell, const ElemType* dHidden,
+                                            ElemType* dRecurrentHidden, ElemType* dRecurrentCell, ElemType* dGates, ElemType* dRecurrent,
+                                            size_t numSequences, size_t numValidRecurrent, size_t numWithPrevious) const
+{
+    const size_t H = m_hiddenSize;
+    const size_t G = GateDim();
+    const CellType cellType = m_cellType;
+
+#pragma omp parallel for if (numSequences * G >= 4096)
+    for (long s = 0; s < (long) numSequences; s++)
+    {
+        const ElemType* x = gates + s * G;
+        const ElemType* dh = dHidden + s * H;
+        ElemType* dhRec = dRecurrentHidden + s * H;
+        ElemType* dx = dGates + s * G;
+        const bool hasRecurrent = (size_t) s < numValidRecurrent;
+        const bool hasPrevious = (size_t) s < numWithPrevious;
+        switch (cellType)
+        {
+        case CellType::LSTM:
+        {
+            const ElemType* c = aux + s * H;
+            ElemType* dcRec = dRecurrentCell + s * H;
+            for (size_t k = 0; k < H; k++)
+            {
+                ComputeType i = x[k], f = x[k + H], g = x[k + 2 * H], o = x[k + 3 * H];
+                ComputeType dht = (ComputeType) dh[k] + (hasRecurrent ? (ComputeType) dhRec[k] : 0);
+                ComputeType tc = std::tanh((ComputeType) c[k]);
+                ComputeType dct = dht * o * (1 - tc * tc) + (hasRecurrent ? (ComputeType) dcRec[k] : 0);
+                ComputeType cPrev = hasPrevious ? (ComputeType) prevCell[s * H + k] : 0;
+                dx[k]         = (ElemType) (dct * g * i * (1 - i));
+                dx[k + H]     = (ElemType) (dct * cPrev * f * (1 - f));
+                dx[k + 2 * H] = (ElemType) (dct * i * (1 - g * g));
+                dx[k + 3 * H] = (ElemType) (dht * tc * o * (1 - o));
+                dcRec[k] = (ElemType) (dct * f);
+            }
+            break;
+        }
+        case CellType::GRU:
+        {
+            const ElemType* rh = aux + s * H;
+            ElemType* dr = dRecurrent + s * G;
+            for (size_t k = 0; k < H; k++)
+            {
+                ComputeType rt = x[k], zt = x[k + H], nt = x[k + 2 * H];
+                ComputeType dht = (ComputeType) dh[k] + (hasRecurrent ? (ComputeType) dhRec[k] : 0);
+                ComputeType hPrev = hasPrevious ? (ComputeType) prevHidden[s * H + k] : 0;
+                ComputeType dn = dht * (1 - zt) * (1 - nt * nt);
+                ComputeType dpr = dn * (ComputeType) rh[k] * rt * (1 - rt);
+                ComputeType dpz = dht * (hPrev - nt) * zt * (1 - zt);
+                dx[k] = dr[k] = (ElemType) dpr;
+                dx[k + H] = dr[k + H] = (ElemType) dpz;
+                dx[k + 2 * H] = (ElemType) dn;
+                dr[k + 2 * H] = (ElemType) (dn * rt);
+                dhRec[k] = (ElemType) (dht * zt);
+            }
+            break;
+        }
+        case CellType::RNNReLU:
+        case CellType::RNNTanh:
+        {
+            const ElemType* h = hidden + s * H;
+            for (size_t k = 0; k < H; k++)
+            {
+                ComputeType ht = h[k];
+                ComputeType dht = (ComputeType) dh[k] + (hasRecurrent ? (ComputeType) dhRec[k] : 0);
+                dx[k] = (ElemType) (cellType == CellType::RNNTanh ? dht * (1 - ht * ht) : (ht > 0 ? dht : 0));
+            }
+            break;
+        }
+        }
+    }
+}
+
+template <class ElemType>
+void CPURNNExecutor<ElemType>::ForwardCore(
+    const CPUMatrix<ElemType>& weightsW,
+    const CPUMatrix<ElemType>& inputX, CPUMatrix<ElemType>& outputY,
+    const vector<size_t>& numSequencesForFrame,
+    const RnnAttributes& rnnAttributes,
+    CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    // test that the RNN shape is correct
+    if (!(m_rnnAttributes == rnnAttributes))
+        LogicError("RNN Layout has changed during processing");
+    if (weightsW.GetNumElements() != m_numParameters)
+        InvalidArgument("RNN needs %ld parameters, but %ld were allocated", (long) m_numParameters, (long) weightsW.GetNumElements());
+
+    m_numSequencesForFrame = numSequencesForFrame;
+    m_frameOffset.assign(1, 0);
+    for (auto n : m_numSequencesForFrame)
+        m_frameOffset.push_back(m_frameOffset.back() + n);
+    m_numSamples = m_frameOffset.back();
+    if (inputX.GetNumRows() != m_xDim || inputX.GetNumCols() != m_numSamples)
+        InvalidArgument("CPU RNN: Input is %d x %d, but the RNN expects %d x %d", (int) inputX.GetNumRows(), (int) inputX.GetNumCols(), (int) m_xDim, (int) m_numSamples);
+
+    reserve.Resize(m_reserveRows * m_numSamples, 1);
+    workspace.Resize(GateDim() * m_numSamples, 1);
+    outputY.Resize(m_yDim, m_numSamples);
+    if (m_numSamples == 0)
+        return;
+
+    const size_t H = m_hiddenSize;
+    const size_t numLayers = m_rnnAttributes.m_numLayers;
+    const size_t numFrames = m_numSequencesForFrame.size();
+    auto recurrent = SampleBlock(workspace, 0, GateDim()); // R^T h of the current frame
+    for (size_t layer = 0; layer < numLayers; layer++)
+    {
+        auto layerInput  = layer == 0             ? FlatBlock(inputX, 0, m_xDim, m_numSamples) : SampleBlock(reserve, m_reserveLayerOutput[layer - 1], m_yDim);
+        auto layerOutput = layer + 1 == numLayers ? FlatBlock(outputY, 0, m_yDim, m_numSamples) : SampleBlock(reserve, m_reserveLayerOutput[layer], m_yDim);
+        for (size_t dir = 0; dir < NumDirections(); dir++)
+        {
+            const size_t ld = layer * NumDirections() + dir;
+            const bool backward = dir == 1;
+            auto W = FlatBlock(weightsW, m_offsetW[ld], LayerInputDim(layer), GateDim());
+            auto R = FlatBlock(weightsW, m_offsetR[ld], H, GateDim());
+            const ElemType* biasW = weightsW.Data() + m_offsetBiasW[ld];
+            const ElemType* biasR = weightsW.Data() + m_offsetBiasR[ld];
+            auto gates  = SampleBlock(reserve, m_reserveGates[ld], GateDim());
+            auto hidden = SampleBlock(reserve, m_reserveHidden[ld], H);
+            ElemType* aux = reserve.Data() + m_reserveAux[ld] * m_numSamples;
+
+            // input projection of all frames in one go
+            CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, W, true, layerInput, false, (ElemType) 0, gates);
+            ElemType* gatesData = gates.Data();
+#pragma omp parallel for
+            for (long j = 0; j < (long) m_numSamples; j++)
+                for (size_t k = 0; k < GateDim(); k++)
+                    gatesData[j * GateDim() + k] += biasW[k];
+
+            for (size_t step = 0; step < numFrames; step++)
+            {
+                const size_t t = backward ? numFrames - 1 - step : step;
+                size_t numWithPrevious;
+                const size_t prev = PreviousFrame(t, backward, numWithPrevious);
+                if (numWithPrevious > 0)
+                {
+                    auto prevHidden = hidden.ColumnSlice(m_frameOffset[prev], numWithPrevious);
+                    auto frameRecurrent = recurrent.ColumnSlice(0, numWithPrevious);
+                    CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, R, true, prevHidden, false, (ElemType) 0, frameRecurrent);
+                }
+                const size_t col = m_frameOffset[t];
+                const size_t prevCol = numWithPrevious > 0 ? m_frameOffset[prev] : 0;
+                ForwardStep(gatesData + col * GateDim(), recurrent.Data(), biasR,
+                            hidden.Data() + prevCol * H, aux + prevCol * H,
+                            hidden.Data() + col * H, aux + col * H,
+                            m_numSequencesForFrame[t], numWithPrevious);
+            }
+
+            CopyRowsIn(hidden, layerOutput, dir * H);
+        }
+    }
+    m_BackwardDataCalledYet = false;
+}
+
+template <class ElemType>
+void CPURNNExecutor<ElemType>::BackwardDataCore(
+    const CPUMatrix<ElemType>& outputY, const CPUMatrix<ElemType>& outputDY, const CPUMatrix<ElemType>& weightsW, CPUMatrix<ElemType>& dx,
+    const RnnAttributes& rnnAttributes,
+    CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    UNUSED(outputY);
+    // test that the RNN shape is correct
+    if (!(m_rnnAttributes == rnnAttributes))
+        LogicError("RNN Layout has changed during processing");
+    if (m_BackwardDataCalledYet)
+        return;
+    if (outputDY.GetNumRows() != m_yDim || outputDY.GetNumCols() != m_numSamples)
+        InvalidArgument("CPU RNN: Output gradient does not match the last forward pass");
+
+    workspace.Resize(m_workspaceRows * m_numSamples, 1);
+    dx.Resize(m_xDim, m_numSamples);
+    if (m_numSamples == 0)
+    {
+        m_BackwardDataCalledYet = true;
+        return;
+    }
+
+    const size_t H = m_hiddenSize;
+    const size_t numLayers = m_rnnAttributes.m_numLayers;
+    const size_t numFrames = m_numSequencesForFrame.size();
+    auto dHidden = SampleBlock(workspace, m_workspaceDHidden, H);
+    auto dRecurrentHidden = SampleBlock(workspace, m_workspaceDRecurrentHidden, H);
+    ElemType* dRecurrentCell = workspace.Data() + m_workspaceDRecurrentCell * m_numSamples;
+    for (size_t layer = numLayers; layer-- > 0;)
+    {
+        auto layerDOutput = layer + 1 == numLayers ? FlatBlock(outputDY, 0, m_yDim, m_numSamples) : SampleBlock(workspace, m_workspaceDLayer[layer % 2], m_yDim);
+        auto layerDInput  = layer == 0             ? FlatBlock(dx, 0, m_xDim, m_numSamples)        : SampleBlock(workspace, m_workspaceDLayer[(layer - 1) % 2], m_yDim);
+        for (size_t dir = 0; dir < NumDirections(); dir++)
+        {
+            const size_t ld = layer * NumDirections() + dir;
+            const bool backward = dir == 1;
+            auto W = FlatBlock(weightsW, m_offsetW[ld], LayerInputDim(layer), GateDim());
+            auto R = FlatBlock(weightsW, m_offsetR[ld], H, GateDim());
+            const ElemType* gates  = reserve.Data() + m_reserveGates[ld] * m_numSamples;
+            const ElemType* hidden = reserve.Data() + m_reserveHidden[ld] * m_numSamples;
+            const ElemType* aux    = reserve.Data() + m_reserveAux[ld] * m_numSamples;
+            auto dGates     = SampleBlock(workspace, m_workspaceDGates[ld], GateDim());
+            auto dRecurrent = SampleBlock(workspace, m_workspaceDRecurrent[ld], GateDim());
+
+            CopyRowsOut(layerDOutput, dir * H, dHidden);
+
+            // walk the frames in the reverse order of the forward pass
+            size_t numValidRecurrent = 0;
+            for (size_t step = 0; step < numFrames; step++)
+            {
+                const size_t t = backward ? step : numFrames - 1 - step;
+                size_t numWithPrevious;
+                const size_t prev = PreviousFrame(t, backward, numWithPrevious);
+                const size_t col = m_frameOffset[t];
+                const size_t prevCol = numWithPrevious > 0 ? m_frameOffset[prev] : 0;
+                BackwardStep(gates + col * GateDim(), hidden + col * H, aux + col * H,
+                             hidden + prevCol * H, aux + prevCol * H, dHidden.Data() + col * H,
+                             dRecurrentHidden.Data(), dRecurrentCell, dGates.Data() + col * GateDim(), dRecurrent.Data() + col * GateDim(),
+                             m_numSequencesForFrame[t], numValidRecurrent, numWithPrevious);
+                if (numWithPrevious > 0)
+                {
+                    // gradient w.r.t. the previous hidden state, through the recurrent weights
+                    auto frameDRecurrent = dRecurrent.ColumnSlice(col, numWithPrevious);
+                    auto prevDHidden = dRecurrentHidden.ColumnSlice(0, numWithPrevious);
+                    CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, R, false, frameDRecurrent, false, (ElemType) (m_cellType == CellType::GRU ? 1 : 0), prevDHidden);
+                }
+                numValidRecurrent = numWithPrevious;
+            }
+
+            // gradient w.r.t. the layer input, for all frames in one go; the two directions add up
+            CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, W, false, dGates, false, (ElemType) (dir == 0 ? 0 : 1), layerDInput);
+        }
+    }
+    m_BackwardDataCalledYet = true;
+}
+
+template <class ElemType>
+void CPURNNExecutor<ElemType>::BackwardWeightsCore(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& outputY, CPUMatrix<ElemType>& dw, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace)
+{
+    UNUSED(outputY);
+    // test that the RNN shape is correct
+    if (!(m_rnnAttributes == rnnAttributes))
+        LogicError("RNN Layout has changed during processing");
+    if (!m_BackwardDataCalledYet)
+        LogicError("CPU RNN: BackwardWeights() was called before BackwardData() for the last forward pass.");
+    if (dw.GetNumElements() != m_numParameters)
+        InvalidArgument("RNN needs %ld parameters, but %ld were allocated", (long) m_numParameters, (long) dw.GetNumElements());
+    if (m_numSamples == 0)
+        return;
+
+    // like cuDNN, the weight gradients are accumulated into 'dw'
+    const size_t H = m_hiddenSize;
+    const size_t numLayers = m_rnnAttributes.m_numLayers;
+    const size_t numFrames = m_numSequencesForFrame.size();
+    auto prevHidden = SampleBlock(workspace, m_workspaceDHidden, H); // dHidden is no longer needed
+    for (size_t layer = 0; layer < numLayers; layer++)
+    {
+        auto layerInput = layer == 0 ? FlatBlock(inputX, 0, m_xDim, m_numSamples) : SampleBlock(reserve, m_reserveLayerOutput[layer - 1], m_yDim);
+        for (size_t dir = 0; dir < NumDirections(); dir++)
+        {
+            const size_t ld = layer * NumDirections() + dir;
+            const bool backward = dir == 1;
+            auto dW = FlatBlock(dw, m_offsetW[ld], LayerInputDim(layer), GateDim());
+            auto dR = FlatBlock(dw, m_offsetR[ld], H, GateDim());
+            ElemType* dBiasW = dw.Data() + m_offsetBiasW[ld];
+            ElemType* dBiasR = dw.Data() + m_offsetBiasR[ld];
+            auto hidden     = SampleBlock(reserve, m_reserveHidden[ld], H);
+            auto dGates     = SampleBlock(workspace, m_workspaceDGates[ld], GateDim());
+            auto dRecurrent = SampleBlock(workspace, m_workspaceDRecurrent[ld], GateDim());
+
+            CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, layerInput, false, dGates, true, (ElemType) 1, dW);
+
+            // line up the previous hidden state of every sample (zero at sequence starts), so that dR is a single GEMM as well
+            for (size_t t = 0; t < numFrames; t++)
+            {
+                size_t numWithPrevious;
+                const size_t prev = PreviousFrame(t, backward, numWithPrevious);
+                ElemType* dst = prevHidden.Data() + m_frameOffset[t] * H;
+                if (numWithPrevious > 0)
+                {
+                    const ElemType* prevFrame = hidden.Data() + m_frameOffset[prev] * H;
+                    std::copy(prevFrame, prevFrame + numWithPrevious * H, dst);
+                }
+                std::fill(dst + numWithPrevious * H, dst + m_numSequencesForFrame[t] * H, (ElemType) 0);
+            }
+            CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, prevHidden, false, dRecurrent, true, (ElemType) 1, dR);
+
+            const ElemType* dGatesData = dGates.Data();
+            const ElemType* dRecurrentData = dRecurrent.Data();
+#pragma omp parallel for
+            for (long k = 0; k < (long) GateDim(); k++)
+            {
+                ComputeType sumW = 0, sumR = 0;
+                for (size_t j = 0; j < m_numSamples; j++)
+                {
+                    sumW += (ComputeType) dGatesData[j * GateDim() + k];
+                    sumR += (ComputeType) dRecurrentData[j * GateDim() + k];
+                }
+                dBiasW[k] = (ElemType) ((ComputeType) dBiasW[k] + sumW);
+                dBiasR[k] = (ElemType) ((ComputeType) dBiasR[k] + sumR);
+            }
+        }
+    }
+}
+
+template class CPURNNExecutor<float>;
+template class CPURNNExecutor<double>;
+template class CPURNNExecutor<half>;
+
+}}}
@@ -0,0 +1,106 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#pragma once
+
+#include "CPUMatrix.h"
+#include "RNNCommon.h"
+#include <vector>
+#include <type_traits>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// CPURNNExecutor -- CPU implementation of the OptimizedRNNStack (cuDNN RNN) operation
+//
+// This is a drop-in for CuDnnRNNExecutor: it consumes the same packed parameter vector
+// (cuDNN canonical layout, so that models trained on GPU run unchanged on CPU) and the
+// same 'dense CuDNN packing' of the data, i.e. time-major columns where frame t holds the
+// numSequencesForFrame[t] longest sequences. MBLayout gaps are removed by that packing.
+//
+// Parameter layout, per layer l and direction d (forward first):
+//   W[l,d]: inputDim x (numGates * hidden), column j = gate * hidden + unit
+//   R[l,d]: hidden   x (numGates * hidden)
+// followed by, again per layer and direction, the two bias vectors bW[l,d] and bR[l,d].
+// Gate order is i, f, c, o for LSTM and r, z, h for GRU, as in cuDNN. The GRU is cuDNN's
+// variant, where the reset gate is applied after the recurrent projection:
+//   h' = tanh(W_h x + bW_h + r .* (R_h h + bR_h)).
+//
+// For each layer and direction, the input projection for all time steps is a single GEMM.
+// The time loop then only does the recurrent GEMM, followed by one fused pass that applies
+// all gate nonlinearities and the cell update for a frame.
+//
+// 'reserve' keeps the activations needed for backprop between the calls, and 'workspace'
+// the gate gradients between BackwardDataCore() and BackwardWeightsCore().
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class CPURNNExecutor
+{
+    // elementwise math is done in at least single precision, also for half
+    typedef typename std::conditional<std::is_same<ElemType, double>::value, double, float>::type ComputeType;
+
+public:
+    CPURNNExecutor(size_t xDim, size_t yDim, const RnnAttributes& rnnAttributes);
+
+    void ForwardCore(const CPUMatrix<ElemType>& weightsW, const CPUMatrix<ElemType>& inputX, CPUMatrix<ElemType>& outputY, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+    void BackwardWeightsCore(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& outputY, CPUMatrix<ElemType>& dw, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+    void BackwardDataCore(const CPUMatrix<ElemType>& outputY, const CPUMatrix<ElemType>& outputDY, const CPUMatrix<ElemType>& w, CPUMatrix<ElemType>& dx, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& reserve, CPUMatrix<ElemType>& workspace);
+
+private:
+    enum class CellType
+    {
+        LSTM,
+        GRU,
+        RNNReLU,
+        RNNTanh
+    };
+
+    size_t NumDirections() const { return m_rnnAttributes.m_bidirectional ? 2 : 1; }
+    size_t LayerInputDim(size_t layer) const { return layer == 0 ? m_xDim : NumDirections() * m_hiddenSize; }
+    size_t GateDim() const { return m_numGates * m_hiddenSize; }
+
+    // frame whose hidden state feeds frame t, and for how many of the sequences of frame t it exists
+    size_t PreviousFrame(size_t t, bool backward, size_t& numWithPrevious) const;
+
+    // a (rows x numSamples) matrix view of a block of rows of a buffer that is laid out in units of numSamples columns
+    CPUMatrix<ElemType> SampleBlock(const CPUMatrix<ElemType>& buffer, size_t rowOffset, size_t rows) const;
+    // a (rows x cols) matrix view at a flat offset into a buffer, e.g. the parameter vector
+    static CPUMatrix<ElemType> FlatBlock(const CPUMatrix<ElemType>& params, size_t offset, size_t rows, size_t cols);
+
+    void ForwardStep(ElemType* gates, const ElemType* recurrent, const ElemType* biasR, const ElemType* prevHidden, const ElemType* prevCell,
+                     ElemType* hidden, ElemType* aux, size_t numSequences, size_t numWithPrevious) const;
+    void BackwardStep(const ElemType* gates, const ElemType* hidden, const ElemType* aux, const ElemType* prevHidden, const ElemType* prevCell, const ElemType* dHidden,
+                      ElemType* dRecurrentHidden, ElemType* dRecurrentCell, ElemType* dGates, ElemType* dRecurrent,
+                      size_t numSequences, size_t numValidRecurrent, size_t numWithPrevious) const;
+
+    // copy rows [rowOffset, rowOffset + rows) of each column of 'from' into 'to', or the reverse
+    static void CopyRowsOut(const CPUMatrix<ElemType>& from, size_t rowOffset, CPUMatrix<ElemType>& to);
+    static void CopyRowsIn(const CPUMatrix<ElemType>& from, CPUMatrix<ElemType>& to, size_t rowOffset);
+
+    RnnAttributes m_rnnAttributes;
+    CellType m_cellType;
+    size_t m_numGates;
+    size_t m_hiddenSize;
+    size_t m_xDim, m_yDim;
+
+    // offsets into the parameter vector, indexed by layer * NumDirections() + direction
+    std::vector<size_t> m_offsetW, m_offsetR, m_offsetBiasW, m_offsetBiasR;
+    size_t m_numParameters;
+
+    // row offsets into 'reserve' and 'workspace', which hold (rows x numSamples) blocks
+    std::vector<size_t> m_reserveGates, m_reserveHidden, m_reserveAux, m_reserveLayerOutput;
+    size_t m_reserveRows;
+    std::vector<size_t> m_workspaceDGates, m_workspaceDRecurrent;
+    size_t m_workspaceDHidden, m_workspaceDRecurrentHidden, m_workspaceDRecurrentCell, m_workspaceDLayer[2];
+    size_t m_workspaceRows;
+
+    // the packing of the current minibatch
+    std::vector<size_t> m_numSequencesForFrame;
+    std::vector<size_t> m_frameOffset; // first column of frame t
+    size_t m_numSamples;
+    bool m_BackwardDataCalledYet;
+};
+
+}}}
@@ -773,6 +773,54 @@ void CPUSparseMatrix<ElemType>::SetMatrixFromSBCFormat(const size_t* blockIds, c
     memcpy(Data(), val, sizeof(ElemType)*numBlocks*numRows);
 }
 
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::GetCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const
+{
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Expected sparse block col matrix");
+
+    std::fill(cpuCol2BlockId, cpuCol2BlockId + GetNumCols(), SparseIndex_NotAssigned);
+    for (size_t blockId = 0; blockId < GetBlockSize(); blockId++)
+        cpuCol2BlockId[GetBlockIds()[blockId] - GetBlockIdShift()] = (GPUSPARSE_INDEX_TYPE)blockId;
+}
+
+// Rearranges the blocks such that column j is stored in block cpuCol2BlockId[j], columns that get a block they did not
+// have before are zero. Every column that has a block must have one in cpuCol2BlockId too.
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks)
+{
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Expected sparse block col matrix");
+
+    if (!OwnBuffer())
+        LogicError("Cannot modify since the buffer is managed externally.");
+
+    size_t numRows = GetNumRows();
+    size_t numCols = GetNumCols();
+    std::vector<ElemType> blockValues(numBlocks * numRows, 0);
+    for (size_t blockId = 0; blockId < GetBlockSize(); blockId++)
+    {
+        size_t col = GetBlockIds()[blockId] - GetBlockIdShift();
+        GPUSPARSE_INDEX_TYPE newBlockId = cpuCol2BlockId[col];
+        if (newBlockId == SparseIndex_NotAssigned || newBlockId >= (GPUSPARSE_INDEX_TYPE)numBlocks)
+            LogicError("AdjustCol2BlockId: column %d has a block but no valid block is assigned to it.", (int)col);
+
+        memcpy(blockValues.data() + newBlockId * numRows, Data() + blockId * numRows, sizeof(ElemType) * numRows);
+    }
+
+    RequireSizeAndAllocate(numRows, numCols, numBlocks * numRows, /*growOnly=*/ true, /*keepExistingValues=*/ false);
+    for (size_t col = 0; col < numCols; col++)
+    {
+        if (cpuCol2BlockId[col] != SparseIndex_NotAssigned)
+            GetBlockIds()[cpuCol2BlockId[col]] = col;
+    }
+
+    SetBlockSize(numBlocks);
+    SetBlockIdShift(0);
+    if (numBlocks > 0)
+        memcpy(Data(), blockValues.data(), sizeof(ElemType) * numBlocks * numRows);
+}
+
 template <class ElemType>
 ElemType* CPUSparseMatrix<ElemType>::Data()  const
 {
@@ -1897,6 +1945,7 @@ template void CPUSparseMatrix<char>::Reset(void);
 template void CPUSparseMatrix<char>::Resize(const size_t, const size_t, const size_t, const bool);
 template void CPUSparseMatrix<char>::RequireSizeAndAllocate(const size_t, const size_t, const size_t, const bool, bool);
 template void CPUSparseMatrix<char>::RequireSizeAndAllocate(const size_t, const size_t, const size_t, const MatrixFormat, const bool, bool);
+template void CPUSparseMatrix<char>::AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks);
 template CPUSparseMatrix<char>::~CPUSparseMatrix();
 template CPUSparseMatrix<char> CPUSparseMatrix<char>::ColumnSlice(size_t startColumn, size_t numCols) const;
 template CPUMatrix<char> CPUSparseMatrix<char>::CopyColumnSliceToDense(size_t startColumn, size_t numCols) const;
@@ -1922,6 +1971,7 @@ template void CPUSparseMatrix<short>::Reset(void);
 template void CPUSparseMatrix<short>::Resize(const size_t, const size_t, const size_t, const bool);
 template void CPUSparseMatrix<short>::RequireSizeAndAllocate(const size_t, const size_t, const size_t, const bool, bool);
 template void CPUSparseMatrix<short>::RequireSizeAndAllocate(const size_t, const size_t, const size_t, const MatrixFormat, const bool, bool);
+template void CPUSparseMatrix<short>::AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks);
 template CPUSparseMatrix<short>::~CPUSparseMatrix();
 template CPUSparseMatrix<short> CPUSparseMatrix<short>::ColumnSlice(size_t startColumn, size_t numCols) const;
 template CPUMatrix<short> CPUSparseMatrix<short>::CopyColumnSliceToDense(size_t startColumn, size_t numCols) const;
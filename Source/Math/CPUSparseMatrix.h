@@ -125,6 +125,10 @@ public:
 
     void SetMatrixFromSBCFormat(const size_t* blockIds, const ElemType* val, const size_t numBlocks, const size_t numRows, const size_t numCols);
 
+    // Sparse block column counterparts of the GPU col2BlockId functions, the CPU format keeps only the block ids.
+    void GetCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const;
+    void AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks);
+
     // Dense * Sparse -> Dense
     static void MultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& lhs, const bool transposeA,
                                        const CPUSparseMatrix<ElemType>& rhs, const bool transposeB, ElemType beta, CPUMatrix<ElemType>& c);
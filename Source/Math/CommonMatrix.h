@@ -112,6 +112,9 @@ enum ElementWiseOperator
     opElementwiseProductWithAbsDerivative, opElementwiseProductWithSqrtDerivative,
     opElementwiseProductWithReciprocalDerivative, opSqrOfDifference,
     opElementwiseProductWithExponentialLinearUnitDerivativeFromOutput,
+    // binary ops followed by an activation, for fused elementwise nodes
+    opLinearRectifierOfSum, opSigmoidOfSum, opTanhOfSum,
+    opLinearRectifierOfElementwiseProduct, opSigmoidOfElementwiseProduct, opTanhOfElementwiseProduct,
     // binary ops for indexing
     // opIndex,
     // ternary
@@ -123,6 +126,9 @@ enum ElementWiseOperator
     opElementwiseProductWithQuotient, /* a * (b / c) */
     opElementwiseProductWithPowExponentDerivative, /* a * b * log(c) */
     opElementwiseProductWithPowBaseDerivative,  /* a * c * pow(b, c-1) */
+    opElementwiseProductWithSigmoidDerivativeFromOutputAndFactor,         /* a * b * (1 - b) * c */
+    opElementwiseProductWithTanhDerivativeFromOutputAndFactor,            /* a * (1 - b * b) * c */
+    opElementwiseProductWithLinearRectifierDerivativeFromOutputAndFactor, /* b > 0 ? a * c : 0 */
     // Note: not all that's implemented in CNTK ComputationNodes has an opcode yet.
 };
 
@@ -192,18 +198,27 @@ enum ElementWiseOperator
     Macro(ElementwiseProductWithReciprocalDerivative);                       \
     Macro(ElementwiseProductWithSqrtDerivative);                             \
     Macro(SqrOfDifference);                                                  \
-    Macro(ElementwiseProductWithExponentialLinearUnitDerivativeFromOutput);
+    Macro(ElementwiseProductWithExponentialLinearUnitDerivativeFromOutput);  \
+    Macro(LinearRectifierOfSum);                                             \
+    Macro(SigmoidOfSum);                                                     \
+    Macro(TanhOfSum);                                                        \
+    Macro(LinearRectifierOfElementwiseProduct);                              \
+    Macro(SigmoidOfElementwiseProduct);                                      \
+    Macro(TanhOfElementwiseProduct);
     //Macro(Index);
 
-#define ForAllTernaryOps(Macro)                         \
-    Macro(Cond);                                        \
-    Macro(CopyIfEqual);                                 \
-    Macro(Clip);                                        \
-    Macro(ElementwiseProductWithLogSumDerivative);      \
-    Macro(ElementwiseProductWithExpOfDiff);             \
-    Macro(ElementwiseProductWithQuotient);              \
-    Macro(ElementwiseProductWithPowExponentDerivative); \
-    Macro(ElementwiseProductWithPowBaseDerivative);
+#define ForAllTernaryOps(Macro)                                               \
+    Macro(Cond);                                                              \
+    Macro(CopyIfEqual);                                                       \
+    Macro(Clip);                                                              \
+    Macro(ElementwiseProductWithLogSumDerivative);                            \
+    Macro(ElementwiseProductWithExpOfDiff);                                   \
+    Macro(ElementwiseProductWithQuotient);                                    \
+    Macro(ElementwiseProductWithPowExponentDerivative);                       \
+    Macro(ElementwiseProductWithPowBaseDerivative);                           \
+    Macro(ElementwiseProductWithSigmoidDerivativeFromOutputAndFactor);        \
+    Macro(ElementwiseProductWithTanhDerivativeFromOutputAndFactor);           \
+    Macro(ElementwiseProductWithLinearRectifierDerivativeFromOutputAndFactor);
 
 // -----------------------------------------------------------------------
 // various enums to describe
@@ -283,7 +298,8 @@ public:
         {
             if (m_computeDevice < 0)
             {
-                delete[] m_pArray;
+                if (!HasBorrowedBuffer())
+                    delete[] m_pArray;
                 m_pArray = nullptr;
                 m_nzValues = nullptr;
 
@@ -299,7 +315,7 @@ public:
             else
             {
 #ifndef CPUONLY
-                if (m_pArray != nullptr)
+                if (m_pArray != nullptr && !HasBorrowedBuffer())
                     TracingGPUMemoryAllocator::Free<ElemType>(m_computeDevice, m_pArray, true);
                 m_pArray = nullptr;
 
@@ -314,6 +330,7 @@ public:
             }
             m_elemSizeAllocated = 0;
             m_totalBufferSizeAllocated = 0;
+            m_bufferOwner = nullptr;
         }
     }
 
@@ -322,6 +339,7 @@ protected:
     void SetFormat(MatrixFormat format) { m_format = format; }
 
     bool HasExternalBuffer() const { return m_externalBuffer; }
+    bool HasBorrowedBuffer() const { return m_bufferOwner != nullptr; }
 
     DEVICEID_TYPE GetComputeDeviceId() const { return m_computeDevice; }
     void SetComputeDeviceId(const DEVICEID_TYPE computeId) const { m_computeDevice = computeId; }
@@ -339,7 +357,14 @@ protected:
     bool IsEmpty() const { return m_numRows == 0 || m_numCols == 0; }
 
     ElemType* Buffer() const { return m_pArray; }
-    void SetBuffer(ElemType* pArray, size_t alloc, bool external = false) { m_pArray = pArray; m_totalBufferSizeAllocated = alloc; m_externalBuffer = external; }
+    void SetBuffer(ElemType* pArray, size_t alloc, bool external = false) { m_pArray = pArray; m_totalBufferSizeAllocated = alloc; m_externalBuffer = external; m_bufferOwner = nullptr; }
+    // use a range of a buffer that belongs to 'bufferOwner' (which is kept alive by this), see BaseMatrix::BorrowBuffer()
+    void SetBorrowedBuffer(ElemType* pArray, size_t numElements, const shared_ptr<void>& bufferOwner)
+    {
+        SetBuffer(pArray, numElements * sizeof(ElemType));
+        m_elemSizeAllocated = numElements;
+        m_bufferOwner = bufferOwner;
+    }
 
     size_t BufferSizeAllocated() const { return m_totalBufferSizeAllocated; }
     
@@ -388,6 +413,7 @@ protected:
     void ZeroInit(const MatrixFormat matrixFormat = matrixFormatDense, const DEVICEID_TYPE computeDevice = -1)
     {
         m_externalBuffer           = false;
+        m_bufferOwner              = nullptr;
         m_format                   = matrixFormat;
         m_computeDevice            = computeDevice;
         m_numRows                  = 0;
@@ -416,6 +442,7 @@ protected:
     MatrixFormat m_format;
     mutable DEVICEID_TYPE m_computeDevice; // current GPU device Id or CPUDEVICE
     bool m_externalBuffer; // is the buffer used by this matrix,
+    shared_ptr<void> m_bufferOwner; // if not null, m_pArray is borrowed from this object (e.g. a MatrixPool arena) and must not be freed
 
     // m_numRows and m_numCols should be removed
     size_t m_numRows;
@@ -513,6 +540,21 @@ public:
 
     bool OwnBuffer() const { return !HasExternalBuffer(); }
 
+    // Let this matrix use 'numElements' elements at 'pArray' as its storage; the memory belongs to 'bufferOwner', which is kept alive
+    // as long as the matrix uses it. Unlike an external buffer, the matrix remains resizable: it reshapes in place as long as the new
+    // size fits, and moves to an allocation of its own once it needs to grow. This is how MatrixPool places matrices into its arena.
+    void BorrowBuffer(ElemType* pArray, size_t numElements, const shared_ptr<void>& bufferOwner)
+    {
+        VerifyResizable(__FUNCTION__);
+        if (GetFormat() != matrixFormatDense)
+            LogicError("BorrowBuffer: Only dense matrices can borrow a buffer.");
+        m_sob->ReleaseMemory();
+        m_sob->SetBorrowedBuffer(pArray, numElements, bufferOwner);
+        m_numRows = 0;
+        m_numCols = 0;
+        m_sliceViewOffset = 0;
+    }
+
     bool IsEmpty() const { return m_numRows == 0 || m_numCols == 0; }
 
     size_t GetSizeAllocated() const { return m_sob->GetSizeAllocated(); }
@@ -529,6 +571,7 @@ protected:
     void SetFormat(MatrixFormat format) { m_sob->SetFormat(format); }
 
     bool HasExternalBuffer() const { return m_sob->HasExternalBuffer(); }
+    bool HasBorrowedBuffer() const { return m_sob->HasBorrowedBuffer(); }
 
     DEVICEID_TYPE GetComputeDeviceId() const { return m_sob->GetComputeDeviceId(); }
     void SetComputeDeviceId(const DEVICEID_TYPE computeId) const { m_sob->SetComputeDeviceId(computeId); }
@@ -570,6 +570,8 @@ public:
     {
     }
 
+    bool ImplementsQuantizedForward() const override { return true; }
+
 protected:
     using typename Base::IntMatPtr;
 
@@ -578,6 +580,7 @@ protected:
     using Base::m_imageLayout;
     using Base::m_maxTempMemSizeInSamples;
     using Base::m_poolIncludePad;
+    using Base::m_pQuantizedMultiplier;
 
     using Base::m_mpRowCol;
     using Base::m_mpRowIwht;
@@ -611,10 +614,11 @@ protected:
     //    [XYC x NW'H']^T * [XYC x K] -> [NW'H' x K]
     // 3. Reshape and transpose result: [NW'H' x K] -> [N x W'H'K]^T -> [W'H'K x N]
     //    In case minibatch size == 1 this step is not required and step 2 writes results directly to output (out).
+    // With a quantized multiplier, step 2 is done by the multiplier with the unrolled input as activation and kernel as weight.
     void ForwardCore(const Mat& in, const Mat& kernel, Mat& out, Mat& workspace) override
     {
 #ifdef USE_MKL2017DNN
-        if (ForwardCoreMKL(in, kernel, out)) return;
+        if (m_pQuantizedMultiplier == nullptr && ForwardCoreMKL(in, kernel, out)) return;
 #endif
 
         size_t batchSize = in.GetNumCols();
@@ -656,7 +660,7 @@ protected:
             {
                 auto outSlice = out.ColumnSlice(start, 1);
                 outSlice.Reshape(mapOutSize, mapCount);
-                Mat::Multiply(unrolledInput, true, kern, false, outSlice);
+                Mat::MultiplyAndWeightedAdd(1, unrolledInput, true, kern, false, 0, outSlice, m_pQuantizedMultiplier);
             }
             else
             {
@@ -667,7 +671,7 @@ protected:
                     outTempSlice = outTempSlice.ColumnSlice(0, curBatchSize * mapCount);
                     outTempSlice.Reshape(mapOutSize * curBatchSize, mapCount);
                 }
-                Mat::Multiply(unrolledInput, true, kern, false, outTempSlice);
+                Mat::MultiplyAndWeightedAdd(1, unrolledInput, true, kern, false, 0, outTempSlice, m_pQuantizedMultiplier);
                 outTempSlice.Reshape(curBatchSize, mapOutSize * mapCount);
                 auto outSlice = out.ColumnSlice(start, curBatchSize);
                 outSlice.AssignTransposeOf(outTempSlice);
@@ -1148,6 +1152,298 @@ public:
     }
 };
 
+//------------------------------------------------------------------
+// Direct convolution engine for the small, stride-1 kernels that dominate CNN inference on CPU.
+// The forward convolution is computed without the unrolled input of the GEMM engine:
+// * 3x3 kernels use Winograd minimal filtering F(m x m, 3 x 3) (Lavin and Gray, "Fast Algorithms for Convolutional
+//   Neural Networks", 2015): each (m + 2) x (m + 2) input tile and each kernel are transformed, the transforms are
+//   multiplied with one GEMM per transformed element, and the products transformed back into m x m output tiles.
+//   This needs 2.25x (m = 4) or 4x (m = 2) the input as temp memory instead of 9x, and fewer multiplications.
+// * 1x1 kernels are a single GEMM per sample, directly on the [WH x C] input.
+// The backward methods, and the forward method with a quantized multiplier, are those of the GEMM engine.
+//------------------------------------------------------------------
+
+// Transforms of Winograd F(m x m, 3 x 3), as in the paper above: output tile = AT * [(G g GT) .* (BT d B)] * A
+template <size_t m>
+struct WinogradTransform;
+
+template <>
+struct WinogradTransform<2>
+{
+    static const size_t Alpha = 4;
+    static const float* BT() { static const float bt[Alpha * Alpha] = { 1, 0, -1, 0,  0, 1, 1, 0,  0, -1, 1, 0,  0, 1, 0, -1 }; return bt; }
+    static const float* G() { static const float g[Alpha * 3] = { 1, 0, 0,  0.5f, 0.5f, 0.5f,  0.5f, -0.5f, 0.5f,  0, 0, 1 }; return g; }
+    static const float* AT() { static const float at[2 * Alpha] = { 1, 1, 1, 0,  0, 1, -1, -1 }; return at; }
+};
+
+template <>
+struct WinogradTransform<4>
+{
+    static const size_t Alpha = 6;
+    static const float* BT()
+    {
+        static const float bt[Alpha * Alpha] = { 4, 0, -5, 0, 1, 0,
+                                                 0, -4, -4, 1, 1, 0,
+                                                 0, 4, -4, -1, 1, 0,
+                                                 0, -2, -1, 2, 1, 0,
+                                                 0, 2, -1, -2, 1, 0,
+                                                 0, 4, 0, -5, 0, 1 };
+        return bt;
+    }
+    static const float* G()
+    {
+        static const float g[Alpha * 3] = { 1.0f / 4, 0, 0,
+                                            -1.0f / 6, -1.0f / 6, -1.0f / 6,
+                                            -1.0f / 6, 1.0f / 6, -1.0f / 6,
+                                            1.0f / 24, 1.0f / 12, 1.0f / 6,
+                                            1.0f / 24, -1.0f / 12, 1.0f / 6,
+                                            0, 0, 1 };
+        return g;
+    }
+    static const float* AT() { static const float at[4 * Alpha] = { 1, 1, 1, 1, 1, 0,  0, 1, -1, 2, -2, 0,  0, 1, 1, 4, 4, 0,  0, 1, -1, 8, -8, 1 }; return at; }
+};
+
+// out = T * in * T^T for a rows x cols matrix T (row-major) and a cols x cols matrix in (row-major), which gives a rows x rows matrix
+template <class ElemType>
+static inline void WinogradSandwich(const float* t, size_t rows, size_t cols, const ElemType* in, ElemType* tmp, ElemType* out)
+{
+    for (size_t i = 0; i < rows; i++)
+    {
+        for (size_t b = 0; b < cols; b++)
+        {
+            ElemType sum = 0;
+            for (size_t a = 0; a < cols; a++)
+                sum += t[i * cols + a] * in[a * cols + b];
+            tmp[i * cols + b] = sum;
+        }
+    }
+    for (size_t i = 0; i < rows; i++)
+    {
+        for (size_t j = 0; j < rows; j++)
+        {
+            ElemType sum = 0;
+            for (size_t b = 0; b < cols; b++)
+                sum += tmp[i * cols + b] * t[j * cols + b];
+            out[i * rows + j] = sum;
+        }
+    }
+}
+
+template <class ElemType>
+class DirectConvolutionEngine : public GemmConvolutionEngine<ElemType>
+{
+public:
+    using Base = GemmConvolutionEngine<ElemType>;
+    using typename Base::Mat;
+
+public:
+    DirectConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind, bool poolIncludePad)
+        : Base(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad),
+        m_transformedKernel(deviceId)
+    {
+        const auto& inT = m_geometry->InputShape();
+        const auto& outT = m_geometry->OutputShape();
+        m_inW = inT[0];
+        m_inH = inT[1];
+        m_inC = inT[2];
+        m_outW = outT[0];
+        m_outH = outT[1];
+        m_mapCount = m_geometry->GetMapCount(2);
+        m_kernelSize = m_geometry->KernelShape()[0];
+        m_padW = m_geometry->GetLowerPad(0);
+        m_padH = m_geometry->GetLowerPad(1);
+        // F(4x4, 3x3) does less than half the multiplications of F(2x2, 3x3), but wastes more on partial tiles of small maps.
+        m_tileSize = (m_outW >= 8 && m_outH >= 8) ? 4 : 2;
+    }
+
+protected:
+    using Base::m_geometry;
+    using Base::m_maxTempMemSizeInSamples;
+    using Base::m_pQuantizedMultiplier;
+
+    void ForwardCore(const Mat& in, const Mat& kernel, Mat& out, Mat& workspace) override
+    {
+        if (m_pQuantizedMultiplier != nullptr)
+            return Base::ForwardCore(in, kernel, out, workspace);
+
+        if (m_kernelSize == 1)
+            Forward1x1(in, kernel, out);
+        else if (m_tileSize == 4)
+            ForwardWinograd<4>(in, kernel, out, workspace);
+        else
+            ForwardWinograd<2>(in, kernel, out, workspace);
+    }
+
+    // [WH x C] * [C x K] -> [WH x K] for each sample; kernels are stored as rows of a [K x C] matrix, i.e. as [C x K].
+    void Forward1x1(const Mat& in, const Mat& kernel, Mat& out)
+    {
+        size_t mapSize = m_inW * m_inH;
+        auto kern = kernel.ColumnSlice(0, kernel.GetNumCols());
+        kern.Reshape(m_inC, m_mapCount);
+        for (size_t n = 0; n < in.GetNumCols(); n++)
+        {
+            auto inSlice = in.ColumnSlice(n, 1);
+            inSlice.Reshape(mapSize, m_inC);
+            auto outSlice = out.ColumnSlice(n, 1);
+            outSlice.Reshape(mapSize, m_mapCount);
+            Mat::MultiplyAndWeightedAdd(1, inSlice, false, kern, false, 0, outSlice);
+        }
+    }
+
+    // Using the notation of the GEMM engine, with T the number of tiles in a sub-batch and A = (m + 2)^2 transformed elements:
+    // 1. Transform kernels: [XYC x K] -> [C x AK], i.e. a [C x K] matrix for each transformed element.
+    // 2. Transform input tiles: [WHC x N] -> [T x AC], i.e. a [T x C] matrix for each transformed element.
+    // 3. Multiply: [T x C] * [C x K] -> [T x K] for each transformed element, giving [T x AK].
+    // 4. Transform back to output tiles: [T x AK] -> [W'H'K x N].
+    template <size_t m>
+    void ForwardWinograd(const Mat& in, const Mat& kernel, Mat& out, Mat& workspace)
+    {
+        typedef WinogradTransform<m> Transform;
+        const size_t alpha = Transform::Alpha;
+        const size_t numElements = alpha * alpha;
+
+        // 1. Kernel transform, U = G g GT.
+        m_transformedKernel.Resize(m_inC, numElements * m_mapCount);
+        const ElemType* pKernel = kernel.Data();
+        ElemType* pU = m_transformedKernel.Data();
+#pragma omp parallel for
+        for (int64_t kc = 0; kc < (int64_t)(m_mapCount * m_inC); kc++)
+        {
+            size_t k = (size_t)kc / m_inC;
+            size_t c = (size_t)kc % m_inC;
+            ElemType g[3 * 3], tmp[alpha * 3], u[alpha * alpha];
+            for (size_t x = 0; x < 3; x++)
+                for (size_t y = 0; y < 3; y++)
+                    g[x * 3 + y] = pKernel[k * 9 * m_inC + c * 9 + y * 3 + x];
+            WinogradSandwich(Transform::G(), alpha, 3, g, tmp, u);
+            for (size_t e = 0; e < numElements; e++)
+                pU[c + m_inC * (e * m_mapCount + k)] = u[e];
+        }
+
+        size_t batchSize = in.GetNumCols();
+        size_t subBatchSize = m_maxTempMemSizeInSamples == 0 ? batchSize : min(batchSize, m_maxTempMemSizeInSamples);
+        size_t tilesW = (m_outW + m - 1) / m;
+        size_t tilesH = (m_outH + m - 1) / m;
+        size_t tilesPerSample = tilesW * tilesH;
+        workspace.Resize(1, tilesPerSample * subBatchSize * numElements * (m_inC + m_mapCount));
+
+        for (size_t start = 0; start < batchSize; start += subBatchSize)
+        {
+            size_t curBatchSize = min(subBatchSize, batchSize - start);
+            size_t numTiles = tilesPerSample * curBatchSize;
+            auto transformedInput = workspace.ColumnSlice(0, numTiles * numElements * m_inC);
+            transformedInput.Reshape(numTiles, numElements * m_inC);
+            auto transformedOutput = workspace.ColumnSlice(numTiles * numElements * m_inC, numTiles * numElements * m_mapCount);
+            transformedOutput.Reshape(numTiles, numElements * m_mapCount);
+
+            // 2. Input transform, V = BT d B, with zeroes for the padding.
+            const ElemType* pIn = in.Data() + start * in.GetNumRows();
+            ElemType* pV = transformedInput.Data();
+#pragma omp parallel for
+            for (int64_t nc = 0; nc < (int64_t)(curBatchSize * m_inC); nc++)
+            {
+                size_t n = (size_t)nc / m_inC;
+                size_t c = (size_t)nc % m_inC;
+                const ElemType* pMap = pIn + n * in.GetNumRows() + c * m_inW * m_inH;
+                ElemType d[alpha * alpha], tmp[alpha * alpha], v[alpha * alpha];
+                for (size_t ty = 0; ty < tilesH; ty++)
+                {
+                    for (size_t tx = 0; tx < tilesW; tx++)
+                    {
+                        int x0 = (int)(tx * m) - m_padW;
+                        int y0 = (int)(ty * m) - m_padH;
+                        for (size_t i = 0; i < alpha; i++)
+                        {
+                            int x = x0 + (int)i;
+                            for (size_t j = 0; j < alpha; j++)
+                            {
+                                int y = y0 + (int)j;
+                                bool inside = x >= 0 && x < (int)m_inW && y >= 0 && y < (int)m_inH;
+                                d[i * alpha + j] = inside ? pMap[y * m_inW + x] : 0;
+                            }
+                        }
+                        WinogradSandwich(Transform::BT(), alpha, alpha, d, tmp, v);
+                        size_t t = n * tilesPerSample + ty * tilesW + tx;
+                        for (size_t e = 0; e < numElements; e++)
+                            pV[t + numTiles * (e * m_inC + c)] = v[e];
+                    }
+                }
+            }
+
+            // 3. Element-wise products, as a GEMM over input channels for each transformed element.
+            for (size_t e = 0; e < numElements; e++)
+            {
+                auto v = transformedInput.ColumnSlice(e * m_inC, m_inC);
+                auto u = m_transformedKernel.ColumnSlice(e * m_mapCount, m_mapCount);
+                auto product = transformedOutput.ColumnSlice(e * m_mapCount, m_mapCount);
+                Mat::MultiplyAndWeightedAdd(1, v, false, u, false, 0, product);
+            }
+
+            // 4. Output transform, Y = AT M A, dropping the parts of the tiles that are outside of the output.
+            const ElemType* pM = transformedOutput.Data();
+            ElemType* pOut = out.Data() + start * out.GetNumRows();
+#pragma omp parallel for
+            for (int64_t nk = 0; nk < (int64_t)(curBatchSize * m_mapCount); nk++)
+            {
+                size_t n = (size_t)nk / m_mapCount;
+                size_t k = (size_t)nk % m_mapCount;
+                ElemType* pMap = pOut + n * out.GetNumRows() + k * m_outW * m_outH;
+                ElemType product[alpha * alpha], tmp[alpha * alpha], y[m * m];
+                for (size_t ty = 0; ty < tilesH; ty++)
+                {
+                    for (size_t tx = 0; tx < tilesW; tx++)
+                    {
+                        size_t t = n * tilesPerSample + ty * tilesW + tx;
+                        for (size_t e = 0; e < numElements; e++)
+                            product[e] = pM[t + numTiles * (e * m_mapCount + k)];
+                        WinogradSandwich(Transform::AT(), m, alpha, product, tmp, y);
+                        for (size_t i = 0; i < m && tx * m + i < m_outW; i++)
+                            for (size_t j = 0; j < m && ty * m + j < m_outH; j++)
+                                pMap[(ty * m + j) * m_outW + tx * m + i] = y[i * m + j];
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    static bool IsSupported(DEVICEID_TYPE deviceId, ConvolveGeometryPtr geometry, PoolKind poolKind)
+    {
+        // MKL-DNN has its own direct convolution, which the GEMM engine uses when available.
+        if (!Base::IsSupported(deviceId, geometry) || Base::IsMklEnabled() || poolKind != PoolKind::None || geometry->Groups() != 1)
+            return false;
+
+        // 2D convolution over all input channels: [W x H x C] input, [X x Y x C] kernels, [W' x H' x K] output.
+        const auto& inT = geometry->InputShape();
+        const auto& kernT = geometry->KernelShape();
+        if (inT.GetRank() != 3 || kernT.GetRank() != 3 || kernT[2] != inT[2] || geometry->OutputShape()[2] != geometry->GetMapCount(2) || geometry->GetLowerPad(2) != 0)
+            return false;
+
+        size_t kernelSize = kernT[0];
+        if ((kernelSize != 1 && kernelSize != 3) || kernT[1] != kernelSize)
+            return false;
+        for (size_t i = 0; i < 2; i++)
+        {
+            if (geometry->GetStride(i) != 1 || geometry->GetDilation(i) != 1 || geometry->GetMapCount(i) != 1)
+                return false;
+            if (kernelSize == 1 && (geometry->GetLowerPad(i) != 0 || geometry->OutputShape()[i] != inT[i]))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    size_t m_inW, m_inH, m_inC;
+    size_t m_outW, m_outH;
+    size_t m_mapCount;
+    size_t m_kernelSize;
+    int m_padW, m_padH;
+    size_t m_tileSize;
+    // Transformed kernels of the Winograd algorithm. They are recomputed for every minibatch, which costs
+    // a small fraction of the convolution and keeps the engine correct while the kernels are being trained.
+    Mat m_transformedKernel;
+};
+
 template <class ElemType>
 std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId,
                                                                                  ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind,
@@ -1188,6 +1484,14 @@ std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create
 
     if (geometry->Groups() == 1)
     {
+        if (isEnabled(ConvolutionEngineKind::Direct) && DirectConvolutionEngine<ElemType>::IsSupported(deviceId, geometry, poolKind))
+        {
+            if (GetMathLibTraceLevel() > 0)
+                fprintf(stderr, "%lsusing direct convolution engine for geometry: %s.\n", logPrefix.c_str(), engStr.c_str());
+
+            return std::make_unique<DirectConvolutionEngine<ElemType>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad);
+        }
+
         if (isEnabled(ConvolutionEngineKind::Gemm) && GemmConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
         {
             if (GetMathLibTraceLevel() > 0)
@@ -22,8 +22,9 @@ enum class ConvolutionEngineKind
     CuDnn     = 1 << 1, // cuDNN, works only for 2D/3D convos with full sharing.
     Legacy    = 1 << 2, // Legacy, for backwards compatibility. REVIEW alexeyk: implement sparse version and remove Legacy altogether.
     Gemm      = 1 << 3, // Uses convolution unrolling+GEMM technique. Works only for convos with full sharing.
+    Direct    = 1 << 4, // Winograd (3x3) and unrolling-free GEMM (1x1) forward convolution for stride-1 2D convos on CPU.
 
-    All       = Reference | CuDnn | Legacy | Gemm
+    All       = Reference | CuDnn | Legacy | Gemm | Direct
 };
 
 enum class PoolKind
@@ -75,6 +76,18 @@ public:
 
     virtual bool ImplementsGradientOverwriteOptimization() const { return false; }
 
+    // Engines that implement the forward convolution as a matrix product can compute it with a quantized multiplier
+    // for low precision inference, see Int8QuantizedMultiplier. Passing nullptr restores full precision.
+    virtual bool ImplementsQuantizedForward() const { return false; }
+
+    void SetQuantizedMultiplier(shared_ptr<QuantizedMultiplier<ElemType>> pQuantizedMultiplier)
+    {
+        if (pQuantizedMultiplier != nullptr && !ImplementsQuantizedForward())
+            LogicError("Quantized convolution is not supported by this convolution engine.");
+
+        m_pQuantizedMultiplier = pQuantizedMultiplier;
+    }
+
 protected:
     ConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind, bool poolIncludePad = false)
         : m_geometry(geometry), m_deviceId(deviceId), m_imageLayout(imageLayout), m_maxTempMemSizeInSamples(maxTempMemSizeInSamples), m_poolKind(poolKind), m_poolIncludePad(poolIncludePad)
@@ -107,6 +120,7 @@ protected:
     size_t m_maxTempMemSizeInSamples;
     PoolKind m_poolKind;
     bool m_poolIncludePad;
+    shared_ptr<QuantizedMultiplier<ElemType>> m_pQuantizedMultiplier;
 };
 
 #pragma warning(pop)
@@ -425,7 +425,8 @@ void GPUMatrix<ElemType>::ChangeDeviceTo(DEVICEID_TYPE to_id)
         }
     }
 
-    TracingGPUMemoryAllocator::Free<ElemType>(GetComputeDeviceId(), Buffer());
+    if (!HasBorrowedBuffer())
+        TracingGPUMemoryAllocator::Free<ElemType>(GetComputeDeviceId(), Buffer());
     SetBuffer(d_dst, m_numRows * m_numCols * sizeof(ElemType));
 
     PrepareDevice((DEVICEID_TYPE) to_id);
@@ -1234,7 +1235,7 @@ void GPUMatrix<ElemType>::SetValue(const size_t numRows, const size_t numCols, i
     if (matrixFlags & matrixFlagDontOwnBuffer)
     {
         // free the existing array if it used to be an owned array
-        if ( Buffer() != NULL)
+        if (Buffer() != NULL && !HasBorrowedBuffer())
         {
             TracingGPUMemoryAllocator::Free<ElemType>(GetComputeDeviceId(), Buffer());
         }
@@ -1692,7 +1693,8 @@ void GPUMatrix<ElemType>::Resize(const size_t numRows, const size_t numCols, boo
         (!growOnly && numElements != GetSizeAllocated()))   // shrink allocation if not growOnly
     {
         // If the buffer exists, free it before allocate
-        if (Buffer())
+        // A borrowed buffer is just left to its owner, so a matrix that outgrows its arena slot continues with its own allocation.
+        if (Buffer() && !HasBorrowedBuffer())
         {
             TracingGPUMemoryAllocator::Free<ElemType>(GetComputeDeviceId(), Buffer());
         }
@@ -133,6 +133,7 @@ class MATH_API GPUMatrix : public BaseMatrix<ElemType>
     using Base::m_numCols;
     using Base::m_sliceViewOffset;
     using Base::HasExternalBuffer;
+    using Base::HasBorrowedBuffer;
     using Base::SetBuffer;
     using Base::SetComputeDeviceId;
     using Base::ZeroInit;
@@ -503,6 +503,23 @@ void GPUSparseMatrix<ElemType>::SetValue(const GPUMatrix<ElemType>& denseMatrix,
     }
 }
 
+template <class ElemType>
+void GPUSparseMatrix<ElemType>::GetCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const
+{
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Expected sparse block col matrix");
+
+    // the index of a matrix without blocks (e.g. after Reset()) is not maintained
+    if (GetBlockSize() == 0)
+    {
+        std::fill(cpuCol2BlockId, cpuCol2BlockId + GetNumCols(), SparseIndex_NotAssigned);
+        return;
+    }
+
+    PrepareDevice();
+    CUDA_CALL(cudaMemcpy(cpuCol2BlockId, ColOrRow2BlockId(), GetNumCols() * sizeof(GPUSPARSE_INDEX_TYPE), cudaMemcpyDeviceToHost));
+}
+
 ///
 /// adjusts the sparse block column matrix with the new Col2BlockId
 /// For each column, if new Col2BlockId contains valid index, a corresponding block exists at the index
@@ -526,6 +543,10 @@ void GPUSparseMatrix<ElemType>::AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cp
     CUDA_CALL(cudaMemset(newBlockId2Col, SparseIndex_NotAssigned, numCols * sizeof(GPUSPARSE_INDEX_TYPE)));
     CUDA_CALL(cudaMemcpy(newCol2BlockId, cpuCol2BlockId, numCols * sizeof(GPUSPARSE_INDEX_TYPE), cudaMemcpyHostToDevice));
 
+    // a matrix without blocks has no values to carry over, its index is not maintained (e.g. after Reset())
+    if (GetBlockSize() == 0 && !useBlockId2Col && Buffer() != nullptr)
+        CUDA_CALL(cudaMemset(ColOrRow2BlockId(), SparseIndex_NotAssigned, numCols * sizeof(GPUSPARSE_INDEX_TYPE)));
+
     int blocksPerGrid = CeilDiv(numCols, GridDim::maxThreadsPerBlock);
 
     // when useBlockId2Col==true, the original col2BlockId is copied to blockId2Col to avoid getting overwritten
@@ -289,6 +289,7 @@ public:
     void SetValue(const GPUMatrix<ElemType>& denseMatrix, const MatrixFormat matrixFormat);
     void SetValue(const GPUMatrix<ElemType>& denseMatrix);
 
+    void GetCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const;
     void AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks, bool useBlockId2Col);
 
     GPUSPARSE_INDEX_TYPE* GetCondensedVector() const;
@@ -1451,6 +1451,17 @@ void Matrix<ElemType>::SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYPE* h_CSCC
         { m_GPUSparseMatrix->SetMatrixFromCSCFormat(h_CSCCol, h_Row, h_Val, nz, numRows, numCols, false, -1, transferer); });
 }
 
+template <class ElemType>
+void Matrix<ElemType>::GetSparseBlockColumnCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const
+{
+    DISPATCH_MATRIX_ON_FLAG(this,
+        nullptr,
+        NOT_IMPLEMENTED,
+        NOT_IMPLEMENTED,
+        m_CPUSparseMatrix->GetCol2BlockId(cpuCol2BlockId),
+        m_GPUSparseMatrix->GetCol2BlockId(cpuCol2BlockId));
+}
+
 ///
 /// adjusts the sparse block column matrix with the new Col2BlockId
 /// For each column, if new Col2BlockId contains valid index, a corresponding block exists at the index
@@ -1463,7 +1474,7 @@ void Matrix<ElemType>::AdjustSparseBlockColumn(const GPUSPARSE_INDEX_TYPE* cpuCo
         this,
         NOT_IMPLEMENTED,
         NOT_IMPLEMENTED,
-        NOT_IMPLEMENTED,
+        m_CPUSparseMatrix->AdjustCol2BlockId(cpuCol2BlockId, numBlocks),
         m_GPUSparseMatrix->AdjustCol2BlockId(cpuCol2BlockId, numBlocks, useBlockId2Col));
 }
 
@@ -1918,6 +1929,44 @@ void Matrix<ElemType>::Reshape(const size_t numRows, const size_t numCols)
     }
 }
 
+// Let this (dense) matrix use elements [offset, offset + numElements) of 'arena' as its storage, see BaseMatrix::BorrowBuffer().
+// The matrix keeps 'arena' alive for as long as it uses that memory. Note: the content of the matrix is undefined afterwards.
+template <class ElemType>
+void Matrix<ElemType>::BorrowBufferFrom(const shared_ptr<Matrix<ElemType>>& arena, size_t offset, size_t numElements)
+{
+    if (GetMatrixType() != MatrixType::DENSE || arena->GetMatrixType() != MatrixType::DENSE)
+        LogicError("BorrowBufferFrom: Only dense matrices can borrow from a dense arena.");
+    if (GetDeviceId() != arena->GetDeviceId())
+        LogicError("BorrowBufferFrom: The matrix and the arena must be on the same device.");
+    if (offset + numElements > arena->GetNumElements())
+        LogicError("BorrowBufferFrom: The range [%d, %d) exceeds the arena size %d.", (int)offset, (int)(offset + numElements), (int)arena->GetNumElements());
+
+    ElemType* pArray = arena->Data() + offset;
+    DISPATCH_MATRIX_ON_FLAG(this, this,
+        { m_CPUMatrix->BorrowBuffer(pArray, numElements, arena); },
+        { m_GPUMatrix->BorrowBuffer(pArray, numElements, arena); },
+        { NOT_IMPLEMENTED; },
+        { NOT_IMPLEMENTED; });
+}
+
+// Let this (dense CPU) matrix use the numRows x numCols elements at 'pArray' as its storage without copying them, see BaseMatrix::BorrowBuffer().
+// The matrix keeps 'bufferOwner' alive for as long as it uses that memory. This is how the reader hands packed minibatches to the network.
+template <class ElemType>
+void Matrix<ElemType>::BorrowBuffer(ElemType* pArray, size_t numRows, size_t numCols, const shared_ptr<void>& bufferOwner)
+{
+    if (GetMatrixType() != MatrixType::DENSE)
+        LogicError("BorrowBuffer: Only dense matrices can borrow a buffer.");
+
+    DISPATCH_MATRIX_ON_FLAG(this, this,
+        {
+            m_CPUMatrix->BorrowBuffer(pArray, numRows * numCols, bufferOwner);
+            m_CPUMatrix->Resize(numRows, numCols);
+        },
+        { LogicError("BorrowBuffer: GPU matrices cannot borrow host memory."); },
+        { NOT_IMPLEMENTED; },
+        { NOT_IMPLEMENTED; });
+}
+
 // Note: Resize() will leave the matrix content undefined.
 // Note: Resize calls RequireSizeAndAllocate on the sparse versions in for performance reasons. If the external caller knows the nz, then we should set it.
 template <class ElemType>
@@ -4964,7 +5013,7 @@ void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<E
 
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNForward(*(inputX.m_CPUMatrix), *(paramW.m_CPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_CPUMatrix), *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNForward(*(inputX.m_GPUMatrix), *(paramW.m_GPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -4979,7 +5028,7 @@ void Matrix<ElemType>::RNNBackwardData(const Matrix<ElemType>& outputDY, const M
     workspace._transferToDevice(GetDeviceId());
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNBackwardData(*(outputDY.m_CPUMatrix), *(paramW.m_CPUMatrix), *(outputDX.m_CPUMatrix), rnnAttributes, *(reserve.m_CPUMatrix), *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNBackwardData(*(outputDY.m_GPUMatrix), *(paramW.m_GPUMatrix), *(outputDX.m_GPUMatrix), rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -4994,7 +5043,7 @@ void Matrix<ElemType>::RNNBackwardWeights(const Matrix<ElemType>& inputX, const
     workspace._transferToDevice(GetDeviceId());
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNBackwardWeights(*(inputX.m_CPUMatrix), *(outputY.m_CPUMatrix), *(dw.m_CPUMatrix), rnnAttributes, *(reserve.m_CPUMatrix), *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNBackwardWeights(*(inputX.m_GPUMatrix), *(outputY.m_GPUMatrix), *(dw.m_GPUMatrix), rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
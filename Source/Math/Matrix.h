@@ -246,6 +246,8 @@ public:
         return ColumnSlice(0, GetNumCols());
     }                                                                           // get a reference (e.g. this is not resizable but can be reshaped)
     void Reshape(const size_t numRows, const size_t numCols);                   // note: reshapes in place. To get a reshaped reference, use Reshaped()
+    void BorrowBufferFrom(const shared_ptr<Matrix<ElemType>>& arena, size_t offset, size_t numElements); // use a range of 'arena' as storage; stays resizable (see MatrixPool)
+    void BorrowBuffer(ElemType* pArray, size_t numRows, size_t numCols, const shared_ptr<void>& bufferOwner); // use memory kept alive by 'bufferOwner' as storage; stays resizable (see ReaderShim)
     Matrix<ElemType> Reshaped(const size_t numRows, const size_t numCols) const // get a reshaped reference
     {
         Matrix<ElemType> result = AsReference();
@@ -300,6 +302,8 @@ public:
     void SetColumn(const ElemType val, size_t colInd);
     void SetColumn(const Matrix<ElemType>& valMat, size_t colInd);
 
+    // Sparse block column only: col2BlockId[j] is the block that holds column j, or SparseIndex_NotAssigned.
+    void GetSparseBlockColumnCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const;
     void AdjustSparseBlockColumn(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks, bool useBlockId2Col);
 
     void SetDiagonalValue(const ElemType v);
@@ -197,6 +197,10 @@ void GPUSparseMatrix<ElemType>::Resize(const size_t numRows, const size_t numCol
 {
 }
 template <class ElemType>
+void GPUSparseMatrix<ElemType>::GetCol2BlockId(GPUSPARSE_INDEX_TYPE* cpuCol2BlockId) const
+{
+}
+template <class ElemType>
 void GPUSparseMatrix<ElemType>::AdjustCol2BlockId(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks, bool useBlockId2Col)
 {
 }
@@ -4,6 +4,7 @@
 //
 #pragma once
 #include "Quantizers.h"
+#include <cstdint>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -29,7 +30,16 @@ class QuantizedMultiplier
 
     bool m_firstPass;
 
+protected:
+    // For derived multipliers that quantize the matrices themselves.
+    QuantizedMultiplier() :
+        m_isAConstant(false), m_isBConstant(false), m_firstPass(true)
+    {
+    };
+
 public: 
+    virtual ~QuantizedMultiplier() {}
+
     QuantizedMultiplier(shared_ptr<QuantizerBase<ElemType, short>> pQuantizerA, bool isAConstant, shared_ptr<QuantizerBase<ElemType, short>> pQuantizerB, bool isBConstant) :
         m_pQuantizerA(pQuantizerA), m_pQuantizerB(pQuantizerB), m_isAConstant(isAConstant), m_isBConstant(isBConstant), m_firstPass(true)
     {
@@ -41,8 +51,18 @@ public:
     {
     };
 
+    // op(A)[m,k]*op(B)[k,n] = C[m,n], where op(X) is X or its transpose
+    virtual void Multiply(int m, int n, int k, ElemType* A, bool transA, ElemType* B, bool transB, ElemType* C)
+    {
+        // TODO: support transpose product
+        if (transA || transB)
+            LogicError("Quantized multiplier currently doesn't support transpose.");
+
+        Multiply(m, n, k, A, B, C);
+    }
+
     // A[m,k]*B[k,n] = C[m,n]
-    void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
+    virtual void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
     {
         // Quantize
         if (!m_isAConstant || m_firstPass)
@@ -86,4 +106,137 @@ public:
     void SetIsBConstant(bool v) { m_isBConstant = v; }
 };
 
+// Calibrated int8 product of a constant weight matrix and an activation matrix, for post-training quantized inference.
+// The weight is quantized once, with one symmetric scale per output channel (row of op(A) or column of op(B)), and is
+// kept in its quantized form for the lifespan of the object, so it must not change after the first product.
+// The activation is quantized on every product with a single symmetric scale, derived from the activation range
+// calibrated ahead of time or, if none is given, from the absolute max of the activation matrix itself.
+// Both operands are packed so that the vectors to be multiplied are contiguous; their products are accumulated in int32
+// and de-quantized with the product of their scales.
+template <class ElemType>
+class Int8QuantizedMultiplier : public QuantizedMultiplier<ElemType>
+{
+    static const int c_rangeMax = 127;
+
+    // Whether A or B is the constant weight matrix
+    bool m_isAWeight;
+
+    // Calibrated absolute max of the activation matrix, 0 if not calibrated
+    float m_activationRange;
+
+    // Quantized op(A) rows and op(B) columns, each vector of length k stored contiguously, and their scales
+    vector<int8_t> m_matA, m_matB;
+    vector<float> m_scaleA, m_scaleB;
+
+    // Weight matrix the quantized weight was computed from, to detect a change of the weight storage
+    const ElemType* m_weight;
+    int m_weightVectors;
+    int m_weightVectorLength;
+
+    // Quantizes 'count' vectors of length k from X into 'output', where element l of vector v is X[l + v*k] if
+    // vectorsAreContiguous and X[v + l*count] otherwise. Each vector gets its own scale if perVector is set, otherwise
+    // all vectors are quantized with the range 'range' or, if it is 0, with the absolute max of X.
+    static void QuantizeVectors(const ElemType* X, bool vectorsAreContiguous, int count, int k, bool perVector, float range,
+                                vector<int8_t>& output, vector<float>& scales)
+    {
+        output.resize((size_t)count * k);
+        scales.resize(count);
+
+        auto element = [=](int v, int l) { return (float)X[vectorsAreContiguous ? l + (size_t)v * k : v + (size_t)l * count]; };
+        auto absMax = [=](int v)
+        {
+            float vectorMax = 0;
+            for (int l = 0; l < k; l++)
+                vectorMax = std::max(vectorMax, std::fabs(element(v, l)));
+            return vectorMax;
+        };
+
+        if (!perVector && range <= 0)
+        {
+            for (int v = 0; v < count; v++)
+                range = std::max(range, absMax(v));
+        }
+
+#pragma omp parallel for if ((size_t)count * k > 4096)
+        for (int v = 0; v < count; v++)
+        {
+            float vectorRange = perVector ? absMax(v) : range;
+            float quantizeFactor = vectorRange > 0 ? c_rangeMax / vectorRange : 0;
+            scales[v] = vectorRange / c_rangeMax;
+
+            int8_t* quantized = &output[(size_t)v * k];
+            for (int l = 0; l < k; l++)
+            {
+                // Calibrated ranges can be exceeded by unseen inputs, so saturate.
+                float value = std::round(element(v, l) * quantizeFactor);
+                quantized[l] = (int8_t)std::max((float)-c_rangeMax, std::min((float)c_rangeMax, value));
+            }
+        }
+    }
+
+    // Dot product with int32 accumulation, written so that compilers vectorize it (e.g. into pmaddwd on x86).
+    static int DotProduct(const int8_t* a, const int8_t* b, int k)
+    {
+        int dotProduct = 0;
+        for (int l = 0; l < k; l++)
+            dotProduct += (int)a[l] * (int)b[l];
+        return dotProduct;
+    }
+
+    void QuantizeWeight(const ElemType* W, bool vectorsAreContiguous, int count, int k, vector<int8_t>& output, vector<float>& scales)
+    {
+        if (W == m_weight && count == m_weightVectors && k == m_weightVectorLength)
+            return;
+
+        QuantizeVectors(W, vectorsAreContiguous, count, k, /*perVector=*/true, 0, output, scales);
+        m_weight = W;
+        m_weightVectors = count;
+        m_weightVectorLength = k;
+    }
+
+public:
+    // isAWeight - whether A (rather than B) is the constant weight matrix
+    // activationRange - calibrated absolute max of the activation matrix, 0 to derive it from each activation matrix
+    Int8QuantizedMultiplier(bool isAWeight, float activationRange = 0) :
+        m_isAWeight(isAWeight), m_activationRange(activationRange), m_weight(nullptr), m_weightVectors(0), m_weightVectorLength(0)
+    {
+        if (activationRange < 0)
+            InvalidArgument("Int8QuantizedMultiplier: The activation range must not be negative.");
+    }
+
+    virtual void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C) override
+    {
+        Multiply(m, n, k, A, false, B, false, C);
+    }
+
+    virtual void Multiply(int m, int n, int k, ElemType* A, bool transA, ElemType* B, bool transB, ElemType* C) override
+    {
+        // Rows of op(A) are contiguous in A if it is transposed, columns of op(B) if B is not.
+        if (m_isAWeight)
+        {
+            QuantizeWeight(A, transA, m, k, m_matA, m_scaleA);
+            QuantizeVectors(B, !transB, n, k, /*perVector=*/false, m_activationRange, m_matB, m_scaleB);
+        }
+        else
+        {
+            QuantizeVectors(A, transA, m, k, /*perVector=*/false, m_activationRange, m_matA, m_scaleA);
+            QuantizeWeight(B, !transB, n, k, m_matB, m_scaleB);
+        }
+
+        // Each element of C is computed independently; walk C in storage order so that consecutive iterations share a column of op(B).
+        long long mn = (long long)m * n;
+#pragma omp parallel for if (mn * k > 65536)
+        for (long long ij = 0; ij < mn; ij++)
+        {
+            int i = (int)(ij % m);
+            int j = (int)(ij / m);
+            int dotProduct = DotProduct(&m_matA[(size_t)i * k], &m_matB[(size_t)j * k], k);
+            C[ij] = (ElemType)(dotProduct * m_scaleA[i] * m_scaleB[j]);
+        }
+    }
+
+    float ActivationRange() const { return m_activationRange; }
+    bool IsAWeight() const { return m_isAWeight; }
+};
+
 }}}
\ No newline at end of file
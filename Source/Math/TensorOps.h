@@ -462,6 +462,12 @@ DefBinaryOp(ElementwiseProductWithSinhDerivative, a * cosh_(b)); // note: b = in
 DefBinaryOp(ElementwiseProductWithCoshDerivative, a * sinh_(b)); // note: b = input for cosh()
 DefBinaryOp(ElementwiseProductWithAsinhDerivative, a / sqrt_(1 + b * b)); // note: b = input for asinh()
 DefBinaryOp(ElementwiseProductWithAtanhDerivative, a / (1 - b * b)); // note: b = input for atanh()
+DefBinaryOp(LinearRectifierOfSum, OpLinearRectifier(a + b));
+DefBinaryOp(SigmoidOfSum, Sigmoid(a + b));
+DefBinaryOp(TanhOfSum, tanh_(a + b));
+DefBinaryOp(LinearRectifierOfElementwiseProduct, OpLinearRectifier(a * b));
+DefBinaryOp(SigmoidOfElementwiseProduct, Sigmoid(a * b));
+DefBinaryOp(TanhOfElementwiseProduct, tanh_(a * b));
 //DefBinaryOp(Index, IndexElement(a, b, i));  // note: this one uses the third argument
 
 #pragma pop_macro("DefBinaryOp")
@@ -482,6 +488,9 @@ DefTernaryOp(ElementwiseProductWithExpOfDiff, a * exp_(b - c));
 DefTernaryOp(ElementwiseProductWithQuotient, a * b * OpReciprocal(c));
 DefTernaryOp(ElementwiseProductWithPowExponentDerivative, c <= 0 ? (ElemType)0 : (ElemType)(a * b * log_(c))); // same behavior as other toolkits
 DefTernaryOp(ElementwiseProductWithPowBaseDerivative, (ElemType)(a * c * OpPow(b, c - (ElemType)1))); // Using the output of pow would be faster but it requires a quaternary op and users will likely only use pow in forward mode
+DefTernaryOp(ElementwiseProductWithSigmoidDerivativeFromOutputAndFactor, a * (b * (1 - b)) * c); // b = output; c = other factor of a fused elementwise product
+DefTernaryOp(ElementwiseProductWithTanhDerivativeFromOutputAndFactor, a * (1 - b * b) * c);
+DefTernaryOp(ElementwiseProductWithLinearRectifierDerivativeFromOutputAndFactor, b > (ElemType)0 ? a * c : (ElemType)0);
 
 #pragma pop_macro("DefTernaryOp")
 
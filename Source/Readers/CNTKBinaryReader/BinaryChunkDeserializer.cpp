@@ -10,20 +10,13 @@
 #include "BinaryDataChunk.h"
 #include "CBFUtils.h"
 #include "FileWrapper.h"
+#include "LZCompression.h"
 #include <vector>
 
 namespace CNTK {
 
 using namespace Microsoft::MSR::CNTK;
 
-enum class MatrixEncodingType : unsigned char
-{
-    dense = 0,
-    sparse_csc = 1,
-    // TODO: compressed_sparse_csc = 2, // indices are encoded as var-ints
-};
-
-
 void BinaryChunkDeserializer::ReadChunkTable()
 {
     uint64_t firstChunkOffset = m_chunkTableOffset;
@@ -46,8 +39,8 @@ void BinaryChunkDeserializer::ReadChunkTable()
     m_chunkTable = make_unique<ChunkTable>(m_numChunks, chunks);
 }
 
-BinaryChunkDeserializer::BinaryChunkDeserializer(const BinaryConfigHelper& helper) :
-    BinaryChunkDeserializer(helper.GetFilePath())
+BinaryChunkDeserializer::BinaryChunkDeserializer(const BinaryConfigHelper& helper, size_t shard) :
+    BinaryChunkDeserializer(helper.GetShardFilePath(shard))
 {
     SetTraceLevel(helper.GetTraceLevel());
 
@@ -60,6 +53,7 @@ BinaryChunkDeserializer::BinaryChunkDeserializer(const std::wstring& filename) :
     m_file(FileWrapper::OpenOrDie(filename, L"rb")),
     m_headerOffset(0),
     m_chunkTableOffset(0),
+    m_version(0),
     m_traceLevel(0)
 {
 }
@@ -71,11 +65,11 @@ void BinaryChunkDeserializer::Initialize(const std::map<std::wstring, std::wstri
     // First, verify the magic number.
     CBFUtils::FindMagicOrDie(m_file);
     
-    // Second, read the version number of the data file, and (for now) make sure the reader version is the same.
-    uint32_t versionNumber = CBFUtils::GetVersionNumber(m_file);
-    if (versionNumber != s_currentVersion)
+    // Second, read the version number of the data file, and make sure the reader supports it.
+    m_version = CBFUtils::GetVersionNumber(m_file);
+    if (m_version < CBFUtils::VERSION || m_version > s_currentVersion)
         LogicError("The reader version is %" PRIu32 ", but the data file was created for version %" PRIu32 ".",
-            s_currentVersion, versionNumber);
+            s_currentVersion, m_version);
 
     // Now, find where the header is.
     m_headerOffset = CBFUtils::GetHeaderOffset(m_file);
@@ -150,10 +144,8 @@ void BinaryChunkDeserializer::SequenceInfosForChunk(ChunkIdType chunkId, std::ve
     auto numberOfSequences = m_chunkTable->GetNumSequences(chunkId);
     unique_ptr<uint32_t[]> numSamplesPerSequence(new uint32_t[numberOfSequences]);
 
-    // Seek to the start of the chunk
-    m_file.SeekOrDie(offset, SEEK_SET);
-    // read 'numberOfSequences' unsigned ints
-    m_file.ReadOrDie(numSamplesPerSequence.get(), sizeof(uint32_t), numberOfSequences);
+    // read 'numberOfSequences' unsigned ints at the start of the chunk
+    m_file.ReadAtOrDie(numSamplesPerSequence.get(), sizeof(uint32_t) * numberOfSequences, offset);
 
     auto startId = m_chunkTable->GetStartIndex(chunkId);
     for (decltype(numberOfSequences) i = 0; i < numberOfSequences; i++)
@@ -171,8 +163,9 @@ void BinaryChunkDeserializer::SequenceInfosForChunk(ChunkIdType chunkId, std::ve
 
 unique_ptr<byte[]> BinaryChunkDeserializer::ReadChunk(ChunkIdType chunkId)
 {
-    // Seek to the start of the data portion in the chunk
-    m_file.SeekOrDie(m_chunkTable->GetDataStartOffset(chunkId), SEEK_SET);
+    // Chunks are read with positional reads, so that chunks can be loaded on several threads at the same time.
+    if (m_version >= CBFUtils::COMPRESSED_CHUNKS_VERSION)
+        return ReadCompressedChunk(chunkId);
 
     // Determine how big the chunk is.
     size_t chunkSize = m_chunkTable->GetChunkSize(chunkId);
@@ -181,12 +174,38 @@ unique_ptr<byte[]> BinaryChunkDeserializer::ReadChunk(ChunkIdType chunkId)
     // TODO: use a pool of buffers instead of allocating a new one, each time a chunk is read.
     unique_ptr<byte[]> buffer(new byte[chunkSize]);
 
-    // Read the chunk from disk
-    m_file.ReadOrDie(buffer.get(), sizeof(byte), chunkSize);
+    // Read the data portion of the chunk from disk
+    m_file.ReadAtOrDie(buffer.get(), chunkSize, m_chunkTable->GetDataStartOffset(chunkId));
 
     return buffer;
 }
 
+unique_ptr<byte[]> BinaryChunkDeserializer::ReadCompressedChunk(ChunkIdType chunkId)
+{
+    // The data is prefixed by its uncompressed and its stored size, the last chunk in the table
+    // extends up to the header, so the stored size is the only reliable end of the data.
+    int64_t offset = m_chunkTable->GetDataStartOffset(chunkId);
+    uint64_t sizes[2];
+    m_file.ReadAtOrDie(sizes, sizeof(sizes), offset);
+    offset += sizeof(sizes);
+
+    uint64_t uncompressedSize = sizes[0], storedSize = sizes[1];
+    if (storedSize > uncompressedSize || storedSize + 2 * sizeof(uint64_t) > m_chunkTable->GetChunkSize(chunkId))
+        RuntimeError("Chunk %" PRIu32 " of the input (%ls) is corrupted.", chunkId, m_file.Filename().c_str());
+
+    unique_ptr<byte[]> buffer(new byte[uncompressedSize]);
+    if (storedSize == uncompressedSize)
+    {
+        m_file.ReadAtOrDie(buffer.get(), storedSize, offset);
+        return buffer;
+    }
+
+    vector<char> compressed(storedSize);
+    m_file.ReadAtOrDie(compressed.data(), storedSize, offset);
+    LZDecompress(compressed.data(), compressed.size(), (char*)buffer.get(), uncompressedSize);
+    return buffer;
+}
+
 
 ChunkPtr BinaryChunkDeserializer::GetChunk(ChunkIdType chunkId)
 {
@@ -196,6 +215,15 @@ ChunkPtr BinaryChunkDeserializer::GetChunk(ChunkIdType chunkId)
     return make_shared<BinaryDataChunk>(chunkId, m_chunkTable->GetNumSequences(chunkId), std::move(buffer), m_deserializers);
 }
 
+void BinaryChunkDeserializer::HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds)
+{
+    for (auto chunkId : chunkIds)
+    {
+        auto offset = m_chunkTable->GetOffset(chunkId);
+        m_file.AdviseWillNeed(offset, m_chunkTable->GetOffset(chunkId + 1) - offset);
+    }
+}
+
 void BinaryChunkDeserializer::SetTraceLevel(unsigned int traceLevel)
 {
     m_traceLevel = traceLevel;
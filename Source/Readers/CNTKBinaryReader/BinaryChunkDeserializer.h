@@ -86,7 +86,8 @@ class FileWrapper;
 // TODO: more details when tracing warnings 
 class BinaryChunkDeserializer : public DataDeserializerBase {
 public:
-    explicit BinaryChunkDeserializer(const BinaryConfigHelper& helper);
+    // Reads the given shard of the file, the file itself if it has not been sharded.
+    explicit BinaryChunkDeserializer(const BinaryConfigHelper& helper, size_t shard = 0);
 
     BinaryChunkDeserializer(CorpusDescriptorPtr corpus, const BinaryConfigHelper& helper) = delete;
 
@@ -101,6 +102,15 @@ public:
     // Get information about particular chunk.
     void SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& result) override;
 
+    // Asks the operating system to start reading the given chunks.
+    void HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds) override;
+
+    // Chunks are read with positional reads, so they can be loaded on several threads.
+    bool SupportsConcurrentGetChunk() const override
+    {
+        return true;
+    }
+
 private:
     // Builds an index of the input data.
     void Initialize(const std::map<std::wstring, std::wstring>& rename, DataType precision);
@@ -111,6 +121,9 @@ private:
     // Reads a chunk from disk into buffer
     unique_ptr<byte[]> ReadChunk(ChunkIdType chunkId);
 
+    // Reads the data of a chunk in a file with compressed chunks and decompresses it if needed.
+    unique_ptr<byte[]> ReadCompressedChunk(ChunkIdType chunkId);
+
     BinaryChunkDeserializer(const wstring& filename);
 
     void SetTraceLevel(unsigned int traceLevel);
@@ -120,6 +133,9 @@ private:
 
     int64_t m_headerOffset, m_chunkTableOffset;
 
+    // Version of the data file, see CBFUtils.
+    uint32_t m_version;
+
     std::vector<BinaryDataDeserializerPtr> m_deserializers;
     ChunkTablePtr m_chunkTable;
     void* m_chunkBuffer;
@@ -130,7 +146,7 @@ private:
     
     unsigned int m_traceLevel;
 
-    static const uint32_t s_currentVersion = 1;
+    static const uint32_t s_currentVersion = 2;
 
     friend class CNTKBinaryReaderTestRunner;
 
@@ -12,6 +12,7 @@
 #include "StringUtil.h"
 #include "ReaderConstants.h"
 #include "ReaderUtil.h"
+#include "CBFWriter.h"
 
 using std::string;
 using std::wstring;
@@ -65,6 +66,9 @@ namespace CNTK {
         }
 
         m_filepath = msra::strfun::utf16(config(L"file"));
+        m_numberOfShards = config(L"numShards", (size_t)1);
+        if (m_numberOfShards == 0)
+            InvalidArgument("numShards has to be positive.");
         m_keepDataInMemory = config(L"keepDataInMemory", false);
 
         m_randomizationWindow = GetRandomizationWindowFromConfig(config);
@@ -81,4 +85,11 @@ namespace CNTK {
         m_traceLevel = config(L"traceLevel", 1);
     }
 
+    std::wstring BinaryConfigHelper::GetShardFilePath(size_t shard) const
+    {
+        if (shard >= m_numberOfShards)
+            InvalidArgument("Shard %" PRIu64 " does not exist, the file '%ls' has %" PRIu64 " shard(s).", shard, m_filepath.c_str(), m_numberOfShards);
+        return CBFWriter::GetShardFileName(m_filepath, shard, m_numberOfShards);
+    }
+
 }
@@ -27,6 +27,13 @@ public:
     // Get full path to the input file.
     const wstring& GetFilePath() const { return m_filepath; }
 
+    // Number of shards the input file has been written in by the CBF converter, 1 if it is a single file.
+    // Each worker then reads the shard of its rank on its own, see CNTKBinaryReader.
+    size_t GetNumberOfShards() const { return m_numberOfShards; }
+
+    // Get full path to the given shard of the input file.
+    std::wstring GetShardFilePath(size_t shard) const;
+
     size_t GetRandomizationWindow() const { return m_randomizationWindow; }
 
     bool UseSampleBasedRandomizationWindow() const { return m_sampleBasedRandomizationWindow; }
@@ -41,6 +48,7 @@ public:
 
 private:
     std::wstring m_filepath;
+    size_t m_numberOfShards;
     std::map<std::wstring, std::wstring> m_streams;
     DataType m_elementType;
     size_t m_randomizationWindow;
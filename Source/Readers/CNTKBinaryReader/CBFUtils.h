@@ -13,12 +13,25 @@ class FileWrapper;
 
 namespace CNTK {
 
+enum class MatrixEncodingType : unsigned char
+{
+    dense = 0,
+    sparse_csc = 1,
+    // TODO: compressed_sparse_csc = 2, // indices are encoded as var-ints
+};
+
 // Implementation of a helper class for reading binary files with FileWrapper class
 class CBFUtils
 {
 public:
     static const uint64_t MAGIC_NUMBER = 0x636e746b5f62696eU;
 
+    // Version 1 files store the data of the chunks as is. In version 2 files the data of every chunk
+    // (everything after the sequence lengths) is prefixed by its uncompressed and its stored size,
+    // and is compressed if the stored size is smaller than the uncompressed one.
+    static const uint32_t VERSION = 1;
+    static const uint32_t COMPRESSED_CHUNKS_VERSION = 2;
+
     static void FindMagicOrDie(FileWrapper& f)
     {
         // Read the magic number and make sure we're given a proper CBF file.
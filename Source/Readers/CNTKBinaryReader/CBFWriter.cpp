@@ -0,0 +1,262 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <algorithm>
+#include <cstring>
+#include "CBFWriter.h"
+#include "CBFUtils.h"
+#include "LZCompression.h"
+
+namespace CNTK {
+
+using namespace Microsoft::MSR::CNTK;
+
+static inline void Append(char*& position, const void* data, size_t size)
+{
+    if (size == 0)
+        return;
+    memcpy(position, data, size);
+    position += size;
+}
+
+CBFChunkSerializer::CBFChunkSerializer(const std::vector<StreamInformation>& streams, bool compress)
+    : m_streams(streams), m_compress(compress)
+{
+    for (const auto& stream : m_streams)
+    {
+        if (stream.m_elementType != DataType::Float && stream.m_elementType != DataType::Double)
+            InvalidArgument("The stream '%ls' cannot be written in the CNTK binary format, only float and double streams are supported.", stream.m_name.c_str());
+        if (stream.m_storageFormat != StorageFormat::Dense && stream.m_storageFormat != StorageFormat::SparseCSC)
+            InvalidArgument("The stream '%ls' cannot be written in the CNTK binary format, its storage format is not supported.", stream.m_name.c_str());
+        if (stream.m_sampleLayout.TotalSize() > std::numeric_limits<uint32_t>::max())
+            InvalidArgument("The sample dimension of the stream '%ls' is too large for the CNTK binary format.", stream.m_name.c_str());
+    }
+}
+
+uint32_t CBFChunkSerializer::GetVersion() const
+{
+    if (m_compress)
+        return CBFUtils::COMPRESSED_CHUNKS_VERSION;
+    return CBFUtils::VERSION;
+}
+
+size_t CBFChunkSerializer::GetElementSize(size_t streamIndex) const
+{
+    return m_streams[streamIndex].m_elementType == DataType::Double ? sizeof(double) : sizeof(float);
+}
+
+size_t CBFChunkSerializer::GetSerializedSize(const std::vector<SequenceDataPtr>& sequence) const
+{
+    // The length of the sequence in the chunk prefix.
+    size_t size = sizeof(uint32_t);
+    for (size_t i = 0; i < m_streams.size(); ++i)
+    {
+        const auto& data = sequence[i];
+        size += sizeof(uint32_t);
+        if (m_streams[i].m_storageFormat == StorageFormat::Dense)
+        {
+            size += data->m_numberOfSamples * m_streams[i].m_sampleLayout.TotalSize() * GetElementSize(i);
+        }
+        else
+        {
+            const auto& sparse = static_cast<const SparseSequenceData&>(*data);
+            size += sizeof(int32_t) + sparse.m_totalNnzCount * (GetElementSize(i) + sizeof(int32_t)) + sparse.m_nnzCounts.size() * sizeof(int32_t);
+        }
+    }
+    return size;
+}
+
+// The layout of a chunk is the following:
+//   uint32_t[numberOfSequences]: number of samples of every sequence (the maximum over the streams),
+//   followed by the data of every stream, for all sequences of the chunk:
+//     dense:  uint32_t number of samples, values of all samples
+//     sparse: uint32_t number of samples, int32_t nnz, values[nnz], int32_t row indices[nnz], int32_t nnz counts of every sample
+// With compression the data after the sequence lengths is prefixed by its uncompressed and its stored size.
+void CBFChunkSerializer::Serialize(const std::vector<std::vector<SequenceDataPtr>>& sequences, CBFChunk& result) const
+{
+    result.m_numberOfSequences = (uint32_t)sequences.size();
+    result.m_numberOfSamples = 0;
+
+    size_t dataSize = 0;
+    std::vector<uint32_t> lengths(sequences.size());
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        if (sequences[i].size() != m_streams.size())
+            LogicError("Sequence %" PRIu64 " has %" PRIu64 " streams, expected %" PRIu64 ".", i, sequences[i].size(), m_streams.size());
+
+        uint32_t length = 0;
+        for (const auto& s : sequences[i])
+            length = std::max(length, (uint32_t)s->m_numberOfSamples);
+        lengths[i] = length;
+        result.m_numberOfSamples += length;
+        dataSize += GetSerializedSize(sequences[i]) - sizeof(uint32_t);
+    }
+
+    std::vector<char> buffer(dataSize);
+    char* position = buffer.data();
+    for (size_t streamIndex = 0; streamIndex < m_streams.size(); ++streamIndex)
+    {
+        const auto& stream = m_streams[streamIndex];
+        size_t elementSize = GetElementSize(streamIndex);
+        for (const auto& sequence : sequences)
+        {
+            const auto& data = sequence[streamIndex];
+            if (data->m_elementType != stream.m_elementType)
+                LogicError("The element type of a sequence does not match the element type of the stream '%ls'.", stream.m_name.c_str());
+
+            uint32_t numberOfSamples = data->m_numberOfSamples;
+            Append(position, &numberOfSamples, sizeof(numberOfSamples));
+            if (stream.m_storageFormat == StorageFormat::Dense)
+            {
+                Append(position, data->GetDataBuffer(), numberOfSamples * stream.m_sampleLayout.TotalSize() * elementSize);
+                continue;
+            }
+
+            const auto& sparse = static_cast<SparseSequenceData&>(*data);
+            if (sparse.m_nnzCounts.size() != numberOfSamples)
+                LogicError("The number of nnz counts of a sparse sequence does not match its number of samples in the stream '%ls'.", stream.m_name.c_str());
+
+            int32_t nnz = sparse.m_totalNnzCount;
+            Append(position, &nnz, sizeof(nnz));
+            Append(position, data->GetDataBuffer(), nnz * elementSize);
+            Append(position, sparse.m_indices, nnz * sizeof(int32_t));
+            Append(position, sparse.m_nnzCounts.data(), numberOfSamples * sizeof(int32_t));
+        }
+    }
+    assert(position == buffer.data() + buffer.size());
+
+    size_t lengthsSize = lengths.size() * sizeof(uint32_t);
+    if (!m_compress)
+    {
+        result.m_data.resize(lengthsSize + buffer.size());
+        char* out = result.m_data.data();
+        Append(out, lengths.data(), lengthsSize);
+        Append(out, buffer.data(), buffer.size());
+        return;
+    }
+
+    // Data that does not get smaller is stored as is, the reader recognizes it by the equal sizes.
+    std::vector<char> compressed;
+    LZCompress(buffer.data(), buffer.size(), compressed);
+    const std::vector<char>& stored = compressed.size() < buffer.size() ? compressed : buffer;
+
+    uint64_t uncompressedSize = buffer.size();
+    uint64_t storedSize = stored.size();
+    result.m_data.resize(lengthsSize + 2 * sizeof(uint64_t) + stored.size());
+    char* out = result.m_data.data();
+    Append(out, lengths.data(), lengthsSize);
+    Append(out, &uncompressedSize, sizeof(uncompressedSize));
+    Append(out, &storedSize, sizeof(storedSize));
+    Append(out, stored.data(), stored.size());
+}
+
+CBFWriter::CBFWriter(const std::wstring& fileName, const std::vector<StreamInformation>& streams, uint32_t version, size_t numberOfShards)
+    : m_streams(streams), m_completed(false)
+{
+    if (numberOfShards == 0)
+        InvalidArgument("The number of shards of a CNTK binary format file has to be positive.");
+
+    m_shards.resize(numberOfShards);
+    for (size_t i = 0; i < numberOfShards; ++i)
+    {
+        auto& shard = m_shards[i];
+        shard.m_fileName = GetShardFileName(fileName, i, numberOfShards);
+        shard.m_file.reset(new FileWrapper(FileWrapper::OpenOrDie(shard.m_fileName, L"wb")));
+        shard.m_numberOfSamples = 0;
+        uint64_t magic = CBFUtils::MAGIC_NUMBER;
+        shard.m_file->WriteOrDie(magic);
+        shard.m_file->WriteOrDie(version);
+    }
+}
+
+CBFWriter::~CBFWriter()
+{
+    if (m_completed)
+        return;
+
+    for (auto& shard : m_shards)
+    {
+        shard.m_file.reset();
+        if (fexists(shard.m_fileName))
+            _wunlink(shard.m_fileName.c_str());
+    }
+}
+
+std::wstring CBFWriter::GetShardFileName(const std::wstring& fileName, size_t shardIndex, size_t numberOfShards)
+{
+    if (numberOfShards == 1)
+        return fileName;
+    return fileName + L"." + std::to_wstring(shardIndex);
+}
+
+void CBFWriter::WriteChunk(const CBFChunk& chunk)
+{
+    if (m_completed)
+        LogicError("Cannot write a chunk to a completed CNTK binary format file.");
+
+    auto shard = std::min_element(m_shards.begin(), m_shards.end(),
+        [](const Shard& a, const Shard& b) { return a.m_numberOfSamples < b.m_numberOfSamples; });
+
+    ChunkEntry entry;
+    entry.m_offset = shard->m_file->TellOrDie();
+    entry.m_numberOfSequences = chunk.m_numberOfSequences;
+    entry.m_numberOfSamples = chunk.m_numberOfSamples;
+    shard->m_file->WriteOrDie(chunk.m_data.data(), 1, chunk.m_data.size());
+    shard->m_chunks.push_back(entry);
+    shard->m_numberOfSamples += chunk.m_numberOfSamples;
+}
+
+void CBFWriter::Complete()
+{
+    for (auto& shard : m_shards)
+    {
+        if (shard.m_chunks.empty())
+            fprintf(stderr, "WARNING: The shard '%ls' does not contain any data, there are fewer chunks than shards.\n", shard.m_fileName.c_str());
+        WriteHeader(shard);
+        shard.m_file->FlushOrDie();
+        shard.m_file.reset();
+    }
+    m_completed = true;
+}
+
+void CBFWriter::WriteHeader(Shard& shard)
+{
+    FileWrapper& file = *shard.m_file;
+    int64_t headerOffset = file.TellOrDie();
+
+    uint64_t magic = CBFUtils::MAGIC_NUMBER;
+    file.WriteOrDie(magic);
+    file.WriteOrDie((uint32_t)shard.m_chunks.size());
+    file.WriteOrDie((uint32_t)m_streams.size());
+    for (const auto& stream : m_streams)
+    {
+        auto encoding = stream.m_storageFormat == StorageFormat::Dense ? MatrixEncodingType::dense : MatrixEncodingType::sparse_csc;
+        file.WriteOrDie(encoding);
+
+        std::string name = msra::strfun::utf8(stream.m_name);
+        file.WriteOrDie((uint32_t)name.size());
+        file.WriteOrDie(name.data(), 1, name.size());
+
+        // Element types as read by the BinaryDataDeserializer: 0 - float, 1 - double.
+        unsigned char elementType = stream.m_elementType == DataType::Double ? 1 : 0;
+        file.WriteOrDie(elementType);
+        file.WriteOrDie((uint32_t)stream.m_sampleLayout.TotalSize());
+    }
+
+    // The chunk table.
+    for (const auto& chunk : shard.m_chunks)
+    {
+        file.WriteOrDie(chunk.m_offset);
+        file.WriteOrDie(chunk.m_numberOfSequences);
+        file.WriteOrDie(chunk.m_numberOfSamples);
+    }
+
+    file.WriteOrDie(headerOffset);
+}
+
+}
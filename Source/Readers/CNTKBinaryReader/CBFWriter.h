@@ -0,0 +1,95 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Basics.h"
+#include "Reader.h"
+#include "FileWrapper.h"
+
+namespace CNTK {
+
+// A chunk of sequences serialized in the CNTK binary format, ready to be appended to a CBF file.
+struct CBFChunk
+{
+    std::vector<char> m_data;        // Sequence lengths, followed by the (possibly compressed) data of all streams.
+    uint32_t m_numberOfSequences;
+    uint32_t m_numberOfSamples;
+};
+
+// Serializes sequences into CBF chunks. Besides the stream descriptions it has no state,
+// so that chunks can be serialized and compressed on several threads at the same time.
+class CBFChunkSerializer
+{
+public:
+    CBFChunkSerializer(const std::vector<StreamInformation>& streams, bool compress);
+
+    // Serializes the given sequences, sequences[i] holds the data of all streams of the i-th sequence.
+    void Serialize(const std::vector<std::vector<SequenceDataPtr>>& sequences, CBFChunk& result) const;
+
+    // Returns the number of bytes the (uncompressed) sequence takes in a chunk.
+    size_t GetSerializedSize(const std::vector<SequenceDataPtr>& sequence) const;
+
+    // Files with compressed chunks have a newer version, so that older readers reject them.
+    uint32_t GetVersion() const;
+
+    const std::vector<StreamInformation>& GetStreams() const { return m_streams; }
+
+private:
+    size_t GetElementSize(size_t streamIndex) const;
+
+    std::vector<StreamInformation> m_streams;
+    bool m_compress;
+};
+
+// Writes sequences to one or several CBF files. Chunks are appended as they come,
+// the header and the chunk table are written when the writer is completed.
+// With several shards every chunk goes to the shard that has the smallest number of samples so far,
+// so that the shards are balanced and each of them is a complete CBF file that a worker can read on its own.
+class CBFWriter
+{
+public:
+    CBFWriter(const std::wstring& fileName, const std::vector<StreamInformation>& streams, uint32_t version, size_t numberOfShards = 1);
+
+    // Deletes the shards if the writer has not been completed, they would not be valid CBF files.
+    ~CBFWriter();
+
+    void WriteChunk(const CBFChunk& chunk);
+
+    // Writes the headers and closes all shards.
+    void Complete();
+
+    // Returns the file name of a shard: the file name itself if there is a single shard.
+    static std::wstring GetShardFileName(const std::wstring& fileName, size_t shardIndex, size_t numberOfShards);
+
+private:
+    struct ChunkEntry
+    {
+        int64_t m_offset;
+        uint32_t m_numberOfSequences;
+        uint32_t m_numberOfSamples;
+    };
+
+    struct Shard
+    {
+        std::wstring m_fileName;
+        std::unique_ptr<FileWrapper> m_file;
+        std::vector<ChunkEntry> m_chunks;
+        size_t m_numberOfSamples;
+    };
+
+    void WriteHeader(Shard& shard);
+
+    std::vector<StreamInformation> m_streams;
+    std::vector<Shard> m_shards;
+    bool m_completed;
+
+    DISABLE_COPY_AND_MOVE(CBFWriter);
+};
+
+}
@@ -4,6 +4,8 @@
 //
 
 #include "stdafx.h"
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
 #include "CNTKBinaryReader.h"
 #include "Config.h"
 #include "BinaryConfigHelper.h"
@@ -13,6 +15,7 @@
 #include "NoRandomizer.h"
 #include "SequencePacker.h"
 #include "FramePacker.h"
+#include "DataReader.h"
 
 namespace CNTK {
 
@@ -21,19 +24,31 @@ using namespace Microsoft::MSR::CNTK;
 // TODO: This class should go away eventually.
 // TODO: The composition of packer + randomizer + different deserializers in a generic manner is done in the CompositeDataReader.
 // TODO: Currently preserving this for backward compatibility with current configs.
-CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config) 
+CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
+    : m_config(std::make_shared<ConfigParameters>(config)),
+      m_configHelper(std::make_shared<BinaryConfigHelper>(config)),
+      m_shard(0)
 {
-    BinaryConfigHelper configHelper(config);
+    // Until the rank of the worker is known the first shard is open, all shards have the same streams.
+    Initialize(m_shard);
+}
+
+void CNTKBinaryReader::Initialize(size_t shard)
+{
+    const ConfigParameters& config = *m_config;
+    const BinaryConfigHelper& configHelper = *m_configHelper;
 
     std::stringstream log;
     log << "Initializing CNTKBinaryReader";
     try
     {
-        m_deserializer = shared_ptr<DataDeserializer>(new BinaryChunkDeserializer(configHelper));
+        m_deserializer = shared_ptr<DataDeserializer>(new BinaryChunkDeserializer(configHelper, shard));
+        if (configHelper.GetNumberOfShards() > 1)
+            log << " | reading shard " << shard << " of " << configHelper.GetNumberOfShards();
 
         if (configHelper.ShouldKeepDataInMemory())
         {
-            m_deserializer = shared_ptr<DataDeserializer>(new ChunkCache(m_deserializer));
+            m_deserializer = shared_ptr<DataDeserializer>(new ChunkCache(m_deserializer, ChunkCacheConfig(config)));
             log << " | keeping data in memory";
         }
 
@@ -53,7 +68,9 @@ CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
                 false, /* multithreadedGetNextSequences */
                  0, /*maxNumberOfInvalidSequences */
                 configHelper.UseSampleBasedRandomizationWindow() /*sampleBasedRandomizationWindow */,
-                GetRandomSeed(config) /*seedOffset*/);
+                GetRandomSeed(config) /*seedOffset*/,
+                ChunkPrefetchConfig(config) /*prefetchConfig*/,
+                ChunkAffinityConfig(config) /*affinityConfig*/);
         }
         else
         {
@@ -66,10 +83,68 @@ CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
     }
     catch (const std::runtime_error& e)
     {
-        RuntimeError("CNTKBinaryReader: While reading '%ls': %s", configHelper.GetFilePath().c_str(), e.what());
+        RuntimeError("CNTKBinaryReader: While reading '%ls': %s", configHelper.GetShardFilePath(shard).c_str(), e.what());
     }
     if (configHelper.GetTraceLevel() > 2)
         fprintf(stderr, "%s\n", log.str().c_str());
 }
 
+void CNTKBinaryReader::StartEpoch(const EpochConfiguration& config, const std::map<std::wstring, int>& inputDescriptions)
+{
+    if (m_configHelper->GetNumberOfShards() == 1)
+        return ReaderBase::StartEpoch(config, inputDescriptions);
+
+    EpochConfiguration local = config;
+    static_cast<ReaderConfiguration&>(local) = SelectShard(config);
+
+    // The worker reads its share of the epoch from its shard, a sweep of the data is a sweep of the shard.
+    if (config.m_totalEpochSizeInSamples != Microsoft::MSR::CNTK::requestDataSize)
+    {
+        local.m_totalEpochSizeInSamples = config.m_totalEpochSizeInSamples / config.m_numberOfWorkers +
+            (config.m_totalEpochSizeInSamples % config.m_numberOfWorkers > config.m_workerRank ? 1 : 0);
+        if (local.m_totalEpochSizeInSamples == 0)
+            InvalidArgument("The epoch size '%" PRIu64 "' is too small to be used with %" PRIu64 " workers.",
+                config.m_totalEpochSizeInSamples, config.m_numberOfWorkers);
+    }
+
+    ReaderBase::StartEpoch(local, inputDescriptions);
+}
+
+void CNTKBinaryReader::SetConfiguration(const ReaderConfiguration& config, const std::map<std::wstring, int>& inputDescriptions)
+{
+    if (m_configHelper->GetNumberOfShards() == 1)
+        return ReaderBase::SetConfiguration(config, inputDescriptions);
+
+    ReaderBase::SetConfiguration(SelectShard(config), inputDescriptions);
+}
+
+ReaderConfiguration CNTKBinaryReader::SelectShard(const ReaderConfiguration& config)
+{
+    if (config.m_numberOfWorkers != m_configHelper->GetNumberOfShards())
+        InvalidArgument("CNTKBinaryReader: The file '%ls' has %" PRIu64 " shards, but there are %" PRIu64 " workers, each worker has to read its own shard.",
+            m_configHelper->GetFilePath().c_str(), m_configHelper->GetNumberOfShards(), config.m_numberOfWorkers);
+
+    if (config.m_workerRank != m_shard)
+    {
+        m_shard = config.m_workerRank;
+        Initialize(m_shard);
+    }
+
+    // The shard only contains the data of this worker, so the randomizer must not decimate it,
+    // the worker reads its share of the minibatch.
+    ReaderConfiguration local = config;
+    local.m_numberOfWorkers = 1;
+    local.m_workerRank = 0;
+    local.m_minibatchSizeInSamples = config.m_minibatchSizeInSamples / config.m_numberOfWorkers +
+        (config.m_minibatchSizeInSamples % config.m_numberOfWorkers > config.m_workerRank ? 1 : 0);
+    if (local.m_minibatchSizeInSamples == 0)
+    {
+        // We expect to have a least a single sample per worker.
+        fprintf(stderr, "WARNING: The minibatch size '%" PRIu64 "' is too small to be used with %" PRIu64 " workers, adjusting to minibatch size of 1 sample per worker\n",
+            config.m_minibatchSizeInSamples, config.m_numberOfWorkers);
+        local.m_minibatchSizeInSamples = 1;
+    }
+    return local;
+}
+
 }
@@ -14,13 +14,35 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 namespace CNTK {
 
 
+class BinaryConfigHelper;
+
 // Implementation of the binary reader.
 // Effectively the class represents a factory for connecting the packer,
 // transformers and the deserializer together.
+// If the file has been written in several shards (numShards > 1, one shard per worker), each worker
+// opens the shard of its rank and reads all of it: the randomizer sees a single worker, so that
+// the data is not decimated a second time. Only the minibatch size is split among the workers.
 class CNTKBinaryReader : public ReaderBase
 {
 public:
     CNTKBinaryReader(const Microsoft::MSR::CNTK::ConfigParameters& parameters);
+
+    void StartEpoch(const EpochConfiguration& config, const std::map<std::wstring, int>& inputDescriptions) override;
+
+    void SetConfiguration(const ReaderConfiguration& config, const std::map<std::wstring, int>& inputDescriptions) override;
+
+private:
+    // Creates the deserializer of the given shard, the randomizer and the packer.
+    void Initialize(size_t shard);
+
+    // Opens the shard of the worker if needed and returns the configuration of the worker within its shard.
+    ReaderConfiguration SelectShard(const ReaderConfiguration& config);
+
+    std::shared_ptr<Microsoft::MSR::CNTK::ConfigParameters> m_config;
+    std::shared_ptr<BinaryConfigHelper> m_configHelper;
+
+    // Shard that is currently open.
+    size_t m_shard;
 };
 
 }
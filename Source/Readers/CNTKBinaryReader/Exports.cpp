@@ -46,7 +46,10 @@ extern "C" DATAREADER_API bool CreateDeserializer(DataDeserializerPtr& deseriali
     
     if (type == L"CNTKBinaryFormatDeserializer")
     {
-        deserializer = make_shared<BinaryChunkDeserializer>(BinaryConfigHelper(deserializerConfig));
+        BinaryConfigHelper helper(deserializerConfig);
+        if (helper.GetNumberOfShards() > 1)
+            InvalidArgument("Sharded binary files can only be read by the CNTKBinaryReader, which opens the shard of the worker.");
+        deserializer = make_shared<BinaryChunkDeserializer>(helper);
     }
     else
         InvalidArgument("Unknown deserializer type '%ls'", type.c_str());
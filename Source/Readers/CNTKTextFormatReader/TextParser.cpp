@@ -11,6 +11,7 @@
 #include "IndexBuilder.h"
 #include "TextParser.h"
 #include "TextReaderConstants.h"
+#include "TextScanning.h"
 #include "File.h"
 
 #define isSign(c) ((c == '-' || c == '+'))
@@ -223,6 +224,22 @@ std::vector<ChunkInfo> TextParser<ElemType>::ChunkInfos()
     return result;
 }
 
+template <class ElemType>
+void TextParser<ElemType>::HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds)
+{
+    // Only a hint: the chunks are still read through the shared buffered reader when they are requested.
+    // It is given on the reader thread, while GetChunk may reopen the file on a load thread.
+    std::shared_ptr<FileWrapper> file;
+    {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        file = m_file;
+    }
+
+    const auto& chunks = m_index->Chunks();
+    for (auto chunkId : chunkIds)
+        file->AdviseWillNeed(chunks[chunkId].StartOffset(), chunks[chunkId].SizeInBytes());
+}
+
 template <class ElemType>
 void TextParser<ElemType>::SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& result)
 {
@@ -268,8 +285,10 @@ ChunkPtr TextParser<ElemType>::GetChunk(ChunkIdType chunkId)
     {
         if (m_file->CheckError())
         {
-            m_file.reset(new FileWrapper(m_filename, L"rbS"));
-            m_file->CheckIsOpenOrDie();
+            auto file = std::make_shared<FileWrapper>(m_filename, L"rbS");
+            file->CheckIsOpenOrDie();
+            std::lock_guard<std::mutex> lock(m_fileMutex);
+            m_file = file;
         }
 
         LoadChunk(textChunk, chunkDescriptor);
@@ -710,6 +729,12 @@ bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t s
 
     while (bytesToRead && CanRead())
     {
+        // Values that are entirely in the current buffer are read in bulk,
+        // whatever the bulk reader stops at is handled one character at a time.
+        counter += ReadDenseValuesInBulk(values, bytesToRead);
+        if (!bytesToRead || !CanRead())
+            break;
+
         char c = m_fileReader->Peek();
 
         if (isValueDelimiter(c))
@@ -795,6 +820,11 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
 
     while (bytesToRead && CanRead())
     {
+        // Same as for dense samples, valid index-value pairs in the current buffer are read in bulk.
+        ReadSparseValuesInBulk(values, indices, sampleSize, bytesToRead);
+        if (!bytesToRead || !CanRead())
+            break;
+
         char c = m_fileReader->Peek();
 
         if (isValueDelimiter(c))
@@ -883,14 +913,87 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
     return bytesToRead > 0 || values.size() > 0;
 }
 
+template <class ElemType>
+size_t TextParser<ElemType>::ReadDenseValuesInBulk(vector<ElemType>& values, size_t& bytesToRead)
+{
+    const char* begin = m_fileReader->CurrentBuffer();
+    const char* end = begin + min(bytesToRead, m_fileReader->BufferedBytes());
+    const char* position = begin;
+    size_t counter = 0;
+    double value;
+
+    while (position < end)
+    {
+        if (isValueDelimiter(*position))
+        {
+            ++position;
+            continue;
+        }
+
+        // Only values followed by a delimiter in the buffer are complete.
+        const char* valueEnd = FindValueEnd(position, end);
+        if (valueEnd == end || !TryParseRealNumber(position, valueEnd, value))
+            break;
+
+        values.push_back(static_cast<ElemType>(value));
+        ++counter;
+        position = valueEnd;
+    }
+
+    m_fileReader->Skip(position - begin);
+    bytesToRead -= position - begin;
+    return counter;
+}
+
+template <class ElemType>
+void TextParser<ElemType>::ReadSparseValuesInBulk(vector<ElemType>& values, vector<SparseIndexType>& indices,
+    size_t sampleSize, size_t& bytesToRead)
+{
+    const char* begin = m_fileReader->CurrentBuffer();
+    const char* end = begin + min(bytesToRead, m_fileReader->BufferedBytes());
+    const char* position = begin;
+    size_t index;
+    double value;
+
+    while (position < end)
+    {
+        if (isValueDelimiter(*position))
+        {
+            ++position;
+            continue;
+        }
+
+        const char* valueEnd = FindValueEnd(position, end);
+        if (valueEnd == end)
+            break;
+
+        const char* indexEnd = static_cast<const char*>(memchr(position, INDEX_DELIMITER, valueEnd - position));
+        if (!indexEnd || !TryParseUint64(position, indexEnd, index) || index >= sampleSize ||
+            !TryParseRealNumber(indexEnd + 1, valueEnd, value))
+            break;
+
+        values.push_back(static_cast<ElemType>(value));
+        indices.push_back(static_cast<SparseIndexType>(index));
+        position = valueEnd;
+    }
+
+    m_fileReader->Skip(position - begin);
+    bytesToRead -= position - begin;
+}
+
 template <class ElemType>
 void TextParser<ElemType>::SkipToNextInput(size_t& bytesToRead)
 {
-    for (; bytesToRead && CanRead(); m_fileReader->Pop(), --bytesToRead)
+    // skip everything until we hit either an input marker or the end of row.
+    while (bytesToRead && CanRead())
     {
-        char c = m_fileReader->Peek();
-        // skip everything until we hit either an input marker or the end of row.
-        if (c == NAME_PREFIX || c == ROW_DELIMITER)
+        const char* begin = m_fileReader->CurrentBuffer();
+        const char* end = begin + min(bytesToRead, m_fileReader->BufferedBytes());
+        const char* found = FindInputOrRowEnd(begin, end);
+
+        m_fileReader->Skip(found - begin);
+        bytesToRead -= found - begin;
+        if (found != end)
         {
             return;
         }
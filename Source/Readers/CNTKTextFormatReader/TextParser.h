@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <mutex>
 #include "DataDeserializerBase.h"
 #include "Descriptors.h"
 #include "TextConfigHelper.h"
@@ -38,6 +39,9 @@ public:
 
     bool GetSequenceInfoByKey(const SequenceKey&, SequenceInfo&) override;
 
+    // Asks the operating system to start reading the given chunks.
+    void HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds) override;
+
 private:
     TextParser(CorpusDescriptorPtr corpus, const std::wstring& filename, const vector<StreamDescriptor>& streams, bool primary = true);
 
@@ -108,6 +112,7 @@ private:
 
     const std::wstring m_filename;
     std::shared_ptr<FileWrapper> m_file;
+    std::mutex m_fileMutex; // Guards m_file, which is reopened on a load thread and used for hints on the reader thread.
     std::shared_ptr<BufferedFileReader> m_fileReader;
 
     // An internal structure to assist with copying from input stream buffers into
@@ -169,6 +174,14 @@ private:
     bool TryReadSparseSample(std::vector<ElemType>& values, std::vector<SparseIndexType>& indices,
         size_t sampleSize, size_t& bytesToRead);
 
+    // Reads the dense values that are entirely in the current buffer, stopping at the end of the sample or
+    // at anything that needs to be read by TryReadRealNumber. Returns the number of values read.
+    size_t ReadDenseValuesInBulk(std::vector<ElemType>& values, size_t& bytesToRead);
+
+    // Same as above for sparse index-value pairs, stops at anything that needs to be read by TryReadSparseSample.
+    void ReadSparseValuesInBulk(std::vector<ElemType>& values, std::vector<SparseIndexType>& indices,
+        size_t sampleSize, size_t& bytesToRead);
+
     // Reads one sample (an input identifier followed by a list of values)
     bool TryReadSample(SequenceBuffer& sequence, size_t& bytesToRead);
 
@@ -0,0 +1,197 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Bulk scanning of CNTK text format buffers: a vectorized search for the end of a value and a conversion
+// of a whole number token, used by the text parser to read the values that are entirely inside of
+// the current buffer. Anything these do not handle is left to the character by character parser,
+// which also reports the errors.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include "TextReaderConstants.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define VECTORIZED_TEXT_SCANNING_SUPPORTED
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace CNTK {
+
+    inline bool IsValueEnd(char c)
+    {
+        return isValueDelimiter(c) || c == NAME_PREFIX || isNonPrintable(c);
+    }
+
+#ifdef VECTORIZED_TEXT_SCANNING_SUPPORTED
+    inline int FirstSetBit(unsigned int mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    // Returns the position of the first character in [begin, end) that ends a value (a value delimiter,
+    // a name prefix or a non-printable character), or end if there is none.
+    inline const char* FindValueEnd(const char* begin, const char* end)
+    {
+        const char* p = begin;
+#ifdef VECTORIZED_TEXT_SCANNING_SUPPORTED
+        // Value delimiters and non-printable characters are exactly the (signed) characters up to the space.
+        const __m128i space = _mm_set1_epi8(SPACE_CHAR + 1);
+        const __m128i prefix = _mm_set1_epi8(NAME_PREFIX);
+        for (; p + 16 <= end; p += 16)
+        {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i found = _mm_or_si128(_mm_cmplt_epi8(chars, space), _mm_cmpeq_epi8(chars, prefix));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+            if (mask)
+                return p + FirstSetBit(mask);
+        }
+#endif
+        for (; p < end && !IsValueEnd(*p); ++p);
+        return p;
+    }
+
+    // Returns the position of the first name prefix or row delimiter in [begin, end), or end if there is none.
+    inline const char* FindInputOrRowEnd(const char* begin, const char* end)
+    {
+        const char* p = begin;
+#ifdef VECTORIZED_TEXT_SCANNING_SUPPORTED
+        const __m128i prefix = _mm_set1_epi8(NAME_PREFIX);
+        const __m128i row = _mm_set1_epi8(ROW_DELIMITER);
+        for (; p + 16 <= end; p += 16)
+        {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i found = _mm_or_si128(_mm_cmpeq_epi8(chars, prefix), _mm_cmpeq_epi8(chars, row));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+            if (mask)
+                return p + FirstSetBit(mask);
+        }
+#endif
+        for (; p < end && *p != NAME_PREFIX && *p != ROW_DELIMITER; ++p);
+        return p;
+    }
+
+    // Tries to read an unsigned integer that takes up the whole [begin, end), returns false if it does not, or if it overflows.
+    inline bool TryParseUint64(const char* begin, const char* end, size_t& value)
+    {
+        if (begin == end)
+            return false;
+
+        value = 0;
+        for (const char* p = begin; p < end; ++p)
+        {
+            if (*p < '0' || *p > '9')
+                return false;
+
+            size_t temp = value;
+            value = value * 10 + (*p - '0');
+            if (temp > value)
+                return false;
+        }
+        return true;
+    }
+
+    // Tries to read a floating point number ([sign]digits[.digits][(e|E)[sign]digits]) that takes up the whole [begin, end).
+    // Digits are accumulated into an integer, which is then scaled by an exactly representable power of ten,
+    // so the result is correctly rounded for up to 15 significant digits. Returns false for anything else,
+    // including numbers with more than 19 significant digits or a decimal exponent beyond 22 in magnitude,
+    // those are left to the general parser.
+    inline bool TryParseRealNumber(const char* begin, const char* end, double& value)
+    {
+        static const double s_powersOf10[] =
+        {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        const int maxExponent = 22, maxSignificantDigits = 19;
+
+        const char* p = begin;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        uint64_t mantissa = 0;
+        int significantDigits = 0, exponent = 0;
+        auto accumulate = [&](char c)
+        {
+            if (mantissa == 0 && c == '0')
+                return true; // leading zeros are not significant.
+            mantissa = mantissa * 10 + (c - '0');
+            return ++significantDigits <= maxSignificantDigits;
+        };
+
+        const char* integralPart = p;
+        for (; p < end && '0' <= *p && *p <= '9'; ++p)
+        {
+            if (!accumulate(*p))
+                return false;
+        }
+        if (p == integralPart)
+            return false;
+
+        if (p < end && *p == '.')
+        {
+            const char* fractionalPart = ++p;
+            for (; p < end && '0' <= *p && *p <= '9'; ++p, --exponent)
+            {
+                if (!accumulate(*p))
+                    return false;
+            }
+            if (p == fractionalPart)
+                return false;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            ++p;
+            bool negativeExponent = false;
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                negativeExponent = (*p == '-');
+                ++p;
+            }
+
+            const char* exponentPart = p;
+            int explicitExponent = 0;
+            for (; p < end && '0' <= *p && *p <= '9'; ++p)
+            {
+                explicitExponent = explicitExponent * 10 + (*p - '0');
+                if (explicitExponent > 2 * maxExponent + maxSignificantDigits)
+                    return false;
+            }
+            if (p == exponentPart)
+                return false;
+
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (p != end)
+            return false;
+
+        double result = static_cast<double>(mantissa);
+        if (mantissa != 0)
+        {
+            if (exponent < -maxExponent || exponent > maxExponent)
+                return false;
+            result = (exponent < 0) ? result / s_powersOf10[-exponent] : result * s_powersOf10[exponent];
+        }
+
+        value = negative ? -result : result;
+        return true;
+    }
+}
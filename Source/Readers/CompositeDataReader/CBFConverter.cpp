@@ -0,0 +1,143 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <thread>
+#include "CBFConverter.h"
+#include "ReaderConstants.h"
+
+namespace CNTK {
+
+using namespace Microsoft::MSR::CNTK;
+
+CBFConverter::CBFConverter(const ConfigParameters& config)
+{
+    wstring outputFile = config(L"outputFile");
+    m_outputFile = outputFile;
+    m_numberOfShards = config(L"numShards", (size_t)1);
+    m_chunkSizeInBytes = config(L"chunkSizeInBytes", g_32MB);
+    m_numberOfThreads = config(L"numThreads", (size_t)std::max(std::thread::hardware_concurrency(), 1u));
+    m_concurrentChunkLoading = config(L"concurrentChunkLoading", false);
+    m_traceLevel = config(L"traceLevel", 1);
+    bool compress = config(L"compressChunks", false);
+
+    if (m_numberOfShards == 0)
+        InvalidArgument("numShards has to be positive.");
+    if (m_chunkSizeInBytes == 0)
+        InvalidArgument("chunkSizeInBytes has to be positive.");
+    m_numberOfThreads = std::max(m_numberOfThreads, (size_t)1);
+
+    ConfigParameters readerConfig(config(L"reader"));
+    m_reader.reset(new CompositeDataReader(readerConfig));
+    m_deserializer = m_reader->GetDeserializer();
+    m_serializer.reset(new CBFChunkSerializer(m_deserializer->StreamInfos(), compress));
+}
+
+void CBFConverter::Convert()
+{
+    auto start = std::chrono::system_clock::now();
+    auto chunks = m_deserializer->ChunkInfos();
+
+    CBFWriter writer(m_outputFile, m_serializer->GetStreams(), m_serializer->GetVersion(), m_numberOfShards);
+    if (m_traceLevel > 0)
+        fprintf(stderr, "CBFConverter: converting %" PRIu64 " chunks into '%ls' (%" PRIu64 " shard(s)) on %" PRIu64 " thread(s).\n",
+            chunks.size(), m_outputFile.c_str(), m_numberOfShards, m_numberOfThreads);
+
+    // Up to m_numberOfThreads input chunks are converted at the same time, the results are written in order.
+    std::deque<std::future<std::vector<CBFChunk>>> pending;
+    size_t next = 0, numberOfChunks = 0, numberOfSamples = 0;
+    while (next < chunks.size() || !pending.empty())
+    {
+        while (next < chunks.size() && pending.size() < m_numberOfThreads)
+        {
+            const ChunkInfo& chunk = chunks[next++];
+            pending.push_back(std::async(std::launch::async, [this, &chunk]() { return ConvertChunk(chunk); }));
+        }
+
+        auto converted = pending.front().get();
+        pending.pop_front();
+        for (const auto& c : converted)
+        {
+            writer.WriteChunk(c);
+            numberOfSamples += c.m_numberOfSamples;
+        }
+        numberOfChunks += converted.size();
+
+        if (m_traceLevel > 1)
+            fprintf(stderr, "CBFConverter: converted %" PRIu64 " of %" PRIu64 " input chunks.\n", next - pending.size(), chunks.size());
+    }
+
+    writer.Complete();
+
+    if (m_traceLevel > 0)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start);
+        fprintf(stderr, "CBFConverter: wrote %" PRIu64 " samples in %" PRIu64 " chunks in %.3f seconds.\n",
+            numberOfSamples, numberOfChunks, elapsed.count() / 1000.0);
+    }
+}
+
+std::vector<CBFChunk> CBFConverter::ConvertChunk(const ChunkInfo& chunkInfo)
+{
+    ChunkPtr chunk;
+    std::vector<SequenceInfo> sequences;
+    {
+        std::unique_lock<std::mutex> lock(m_deserializerMutex, std::defer_lock);
+        if (!m_concurrentChunkLoading)
+            lock.lock();
+
+        chunk = m_deserializer->GetChunk(chunkInfo.m_id);
+        m_deserializer->SequenceInfosForChunk(chunkInfo.m_id, sequences);
+    }
+
+    std::vector<CBFChunk> result;
+    std::vector<std::vector<SequenceDataPtr>> batch;
+    size_t batchSize = 0;
+    auto flush = [&]()
+    {
+        result.push_back(CBFChunk());
+        m_serializer->Serialize(batch, result.back());
+        batch.clear();
+        batchSize = 0;
+    };
+
+    size_t numberOfInvalidSequences = 0;
+    for (const auto& sequence : sequences)
+    {
+        std::vector<SequenceDataPtr> data;
+        chunk->GetSequence(sequence.m_indexInChunk, data);
+
+        bool isValid = std::all_of(data.begin(), data.end(), [](const SequenceDataPtr& s) { return s->m_isValid; });
+        if (!isValid)
+        {
+            numberOfInvalidSequences++;
+            continue;
+        }
+
+        size_t size = m_serializer->GetSerializedSize(data);
+        if (!batch.empty() && batchSize + size > m_chunkSizeInBytes)
+            flush();
+
+        batch.push_back(std::move(data));
+        batchSize += size;
+    }
+
+    if (!batch.empty())
+        flush();
+
+    if (numberOfInvalidSequences > 0)
+        fprintf(stderr, "WARNING: CBFConverter: skipped %" PRIu64 " invalid sequences in chunk %" PRIu64 ".\n",
+            numberOfInvalidSequences, (size_t)chunkInfo.m_id);
+
+    return result;
+}
+
+}
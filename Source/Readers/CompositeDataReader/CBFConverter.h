@@ -0,0 +1,56 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "CompositeDataReader.h"
+#include "CBFWriter.h"
+
+namespace CNTK {
+
+// Converts the data provided by the deserializers of a reader config (i.e. CTF, HTK or any other deserializer)
+// into the CNTK binary format. Input chunks are loaded and serialized on several threads, the resulting chunks
+// are written in the order of the input. Transforms are not applied, the sequences are written as deserialized.
+// Config parameters:
+//     outputFile             - name of the CBF file, with several shards the shards are named <outputFile>.<shard index>
+//     numShards              - number of shards (1 by default), usually the number of workers that read the data
+//     compressChunks         - compress the data of the chunks (false by default)
+//     chunkSizeInBytes       - maximum size of the written chunks (32MB by default), chunks never span several input chunks
+//     numThreads             - number of input chunks that are converted at the same time (number of cores by default)
+//     concurrentChunkLoading - load input chunks concurrently, only if the deserializers support it (false by default)
+//     reader                 - the reader config with the deserializers, as for the CompositeDataReader
+class CBFConverter
+{
+public:
+    explicit CBFConverter(const Microsoft::MSR::CNTK::ConfigParameters& config);
+
+    void Convert();
+
+private:
+    // Loads an input chunk and serializes its sequences into one or several output chunks.
+    std::vector<CBFChunk> ConvertChunk(const ChunkInfo& chunk);
+
+    std::wstring m_outputFile;
+    size_t m_numberOfShards;
+    size_t m_chunkSizeInBytes;
+    size_t m_numberOfThreads;
+    bool m_concurrentChunkLoading;
+    int m_traceLevel;
+
+    // The reader is kept alive, because it owns the modules of the deserializers.
+    std::unique_ptr<CompositeDataReader> m_reader;
+    DataDeserializerPtr m_deserializer;
+    std::mutex m_deserializerMutex;
+
+    std::unique_ptr<CBFChunkSerializer> m_serializer;
+
+    DISABLE_COPY_AND_MOVE(CBFConverter);
+};
+
+}
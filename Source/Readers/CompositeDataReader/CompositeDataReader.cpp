@@ -94,14 +94,15 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
     if (!composable && m_deserializers.size() > 1)
         InvalidArgument("Currently user defined deserializers do not support composability. Please specify a single deserializer.");
 
-    DataDeserializerPtr deserializer = m_deserializers.front();
+    m_deserializer = m_deserializers.front();
     if (m_deserializers.size() > 1)
     {
         // Bundling deserializers together.
         // Option whether we need to check data between different deserializers.
         bool cleanse = config(L"checkData", true);
-        deserializer = std::make_shared<Bundler>(config, m_corpus, deserializer, m_deserializers, cleanse);
+        m_deserializer = std::make_shared<Bundler>(config, m_corpus, m_deserializer, m_deserializers, cleanse);
     }
+    DataDeserializerPtr deserializer = m_deserializer;
 
     int verbosity = config(L"verbosity", 0);
 
@@ -124,7 +125,7 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
             m_sequenceEnumerator = std::make_shared<LTTumblingWindowRandomizer>(deserializer,
                 sampleBasedRandomizationWindow, config(L"randomizationWindow", requestDataSize),
                 GetRandomSeed(config),
-                multiThreadedDeserialization, maxErrors);
+                multiThreadedDeserialization, maxErrors, ChunkAffinityConfig(config));
         }
         else
             m_sequenceEnumerator = std::make_shared<LTNoRandomizer>(deserializer, multiThreadedDeserialization, maxErrors);
@@ -165,16 +166,19 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
 
             bool shouldPrefetch = true;
             m_sequenceEnumerator = std::make_shared<BlockRandomizer>(verbosity, randomizationWindow, deserializer, shouldPrefetch,
-                multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config));
+                multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config), ChunkPrefetchConfig(config),
+                ChunkAffinityConfig(config));
         }
         else
             m_sequenceEnumerator = std::make_shared<NoRandomizer>(deserializer, multiThreadedDeserialization, maxErrors);
     }
 
     // In case when there are transforms, applying them to the data.
+    // Consecutive transforms are fused into a single pass where possible if requested.
+    bool fuseTransforms = config(L"fuseTransforms", false);
     m_sequenceEnumerator = m_transforms.empty()
         ? m_sequenceEnumerator
-        : std::make_shared<TransformController>(m_transforms, m_sequenceEnumerator, multiThreadedDeserialization);
+        : std::make_shared<TransformController>(m_transforms, m_sequenceEnumerator, multiThreadedDeserialization, fuseTransforms);
 
     // TODO: Output stream descriptions - this should come from the network so that we can check 
     // that input matches what the network expects (including tensor shape, etc.).
@@ -60,6 +60,9 @@ public:
     // Starts a new epoch with the provided configuration
     void StartEpoch(const EpochConfiguration& config, const std::map<std::wstring, int>& inputDescriptions) override;
 
+    // Returns the deserializer that provides sequences to the randomizer, bundled if there are several deserializers.
+    DataDeserializerPtr GetDeserializer() const { return m_deserializer; }
+
 private:
     bool CreateDeserializers(const Microsoft::MSR::CNTK::ConfigParameters& readerConfig);
     void CreateTransforms(const Microsoft::MSR::CNTK::ConfigParameters& deserializerConfig);
@@ -82,6 +85,9 @@ private:
     // A list of deserializers.
     std::vector<DataDeserializerPtr> m_deserializers;
 
+    // The deserializer the randomizer reads from.
+    DataDeserializerPtr m_deserializer;
+
     // A list of transformers.
     std::vector<Transformation> m_transforms;
 
@@ -12,6 +12,7 @@
 #include "DataReader.h"
 #include "CompositeDataReader.h"
 #include "ReaderShim.h"
+#include "CBFConverter.h"
 
 namespace CNTK {
 
@@ -51,4 +52,11 @@ extern "C" DATAREADER_API Reader* CreateCompositeDataReader(const ConfigParamete
     return new CompositeDataReader(*parameters);
 }
 
+// Converts the data of the deserializers in the config into the CNTK binary format, see CBFConverter.
+extern "C" DATAREADER_API void ConvertToCBF(const ConfigParameters* config)
+{
+    CBFConverter converter(*config);
+    converter.Convert();
+}
+
 }
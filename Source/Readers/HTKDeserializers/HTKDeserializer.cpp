@@ -248,6 +248,9 @@ void HTKDeserializer::InitializeChunkInfos(ConfigHelper& config)
     {
         RuntimeError("HTKDeserializer: No utterances to process.");
     }
+
+    m_chunkUsers.assign(m_chunks.size(), 0);
+    m_chunkLocks.reset(new std::mutex[m_chunks.size()]);
 }
 
 // Describes exposed stream - a single stream of htk features.
@@ -375,12 +378,19 @@ public:
     {
         auto& chunkInfo = m_parent->m_chunks[chunkId];
 
-        // possibly distributed read
-        // making several attempts
-        msra::util::attempt(5, [&]()
+        // Chunks can be loaded concurrently, and a chunk can be requested again while its previous HTKChunk is being
+        // destroyed, so the data is paged in by the first user and paged out by the last one.
+        std::lock_guard<std::mutex> lock(m_parent->m_chunkLocks[chunkId]);
+        if (m_parent->m_chunkUsers[chunkId] == 0)
         {
-            chunkInfo.RequireData(m_parent->m_featureKind, m_parent->m_ioFeatureDimension, m_parent->m_samplePeriod, m_parent->m_verbosity);
-        });
+            // possibly distributed read
+            // making several attempts
+            msra::util::attempt(5, [&]()
+            {
+                chunkInfo.RequireData(m_parent->m_featureKind, m_parent->m_ioFeatureDimension, m_parent->m_samplePeriod, m_parent->m_verbosity);
+            });
+        }
+        m_parent->m_chunkUsers[chunkId]++;
     }
 
     // Gets data for the sequence.
@@ -392,8 +402,12 @@ public:
     // Unloads the data from memory.
     ~HTKChunk()
     {
-        auto& chunkInfo = m_parent->m_chunks[m_chunkId];
-        chunkInfo.ReleaseData(m_parent->m_verbosity);
+        std::lock_guard<std::mutex> lock(m_parent->m_chunkLocks[m_chunkId]);
+        if (--m_parent->m_chunkUsers[m_chunkId] == 0)
+        {
+            auto& chunkInfo = m_parent->m_chunks[m_chunkId];
+            chunkInfo.ReleaseData(m_parent->m_verbosity);
+        }
     }
 
 private:
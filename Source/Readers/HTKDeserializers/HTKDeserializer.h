@@ -12,6 +12,7 @@
 #include "HTKChunkDescription.h"
 #include "ConfigHelper.h"
 #include <boost/noncopyable.hpp>
+#include <mutex>
 
 namespace CNTK {
 
@@ -38,6 +39,12 @@ public:
     // Gets sequence description by the primary one.
     virtual bool GetSequenceInfo(const SequenceInfo& primary, SequenceInfo&) override;
 
+    // Every chunk is read with its own feature reader, so chunks can be loaded concurrently.
+    virtual bool SupportsConcurrentGetChunk() const override
+    {
+        return true;
+    }
+
 private:
     class HTKChunk;
 
@@ -59,6 +66,10 @@ private:
     // Chunk descriptions.
     std::vector<HTKChunkInfo> m_chunks;
 
+    // Number of HTKChunks that use the data of a chunk, and per chunk locks that guard the counts and the paging of the data.
+    std::vector<size_t> m_chunkUsers;
+    std::unique_ptr<std::mutex[]> m_chunkLocks;
+
     // Augmentation window.
     std::pair<size_t, size_t> m_augmentationWindow;
 
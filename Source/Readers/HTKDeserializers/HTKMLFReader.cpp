@@ -119,7 +119,9 @@ HTKMLFReader::HTKMLFReader(const ConfigParameters& readerConfig)
             /*multithreadedGetNextSequences =*/ false, // default
             /*maxNumberOfInvalidSequences =*/ 0, // default
             /*sampleBasedRandomizationWindow =*/ true, // default
-            GetRandomSeed(readerConfig));
+            GetRandomSeed(readerConfig),
+            ChunkPrefetchConfig(readerConfig),
+            ChunkAffinityConfig(readerConfig));
     }
     else if (AreEqualIgnoreCase(readMethod, std::wstring(L"none")))
     {
@@ -34,6 +34,12 @@ public:
     // Retrieves data for a chunk.
     virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
 
+    // Every chunk opens the file and reads its part of it, so chunks can be loaded concurrently.
+    virtual bool SupportsConcurrentGetChunk() const override
+    {
+        return true;
+    }
+
 private:
     class LatticeChunk;
     class ChunkBase;
@@ -36,6 +36,12 @@ public:
     // Retrieves a chunk with data.
     virtual ChunkPtr GetChunk(ChunkIdType) override;
 
+    // Every chunk opens the file and reads its part of it, so chunks can be loaded concurrently.
+    virtual bool SupportsConcurrentGetChunk() const override
+    {
+        return true;
+    }
+
 private:
     class ChunkBase;
     class SequenceChunk;
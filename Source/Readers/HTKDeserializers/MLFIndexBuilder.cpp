@@ -48,110 +48,137 @@ namespace CNTK {
     // MLF file should start with the MLF header (State::Header -> State:UtteranceKey).
     // Each utterance starts with an utterance key (State::UtteranceKey -> State::UtteranceFrames).
     // End of utterance is indicated by a single dot on a line (State::UtteranceFrames -> State::UtteranceKey)
+    // The file is scanned in parallel ranges. A range owns the utterances that follow the end of utterance
+    // lines starting inside of it, it scans up to the end of the first utterance past its end, and the next
+    // range starts after that same end of utterance line (State::Resync -> State::UtteranceKey).
 
     /*virtual*/ void MLFIndexBuilder::Populate(shared_ptr<Index>& index) /*override*/
     {
         m_input.CheckIsOpenOrDie();
 
-        index->Reserve(filesize(m_input.File()));
+        size_t fileSize = m_input.Filesize();
 
-        BufferedFileReader reader(m_bufferSize, m_input);
+        index->Reserve(fileSize);
 
-        if (reader.Empty())
+        if (fileSize == 0)
             RuntimeError("Input file is empty");
    
         if (!m_corpus)
             RuntimeError("MLFIndexBuilder: corpus descriptor was not specified.");
 
 
-        size_t id = 0;
-        State currentState = State::Header;
-        vector<boost::iterator_range<char*>> tokens;
-        bool isValid = true; // Flag indicating whether the current sequence is valid.
-        size_t sequenceStartOffset = 0; // Offset in file where current sequence starts.
-        string lastNonEmptyLine; // Needed to parse information about last frame
-        IndexedSequence sequence;
-        string line;
-        while (true)
+        auto scanRange = [this](size_t rangeEnd, BufferedFileReader& reader, vector<IndexedSequence>& sequences)
         {
-            auto offset = reader.GetFileOffset();
-
-            if (!reader.TryReadLine(line))
-                break;
+            size_t id = 0;
+            State currentState = (reader.GetFileOffset() == 0) ? State::Header : State::Resync;
+            vector<boost::iterator_range<char*>> tokens;
+            bool isValid = true; // Flag indicating whether the current sequence is valid.
+            size_t sequenceStartOffset = 0; // Offset in file where current sequence starts.
+            string lastNonEmptyLine; // Needed to parse information about last frame
+            IndexedSequence sequence;
+            string line;
+            while (true)
+            {
+                auto offset = reader.GetFileOffset();
 
-            if (!line.empty() && line.back() == '\r')
-                line.pop_back();
+                if (!reader.TryReadLine(line))
+                    break;
 
-            if (line.empty())
-                continue;
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
 
-            switch (currentState)
-            {
-            case State::Header:
-            {
-                if (line != "#!MLF!#")
-                    RuntimeError("Expected MLF header was not found.");
-                currentState = State::UtteranceKey;
-            }
-            break;
-            case State::UtteranceKey:
-            {
-                // When several files are appended to a big mlf, there can be
-                // an MLF header between the utterances.
-                if (line == "#!MLF!#")
+                if (line.empty())
                     continue;
 
-                lastNonEmptyLine.clear();
-
-                sequenceStartOffset = offset;
-                isValid = TryParseSequenceKey(line, id, m_corpus->KeyToId);
-                currentState = State::UtteranceFrames;
-            }
-            break;
-            case State::UtteranceFrames:
-            {
-                if (line != ".")
+                switch (currentState)
                 {
-                    // Remembering last non empty string to be able to retrieve time frame information 
-                    // when the dot is just at the beginning of the next buffer.
-                    lastNonEmptyLine = line;
-                    continue; // Still current utterance.
-                }   
-
-                // Ok, a single . on a line means we found the end of the utterance.
-                auto sequenceEndOffset = reader.GetFileOffset();
-
-                uint32_t numberOfSamples = 0;
-                if (lastNonEmptyLine.empty())
-                    isValid = false;
-                else
+                case State::Resync:
                 {
-                    tokens.clear();
-                    
-                    const static vector<bool> delim = DelimiterHash({ ' ' });
-                    Split(&lastNonEmptyLine[0], &lastNonEmptyLine[0] + lastNonEmptyLine.size(), delim, tokens);
+                    if (offset >= rangeEnd)
+                        return; // No utterance of this range.
 
-                    auto range = MLFFrameRange::ParseFrameRange(tokens, sequenceEndOffset);
-                    numberOfSamples = static_cast<uint32_t>(range.second);
+                    if (line == ".")
+                        currentState = State::UtteranceKey;
+                }
+                break;
+                case State::Header:
+                {
+                    if (line != "#!MLF!#")
+                        RuntimeError("Expected MLF header was not found.");
+                    currentState = State::UtteranceKey;
                 }
+                break;
+                case State::UtteranceKey:
+                {
+                    // When several files are appended to a big mlf, there can be
+                    // an MLF header between the utterances.
+                    if (line == "#!MLF!#")
+                        continue;
+
+                    lastNonEmptyLine.clear();
 
-                if (isValid)
+                    sequenceStartOffset = offset;
+                    isValid = TryParseSequenceKey(line, id, m_corpus->KeyToId);
+                    currentState = State::UtteranceFrames;
+                }
+                break;
+                case State::UtteranceFrames:
                 {
-                    sequence.SetKey(id)
-                        .SetNumberOfSamples(numberOfSamples)
-                        .SetOffset(sequenceStartOffset)
-                        .SetSize(sequenceEndOffset - sequenceStartOffset);
-                    index->AddSequence(sequence);
+                    if (line != ".")
+                    {
+                        // Remembering last non empty string to be able to retrieve time frame information 
+                        // when the dot is just at the beginning of the next buffer.
+                        lastNonEmptyLine = line;
+                        continue; // Still current utterance.
+                    }   
+
+                    // Ok, a single . on a line means we found the end of the utterance.
+                    auto sequenceEndOffset = reader.GetFileOffset();
+
+                    uint32_t numberOfSamples = 0;
+                    if (lastNonEmptyLine.empty())
+                        isValid = false;
+                    else
+                    {
+                        tokens.clear();
+                        
+                        const static vector<bool> delim = DelimiterHash({ ' ' });
+                        Split(&lastNonEmptyLine[0], &lastNonEmptyLine[0] + lastNonEmptyLine.size(), delim, tokens);
+
+                        auto range = MLFFrameRange::ParseFrameRange(tokens, sequenceEndOffset);
+                        numberOfSamples = static_cast<uint32_t>(range.second);
+                    }
+
+                    if (isValid)
+                    {
+                        sequence.SetKey(id)
+                            .SetNumberOfSamples(numberOfSamples)
+                            .SetOffset(sequenceStartOffset)
+                            .SetSize(sequenceEndOffset - sequenceStartOffset);
+                        sequences.push_back(sequence);
+                    }
+                    else
+                        fprintf(stderr, "WARNING: Cannot parse the utterance '%s' at offset (%" PRIu64 ")\n", m_corpus->IdToKey(id).c_str(), sequenceStartOffset);
+
+                    if (offset >= rangeEnd)
+                        return; // The next utterance belongs to the next range.
+
+                    currentState = State::UtteranceKey; // Let's try the next one.
                 }
-                else
-                    fprintf(stderr, "WARNING: Cannot parse the utterance '%s' at offset (%" PRIu64 ")\n", m_corpus->IdToKey(id).c_str(), sequenceStartOffset);
-                currentState = State::UtteranceKey; // Let's try the next one.
+                break;
+                default:
+                    LogicError("Unexpected MLF state.");
+                }  
             }
-            break;
-            default:
-                LogicError("Unexpected MLF state.");
-            }  
-        }
+        };
+
+        auto mergeRange = [&index](vector<IndexedSequence>& sequences)
+        {
+            for (auto& sequence : sequences)
+                index->AddSequence(sequence);
+        };
+
+        ScanInParallel<vector<IndexedSequence>>(0, fileSize, scanRange, mergeRange);
     }
 
 
@@ -23,6 +23,7 @@ namespace CNTK {
 
         enum class State
         {
+            Resync, // Skipping the end of an utterance that belongs to the preceding scan range.
             Header,
             UtteranceKey,
             UtteranceFrames
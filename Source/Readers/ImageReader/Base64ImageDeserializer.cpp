@@ -9,6 +9,7 @@
 #include <opencv2/opencv.hpp>
 #include "Base64ImageDeserializer.h"
 #include "ImageTransformers.h"
+#include "ByteReader.h"
 #include "ReaderUtil.h"
 #include "Index.h"
 #include "IndexBuilder.h"
@@ -28,6 +29,8 @@ namespace CNTK {
         ImageChunk(const ChunkDescriptor& descriptor, Base64ImageDeserializerImpl& parent)
             : m_descriptor(descriptor), m_deserializer(parent)
         {
+            std::lock_guard<std::mutex> lock(m_deserializer.m_dataFileMutex);
+
             // Let's see if the open descriptor has problems.
             if (ferror(m_deserializer.m_dataFile.get()) != 0)
                 m_deserializer.m_dataFile.reset(fopenOrDie(m_deserializer.m_fileName.c_str(), L"rbS"), [](FILE* f) { if (f) fclose(f); });
@@ -105,16 +108,18 @@ namespace CNTK {
             while (currentSequence > imageStart &&  !IsBase64Char(*(currentSequence - 1)))
                 currentSequence--;
 
-            std::vector<char> decodedImage;
-            cv::Mat image;
-            if (!DecodeBase64(imageStart, currentSequence, decodedImage))
-            {
-                fprintf(stderr, "WARNING: Cannot decode sequence with id %zu in the input file '%ls'\n", sequence.m_key, m_deserializer.m_fileName.c_str());
-            }
-            else
+            cv::Mat image = m_deserializer.GetDecodedImage(sequence.m_key, [&]()
             {
-                image = cv::imdecode(decodedImage, m_deserializer.m_grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
-            }
+                std::vector<char> decodedImage;
+                if (!DecodeBase64(imageStart, currentSequence, decodedImage))
+                {
+                    fprintf(stderr, "WARNING: Cannot decode sequence with id %zu in the input file '%ls'\n", sequence.m_key, m_deserializer.m_fileName.c_str());
+                    return cv::Mat();
+                }
+
+                return DecodeImage(reinterpret_cast<const unsigned char*>(decodedImage.data()), decodedImage.size(),
+                                   m_deserializer.m_grayscale, m_deserializer.m_decodeMinimumSide);
+            });
 
             m_deserializer.PopulateSequenceData(image, classId, copyId, { sequence.m_key, 0 }, result);
         }
@@ -160,6 +165,8 @@ namespace CNTK {
                 .SetCachingEnabled(cacheIndex)
                 .Build();
         });
+
+        CreateDecodedImageCache(m_index->NumberOfSequences());
     }
 
     std::vector<ChunkInfo> Base64ImageDeserializerImpl::ChunkInfos()
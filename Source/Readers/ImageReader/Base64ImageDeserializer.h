@@ -8,6 +8,7 @@
 #include "ImageDeserializerBase.h"
 #include "Config.h"
 #include "CorpusDescriptor.h"
+#include <mutex>
 
 namespace CNTK {
 
@@ -20,6 +21,12 @@ namespace CNTK {
         // Get a chunk by id.
         ChunkPtr GetChunk(ChunkIdType chunkId) override;
 
+        // Reading of the chunks from the data file is serialized, so chunks can be loaded concurrently.
+        bool SupportsConcurrentGetChunk() const override
+        {
+            return true;
+        }
+
         // Get chunk descriptions.
         std::vector<ChunkInfo> ChunkInfos() override;
 
@@ -34,6 +41,7 @@ namespace CNTK {
 
         std::shared_ptr<Index> m_index;
         std::shared_ptr<FILE> m_dataFile;
+        std::mutex m_dataFileMutex; // Guards the position of the data file.
         std::wstring m_fileName;
         bool m_hasSequenceIds;
     };
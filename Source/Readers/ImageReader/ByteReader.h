@@ -17,6 +17,10 @@ namespace CNTK {
 
 using MultiMap = std::map<std::string, std::vector<size_t>>;
 
+// Decodes an encoded image. If minimumSide is not zero and the image is a JPEG, it is decoded in the DCT domain
+// at 1/2, 1/4 or 1/8 of its resolution, whichever is the smallest that keeps its shorter side at least minimumSide.
+cv::Mat DecodeImage(const unsigned char* data, size_t size, bool grayscale, size_t minimumSide);
+
 class ByteReader
 {
 public:
@@ -26,7 +30,16 @@ public:
     virtual void Register(const MultiMap& sequences) = 0;
     virtual cv::Mat Read(size_t seqId, const std::string& path, bool grayscale) = 0;
 
+    // Sets the shorter side images are at least decoded with, 0 (default) means full resolution.
+    void SetDecodeMinimumSide(size_t minimumSide)
+    {
+        m_decodeMinimumSide = minimumSide;
+    }
+
     DISABLE_COPY_AND_MOVE(ByteReader);
+
+protected:
+    size_t m_decodeMinimumSide = 0;
 };
 
 class FileByteReader : public ByteReader
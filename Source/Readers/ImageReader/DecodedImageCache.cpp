@@ -0,0 +1,287 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#ifndef __WINDOWS__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <cstring>
+#include <opencv2/core/core.hpp>
+#include "DecodedImageCache.h"
+
+namespace CNTK {
+
+using namespace Microsoft::MSR::CNTK;
+
+static const char s_cacheMagic[8] = { 'C', 'N', 'T', 'K', 'I', 'M', 'G', 'C' };
+
+DecodedImageCache::DecodedImageCache(const std::wstring& fileName, size_t numberOfImages, bool grayscale, size_t decodeMinimumSide)
+    : m_fileName(fileName),
+      m_numberOfImages(numberOfImages),
+      m_mappedData(nullptr),
+      m_mappedSize(0),
+#ifdef __WINDOWS__
+      m_fileHandle(INVALID_HANDLE_VALUE),
+      m_mappingHandle(nullptr)
+#else
+      m_fileDescriptor(-1)
+#endif
+{
+    // Several processes may build the same cache, the first one to complete it wins.
+    m_temporaryFileName = m_fileName + L"." + std::to_wstring((size_t)GetCurrentProcessId()) + L".tmp";
+
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.m_magic, s_cacheMagic, sizeof(s_cacheMagic));
+    m_header.m_version = CurrentVersion;
+    m_header.m_grayscale = grayscale ? 1 : 0;
+    m_header.m_decodeMinimumSide = decodeMinimumSide;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (fexists(m_fileName))
+        Map();
+}
+
+DecodedImageCache::~DecodedImageCache()
+{
+    // With distributed reading or when the training stops early not all images are seen,
+    // the images that have been decoded are still cached and the cache is extended in the next run.
+    try
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_temporaryFile)
+            Complete();
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "WARNING: Could not write the decoded image cache '%ls': %s\n", m_fileName.c_str(), e.what());
+        m_temporaryFile.reset();
+        if (fexists(m_temporaryFileName))
+            _wunlink(m_temporaryFileName.c_str());
+    }
+
+    Unmap();
+}
+
+bool DecodedImageCache::IsComplete() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_mappedData != nullptr && m_index.size() >= m_numberOfImages;
+}
+
+bool DecodedImageCache::TryGet(const std::string& key, cv::Mat& image)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = m_index.find(key);
+    if (found == m_index.end())
+        return false;
+
+    // The mapping is read only and transforms may change the image in place, so the pixels are copied.
+    // This happens under the lock, because completing an extended cache maps the new file.
+    const ImageEntry& entry = found->second;
+    image = cv::Mat(entry.m_rows, entry.m_cols, entry.m_type, const_cast<char*>(m_mappedData + entry.m_offset)).clone();
+    return true;
+}
+
+void DecodedImageCache::Add(const std::string& key, const cv::Mat& image)
+{
+    if (!image.data)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool isComplete = m_mappedData != nullptr && m_index.size() >= m_numberOfImages;
+    if (isComplete || m_index.find(key) != m_index.end() || m_temporaryIndex.find(key) != m_temporaryIndex.end())
+        return;
+
+    if (!m_temporaryFile)
+        CreateTemporaryFile();
+
+    Append(key, image);
+    if (m_temporaryIndex.size() >= m_numberOfImages)
+        Complete();
+}
+
+void DecodedImageCache::CreateTemporaryFile()
+{
+    m_temporaryFile.reset(new FileWrapper(FileWrapper::OpenOrDie(m_temporaryFileName, L"wb")));
+    m_temporaryFile->WriteOrDie(&m_header, sizeof(m_header), 1);
+
+    // The images of a partial cache file are kept.
+    for (const auto& image : m_index)
+    {
+        const ImageEntry& entry = image.second;
+        Append(image.first, cv::Mat(entry.m_rows, entry.m_cols, entry.m_type, const_cast<char*>(m_mappedData + entry.m_offset)));
+    }
+}
+
+void DecodedImageCache::Append(const std::string& key, const cv::Mat& image)
+{
+    static const char padding[ImageAlignment] = {};
+    uint64_t offset = m_temporaryFile->TellOrDie();
+    size_t paddingSize = (ImageAlignment - offset % ImageAlignment) % ImageAlignment;
+    m_temporaryFile->WriteOrDie(padding, 1, paddingSize);
+
+    ImageEntry entry = {};
+    entry.m_offset = offset + paddingSize;
+    entry.m_rows = image.rows;
+    entry.m_cols = image.cols;
+    entry.m_type = image.type();
+
+    size_t rowSize = image.cols * image.elemSize();
+    if (image.isContinuous())
+        m_temporaryFile->WriteOrDie(image.data, rowSize, image.rows);
+    else
+    {
+        for (int row = 0; row < image.rows; ++row)
+            m_temporaryFile->WriteOrDie(image.ptr(row), rowSize, 1);
+    }
+
+    m_temporaryIndex[key] = entry;
+}
+
+void DecodedImageCache::Complete()
+{
+    m_header.m_indexOffset = m_temporaryFile->TellOrDie();
+    m_header.m_numberOfImages = m_temporaryIndex.size();
+    for (const auto& image : m_temporaryIndex)
+    {
+        uint32_t keyLength = (uint32_t)image.first.size();
+        m_temporaryFile->WriteOrDie(&keyLength, sizeof(keyLength), 1);
+        m_temporaryFile->WriteOrDie(image.first.data(), 1, keyLength);
+        m_temporaryFile->WriteOrDie(&image.second, sizeof(image.second), 1);
+    }
+
+    m_temporaryFile->SeekOrDie(0, SEEK_SET);
+    m_temporaryFile->WriteOrDie(&m_header, sizeof(m_header), 1);
+    m_temporaryFile->FlushOrDie();
+    m_temporaryFile.reset();
+
+    // Several processes may build the same cache, the file with the most images is kept.
+    Unmap();
+    if (GetNumberOfImagesInFile() >= m_temporaryIndex.size())
+        unlinkOrDie(m_temporaryFileName);
+    else
+        renameOrDie(m_temporaryFileName, m_fileName);
+
+    m_temporaryIndex.clear();
+    Map();
+}
+
+size_t DecodedImageCache::GetNumberOfImagesInFile() const
+{
+    if (!fexists(m_fileName))
+        return 0;
+
+    Header header;
+    auto file = FileWrapper::OpenOrDie(m_fileName, L"rb");
+    if (fread(&header, sizeof(header), 1, file.File()) != 1 ||
+        memcmp(header.m_magic, s_cacheMagic, sizeof(s_cacheMagic)) != 0 || header.m_version != CurrentVersion ||
+        header.m_grayscale != m_header.m_grayscale || header.m_decodeMinimumSide != m_header.m_decodeMinimumSide)
+        return 0;
+    return header.m_numberOfImages;
+}
+
+void DecodedImageCache::Map()
+{
+#ifdef __WINDOWS__
+    m_fileHandle = CreateFileW(m_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+        RuntimeError("Cannot open the decoded image cache '%ls', error %x.", m_fileName.c_str(), GetLastError());
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(m_fileHandle, &fileSize);
+    m_mappedSize = (size_t)fileSize.QuadPart;
+    m_mappingHandle = CreateFileMapping(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mappingHandle)
+        m_mappedData = (const char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+    m_fileDescriptor = open(msra::strfun::utf8(m_fileName).c_str(), O_RDONLY);
+    if (m_fileDescriptor == -1)
+        RuntimeError("Cannot open the decoded image cache '%ls': %s.", m_fileName.c_str(), strerror(errno));
+
+    struct stat fileStat;
+    if (fstat(m_fileDescriptor, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        m_mappedSize = fileStat.st_size;
+        void* data = mmap(nullptr, m_mappedSize, PROT_READ, MAP_SHARED, m_fileDescriptor, 0);
+        m_mappedData = (data == MAP_FAILED) ? nullptr : (const char*)data;
+    }
+#endif
+
+    auto fail = [this](const char* reason)
+    {
+        Unmap();
+        RuntimeError("The decoded image cache '%ls' %s.", m_fileName.c_str(), reason);
+    };
+
+    if (!m_mappedData)
+        fail("cannot be memory mapped");
+
+    Header header;
+    if (m_mappedSize < sizeof(header))
+        fail("is truncated");
+    memcpy(&header, m_mappedData, sizeof(header));
+
+    if (memcmp(header.m_magic, s_cacheMagic, sizeof(s_cacheMagic)) != 0 || header.m_version != CurrentVersion)
+        fail("is not a decoded image cache of this version");
+    if (header.m_grayscale != m_header.m_grayscale || header.m_decodeMinimumSide != m_header.m_decodeMinimumSide)
+        fail("has been created with different decoding options, please delete it");
+
+    const char* position = m_mappedData + header.m_indexOffset;
+    const char* end = m_mappedData + m_mappedSize;
+    if (header.m_indexOffset > m_mappedSize)
+        fail("is truncated");
+
+    m_index.clear();
+    m_index.reserve(header.m_numberOfImages);
+    for (uint64_t i = 0; i < header.m_numberOfImages; ++i)
+    {
+        uint32_t keyLength;
+        ImageEntry entry;
+        if ((size_t)(end - position) < sizeof(keyLength))
+            fail("is truncated");
+        memcpy(&keyLength, position, sizeof(keyLength));
+        position += sizeof(keyLength);
+
+        if ((size_t)(end - position) < keyLength + sizeof(entry))
+            fail("is truncated");
+        std::string key(position, keyLength);
+        position += keyLength;
+        memcpy(&entry, position, sizeof(entry));
+        position += sizeof(entry);
+
+        size_t imageSize = (size_t)entry.m_rows * entry.m_cols * CV_ELEM_SIZE(entry.m_type);
+        if (entry.m_offset + imageSize > header.m_indexOffset)
+            fail("is corrupted");
+
+        m_index[key] = entry;
+    }
+}
+
+void DecodedImageCache::Unmap()
+{
+#ifdef __WINDOWS__
+    if (m_mappedData)
+        UnmapViewOfFile(m_mappedData);
+    if (m_mappingHandle)
+        CloseHandle(m_mappingHandle);
+    if (m_fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_fileHandle);
+    m_mappingHandle = nullptr;
+    m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (m_mappedData)
+        munmap(const_cast<char*>(m_mappedData), m_mappedSize);
+    if (m_fileDescriptor != -1)
+        close(m_fileDescriptor);
+    m_fileDescriptor = -1;
+#endif
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+}
+
+}
@@ -0,0 +1,111 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <opencv2/core/mat.hpp>
+#include "Basics.h"
+#include "FileWrapper.h"
+
+namespace CNTK {
+
+// A file of decoded images keyed by sequence key, so that images are decoded only once and not in every epoch.
+// The file contains the raw pixels of the images (as decoded, i.e. possibly at a reduced resolution) followed by an index,
+// and is memory mapped once it is complete:
+//   header: magic, version, decoding parameters, number of images, offset of the index
+//   data:   raw pixels of every image, each aligned to ImageAlignment bytes
+//   index:  for every image the key length, the key, the offset of the pixels, rows, columns and the OpenCV type
+// If the file does not exist or does not contain all images yet (e.g. the training stopped early, or a worker only read
+// its share of the images), the images are appended to a temporary file as they are decoded, after a copy of the images
+// that are already cached. The temporary file replaces the cache file when all images have been added or when the cache
+// is destroyed, unless the cache file contains at least as many images by then. So a partial cache is extended in the
+// following runs until it is complete.
+class DecodedImageCache
+{
+public:
+    DecodedImageCache(const std::wstring& fileName, size_t numberOfImages, bool grayscale, size_t decodeMinimumSide);
+
+    ~DecodedImageCache();
+
+    // Copies the decoded image with the given key out of the cache, returns false if it is not cached yet.
+    bool TryGet(const std::string& key, cv::Mat& image);
+
+    // Adds a decoded image to the cache that is being built, ignored if the image is cached already or the cache is complete.
+    void Add(const std::string& key, const cv::Mat& image);
+
+    // Whether the mapped cache file contains all images.
+    bool IsComplete() const;
+
+private:
+    struct Header
+    {
+        char m_magic[8];
+        uint32_t m_version;
+        uint32_t m_grayscale;
+        uint64_t m_decodeMinimumSide;
+        uint64_t m_numberOfImages;
+        uint64_t m_indexOffset;
+    };
+
+    struct ImageEntry
+    {
+        uint64_t m_offset;
+        int32_t m_rows;
+        int32_t m_cols;
+        int32_t m_type;
+    };
+
+    static const uint32_t CurrentVersion = 1;
+    static const size_t ImageAlignment = 64;
+
+    // Maps the complete cache file and reads its index, expects m_mutex to be locked.
+    void Map();
+    void Unmap();
+
+    // Creates the temporary file and copies the mapped images into it, expects m_mutex to be locked.
+    void CreateTemporaryFile();
+
+    // Appends an image to the temporary file, expects m_mutex to be locked.
+    void Append(const std::string& key, const cv::Mat& image);
+
+    // Writes the index and the header of the temporary file and moves it to the cache file, expects m_mutex to be locked.
+    void Complete();
+
+    // Returns the number of images in the cache file, 0 if there is no cache file with the same decoding options.
+    size_t GetNumberOfImagesInFile() const;
+
+    std::wstring m_fileName;
+    std::wstring m_temporaryFileName;
+    size_t m_numberOfImages;
+    Header m_header;
+
+    mutable std::mutex m_mutex;
+
+    // Index of the mapped cache file.
+    std::unordered_map<std::string, ImageEntry> m_index;
+
+    // Cache file that is being built and its index.
+    std::unique_ptr<FileWrapper> m_temporaryFile;
+    std::unordered_map<std::string, ImageEntry> m_temporaryIndex;
+
+    // Memory mapping of the complete cache file.
+    const char* m_mappedData;
+    size_t m_mappedSize;
+#ifdef __WINDOWS__
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#else
+    int m_fileDescriptor;
+#endif
+
+    DISABLE_COPY_AND_MOVE(DecodedImageCache);
+};
+
+typedef std::shared_ptr<DecodedImageCache> DecodedImageCachePtr;
+
+}
@@ -36,7 +36,10 @@ public:
         assert(sequenceIndex == 0 && sequenceIndex == m_description.m_indexInChunk);
         UNUSED(sequenceIndex);
 
-        auto cvImage = m_deserializer.ReadImage(m_description.m_key.m_sequence, m_description.m_path, m_deserializer.m_grayscale);
+        auto cvImage = m_deserializer.GetDecodedImage(m_description.m_key.m_sequence, [this]()
+        {
+            return m_deserializer.ReadImage(m_description.m_key.m_sequence, m_description.m_path, m_deserializer.m_grayscale);
+        });
         if (!cvImage.data)
             RuntimeError("Cannot open file '%s'", m_description.m_path.c_str());
 
@@ -64,6 +67,7 @@ private:
 ImageDataDeserializer::ImageDataDeserializer(CorpusDescriptorPtr corpus, const ConfigParameters& config, bool primary) : ImageDeserializerBase(corpus, config, primary)
 {
     CreateSequenceDescriptions(corpus, config(L"file"), m_labelGenerator->LabelDimension(), m_multiViewCrop);
+    CreateDecodedImageCache(m_imageSequences.size() / (m_multiViewCrop ? ImageDeserializerBase::NumMultiViewCopies : 1));
 }
 
 // TODO: Should be removed at some point.
@@ -109,7 +113,13 @@ ImageDataDeserializer::ImageDataDeserializer(const ConfigParameters& config)
         RuntimeError("Unsupported label element type '%d'.", (int)label.m_elementType);
     }
 
-    CreateSequenceDescriptions(std::make_shared<CorpusDescriptor>(false), configHelper.GetMapPath(), labelDimension, configHelper.IsMultiViewCrop());
+    // Crop and scale parameters are part of the feature section.
+    ConfigParameters featureSection = config(feature.m_name);
+    InitializeDecoding(config, &featureSection, &featureSection);
+
+    m_corpus = std::make_shared<CorpusDescriptor>(false);
+    CreateSequenceDescriptions(m_corpus, configHelper.GetMapPath(), labelDimension, configHelper.IsMultiViewCrop());
+    CreateDecodedImageCache(m_imageSequences.size() / (configHelper.IsMultiViewCrop() ? ImageDeserializerBase::NumMultiViewCopies : 1));
 }
 
 // Descriptions of chunks exposed by the image reader.
@@ -146,6 +156,7 @@ void ImageDataDeserializer::CreateSequenceDescriptions(CorpusDescriptorPtr corpu
     // Creating the default reader with expanded directory to the map file.
     auto mapFileDirectory = ExtractDirectory(mapPath);
     m_defaultReader = make_unique<FileByteReader>(mapFileDirectory);
+    m_defaultReader->SetDecodeMinimumSide(m_decodeMinimumSide);
 
     size_t numberOfCopies = isMultiCrop ? ImageDeserializerBase::NumMultiViewCopies : 1;
     static_assert(ImageDeserializerBase::NumMultiViewCopies < std::numeric_limits<uint8_t>::max(), "Do not support more than 256 copies.");
@@ -262,6 +273,7 @@ void ImageDataDeserializer::RegisterByteReader(size_t seqId, const std::string&
     if (r == knownReaders.end())
     {
         reader = std::make_shared<ZipByteReader>(containerPath);
+        reader->SetDecodeMinimumSide(m_decodeMinimumSide);
         knownReaders[containerPath] = reader;
         readerSequences[containerPath] = MultiMap();
     }
@@ -295,7 +307,101 @@ cv::Mat FileByteReader::Read(size_t, const std::string& seqPath, bool grayscale)
     assert(!seqPath.empty());
     auto path = Expand3Dots(seqPath, m_expandDirectory);
 
-    return cv::imread(path, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    if (m_decodeMinimumSide == 0)
+        return cv::imread(path, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+
+    // The reduction depends on the size of the image, so the file is decoded from memory.
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return cv::Mat();
+
+    std::vector<unsigned char> contents((size_t)file.tellg());
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(contents.data()), contents.size()))
+        return cv::Mat();
+
+    return DecodeImage(contents.data(), contents.size(), grayscale, m_decodeMinimumSide);
+}
+
+// Reads the size of a JPEG image from its frame header, returns false if it is not a JPEG image.
+static bool TryGetJpegSize(const unsigned char* data, size_t size, size_t& width, size_t& height)
+{
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+        return false;
+
+    size_t position = 2;
+    while (position + 4 <= size)
+    {
+        if (data[position] != 0xFF)
+            return false;
+
+        unsigned char marker = data[position + 1];
+        if (marker == 0xFF) // Fill byte.
+        {
+            position++;
+            continue;
+        }
+
+        position += 2;
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) // Markers without a segment.
+            continue;
+        if (marker == 0xD9 || marker == 0xDA) // End of image or start of scan before any frame header.
+            return false;
+
+        // Start of frame markers, except for DHT, JPG and DAC: length, precision, height, width.
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+        {
+            if (position + 7 > size)
+                return false;
+            height = (data[position + 3] << 8) | data[position + 4];
+            width = (data[position + 5] << 8) | data[position + 6];
+            return width > 0 && height > 0;
+        }
+
+        position += (data[position] << 8) | data[position + 1];
+    }
+    return false;
+}
+
+cv::Mat DecodeImage(const unsigned char* data, size_t size, bool grayscale, size_t minimumSide)
+{
+    if (size == 0)
+        return cv::Mat();
+
+    int flags = grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR;
+#if CV_VERSION_MAJOR > 3 || (CV_VERSION_MAJOR == 3 && CV_VERSION_MINOR >= 1)
+    struct Reduction
+    {
+        size_t m_factor;
+        int m_grayscaleFlags;
+        int m_colorFlags;
+    };
+    static const Reduction reductions[] =
+    {
+        { 8, cv::IMREAD_REDUCED_GRAYSCALE_8, cv::IMREAD_REDUCED_COLOR_8 },
+        { 4, cv::IMREAD_REDUCED_GRAYSCALE_4, cv::IMREAD_REDUCED_COLOR_4 },
+        { 2, cv::IMREAD_REDUCED_GRAYSCALE_2, cv::IMREAD_REDUCED_COLOR_2 }
+    };
+
+    size_t width, height;
+    if (minimumSide > 0 && TryGetJpegSize(data, size, width, height))
+    {
+        // The decoder rounds the reduced size up.
+        size_t shorterSide = std::min(width, height);
+        for (const auto& reduction : reductions)
+        {
+            if ((shorterSide + reduction.m_factor - 1) / reduction.m_factor >= minimumSide)
+            {
+                flags = grayscale ? reduction.m_grayscaleFlags : reduction.m_colorFlags;
+                break;
+            }
+        }
+    }
+#else
+    UNUSED(minimumSide);
+#endif
+
+    return cv::imdecode(cv::Mat(1, (int)size, CV_8U, const_cast<unsigned char*>(data)), flags);
 }
 
 bool ImageDataDeserializer::GetSequenceInfoByKey(const SequenceKey& key, SequenceInfo& result)
@@ -31,6 +31,13 @@ public:
     // Gets sequences by specified ids. Order of returned sequences corresponds to the order of provided ids.
     virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
 
+    // A chunk only refers to the description of its image, which is read and decoded when the sequence is requested,
+    // so chunks can be created concurrently.
+    virtual bool SupportsConcurrentGetChunk() const override
+    {
+        return true;
+    }
+
     // Gets chunk descriptions.
     virtual std::vector<ChunkInfo> ChunkInfos() override;
 
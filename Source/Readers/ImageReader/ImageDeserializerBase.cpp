@@ -20,7 +20,7 @@ using namespace Microsoft::MSR::CNTK;
     ImageDeserializerBase::ImageDeserializerBase() 
         : DataDeserializerBase(true),
           m_precision(DataType::Float),
-          m_grayscale(false), m_verbosity(0), m_multiViewCrop(false)
+          m_grayscale(false), m_verbosity(0), m_multiViewCrop(false), m_decodeMinimumSide(0)
     {}
 
     ImageDeserializerBase::ImageDeserializerBase(CorpusDescriptorPtr corpus, const ConfigParameters& config, bool primary)
@@ -74,6 +74,65 @@ using namespace Microsoft::MSR::CNTK;
         // TODO: multiview should be done on the level of randomizer/transformers - it is responsiblity of the
         // TODO: randomizer to collect how many copies each transform needs and request same sequence several times.
         m_multiViewCrop = config(L"multiViewCrop", false);
+
+        // Crop and scale transforms determine the resolution images need to be decoded with.
+        const ConfigParameters* crop = nullptr;
+        const ConfigParameters* scale = nullptr;
+        argvector<ConfigParameters> transforms = featureSection("transforms");
+        for (size_t i = 0; i < transforms.size() && !scale; ++i)
+        {
+            std::string type = transforms[i]("type", "");
+            if (AreEqualIgnoreCase(type, "Crop"))
+                crop = &transforms[i];
+            else if (AreEqualIgnoreCase(type, "Scale"))
+                scale = &transforms[i];
+        }
+
+        InitializeDecoding(config, crop, scale);
+    }
+
+    void ImageDeserializerBase::InitializeDecoding(const ConfigParameters& config, const ConfigParameters* cropConfig, const ConfigParameters* scaleConfig)
+    {
+        m_decodeMinimumSide = 0;
+        bool reducedDecoding = config(L"reducedDecoding", false);
+        if (reducedDecoding && scaleConfig)
+        {
+            // The crop is scaled to the target size, so its shorter side must not be smaller than the larger target side.
+            size_t width = (*scaleConfig)(L"width");
+            size_t height = (*scaleConfig)(L"height");
+            double ratio = cropConfig ? CropTransformer(*cropConfig).GetMinimumSideRatio() : 1.0;
+            if (ratio > 0)
+                m_decodeMinimumSide = (size_t)std::ceil(std::max(width, height) / ratio);
+        }
+
+        if (reducedDecoding && m_decodeMinimumSide == 0)
+            fprintf(stderr, "WARNING: reducedDecoding requires a scale transform and a relative crop, images are decoded at full resolution.\n");
+        else if (m_verbosity > 0 && m_decodeMinimumSide > 0)
+            fprintf(stderr, "ImageDeserializer: JPEG images are decoded with the shorter side of at least %d pixels.\n", (int)m_decodeMinimumSide);
+
+        std::wstring decodedImageCacheFile = config(L"decodedImageCache", L"");
+        m_decodedImageCacheFile = decodedImageCacheFile;
+    }
+
+    void ImageDeserializerBase::CreateDecodedImageCache(size_t numberOfImages)
+    {
+        if (!m_decodedImageCacheFile.empty())
+            m_decodedImageCache = std::make_shared<DecodedImageCache>(m_decodedImageCacheFile, numberOfImages, m_grayscale, m_decodeMinimumSide);
+    }
+
+    cv::Mat ImageDeserializerBase::GetDecodedImage(size_t sequenceKey, const std::function<cv::Mat()>& decode)
+    {
+        if (!m_decodedImageCache)
+            return decode();
+
+        cv::Mat image;
+        const auto& key = m_corpus->IdToKey(sequenceKey);
+        if (m_decodedImageCache->TryGet(key, image))
+            return image;
+
+        image = decode();
+        m_decodedImageCache->Add(key, image);
+        return image;
     }
 
     void ImageDeserializerBase::PopulateSequenceData(
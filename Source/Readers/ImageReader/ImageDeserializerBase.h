@@ -5,10 +5,12 @@
 
 #pragma once
 
+#include <functional>
 #include "DataDeserializerBase.h"
 #include "Config.h"
 #include "CorpusDescriptor.h"
 #include "ImageUtil.h"
+#include "DecodedImageCache.h"
 
 namespace CNTK {
 
@@ -29,6 +31,18 @@ namespace CNTK {
         ImageDeserializerBase();
 
     protected:
+        // Reads the decoding options of the config:
+        //   reducedDecoding   - decode JPEG images at the lowest resolution that does not make the scale transform
+        //                       upsample any crop (default: false).
+        //   decodedImageCache - file of decoded images, built during the first run and memory mapped in the following ones.
+        void InitializeDecoding(const ConfigParameters& config, const ConfigParameters* cropConfig, const ConfigParameters* scaleConfig);
+
+        // Creates the decoded image cache if configured, to be called when the number of images is known.
+        void CreateDecodedImageCache(size_t numberOfImages);
+
+        // Gets the decoded image of the sequence from the decoded image cache, or decodes it and adds it to the cache.
+        cv::Mat GetDecodedImage(size_t sequenceKey, const std::function<cv::Mat()>& decode);
+
         void PopulateSequenceData(cv::Mat image, size_t classId, size_t sequenceId, const SequenceKey& sequenceKey, std::vector<SequenceDataPtr>& result);
 
         // A helper class for generation of type specific labels (currently float/double only).
@@ -51,5 +65,11 @@ namespace CNTK {
 
         // Corpus descriptor.
         CorpusDescriptorPtr m_corpus;
+
+        // Shorter side images are at least decoded with, 0 means full resolution.
+        size_t m_decodeMinimumSide;
+
+        std::wstring m_decodedImageCacheFile;
+        DecodedImageCachePtr m_decodedImageCache;
     };
 }
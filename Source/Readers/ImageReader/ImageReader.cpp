@@ -79,7 +79,9 @@ ImageReader::ImageReader(const ConfigParameters& config)
     // It is noop if the matrix element type is already expected by the packer.
     transformations.push_back(Transformation{ std::make_shared<CastTransformer>(featureStream), featureName });
 
-    m_sequenceEnumerator = std::make_shared<TransformController>(transformations, randomizer);
+    // Optionally applying crop, scale, mean and transpose in a single pass.
+    bool fuseTransforms = config(L"fuseTransforms", false);
+    m_sequenceEnumerator = std::make_shared<TransformController>(transformations, randomizer, multithreadedGetNextSequences, fuseTransforms);
     bool useLocalTimeline = true;
     m_packer = std::make_shared<FramePacker>(
         m_sequenceEnumerator,
@@ -43,6 +43,14 @@ SequenceDataPtr ImageTransformerBase::Transform(SequenceDataPtr sequence, int in
     return result;
 }
 
+size_t ImageTransformerBase::Fuse(const std::vector<TransformerPtr>& transformers, TransformerPtr& fused)
+{
+    size_t numberOfFusable = FusedImageTransformer::GetNumberOfFusable(transformers);
+    if (numberOfFusable > 0)
+        fused = std::make_shared<FusedImageTransformer>(std::vector<TransformerPtr>(transformers.begin(), transformers.begin() + numberOfFusable));
+    return numberOfFusable;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 CropTransformer::CropTransformer(const ConfigParameters& config) : ImageTransformerBase(config)
 {
@@ -126,24 +134,50 @@ StreamInformation CropTransformer::Transform(const StreamInformation& inputStrea
 }
 
 void CropTransformer::Apply(uint8_t copyId, cv::Mat &mat, int indexInBatch)
+{
+    bool flip = false;
+    mat = mat(GetCropRect(copyId, mat.rows, mat.cols, indexInBatch, flip));
+    if (flip)
+    {
+        cv::flip(mat, mat, 1);
+    }
+}
+
+double CropTransformer::GetMinimumSideRatio() const
+{
+    if (m_cropWidth > 0 && m_cropHeight > 0)
+        return 0;
+
+    double ratio = 1.0;
+    if (m_useSideRatio)
+        ratio = m_sideRatioMin;
+    else if (m_useAreaRatio)
+        ratio = std::sqrt(m_areaRatioMin);
+
+    // Changing the aspect ratio keeps the area of the crop, so one of its sides gets shorter.
+    return ratio / std::sqrt(std::max(m_aspectRatioMax, 1.0 / m_aspectRatioMin));
+}
+
+cv::Rect CropTransformer::GetCropRect(uint8_t copyId, int rows, int cols, int indexInBatch, bool& flip)
 {
     auto seed = GetSeed();
     auto rng = m_rngs.at_or_create(indexInBatch, [seed](int offset) { return std::make_unique<std::mt19937>(seed + offset); });
     int viewIndex = m_cropType == CropType::MultiView10 ? (int)(copyId % ImageDeserializerBase::NumMultiViewCopies) : 0;
 
+    cv::Rect rect;
     switch (m_cropType)
     {
     case CropType::Center: 
-        mat = mat(GetCropRectCenter(mat.rows, mat.cols, *rng));
+        rect = GetCropRectCenter(rows, cols, *rng);
         break; 
     case CropType::RandomSide: 
-        mat = mat(GetCropRectRandomSide(mat.rows, mat.cols, *rng)); 
+        rect = GetCropRectRandomSide(rows, cols, *rng); 
         break; 
     case CropType::RandomArea: 
-        mat = mat(GetCropRectRandomArea(mat.rows, mat.cols, *rng));
+        rect = GetCropRectRandomArea(rows, cols, *rng);
         break;
     case CropType::MultiView10: 
-        mat = mat(GetCropRectMultiView10(viewIndex, mat.rows, mat.cols, *rng));
+        rect = GetCropRectMultiView10(viewIndex, rows, cols, *rng);
         break; 
     default: 
         RuntimeError("Invalid crop type."); 
@@ -151,13 +185,10 @@ void CropTransformer::Apply(uint8_t copyId, cv::Mat &mat, int indexInBatch)
     }
 
     // for MultiView10 m_hFlip is false, hence the first 5 will be unflipped, the later 5 will be flipped
-    if ((m_hFlip && boost::random::bernoulli_distribution<>()(*rng)) ||
-        viewIndex >= 5)
-    {
-        cv::flip(mat, mat, 1);
-    }
+    flip = (m_hFlip && boost::random::bernoulli_distribution<>()(*rng)) || viewIndex >= 5;
 
     m_rngs.assignTo(indexInBatch, std::move(rng));
+    return rect;
 }
 
 CropTransformer::RatioJitterType
@@ -854,5 +885,311 @@ SequenceDataPtr CastTransformer::TypedCast<TElementTo>::Apply(SequenceDataPtr se
     result->m_numberOfSamples = inputSequence.m_numberOfSamples;
     return result;
 }
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Source positions and weights of the interpolation of the output along an axis of the image.
+struct InterpolationAxis
+{
+    std::vector<size_t> m_first;  // Index of the first source element (row or offset in a row).
+    std::vector<size_t> m_second; // Index of the second source element.
+    std::vector<float> m_weight;  // Weight of the second one.
+};
+
+// Computes the interpolation of 'outputSize' positions from the source range [offset, offset + size), read in reverse if flipped.
+// The output position i is mapped to (i + 0.5) * scale - 0.5 for linear interpolation and to i * scale for nearest, as in cv::resize.
+// Source indices are multiplied by 'stride'.
+static void ComputeInterpolationAxis(int offset, int size, int outputSize, bool linear, bool flip, size_t stride, InterpolationAxis& axis)
+{
+    axis.m_first.resize(outputSize);
+    axis.m_second.resize(outputSize);
+    axis.m_weight.resize(outputSize);
+
+    double scale = (double)size / outputSize;
+    for (int i = 0; i < outputSize; ++i)
+    {
+        int first, second;
+        float weight = 0;
+        if (linear)
+        {
+            float position = (float)((i + 0.5) * scale - 0.5);
+            first = (int)std::floor(position);
+            weight = position - first;
+            if (first < 0)
+            {
+                first = 0;
+                weight = 0;
+            }
+            if (first >= size - 1)
+            {
+                first = size - 1;
+                weight = 0;
+            }
+            second = std::min(first + 1, size - 1);
+        }
+        else
+        {
+            first = second = std::min((int)std::floor(i * scale), size - 1);
+        }
+
+        if (flip)
+        {
+            first = size - 1 - first;
+            second = size - 1 - second;
+        }
+
+        axis.m_first[i] = (offset + first) * stride;
+        axis.m_second[i] = (offset + second) * stride;
+        axis.m_weight[i] = weight;
+    }
+}
+
+// Interpolates a source row, already converted to the output type, at the given columns.
+template <class TElement>
+static void InterpolateRow(const TElement* source, size_t channels, const InterpolationAxis& columns, TElement* output)
+{
+    size_t width = columns.m_first.size();
+    if (channels == 3) // Unrolling for BGR, the most common case.
+    {
+        for (size_t x = 0; x < width; ++x, output += 3)
+        {
+            const TElement* left = source + columns.m_first[x];
+            const TElement* right = source + columns.m_second[x];
+            TElement weight = columns.m_weight[x];
+            output[0] = left[0] + (right[0] - left[0]) * weight;
+            output[1] = left[1] + (right[1] - left[1]) * weight;
+            output[2] = left[2] + (right[2] - left[2]) * weight;
+        }
+        return;
+    }
+
+    for (size_t x = 0; x < width; ++x, output += channels)
+    {
+        const TElement* left = source + columns.m_first[x];
+        const TElement* right = source + columns.m_second[x];
+        TElement weight = columns.m_weight[x];
+        for (size_t c = 0; c < channels; ++c)
+            output[c] = left[c] + (right[c] - left[c]) * weight;
+    }
+}
+
+// Interpolates the output image from the rows and columns of the source, subtracts the mean (HWC, if not null)
+// and writes it in HWC or CHW layout. The part of a source row that is used is converted to the output type
+// and interpolated horizontally only once, and reused by the following output rows.
+template <class TElementFrom, class TElementTo>
+static void InterpolateImage(const unsigned char* source, size_t sourceStep, size_t channels,
+                             const InterpolationAxis& rows, const InterpolationAxis& columns,
+                             const TElementTo* mean, bool transpose, TElementTo* output)
+{
+    size_t height = rows.m_first.size();
+    size_t width = columns.m_first.size();
+    size_t rowSize = width * channels;
+
+    // Range of the source row that is used, columns are monotonic.
+    size_t begin = std::min({ columns.m_first.front(), columns.m_second.front(), columns.m_first.back(), columns.m_second.back() });
+    size_t end = std::max({ columns.m_first.front(), columns.m_second.front(), columns.m_first.back(), columns.m_second.back() }) + channels;
+    InterpolationAxis relativeColumns = columns;
+    for (size_t x = 0; x < width; ++x)
+    {
+        relativeColumns.m_first[x] -= begin;
+        relativeColumns.m_second[x] -= begin;
+    }
+
+    std::vector<TElementTo> converted(end - begin), upper(rowSize), lower(rowSize), blended(rowSize);
+    size_t upperRow = SIZE_MAX, lowerRow = SIZE_MAX;
+    auto interpolateRow = [&](size_t row, std::vector<TElementTo>& buffer, size_t& bufferRow)
+    {
+        if (bufferRow == row)
+            return;
+        auto sourceRow = reinterpret_cast<const TElementFrom*>(source + row * sourceStep) + begin;
+        for (size_t i = 0; i < converted.size(); ++i)
+            converted[i] = static_cast<TElementTo>(sourceRow[i]);
+        InterpolateRow(converted.data(), channels, relativeColumns, buffer.data());
+        bufferRow = row;
+    };
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        // The lower row of the previous output row is often the upper one of this row.
+        if (rows.m_first[y] == lowerRow && rows.m_first[y] != upperRow)
+        {
+            upper.swap(lower);
+            std::swap(upperRow, lowerRow);
+        }
+        interpolateRow(rows.m_first[y], upper, upperRow);
+        interpolateRow(rows.m_second[y], lower, lowerRow);
+
+        TElementTo weight = rows.m_weight[y];
+        TElementTo* target = transpose ? blended.data() : output + y * rowSize;
+        for (size_t i = 0; i < rowSize; ++i)
+            target[i] = upper[i] + (lower[i] - upper[i]) * weight;
+        if (mean)
+        {
+            const TElementTo* meanRow = mean + y * rowSize;
+            for (size_t i = 0; i < rowSize; ++i)
+                target[i] -= meanRow[i];
+        }
+
+        if (transpose)
+        {
+            for (size_t c = 0; c < channels; ++c)
+            {
+                TElementTo* plane = output + c * height * width + y * width;
+                for (size_t x = 0; x < width; ++x)
+                    plane[x] = blended[x * channels + c];
+            }
+        }
+    }
+}
+
+size_t FusedImageTransformer::GetNumberOfFusable(const std::vector<TransformerPtr>& transformers)
+{
+    size_t i = 0;
+    auto next = [&]() { return i < transformers.size() ? transformers[i].get() : nullptr; };
+
+    if (dynamic_cast<CropTransformer*>(next()))
+        i++;
+
+    auto scale = dynamic_cast<ScaleTransformer*>(next());
+    if (scale == nullptr ||
+        scale->m_scaleMode != ScaleTransformer::ScaleMode::Fill ||
+        (scale->m_interp != cv::INTER_LINEAR && scale->m_interp != cv::INTER_NEAREST))
+        return 0;
+    i++;
+
+    for (;;)
+    {
+        auto color = dynamic_cast<ColorTransformer*>(next());
+        auto intensity = dynamic_cast<IntensityTransformer*>(next());
+        if ((color == nullptr || !color->IsIdentity()) && (intensity == nullptr || !intensity->IsIdentity()))
+            break;
+        i++;
+    }
+
+    if (auto mean = dynamic_cast<MeanTransformer*>(next()))
+    {
+        // The mean transformer ignores a mean image that does not match the scaled image.
+        const auto& meanImage = mean->m_meanImg;
+        if (!meanImage.empty() &&
+            (meanImage.cols != (int)scale->m_imgWidth || meanImage.rows != (int)scale->m_imgHeight || meanImage.channels() != (int)scale->m_imgChannels))
+            return 0;
+        i++;
+    }
+
+    // The output is in a typed buffer, as produced by transpose or cast.
+    bool typedOutput = false;
+    if (dynamic_cast<TransposeTransformer*>(next()))
+    {
+        typedOutput = true;
+        i++;
+    }
+    if (dynamic_cast<CastTransformer*>(next()))
+    {
+        typedOutput = true;
+        i++;
+    }
+
+    return typedOutput ? i : 0;
+}
+
+FusedImageTransformer::FusedImageTransformer(const std::vector<TransformerPtr>& transformers)
+    : m_transformers(transformers), m_crop(nullptr), m_scale(nullptr), m_transpose(false), m_outputType(DataType::Unknown),
+      m_floatTransform(this), m_doubleTransform(this)
+{
+    MeanTransformer* mean = nullptr;
+    for (const auto& transformer : m_transformers)
+    {
+        if (auto crop = dynamic_cast<CropTransformer*>(transformer.get()))
+            m_crop = crop;
+        else if (auto scale = dynamic_cast<ScaleTransformer*>(transformer.get()))
+            m_scale = scale;
+        else if (auto meanTransformer = dynamic_cast<MeanTransformer*>(transformer.get()))
+            mean = meanTransformer;
+        else if (auto transpose = dynamic_cast<TransposeTransformer*>(transformer.get()))
+        {
+            m_transpose = true;
+            m_outputType = transpose->m_precision;
+        }
+        else if (auto cast = dynamic_cast<CastTransformer*>(transformer.get()))
+            m_outputType = cast->m_precision;
+    }
+
+    if (m_scale == nullptr || m_outputType == DataType::Unknown)
+        LogicError("Image transformers that cannot be fused are provided.");
+
+    if (mean != nullptr && !mean->m_meanImg.empty())
+        mean->m_meanImg.convertTo(m_mean, m_outputType == DataType::Float ? CV_32F : CV_64F);
+
+    auto dims = ImageDimensions(m_scale->m_imgWidth, m_scale->m_imgHeight, m_scale->m_imgChannels).AsTensorShape(m_transpose ? CHW : HWC).GetDims();
+    m_outputShape = NDShape(std::vector<size_t>(dims.begin(), dims.end()));
+}
+
+void FusedImageTransformer::StartEpoch(const EpochConfiguration& config)
+{
+    for (const auto& transformer : m_transformers)
+        transformer->StartEpoch(config);
+}
+
+StreamInformation FusedImageTransformer::Transform(const StreamInformation& inputStream)
+{
+    StreamInformation stream = inputStream;
+    for (const auto& transformer : m_transformers)
+        stream = transformer->Transform(stream);
+    return stream;
+}
+
+SequenceDataPtr FusedImageTransformer::Transform(SequenceDataPtr sequence, int indexInBatch)
+{
+    auto inputSequence = dynamic_cast<ImageSequenceData*>(sequence.get());
+    if (inputSequence == nullptr)
+        RuntimeError("Unexpected sequence provided");
+
+    const cv::Mat& image = inputSequence->m_image;
+    if (image.channels() != (int)m_scale->m_imgChannels)
+        RuntimeError("The image has %d channels, while %d are expected.", image.channels(), (int)m_scale->m_imgChannels);
+
+    cv::Rect crop(0, 0, image.cols, image.rows);
+    bool flip = false;
+    if (m_crop)
+        crop = m_crop->GetCropRect(inputSequence->m_copyIndex, image.rows, image.cols, indexInBatch, flip);
+
+    if (m_outputType == DataType::Float)
+        return m_floatTransform.Apply(inputSequence, crop, flip);
+    return m_doubleTransform.Apply(inputSequence, crop, flip);
+}
+
+template <class TElementTo>
+SequenceDataPtr FusedImageTransformer::TypedFusion<TElementTo>::Apply(ImageSequenceData* inputSequence, const cv::Rect& crop, bool flip)
+{
+    const cv::Mat& image = inputSequence->m_image;
+    const ScaleTransformer& scale = *m_parent->m_scale;
+    bool linear = scale.m_interp == cv::INTER_LINEAR;
+    size_t channels = image.channels();
+
+    InterpolationAxis rows, columns;
+    ComputeInterpolationAxis(crop.y, crop.height, (int)scale.m_imgHeight, linear, /*flip =*/ false, /*stride =*/ 1, rows);
+    ComputeInterpolationAxis(crop.x, crop.width, (int)scale.m_imgWidth, linear, flip, channels, columns);
+
+    auto result = std::make_shared<DenseSequenceWithBuffer<TElementTo>>(m_memBuffers, m_parent->m_outputShape.TotalSize(), m_parent->m_outputShape);
+    const TElementTo* mean = m_parent->m_mean.empty() ? nullptr : m_parent->m_mean.ptr<TElementTo>();
+    switch (image.depth())
+    {
+    case CV_8U:
+        InterpolateImage<unsigned char>(image.data, image.step[0], channels, rows, columns, mean, m_parent->m_transpose, result->GetBuffer());
+        break;
+    case CV_32F:
+        InterpolateImage<float>(image.data, image.step[0], channels, rows, columns, mean, m_parent->m_transpose, result->GetBuffer());
+        break;
+    case CV_64F:
+        InterpolateImage<double>(image.data, image.step[0], channels, rows, columns, mean, m_parent->m_transpose, result->GetBuffer());
+        break;
+    default:
+        RuntimeError("Unsupported type of the image.");
+    }
+
+    result->m_key = inputSequence->m_key;
+    result->m_elementType = m_parent->m_outputType;
+    result->m_numberOfSamples = inputSequence->m_numberOfSamples;
+    return result;
+}
 
 }
@@ -60,6 +60,9 @@ public:
     // Transformation of the sequence.
     SequenceDataPtr Transform(SequenceDataPtr sequence, int indexInBatch=0) override;
 
+    // Fuses crop, scale, mean, transpose and cast transformers into a FusedImageTransformer if possible.
+    size_t Fuse(const std::vector<TransformerPtr>& transformers, TransformerPtr& fused) override;
+
 protected:
     using Base = Transformer;
     using UniRealT = boost::random::uniform_real_distribution<double>;
@@ -93,9 +96,17 @@ public:
 
     StreamInformation Transform(const StreamInformation& inputStream);
 
+    // Gets the smallest ratio of a side of the crop to the shorter side of the image, 0 if the crop size is absolute.
+    double GetMinimumSideRatio() const;
+
 private:
+    friend class FusedImageTransformer;
+
     void Apply(uint8_t copyId, cv::Mat &mat, int indexInBatch) override;
 
+    // Gets the crop rectangle of an image of the given size and whether the crop is flipped horizontally.
+    cv::Rect GetCropRect(uint8_t copyId, int rows, int cols, int indexInBatch, bool& flip);
+
 private:
     enum class RatioJitterType
     {
@@ -143,6 +154,8 @@ public:
     StreamInformation Transform(const StreamInformation& inputStream) override;
 
 private:
+    friend class FusedImageTransformer;
+
     enum class ScaleMode
     {
         Fill = 0,
@@ -168,6 +181,8 @@ public:
     explicit MeanTransformer(const Microsoft::MSR::CNTK::ConfigParameters& config);
 
 private:
+    friend class FusedImageTransformer;
+
     void Apply(uint8_t copyId, cv::Mat &mat, int indexInBatch) override;
 
     cv::Mat m_meanImg;
@@ -186,6 +201,8 @@ public:
     SequenceDataPtr Transform(SequenceDataPtr sequence, int indexInBatch=0) override;
 
 private:
+    friend class FusedImageTransformer;
+
     // A helper class transposes images using a set of typed memory buffers.
     template <class TElementTo>
     struct TypedTranspose
@@ -217,8 +234,16 @@ public:
     explicit IntensityTransformer(const Microsoft::MSR::CNTK::ConfigParameters& config);
 
 private:
+    friend class FusedImageTransformer;
+
     void StartEpoch(const EpochConfiguration &config) override;
 
+    // Whether the transformer leaves images as they are.
+    bool IsIdentity() const
+    {
+        return m_eigVal.empty() || m_eigVec.empty() || m_stdDev == 0.0;
+    }
+
     void Apply(uint8_t copyId, cv::Mat &mat, int indexInBatch) override;
     template <typename ElemType>
     void Apply(cv::Mat &mat, int indexInBatch);
@@ -239,8 +264,16 @@ public:
     explicit ColorTransformer(const Microsoft::MSR::CNTK::ConfigParameters& config);
 
 private:
+    friend class FusedImageTransformer;
+
     void StartEpoch(const EpochConfiguration &config) override;
 
+    // Whether the transformer leaves images as they are.
+    bool IsIdentity() const
+    {
+        return m_brightnessRadius == 0.0 && m_contrastRadius == 0.0 && m_saturationRadius == 0.0;
+    }
+
     void Apply(uint8_t copyId, cv::Mat &mat, int indexInBatch) override;
     template <typename ElemType>
     void Apply(cv::Mat &mat, int indexInBatch);
@@ -270,6 +303,7 @@ public:
     SequenceDataPtr Transform(SequenceDataPtr sequence, int indexInBatch) override;
 
 private:
+    friend class FusedImageTransformer;
 
     // A helper class casts images using a set of typed memory buffers.
     template <class TElementTo>
@@ -288,4 +322,57 @@ private:
     TypedCast<double> m_doubleTransform;
 };
 
+// Crop, scale, mean subtraction, transpose and cast of an image in a single pass: every output element
+// is interpolated from the cropped region of the input image, the mean is subtracted and the result is written
+// at its position in the output layout, without any intermediate images.
+// Replaces a sequence of [crop], scale ("fill" mode with linear or nearest interpolation), [mean],
+// [transpose] and/or cast transformers, color and intensity transformers that do not change images can be in between.
+// Used when fusion of transforms is enabled in the reader config ('fuseTransforms').
+// Scaled values are not rounded to the input type, so the output can slightly differ from the one of separate transformers.
+class FusedImageTransformer : public Transformer
+{
+public:
+    // Returns the number of the transformers that can be fused, starting at the first one, or 0 if they cannot be fused.
+    static size_t GetNumberOfFusable(const std::vector<TransformerPtr>& transformers);
+
+    // Fuses the given transformers, expects the number returned by GetNumberOfFusable.
+    explicit FusedImageTransformer(const std::vector<TransformerPtr>& transformers);
+
+    void StartEpoch(const EpochConfiguration& config) override;
+
+    // Transformation of the stream by all the fused transformers.
+    StreamInformation Transform(const StreamInformation& inputStream) override;
+
+    // Transformation of the sequence.
+    SequenceDataPtr Transform(SequenceDataPtr sequence, int indexInBatch) override;
+
+private:
+    // A helper class that writes the transformed images into a set of typed memory buffers.
+    template <class TElementTo>
+    struct TypedFusion
+    {
+        FusedImageTransformer* m_parent;
+
+        TypedFusion(FusedImageTransformer* parent) : m_parent(parent) {}
+
+        SequenceDataPtr Apply(ImageSequenceData* inputSequence, const cv::Rect& crop, bool flip);
+        Microsoft::MSR::CNTK::conc_stack<std::vector<TElementTo>> m_memBuffers;
+    };
+
+    std::vector<TransformerPtr> m_transformers;
+
+    CropTransformer* m_crop;
+    ScaleTransformer* m_scale;
+    bool m_transpose;
+
+    // Mean image in the output type, empty if there is no mean to subtract.
+    cv::Mat m_mean;
+
+    DataType m_outputType;
+    NDShape m_outputShape;
+
+    TypedFusion<float> m_floatTransform;
+    TypedFusion<double> m_doubleTransform;
+};
+
 }
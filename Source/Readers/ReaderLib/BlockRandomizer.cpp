@@ -10,12 +10,24 @@
 #include "BlockRandomizer.h"
 #include <algorithm>
 #include <utility>
+#include <chrono>
 
 #include "DataReader.h"
 #include "ExceptionCapture.h"
 
 namespace CNTK {
 
+ChunkPrefetchConfig::ChunkPrefetchConfig(const ConfigParameters& config)
+{
+    m_depth = config(L"chunkPrefetchDepth", (size_t)1);
+    m_numberOfThreads = config(L"chunkPrefetchThreads", (size_t)1);
+    m_maxSizeInBytes = config(L"chunkPrefetchBudgetInBytes", (size_t)0);
+    m_readAheadDepth = config(L"chunkReadAheadDepth", (size_t)0);
+
+    if (m_numberOfThreads == 0)
+        InvalidArgument("'chunkPrefetchThreads' must be greater than zero.");
+}
+
 BlockRandomizer::BlockRandomizer(
     int verbosity,
     size_t randomizationRange,
@@ -24,25 +36,46 @@ BlockRandomizer::BlockRandomizer(
     bool multithreadedGetNextSequence,
     size_t maxNumberOfInvalidSequences,
     bool sampleBasedRandomizationWindow,
-    size_t seedOffset)
+    size_t seedOffset,
+    const ChunkPrefetchConfig& prefetchConfig,
+    const ChunkAffinityConfig& affinityConfig)
     : m_verbosity(verbosity),
       m_deserializer(deserializer),
+      m_readAheadDeserializer(std::dynamic_pointer_cast<DataDeserializerBase>(deserializer)),
+      m_readAheadEnd(0),
       m_sweep(SIZE_MAX),
+      m_affinityConfig(affinityConfig),
+      m_numberOfShards(1),
       m_epochSize(SIZE_MAX),
       m_globalSamplePosition(0),
       m_epochStartPosition(0),
       m_sweepSizeInSamples(0),
       m_chunkRandomizer(std::make_shared<ChunkRandomizer>(deserializer, randomizationRange, sampleBasedRandomizationWindow)),
       m_multithreadedGetNextSequences(multithreadedGetNextSequence),
-      m_prefetchedChunk(ChunkIdMax),
+      m_prefetchConfig(prefetchConfig),
       m_cleaner(maxNumberOfInvalidSequences),
       m_seedOffset(seedOffset)
 {
     assert(deserializer != nullptr);
 
-    m_launchType = shouldPrefetch ? launch::async : launch::deferred;
+    // Without prefetch chunks are loaded on the calling thread when they are needed.
+    if (!shouldPrefetch)
+        m_prefetchConfig.m_depth = 0;
+    if (m_prefetchConfig.m_depth > 0 && m_prefetchConfig.m_numberOfThreads > 1 &&
+        !(m_readAheadDeserializer && m_readAheadDeserializer->SupportsConcurrentGetChunk()))
+        InvalidArgument("'chunkPrefetchThreads' is %" PRIu64 ", but the deserializer does not support loading chunks concurrently. "
+                        "Please set it to 1.", (uint64_t)m_prefetchConfig.m_numberOfThreads);
+    if (m_prefetchConfig.m_depth > 0)
+        m_loadThreads.reset(new Microsoft::MSR::CNTK::WorkStealingThreadPool(m_prefetchConfig.m_numberOfThreads));
 
     m_streams = m_deserializer->StreamInfos();
+    m_sampleSizeInBytes = 0;
+    for (const auto& stream : m_streams)
+    {
+        if (stream.m_storageFormat == StorageFormat::Dense && !stream.m_sampleLayout.IsUnknown() && !stream.m_sampleLayout.HasUnboundDimension())
+            m_sampleSizeInBytes += stream.m_sampleLayout.TotalSize() * DataTypeSize(stream.m_elementType);
+    }
+
     m_sequenceRandomizer = std::make_shared<SequenceRandomizer>(verbosity, m_deserializer, m_chunkRandomizer);
 
     // Calculate total number of samples.
@@ -53,6 +86,16 @@ BlockRandomizer::BlockRandomizer(
     }
 }
 
+BlockRandomizer::~BlockRandomizer()
+{
+    // Loads that have not been started are not needed anymore, the threads finish the ones in progress.
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+        m_pendingLoads.clear();
+    }
+    m_loadThreads.reset();
+}
+
 std::map<std::wstring, size_t> BlockRandomizer::GetState()
 {
     return std::map<std::wstring, size_t>({ { g_minibatchSourcePosition , m_globalSamplePosition } });
@@ -96,6 +139,14 @@ void BlockRandomizer::StartEpoch(const EpochConfiguration& config)
                 m_globalSamplePosition,
                 config.m_workerRank,
                 config.m_numberOfWorkers);
+
+        if (m_loadStatistics.m_numberOfChunks > 0)
+            fprintf(stderr, "BlockRandomizer::StartEpoch: %" PRIu64 " chunks loaded so far (%" PRIu64 " prefetched), load time %.3fs average, %.3fs max, %.3fs spent waiting for chunks\n",
+                    m_loadStatistics.m_numberOfChunks,
+                    m_loadStatistics.m_numberOfPrefetchedChunks,
+                    m_loadStatistics.m_totalLoadTimeInSeconds / m_loadStatistics.m_numberOfChunks,
+                    m_loadStatistics.m_maxLoadTimeInSeconds,
+                    m_loadStatistics.m_totalWaitTimeInSeconds);
     }
 }
 
@@ -103,20 +154,23 @@ void BlockRandomizer::StartEpoch(const EpochConfiguration& config)
 void BlockRandomizer::PrepareNewSweepIfNeeded(size_t samplePosition)
 {
     size_t sweep = samplePosition / m_sweepSizeInSamples;
-    if (m_sweep != sweep)
+    size_t numberOfShards = m_affinityConfig.m_enabled ? std::max(m_config.m_numberOfWorkers, (size_t)1) : 1;
+    if (m_sweep != sweep || m_numberOfShards != numberOfShards)
     {
         if (m_verbosity >= Notification)
             fprintf(stderr, "BlockRandomizer::PrepareNewSweepIfNeeded: re-randomizing for sweep %d\n",
                     (int) sweep);
 
         m_sweep = sweep;
+        m_numberOfShards = numberOfShards;
 
         // Rerandomizing the chunks.
-        m_chunkRandomizer->Randomize(m_seedOffset + m_sweep);
+        m_chunkRandomizer->Randomize(m_seedOffset + m_sweep, m_numberOfShards, m_affinityConfig.m_reshuffleFraction);
 
         // Resetting sequence randomizer.
         m_sequenceRandomizer->Reset(m_seedOffset + m_sweep);
         m_currentWindowRange = {};
+        m_readAheadEnd = 0;
     }
 }
 
@@ -234,8 +288,8 @@ std::pair<size_t, size_t> BlockRandomizer::LoadSequenceData(size_t globalSampleC
     }
 
     // Now it is safe to start the new chunk prefetch.
-    ChunkIdType chunkToPrefetchNext = GetChunkToPrefetch(windowRange);
-    Prefetch(chunkToPrefetchNext);
+    Prefetch(windowRange);
+    ReadAhead(windowRange);
 
     return { numGlobalSamples, numLocalSamples };
 }
@@ -386,7 +440,18 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
     // TODO diagnostics for paged out chunks?
     m_chunks.swap(chunks);
 
-    // Adding new ones.
+    // Adding new ones, the chunks that have not been prefetched are loaded concurrently if possible.
+    std::vector<const ChunkInfo*> toLoad;
+    for (size_t i = windowRange.m_begin; i < windowRange.m_end; ++i)
+    {
+        auto const& chunk = m_chunkRandomizer->GetRandomizedChunks()[i];
+        if (needed[i - windowRange.m_begin] && m_loads.find(chunk.m_original->m_id) == m_loads.end())
+            toLoad.push_back(chunk.m_original);
+    }
+
+    if (m_loadThreads)
+        StartLoading(toLoad, /*isPrefetch =*/ false, /*urgent =*/ true);
+
     for (size_t i = windowRange.m_begin; i < windowRange.m_end; ++i)
     {
         if (!needed[i - windowRange.m_begin])
@@ -395,31 +460,39 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
         }
 
         auto const& chunk = m_chunkRandomizer->GetRandomizedChunks()[i];
-        if (chunk.m_original->m_id == m_prefetchedChunk && m_prefetch.valid())
+        auto start = std::chrono::steady_clock::now();
+        LoadedChunk loaded;
+        bool prefetched = false;
+        auto load = m_loads.find(chunk.m_original->m_id);
+        if (load != m_loads.end())
         {
-            // Taking prefetched chunk.
-            m_chunks[chunk.m_original->m_id] = m_prefetch.get();
-            if (m_verbosity >= Information)
-                fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in prefetched chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
-                chunk.m_chunkId,
-                chunk.m_original->m_id,
-                ++numLoadedChunks);
+            prefetched = load->second.m_isPrefetch;
+            auto future = std::move(load->second.m_future);
+            m_loads.erase(load);
+            loaded = future.get();
         }
         else
         {
-            // Make sure we have no outstanding prefetches.
-            if (m_prefetch.valid())
-            {
-                m_prefetch.wait();
-            }
-
-            m_chunks[chunk.m_original->m_id] = m_deserializer->GetChunk(chunk.m_original->m_id);
-            if (m_verbosity >= Information)
-                fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in randomized chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
-                chunk.m_chunkId,
-                chunk.m_original->m_id,
-                ++numLoadedChunks);
+            loaded = LoadChunk(m_deserializer, chunk.m_original->m_id);
         }
+        double waitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        m_chunks[chunk.m_original->m_id] = loaded.m_chunk;
+
+        m_loadStatistics.m_numberOfChunks++;
+        m_loadStatistics.m_numberOfPrefetchedChunks += prefetched ? 1 : 0;
+        m_loadStatistics.m_totalLoadTimeInSeconds += loaded.m_loadTimeInSeconds;
+        m_loadStatistics.m_maxLoadTimeInSeconds = std::max(m_loadStatistics.m_maxLoadTimeInSeconds, loaded.m_loadTimeInSeconds);
+        m_loadStatistics.m_totalWaitTimeInSeconds += waitTime;
+
+        if (m_verbosity >= Information)
+            fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in %s chunk %u (original chunk: %u) loaded in %.3fs after waiting %.3fs, now %" PRIu64 " chunks in memory\n",
+            prefetched ? "prefetched" : "randomized",
+            chunk.m_chunkId,
+            chunk.m_original->m_id,
+            loaded.m_loadTimeInSeconds,
+            waitTime,
+            ++numLoadedChunks);
     }
 
     if (m_verbosity >= Notification)
@@ -429,43 +502,152 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
                 m_chunkRandomizer->GetRandomizedChunks()[windowRange.m_end - 1].m_chunkId);
 }
 
-// Identifies chunk id that should be prefetched.
-ChunkIdType BlockRandomizer::GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange)
+// Prefetches the chunks following the window.
+void BlockRandomizer::Prefetch(const ClosedOpenChunkInterval& windowRange)
 {
-    ChunkIdType toBePrefetched = ChunkIdMax;
-    auto current = windowRange.m_end;
-    while (current < m_chunkRandomizer->GetRandomizedChunks().size())
+    if (m_prefetchConfig.m_depth == 0)
+        return;
+
+    // Candidates for the prefetch, in the order they are needed.
+    std::vector<const RandomizedChunk*> candidates;
+    const auto& randomizedChunks = m_chunkRandomizer->GetRandomizedChunks();
+    for (auto current = windowRange.m_end; current < randomizedChunks.size() && candidates.size() < m_prefetchConfig.m_depth; ++current)
     {
-        const auto& chunk = m_chunkRandomizer->GetRandomizedChunks()[current];
+        const auto& chunk = randomizedChunks[current];
         if (chunk.m_chunkId % m_config.m_numberOfWorkers == m_config.m_workerRank &&
             m_chunks.find(chunk.m_original->m_id) == m_chunks.end())
         {
-            toBePrefetched = chunk.m_original->m_id;
-            break;
+            candidates.push_back(&chunk);
         }
-        ++current;
     }
-    return toBePrefetched;
-}
 
-// Performs io prefetch of the specified chunk if needed.
-void BlockRandomizer::Prefetch(ChunkIdType chunkId)
-{
-    // Start new prefetch if necessary.
-    if (m_prefetchedChunk != chunkId && chunkId != ChunkIdMax)
+    // Dropping stale prefetches, i.e. after the worker configuration or the sweep has changed.
+    size_t prefetchedSizeInBytes = 0;
+    for (auto load = m_loads.begin(); load != m_loads.end();)
     {
-        // Wait to make sure there is no outstanding prefetches.
-        if (m_prefetch.valid())
+        bool isCandidate = std::any_of(candidates.begin(), candidates.end(),
+            [&](const RandomizedChunk* chunk) { return chunk->m_original->m_id == load->first; });
+        if (isCandidate)
+        {
+            prefetchedSizeInBytes += load->second.m_estimatedSizeInBytes;
+            ++load;
+            continue;
+        }
+
         {
-            m_prefetch.wait();
+            std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+            auto pending = std::find_if(m_pendingLoads.begin(), m_pendingLoads.end(),
+                [&](const std::pair<ChunkIdType, LoadTaskPtr>& p) { return p.first == load->first; });
+            if (pending != m_pendingLoads.end())
+                m_pendingLoads.erase(pending);
         }
+        load = m_loads.erase(load);
+    }
 
-        m_prefetchedChunk = chunkId;
-        m_prefetch = std::async(m_launchType, [this, chunkId]() { return m_deserializer->GetChunk(chunkId); });
+    // Starting new ones while within the budget.
+    std::vector<const ChunkInfo*> toPrefetch;
+    for (auto chunk : candidates)
+    {
+        if (m_loads.find(chunk->m_original->m_id) != m_loads.end())
+            continue;
+
+        size_t sizeInBytes = EstimateSizeInBytes(*chunk->m_original);
+        bool nothingPrefetched = m_loads.empty() && toPrefetch.empty();
+        if (m_prefetchConfig.m_maxSizeInBytes != 0 && !nothingPrefetched &&
+            prefetchedSizeInBytes + sizeInBytes > m_prefetchConfig.m_maxSizeInBytes)
+            break;
+
+        prefetchedSizeInBytes += sizeInBytes;
+        toPrefetch.push_back(chunk->m_original);
 
         if (m_verbosity >= Debug)
-            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u\n", chunkId);
+            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u\n", chunk->m_original->m_id);
     }
+
+    StartLoading(toPrefetch, /*isPrefetch =*/ true, /*urgent =*/ false);
+}
+
+// Tells the deserializer about the chunks following the window that have not been hinted yet.
+void BlockRandomizer::ReadAhead(const ClosedOpenChunkInterval& windowRange)
+{
+    if (m_prefetchConfig.m_readAheadDepth == 0 || !m_readAheadDeserializer)
+        return;
+
+    std::vector<ChunkIdType> upcoming;
+    const auto& randomizedChunks = m_chunkRandomizer->GetRandomizedChunks();
+    size_t current = windowRange.m_end, numberOfWorkerChunks = 0;
+    for (; current < randomizedChunks.size() && numberOfWorkerChunks < m_prefetchConfig.m_readAheadDepth; ++current)
+    {
+        const auto& chunk = randomizedChunks[current];
+        if (chunk.m_chunkId % m_config.m_numberOfWorkers != m_config.m_workerRank)
+            continue;
+
+        numberOfWorkerChunks++;
+        if (current >= m_readAheadEnd)
+            upcoming.push_back(chunk.m_original->m_id);
+    }
+    m_readAheadEnd = std::max(m_readAheadEnd, current);
+
+    if (!upcoming.empty())
+        m_readAheadDeserializer->HintUpcomingChunks(upcoming);
+}
+
+void BlockRandomizer::StartLoading(const std::vector<const ChunkInfo*>& chunks, bool isPrefetch, bool urgent)
+{
+    if (chunks.empty())
+        return;
+
+    std::vector<std::pair<ChunkIdType, LoadTaskPtr>> loads;
+    for (auto chunk : chunks)
+    {
+        ChunkIdType chunkId = chunk->m_id;
+        auto deserializer = m_deserializer;
+        auto task = std::make_shared<std::packaged_task<LoadedChunk()>>([deserializer, chunkId]() { return LoadChunk(deserializer, chunkId); });
+
+        auto& load = m_loads[chunkId];
+        load.m_future = task->get_future();
+        load.m_isPrefetch = isPrefetch;
+        load.m_estimatedSizeInBytes = EstimateSizeInBytes(*chunk);
+
+        loads.push_back(std::make_pair(chunkId, task));
+    }
+
+    // The thread pool does not keep the order of the tasks, so every task runs the first load in the queue.
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+        m_pendingLoads.insert(urgent ? m_pendingLoads.begin() : m_pendingLoads.end(), loads.begin(), loads.end());
+    }
+
+    for (size_t i = 0; i < loads.size(); ++i)
+        m_loadThreads->Push([this]() { RunPendingLoad(); });
+}
+
+void BlockRandomizer::RunPendingLoad()
+{
+    LoadTaskPtr task;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLoadsMutex);
+        if (m_pendingLoads.empty())
+            return; // The load has been dropped.
+
+        task = m_pendingLoads.front().second;
+        m_pendingLoads.pop_front();
+    }
+    (*task)();
+}
+
+/*static*/ BlockRandomizer::LoadedChunk BlockRandomizer::LoadChunk(const DataDeserializerPtr& deserializer, ChunkIdType chunkId)
+{
+    auto start = std::chrono::steady_clock::now();
+    LoadedChunk result;
+    result.m_chunk = deserializer->GetChunk(chunkId);
+    result.m_loadTimeInSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+size_t BlockRandomizer::EstimateSizeInBytes(const ChunkInfo& chunk) const
+{
+    return chunk.m_numberOfSamples * m_sampleSizeInBytes;
 }
 
 void BlockRandomizer::SetState(const std::map<std::wstring, size_t>& state)
@@ -492,8 +674,15 @@ void BlockRandomizer::SetConfiguration(const ReaderConfiguration& config)
 {
     // If configuration changes this can lead to reinitialization of worker chunks.
     m_currentWindowRange = ClosedOpenChunkInterval{};
+    m_readAheadEnd = 0;
 
+    bool reshard = m_affinityConfig.m_enabled && config.m_numberOfWorkers != m_config.m_numberOfWorkers;
     *((ReaderConfiguration*)&m_config) = config;
+
+    // With the chunk affinity the randomization depends on the number of workers,
+    // the sweep is randomized again and the current position is restored in it.
+    if (reshard && m_sweep != SIZE_MAX)
+        SetState(GetState());
 }
 
 }
@@ -6,16 +6,50 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
 
 #include "SequenceEnumerator.h"
 #include "DataDeserializer.h"
+#include "DataDeserializerBase.h"
 #include "ChunkRandomizer.h"
 #include "SequenceRandomizer.h"
 #include "ReaderUtil.h"
+#include "WorkStealingThreadPool.h"
 #include <future>
 
 namespace CNTK {
 
+// Configuration of the chunk prefetch of the block randomizer, read from the reader config section:
+//   chunkPrefetchDepth         - number of chunks following the randomization window that are loaded ahead (default: 1).
+//   chunkPrefetchThreads       - number of threads loading chunks (default: 1). More than one thread is only
+//                                accepted for deserializers that support concurrent GetChunk calls.
+//   chunkPrefetchBudgetInBytes - limit on the estimated size of the chunks that are loaded ahead, 0 (default) means unbounded.
+//                                The size is estimated from the dense streams only, and the next chunk is always prefetched.
+//   chunkReadAheadDepth        - number of chunks following the randomization window the deserializer is told about in advance,
+//                                so that it can start reading them from disk in the background (default: 0, no read ahead).
+struct ChunkPrefetchConfig
+{
+    ChunkPrefetchConfig() : m_depth(1), m_numberOfThreads(1), m_maxSizeInBytes(0), m_readAheadDepth(0) {}
+    explicit ChunkPrefetchConfig(const ConfigParameters& config);
+
+    size_t m_depth;
+    size_t m_numberOfThreads;
+    size_t m_maxSizeInBytes;
+    size_t m_readAheadDepth;
+};
+
+// Statistics of the chunks loaded by the block randomizer.
+struct ChunkLoadStatistics
+{
+    size_t m_numberOfChunks = 0;           // Chunks that were loaded.
+    size_t m_numberOfPrefetchedChunks = 0; // Chunks among them that were prefetched.
+    double m_totalLoadTimeInSeconds = 0;   // Time spent in loading chunks.
+    double m_maxLoadTimeInSeconds = 0;     // Longest load of a single chunk.
+    double m_totalWaitTimeInSeconds = 0;   // Time the randomizer was waiting for chunks.
+};
+
 // A randomizer that firstly randomizes chunks and then sequences inside a rolling window of chunks.
 // Uses ChunkRandomizer to randomize chunk descriptions and SequenceRandomizer to randomize sequence descriptions inside a window of chunks.
 // It requires only a window of sequence descriptions and corresponding chunk data.
@@ -30,6 +64,9 @@ namespace CNTK {
 //         5) decimate sequence descriptions based on the worker rank
 //         6) request chunks of data based on decimated sequences and return sequence data
 //
+// With the chunk affinity enabled the chunks are randomized in a way that every worker gets mostly the same chunks in every sweep,
+// see RandomizeChunksInShards.
+//
 // This class is responsible for decimation and loading the data chunks in to memory.
 // Actual randomization happens in ChunkRandomizer and SequenceRandomizer.
 // TODO: The behavior can be simplified by only randomizing sequences forward.
@@ -44,7 +81,9 @@ public:
         bool multithreadedGetNextSequences = false,
         size_t maxNumberOfInvalidSequences = 0, // per worker
         bool sampleBasedRandomizationWindow = true,
-        size_t seedOffset = 0);
+        size_t seedOffset = 0,
+        const ChunkPrefetchConfig& prefetchConfig = ChunkPrefetchConfig(),
+        const ChunkAffinityConfig& affinityConfig = ChunkAffinityConfig());
 
     // Starts a new epoch.
     virtual void StartEpoch(const EpochConfiguration& config) override;
@@ -63,19 +102,36 @@ public:
     // Returns current position in the global timeline. The returned value is in samples.
     std::map<std::wstring, size_t> GetState() override;
 
-    ~BlockRandomizer()
-    {
-        if (m_prefetch.valid())
-        {
-            m_prefetch.wait();
-        }
-    }
+    ~BlockRandomizer();
 
     void SetState(const std::map<std::wstring, size_t>& state) override;
 
     void SetConfiguration(const ReaderConfiguration& config) override;
 
+    // Gets statistics of the chunks loaded so far.
+    const ChunkLoadStatistics& GetChunkLoadStatistics() const
+    {
+        return m_loadStatistics;
+    }
+
 private:
+    // A chunk together with the time it took to load it.
+    struct LoadedChunk
+    {
+        ChunkPtr m_chunk;
+        double m_loadTimeInSeconds;
+    };
+
+    // A chunk that is being loaded on the load threads.
+    struct ChunkLoad
+    {
+        std::future<LoadedChunk> m_future;
+        size_t m_estimatedSizeInBytes;
+        bool m_isPrefetch;
+    };
+
+    typedef std::shared_ptr<std::packaged_task<LoadedChunk()>> LoadTaskPtr;
+
     // Load data for chunks if needed.
     void LoadDataChunks(const ClosedOpenChunkInterval& windowRange);
 
@@ -97,11 +153,24 @@ private:
     // Prepares a new sweep if needed.
     void PrepareNewSweepIfNeeded(size_t samplePosition);
 
-    // Performs io prefetch of the specified chunk if needed.
-    void Prefetch(ChunkIdType chunkId);
+    // Starts loading the chunks following the given window in the randomized order, so that up to the prefetch depth
+    // of them are loaded ahead, within the memory budget. Prefetched chunks that are not among them anymore are dropped.
+    void Prefetch(const ClosedOpenChunkInterval& windowRange);
+
+    // Hints the deserializer about the chunks of this worker that follow the window in the randomized order, up to the read ahead depth.
+    void ReadAhead(const ClosedOpenChunkInterval& windowRange);
 
-    // Returns next candidate for the prefetch in the given range.
-    ChunkIdType GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange);
+    // Queues loads of the specified original chunks on the load threads, in front of the already queued ones if urgent.
+    void StartLoading(const std::vector<const ChunkInfo*>& chunks, bool isPrefetch, bool urgent);
+
+    // Runs the first queued load, called on a load thread.
+    void RunPendingLoad();
+
+    // Loads the specified original chunk, measuring the time it takes.
+    static LoadedChunk LoadChunk(const DataDeserializerPtr& deserializer, ChunkIdType chunkId);
+
+    // Estimated memory taken by the specified chunk.
+    size_t EstimateSizeInBytes(const ChunkInfo& chunk) const;
 
     // Global sample position on the timeline.
     size_t m_globalSamplePosition;
@@ -118,6 +187,12 @@ private:
     // Current sweep.
     size_t m_sweep;
 
+    // Chunk affinity configuration, with it the chunks are randomized in shards of the workers.
+    ChunkAffinityConfig m_affinityConfig;
+
+    // Number of shards the chunks of the current sweep were randomized for.
+    size_t m_numberOfShards;
+
     // Offset used together with the current sweep to seed rngs.
     size_t m_seedOffset;
 
@@ -126,6 +201,12 @@ private:
 
     DataDeserializerPtr m_deserializer;
 
+    // The deserializer as DataDeserializerBase that takes read ahead hints, null if it does not.
+    std::shared_ptr<DataDeserializerBase> m_readAheadDeserializer;
+
+    // Randomized chunk position up to which the read ahead hints have been given in the current sweep.
+    size_t m_readAheadEnd;
+
     // Chunk randomizer.
     ChunkRandomizerPtr m_chunkRandomizer;
 
@@ -153,12 +234,23 @@ private:
 
     int m_verbosity;
 
-    // Prefetch future.
-    std::future<ChunkPtr> m_prefetch;
-    // Whether to have async or deferred prefetch.
-    launch m_launchType;
-    // Prefetched original chunk id.
-    ChunkIdType m_prefetchedChunk;
+    // Chunk prefetch configuration, the depth is 0 if prefetch is disabled.
+    ChunkPrefetchConfig m_prefetchConfig;
+
+    // Estimated number of bytes a sample takes in memory.
+    size_t m_sampleSizeInBytes;
+
+    // A map of chunks that are being loaded from original chunk id into the load.
+    std::map<ChunkIdType, ChunkLoad> m_loads;
+
+    // Loads that have not been started yet, in the order they are run by the load threads.
+    std::deque<std::pair<ChunkIdType, LoadTaskPtr>> m_pendingLoads;
+    std::mutex m_pendingLoadsMutex;
+
+    // Threads loading chunks, null if prefetch is disabled.
+    std::unique_ptr<Microsoft::MSR::CNTK::WorkStealingThreadPool> m_loadThreads;
+
+    ChunkLoadStatistics m_loadStatistics;
 
     // Current loaded chunks.
     ClosedOpenChunkInterval m_currentWindowRange;
@@ -6,6 +6,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <cassert>
+#include <cstring>
 #include <vector>
 #include <memory>
 #include "ReaderConstants.h"
@@ -59,6 +61,23 @@ public:
         return true;
     }
 
+    // Returns the characters of the buffer starting at the current position, so that they can be scanned in bulk.
+    inline const char* CurrentBuffer() const { return m_buffer.data() + m_index; }
+
+    // Returns the number of characters in the buffer starting at the current position (0 upon reaching the EOF).
+    inline size_t BufferedBytes() const { return m_done ? 0 : m_buffer.size() - m_index; }
+
+    // Advances the current position by the given number of buffered characters, which must not contain an EOL.
+    inline void Skip(size_t count)
+    {
+        assert(count <= BufferedBytes());
+        assert(memchr(CurrentBuffer(), g_eol, count) == nullptr);
+
+        m_index += count;
+        if (m_index == m_buffer.size())
+            Refill();
+    }
+
     // Moves the current position to the next line (the position following an EOL delimiter).
     // Returns true, unless the EOF has been reached.
     bool TryMoveToNextLine();
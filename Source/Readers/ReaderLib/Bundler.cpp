@@ -171,6 +171,82 @@ std::vector<ChunkInfo> Bundler::ChunkInfos()
     return std::vector<ChunkInfo>(m_chunks.begin(), m_chunks.end());
 }
 
+void Bundler::HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds)
+{
+    for (size_t deserializerIndex = 0; deserializerIndex < m_deserializers.size(); ++deserializerIndex)
+    {
+        auto deserializer = dynamic_cast<DataDeserializerBase*>(m_deserializers[deserializerIndex].get());
+        if (!deserializer)
+            continue;
+
+        std::vector<ChunkIdType> upcoming;
+        for (auto chunkId : chunkIds)
+        {
+            for (auto c : m_chunks[chunkId].m_secondaryChunks[deserializerIndex])
+            {
+                if (std::find(upcoming.begin(), upcoming.end(), c) == upcoming.end())
+                    upcoming.push_back(c);
+            }
+        }
+        deserializer->HintUpcomingChunks(upcoming);
+    }
+}
+
+bool Bundler::SupportsConcurrentGetChunk() const
+{
+    for (const auto& d : m_deserializers)
+    {
+        auto deserializer = dynamic_cast<DataDeserializerBase*>(d.get());
+        if (!deserializer || !deserializer->SupportsConcurrentGetChunk())
+            return false;
+    }
+    return true;
+}
+
+ChunkPtr Bundler::GetInnerChunk(size_t deserializerIndex, ChunkIdType chunkId)
+{
+    auto key = std::make_pair(deserializerIndex, chunkId);
+    std::shared_future<ChunkPtr> pending;
+    std::promise<ChunkPtr> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m_chunkTableMutex);
+        ChunkPtr chunk = m_weakChunkTable[deserializerIndex][chunkId].lock();
+        if (chunk)
+            return chunk;
+
+        auto found = m_pendingChunks.find(key);
+        if (found != m_pendingChunks.end())
+            pending = found->second;
+        else
+            m_pendingChunks[key] = loaded.get_future().share();
+    }
+
+    // Another bundling chunk is loading it already.
+    if (pending.valid())
+        return pending.get();
+
+    ChunkPtr chunk;
+    try
+    {
+        chunk = m_deserializers[deserializerIndex]->GetChunk(chunkId);
+    }
+    catch (...)
+    {
+        loaded.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(m_chunkTableMutex);
+        m_pendingChunks.erase(key);
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_chunkTableMutex);
+        m_weakChunkTable[deserializerIndex][chunkId] = chunk;
+        m_pendingChunks.erase(key);
+    }
+    loaded.set_value(chunk);
+    return chunk;
+}
+
 // Gets sequence descriptions for a chunk.
 void Bundler::SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& sequences)
 {
@@ -255,7 +331,7 @@ public:
         auto& deserializers = m_parent->m_deserializers;
 
         // Fetch all chunks in parallel.
-        std::vector<std::map<ChunkIdType, std::shared_ptr<std::future<ChunkPtr>>>> chunks;
+        std::vector<std::map<ChunkIdType, std::shared_future<ChunkPtr>>> chunks;
         chunks.resize(chunk.m_secondaryChunks.size());
         for (size_t i = 0; i < chunk.m_secondaryChunks.size(); ++i)
         {
@@ -263,16 +339,12 @@ public:
             {
                 chunks[i].emplace(
                     std::make_pair(c,
-                        std::make_shared<std::future<ChunkPtr>>(
-                            std::async(
-                                launch::async,
-                                [this, c, i]()
-                                {
-                                    ChunkPtr chunk = m_parent->m_weakChunkTable[i][c].lock();
-                                    if (chunk)
-                                        return chunk;
-                                    return m_parent->m_deserializers[i]->GetChunk(c);
-                                }))));
+                        std::async(
+                            launch::async,
+                            [this, c, i]()
+                            {
+                                return m_parent->GetInnerChunk(i, c);
+                            }).share()));
             }
         }
 
@@ -281,7 +353,7 @@ public:
 
         // Creating chunk mapping.
         m_parent->m_primaryDeserializer->SequenceInfosForChunk(original.m_id, sequences);
-        ChunkPtr drivingChunk = chunks.front().find(original.m_id)->second->get();
+        ChunkPtr drivingChunk = chunks.front().find(original.m_id)->second.get();
         m_sequenceToSequence.resize(deserializers.size() * sequences.size());
         m_innerChunks.resize(deserializers.size() * sequences.size());
         for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
@@ -300,7 +372,6 @@ public:
         SequenceInfo s;
         for (size_t deserializerIndex = 1; deserializerIndex < deserializers.size(); ++deserializerIndex)
         {
-            auto& chunkTable = m_parent->m_weakChunkTable[deserializerIndex];
             for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
             {
                 if (chunk.m_invalid.find(sequenceIndex) != chunk.m_invalid.end())
@@ -321,14 +392,7 @@ public:
                 }
 
                 m_sequenceToSequence[currentIndex] = s.m_indexInChunk;
-                ChunkPtr secondaryChunk = chunkTable[s.m_chunkId].lock();
-                if (!secondaryChunk)
-                {
-                    secondaryChunk = chunks[deserializerIndex].find(s.m_chunkId)->second->get();
-                    chunkTable[s.m_chunkId] = secondaryChunk;
-                }
-
-                m_innerChunks[currentIndex] = secondaryChunk;
+                m_innerChunks[currentIndex] = chunks[deserializerIndex].find(s.m_chunkId)->second.get();
             }
         }
     }
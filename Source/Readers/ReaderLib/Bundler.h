@@ -6,6 +6,9 @@
 #pragma once
 
 #include <set>
+#include <map>
+#include <mutex>
+#include <future>
 #include "DataDeserializerBase.h"
 #include "Config.h"
 #include "CorpusDescriptor.h"
@@ -29,9 +32,18 @@ public:
     // Gets a chunk with data.
     virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
 
+    // Passes the hint on to the underlying deserializers, together with their chunks that are needed.
+    virtual void HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds) override;
+
+    // Chunks can be loaded concurrently if all underlying deserializers support it.
+    virtual bool SupportsConcurrentGetChunk() const override;
+
 private:
     DISABLE_COPY_AND_MOVE(Bundler);
 
+    // Gets a chunk of an underlying deserializer, sharing it with the bundling chunks that hold or are loading it.
+    ChunkPtr GetInnerChunk(size_t deserializerIndex, ChunkIdType chunkId);
+
     class BundlingChunk;
 
     struct BundlerChunkDescription : public ChunkInfo
@@ -74,6 +86,13 @@ private:
     // Inner vector is the table of chunk id into weak pointer, the outer vector has an element per deserializer.
     std::vector<std::vector<std::weak_ptr<Chunk>>> m_weakChunkTable;
 
+    // Chunks that are being loaded, keyed by deserializer index and chunk id, so that bundling chunks
+    // that are created concurrently wait for the same load.
+    std::map<std::pair<size_t, ChunkIdType>, std::shared_future<ChunkPtr>> m_pendingChunks;
+
+    // Guards the table of loaded chunks and the chunks being loaded.
+    std::mutex m_chunkTableMutex;
+
     // General configuration
     int m_verbosity;
 
@@ -5,22 +5,479 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
+#include <atomic>
+#include <string.h>
 #include "ChunkCache.h"
+#include "SequenceData.h"
+#include "LZCompression.h"
 
 namespace CNTK {
 
+ChunkCacheConfig::ChunkCacheConfig(const ConfigParameters& config)
+{
+    m_maxSizeInBytes = config(L"chunkCacheSizeInBytes", (size_t)0);
+    m_compress = config(L"chunkCacheCompression", false);
+    std::wstring spillDirectory = config(L"chunkCacheSpillDirectory", L"");
+    m_spillDirectory = spillDirectory;
+}
+
+// Layout of a serialized chunk, with all sections padded to 8 bytes to keep the data aligned:
+//   ChunkHeader
+//   SequenceInfo for every sequence
+//   for every sequence and every stream, a SequenceHeader followed by
+//     - the dimensions of the sample shape (size_t),
+//     - dense: the data of all samples,
+//     - sparse: the nnz counts of all samples, the indices and the non zero values.
+struct ChunkHeader
+{
+    uint64_t m_numberOfSequences;
+    uint64_t m_numberOfStreams;
+};
+
+struct SequenceHeader
+{
+    SequenceKey m_key;
+    uint32_t m_numberOfSamples;
+    uint32_t m_isValid;
+    uint32_t m_rank;
+    uint32_t m_totalNnzCount;
+};
+
+static inline size_t Padded(size_t size)
+{
+    return (size + 7) & ~(size_t)7;
+}
+
+static inline void Append(std::vector<char>& buffer, const void* data, size_t size)
+{
+    size_t offset = buffer.size();
+    buffer.resize(offset + Padded(size));
+    if (size != 0)
+        memcpy(buffer.data() + offset, data, size);
+}
+
+// Sequences returned from a cached chunk point into its buffer, which they keep alive.
+struct CachedDenseSequenceData : DenseSequenceData
+{
+    const void* GetDataBuffer() override { return m_data; }
+    const NDShape& GetSampleShape() override { return m_sampleShape; }
+
+    const void* m_data;
+    NDShape m_sampleShape;
+    std::shared_ptr<std::vector<char>> m_buffer;
+};
+
+struct CachedSparseSequenceData : SparseSequenceData
+{
+    const void* GetDataBuffer() override { return m_data; }
+    const NDShape& GetSampleShape() override { return m_sampleShape; }
+
+    const void* m_data;
+    NDShape m_sampleShape;
+    std::shared_ptr<std::vector<char>> m_buffer;
+};
+
+// A chunk deserialized from the cache.
+class CachedChunk : public Chunk
+{
+public:
+    CachedChunk(const std::shared_ptr<std::vector<char>>& buffer, const std::vector<StreamInformation>& streams)
+        : m_buffer(buffer), m_streams(streams)
+    {
+        const char* data = m_buffer->data();
+        const auto* header = reinterpret_cast<const ChunkHeader*>(data);
+        if (header->m_numberOfStreams != m_streams.size())
+            LogicError("ChunkCache: The cached chunk has %zu streams instead of %zu.", (size_t)header->m_numberOfStreams, m_streams.size());
+
+        size_t offset = Padded(sizeof(ChunkHeader));
+        const auto* infos = reinterpret_cast<const SequenceInfo*>(data + offset);
+        m_sequenceInfos.assign(infos, infos + header->m_numberOfSequences);
+        offset += Padded(sizeof(SequenceInfo) * m_sequenceInfos.size());
+
+        for (size_t i = 0; i < m_sequenceInfos.size(); ++i)
+        {
+            size_t index = m_sequenceInfos[i].m_indexInChunk;
+            if (index >= m_positions.size())
+                m_positions.resize(index + 1, SIZE_MAX);
+            m_positions[index] = i;
+        }
+
+        // Offsets of the sequence headers.
+        m_offsets.reserve(m_sequenceInfos.size() * m_streams.size());
+        for (size_t i = 0; i < m_sequenceInfos.size(); ++i)
+        {
+            for (const auto& stream : m_streams)
+            {
+                m_offsets.push_back(offset);
+                const auto* sequence = reinterpret_cast<const SequenceHeader*>(data + offset);
+                offset += Padded(sizeof(SequenceHeader)) + Padded(sequence->m_rank * sizeof(size_t));
+                if (!sequence->m_isValid)
+                    continue;
+
+                size_t elementSize = DataTypeSize(stream.m_elementType);
+                if (stream.m_storageFormat == StorageFormat::Dense)
+                {
+                    const size_t* dims = reinterpret_cast<const size_t*>(data + m_offsets.back() + Padded(sizeof(SequenceHeader)));
+                    size_t sampleSize = 1;
+                    for (size_t d = 0; d < sequence->m_rank; ++d)
+                        sampleSize *= dims[d];
+                    offset += Padded(sequence->m_numberOfSamples * sampleSize * elementSize);
+                }
+                else
+                {
+                    offset += Padded(sequence->m_numberOfSamples * sizeof(SparseIndexType));
+                    offset += Padded(sequence->m_totalNnzCount * sizeof(SparseIndexType));
+                    offset += Padded(sequence->m_totalNnzCount * elementSize);
+                }
+            }
+        }
+
+        if (offset != m_buffer->size())
+            LogicError("ChunkCache: The cached chunk is corrupted.");
+    }
+
+    void GetSequence(size_t sequenceIndex, std::vector<SequenceDataPtr>& result) override
+    {
+        if (sequenceIndex >= m_positions.size() || m_positions[sequenceIndex] == SIZE_MAX)
+            LogicError("ChunkCache: Sequence %zu is not in the cached chunk.", sequenceIndex);
+
+        char* data = m_buffer->data();
+        for (size_t s = 0; s < m_streams.size(); ++s)
+        {
+            const auto& stream = m_streams[s];
+            size_t offset = m_offsets[m_positions[sequenceIndex] * m_streams.size() + s];
+            const auto* header = reinterpret_cast<const SequenceHeader*>(data + offset);
+            offset += Padded(sizeof(SequenceHeader));
+            if (!header->m_isValid)
+            {
+                result.push_back(InvalidSequenceData::Instance());
+                continue;
+            }
+
+            const size_t* dims = reinterpret_cast<const size_t*>(data + offset);
+            NDShape sampleShape(std::vector<size_t>(dims, dims + header->m_rank));
+            offset += Padded(header->m_rank * sizeof(size_t));
+
+            if (stream.m_storageFormat == StorageFormat::Dense)
+            {
+                auto sequence = std::make_shared<CachedDenseSequenceData>();
+                sequence->m_data = data + offset;
+                sequence->m_sampleShape = sampleShape;
+                sequence->m_buffer = m_buffer;
+                sequence->m_numberOfSamples = header->m_numberOfSamples;
+                sequence->m_elementType = stream.m_elementType;
+                sequence->m_key = header->m_key;
+                result.push_back(sequence);
+            }
+            else
+            {
+                auto sequence = std::make_shared<CachedSparseSequenceData>();
+                const auto* nnzCounts = reinterpret_cast<const SparseIndexType*>(data + offset);
+                sequence->m_nnzCounts.assign(nnzCounts, nnzCounts + header->m_numberOfSamples);
+                offset += Padded(header->m_numberOfSamples * sizeof(SparseIndexType));
+                sequence->m_indices = reinterpret_cast<SparseIndexType*>(data + offset);
+                offset += Padded(header->m_totalNnzCount * sizeof(SparseIndexType));
+                sequence->m_data = data + offset;
+                sequence->m_totalNnzCount = header->m_totalNnzCount;
+                sequence->m_sampleShape = sampleShape;
+                sequence->m_buffer = m_buffer;
+                sequence->m_numberOfSamples = header->m_numberOfSamples;
+                sequence->m_elementType = stream.m_elementType;
+                sequence->m_key = header->m_key;
+                result.push_back(sequence);
+            }
+        }
+    }
+
+    void SequenceInfos(std::vector<SequenceInfo>& result) override
+    {
+        result.insert(result.end(), m_sequenceInfos.begin(), m_sequenceInfos.end());
+    }
+
+private:
+    std::shared_ptr<std::vector<char>> m_buffer;
+    std::vector<StreamInformation> m_streams;
+    std::vector<SequenceInfo> m_sequenceInfos;
+    std::vector<size_t> m_positions; // Index in chunk -> position of the sequence in the buffer.
+    std::vector<size_t> m_offsets;   // Offsets of the sequences of all streams.
+};
+
+ChunkCache::ChunkCache(DataDeserializerPtr deserializer, const ChunkCacheConfig& config)
+    : DataDeserializerBase(true), m_deserializer(deserializer), m_config(config), m_sizeInBytes(0), m_numberOfMisses(0), m_sweep(0)
+{
+    m_streams = m_deserializer->StreamInfos();
+    if (!m_config.RequiresSerialization())
+        return;
+
+    for (const auto& stream : m_streams)
+    {
+        if (stream.m_isBinary || (stream.m_storageFormat != StorageFormat::Dense && stream.m_storageFormat != StorageFormat::SparseCSC))
+            InvalidArgument("ChunkCache: Stream '%ls' cannot be serialized, only a cache without size limit, compression or spill directory is supported.",
+                            stream.m_name.c_str());
+    }
+
+    if (!m_config.m_spillDirectory.empty())
+    {
+        static std::atomic<size_t> s_cacheCount(0);
+        m_spillFileName = m_config.m_spillDirectory + L"/cntk_chunk_cache_" + std::to_wstring((size_t)GetCurrentProcessId()) +
+                          L"_" + std::to_wstring(s_cacheCount++) + L".bin";
+        m_spillFile = std::make_unique<FileWrapper>(FileWrapper::OpenOrDie(m_spillFileName, L"w+b"));
+    }
+}
+
+ChunkCache::~ChunkCache()
+{
+    if (m_spillFile)
+    {
+        m_spillFile.reset();
+        _wunlink(m_spillFileName.c_str());
+    }
+}
+
+size_t ChunkCache::GetSizeInBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sizeInBytes;
+}
+
+size_t ChunkCache::GetNumberOfMisses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numberOfMisses;
+}
+
 ChunkPtr ChunkCache::GetChunk(ChunkIdType chunkId)
 {
-    auto it = m_chunkMap.find(chunkId);
-    if (it != m_chunkMap.end())
+    if (!m_config.RequiresSerialization())
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_chunkMap.find(chunkId);
+        if (it != m_chunkMap.end())
+        {
+            return it->second;
+        }
+
+        m_numberOfMisses++;
+        lock.unlock();
+
+        // If the chunk is requested concurrently, the first loaded chunk is kept.
+        ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
+        lock.lock();
+        return m_chunkMap.insert(std::make_pair(chunkId, chunk)).first->second;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto& entry = m_entries[chunkId];
+    MarkRequested(entry);
+
+    auto data = entry.m_data;
+    if (data)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, entry.m_lruPosition);
+    }
+    else if (entry.m_spillOffset >= 0)
+    {
+        data = ReadSpilled(entry);
+        Admit(chunkId, entry, data);
+    }
+
+    if (data)
     {
-        return it->second;
+        size_t size = entry.m_size;
+        bool isCompressed = entry.m_isCompressed;
+        lock.unlock();
+        return Deserialize(data, size, isCompressed);
     }
- 
+
+    m_numberOfMisses++;
+    lock.unlock();
+
+    // The chunk is read and serialized outside of the lock, so that the cache can serve other requests meanwhile.
     ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
-    m_chunkMap[chunkId] = chunk;
- 
+    auto serialized = Serialize(chunkId, chunk);
+    size_t size = serialized->size();
+    bool isCompressed = false;
+    if (m_config.m_compress)
+    {
+        auto compressed = std::make_shared<std::vector<char>>();
+        LZCompress(serialized->data(), size, *compressed);
+        if (compressed->size() < size)
+        {
+            compressed->shrink_to_fit();
+            serialized = compressed;
+            isCompressed = true;
+        }
+    }
+
+    lock.lock();
+    auto& newEntry = m_entries[chunkId];
+    if (!newEntry.m_data && newEntry.m_spillOffset < 0)
+    {
+        newEntry.m_size = size;
+        newEntry.m_isCompressed = isCompressed;
+        newEntry.m_storedSize = serialized->size();
+        Admit(chunkId, newEntry, serialized);
+    }
+
     return chunk;
 }
 
+void ChunkCache::HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds)
+{
+    auto deserializer = dynamic_cast<DataDeserializerBase*>(m_deserializer.get());
+    if (deserializer)
+        deserializer->HintUpcomingChunks(chunkIds);
+}
+
+bool ChunkCache::SupportsConcurrentGetChunk() const
+{
+    auto deserializer = dynamic_cast<DataDeserializerBase*>(m_deserializer.get());
+    return deserializer && deserializer->SupportsConcurrentGetChunk();
+}
+
+void ChunkCache::MarkRequested(CacheEntry& entry)
+{
+    // With randomization every chunk is requested once per sweep, so a chunk that is requested
+    // again marks the beginning of the next sweep.
+    if (entry.m_lastSweep == m_sweep)
+        m_sweep++;
+    entry.m_lastSweep = m_sweep;
+}
+
+void ChunkCache::Admit(ChunkIdType chunkId, CacheEntry& entry, const std::shared_ptr<std::vector<char>>& data)
+{
+    if (m_config.m_maxSizeInBytes != 0)
+    {
+        // Collect enough chunks that have already been requested in this sweep, least recently used first.
+        std::vector<ChunkIdType> victims;
+        size_t size = m_sizeInBytes;
+        for (auto it = m_lru.rbegin(); it != m_lru.rend() && size + entry.m_storedSize > m_config.m_maxSizeInBytes; ++it)
+        {
+            auto& candidate = m_entries[*it];
+            if (candidate.m_lastSweep != m_sweep)
+                continue;
+
+            victims.push_back(*it);
+            size -= candidate.m_storedSize;
+        }
+
+        // All chunks in memory will be requested in this sweep before this one is requested again,
+        // so this one is not kept in memory.
+        if (size + entry.m_storedSize > m_config.m_maxSizeInBytes)
+        {
+            entry.m_data = data;
+            Spill(entry);
+            entry.m_data = nullptr;
+            return;
+        }
+
+        for (auto victim : victims)
+            Evict(m_entries[victim]);
+    }
+
+    entry.m_data = data;
+    m_sizeInBytes += entry.m_storedSize;
+    m_lru.push_front(chunkId);
+    entry.m_lruPosition = m_lru.begin();
+}
+
+void ChunkCache::Evict(CacheEntry& entry)
+{
+    Spill(entry);
+    entry.m_data = nullptr;
+    m_sizeInBytes -= entry.m_storedSize;
+    m_lru.erase(entry.m_lruPosition);
+}
+
+void ChunkCache::Spill(CacheEntry& entry)
+{
+    // Cached chunks never change, so a chunk is written to the spill file at most once.
+    if (!m_spillFile || entry.m_spillOffset >= 0)
+        return;
+
+    m_spillFile->SeekOrDie(0, SEEK_END);
+    entry.m_spillOffset = m_spillFile->TellOrDie();
+    m_spillFile->WriteOrDie(entry.m_data->data(), 1, entry.m_storedSize);
+}
+
+std::shared_ptr<std::vector<char>> ChunkCache::ReadSpilled(const CacheEntry& entry)
+{
+    auto data = std::make_shared<std::vector<char>>(entry.m_storedSize);
+    m_spillFile->FlushOrDie();
+    m_spillFile->SeekOrDie(entry.m_spillOffset, SEEK_SET);
+    m_spillFile->ReadOrDie(data->data(), 1, entry.m_storedSize);
+    return data;
+}
+
+std::shared_ptr<std::vector<char>> ChunkCache::Serialize(ChunkIdType chunkId, const ChunkPtr& chunk)
+{
+    std::vector<SequenceInfo> infos;
+    m_deserializer->SequenceInfosForChunk(chunkId, infos);
+
+    auto buffer = std::make_shared<std::vector<char>>();
+    ChunkHeader header{ infos.size(), m_streams.size() };
+    Append(*buffer, &header, sizeof(header));
+    Append(*buffer, infos.data(), infos.size() * sizeof(SequenceInfo));
+
+    std::vector<SequenceDataPtr> sequences;
+    for (const auto& info : infos)
+    {
+        sequences.clear();
+        chunk->GetSequence(info.m_indexInChunk, sequences);
+        if (sequences.size() != m_streams.size())
+            LogicError("ChunkCache: Chunk %u returned %zu streams instead of %zu.", (unsigned int)chunkId, sequences.size(), m_streams.size());
+
+        for (size_t s = 0; s < m_streams.size(); ++s)
+        {
+            const auto& stream = m_streams[s];
+            const auto& sequence = sequences[s];
+            SequenceHeader sequenceHeader{ sequence->m_key, sequence->m_numberOfSamples, sequence->m_isValid ? 1u : 0u, 0, 0 };
+            if (!sequence->m_isValid)
+            {
+                Append(*buffer, &sequenceHeader, sizeof(sequenceHeader));
+                continue;
+            }
+
+            const auto& dims = sequence->GetSampleShape().Dimensions();
+            sequenceHeader.m_rank = (uint32_t)dims.size();
+            size_t elementSize = DataTypeSize(stream.m_elementType);
+            if (stream.m_storageFormat == StorageFormat::Dense)
+            {
+                Append(*buffer, &sequenceHeader, sizeof(sequenceHeader));
+                Append(*buffer, dims.data(), dims.size() * sizeof(size_t));
+                size_t sampleSize = sequence->GetSampleShape().TotalSize();
+                Append(*buffer, sequence->GetDataBuffer(), sequence->m_numberOfSamples * sampleSize * elementSize);
+            }
+            else
+            {
+                auto sparse = std::static_pointer_cast<SparseSequenceData>(sequence);
+                if (sparse->m_nnzCounts.size() != sparse->m_numberOfSamples)
+                    LogicError("ChunkCache: Sparse sequence of stream '%ls' has %zu nnz counts for %u samples.",
+                               stream.m_name.c_str(), sparse->m_nnzCounts.size(), sparse->m_numberOfSamples);
+
+                sequenceHeader.m_totalNnzCount = (uint32_t)sparse->m_totalNnzCount;
+                Append(*buffer, &sequenceHeader, sizeof(sequenceHeader));
+                Append(*buffer, dims.data(), dims.size() * sizeof(size_t));
+                Append(*buffer, sparse->m_nnzCounts.data(), sparse->m_nnzCounts.size() * sizeof(SparseIndexType));
+                Append(*buffer, sparse->m_indices, sparse->m_totalNnzCount * sizeof(SparseIndexType));
+                Append(*buffer, sparse->GetDataBuffer(), sparse->m_totalNnzCount * elementSize);
+            }
+        }
+    }
+
+    return buffer;
+}
+
+ChunkPtr ChunkCache::Deserialize(const std::shared_ptr<std::vector<char>>& data, size_t size, bool isCompressed)
+{
+    auto buffer = data;
+    if (isCompressed)
+    {
+        buffer = std::make_shared<std::vector<char>>(size);
+        LZDecompress(data->data(), data->size(), buffer->data(), size);
+    }
+
+    return std::make_shared<CachedChunk>(buffer, m_streams);
+}
+
 }
@@ -6,21 +6,49 @@
 #pragma once
 
 #include <map>
-#include "DataDeserializer.h"
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include "DataDeserializerBase.h"
+#include "FileWrapper.h"
 
 namespace CNTK {
 
-// A cache to store the complete dataset (all chunks) in memory. The caching can
-// be switched on/off by a boolean flag in the reader config section, independent 
-// of the randomization and chunking parameters. The caching should only be enabled 
-// when the whole dataset fits in memory.
-// Implemented as a wrapping proxy around a deserializer that stores pointers to
-// all chunks it sees in an internal map.
-class ChunkCache : public DataDeserializer
+// Configuration of the chunk cache, read from the reader config section:
+//   chunkCacheSizeInBytes    - memory budget of the cache, 0 (default) means unbounded.
+//   chunkCacheCompression    - whether cached chunks are kept compressed in memory (default: false).
+//   chunkCacheSpillDirectory - local directory chunks evicted from memory are written to,
+//                              if empty (default) they are dropped and deserialized again when needed.
+struct ChunkCacheConfig
+{
+    ChunkCacheConfig() : m_maxSizeInBytes(0), m_compress(false) {}
+    explicit ChunkCacheConfig(const ConfigParameters& config);
+
+    // If false, the cache simply keeps the chunks of the underlying deserializer,
+    // otherwise it keeps them serialized into its own buffers.
+    bool RequiresSerialization() const { return m_maxSizeInBytes != 0 || m_compress || !m_spillDirectory.empty(); }
+
+    size_t m_maxSizeInBytes;
+    bool m_compress;
+    std::wstring m_spillDirectory;
+};
+
+// A cache of the chunks of a deserializer, so that the data is deserialized only once and not in every sweep.
+// The caching can be switched on/off by a boolean flag in the reader config section, independent
+// of the randomization and chunking parameters.
+// Implemented as a wrapping proxy around a deserializer. With the default configuration it stores
+// pointers to all chunks it sees in an internal map, which is only feasible when the whole dataset fits in memory.
+// Otherwise chunks are serialized (and optionally compressed) into buffers of known size, so that the cache can
+// be bounded. When the budget is exceeded, chunks that have already been read in the current sweep are evicted first,
+// least recently used first, because with randomization each chunk is read once per sweep and those are the chunks
+// needed last. This avoids the pathology of plain LRU with sweeps larger than the cache, which never hits.
+// Evicted chunks are written to a spill file if a spill directory is configured.
+class ChunkCache : public DataDeserializerBase
 {
 public:
+    ChunkCache(DataDeserializerPtr deserializer, const ChunkCacheConfig& config = ChunkCacheConfig());
 
-    ChunkCache(DataDeserializerPtr deserializer) : m_deserializer(deserializer) { }
+    ~ChunkCache();
 
     virtual std::vector<StreamInformation> StreamInfos() override
     {
@@ -43,12 +71,58 @@ public:
     }
 
     // Gets chunk data given its id.
-    virtual ChunkPtr GetChunk(ChunkIdType chunkId);
+    virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+    // Passes the hint on to the underlying deserializer.
+    virtual void HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds) override;
+
+    // The cache is safe to call concurrently, so this depends on the underlying deserializer only.
+    virtual bool SupportsConcurrentGetChunk() const override;
+
+    // Memory currently used by serialized chunks.
+    size_t GetSizeInBytes() const;
+
+    // Number of chunks that were requested from the underlying deserializer.
+    size_t GetNumberOfMisses() const;
 
 private:
-    // A map of currently loaded chunks
-    std::map<size_t, ChunkPtr> m_chunkMap;
+    // A serialized chunk, in memory and/or in the spill file.
+    struct CacheEntry
+    {
+        std::shared_ptr<std::vector<char>> m_data; // Serialized chunk if it is in memory, possibly compressed.
+        size_t m_size = 0;                         // Size of the serialized chunk when decompressed.
+        bool m_isCompressed = false;
+        size_t m_storedSize = 0;                   // Size of the serialized chunk in memory or in the spill file.
+        int64_t m_spillOffset = -1;                // Offset in the spill file, -1 if not spilled.
+        size_t m_lastSweep = SIZE_MAX;             // Sweep in which the chunk has been requested last.
+        std::list<ChunkIdType>::iterator m_lruPosition;
+    };
+
+    std::shared_ptr<std::vector<char>> Serialize(ChunkIdType chunkId, const ChunkPtr& chunk);
+    ChunkPtr Deserialize(const std::shared_ptr<std::vector<char>>& data, size_t size, bool isCompressed);
+
+    // The following methods expect m_mutex to be locked.
+    void MarkRequested(CacheEntry& entry);
+    void Admit(ChunkIdType chunkId, CacheEntry& entry, const std::shared_ptr<std::vector<char>>& data);
+    void Evict(CacheEntry& entry);
+    void Spill(CacheEntry& entry);
+    std::shared_ptr<std::vector<char>> ReadSpilled(const CacheEntry& entry);
+
     DataDeserializerPtr m_deserializer;
+    ChunkCacheConfig m_config;
+
+    // A map of currently loaded chunks, used when chunks are not serialized, guarded by m_mutex.
+    std::map<size_t, ChunkPtr> m_chunkMap;
+
+    mutable std::mutex m_mutex;
+    std::map<ChunkIdType, CacheEntry> m_entries;
+    std::list<ChunkIdType> m_lru; // Chunks in memory, most recently used first.
+    size_t m_sizeInBytes;
+    size_t m_numberOfMisses;
+    size_t m_sweep;
+
+    std::wstring m_spillFileName;
+    std::unique_ptr<FileWrapper> m_spillFile;
 
     DISABLE_COPY_AND_MOVE(ChunkCache);
 };
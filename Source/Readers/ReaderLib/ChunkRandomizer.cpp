@@ -10,6 +10,15 @@
 
 namespace CNTK {
 
+    ChunkAffinityConfig::ChunkAffinityConfig(const Microsoft::MSR::CNTK::ConfigParameters& config)
+    {
+        m_enabled = config(L"chunkAffinity", false);
+        m_reshuffleFraction = config(L"chunkAffinityReshuffleFraction", 0.0);
+
+        if (m_reshuffleFraction < 0 || m_reshuffleFraction > 1)
+            InvalidArgument("'chunkAffinityReshuffleFraction' must be between 0 and 1.");
+    }
+
     ChunkRandomizer::ChunkRandomizer(DataDeserializerPtr deserializer, 
         size_t randomizationRange,
         bool sampleBasedRandomizationWindow) :
@@ -28,7 +37,7 @@ namespace CNTK {
     }
 
     // Randomizes chunks and calculates randomization windows.
-    void ChunkRandomizer::Randomize(size_t seed)
+    void ChunkRandomizer::Randomize(size_t seed, size_t numberOfShards, double reshuffleFraction)
     {
         std::vector<ChunkIdType> randomizedChunkIndices;
         randomizedChunkIndices.reserve(m_originalChunks.size());
@@ -38,7 +47,10 @@ namespace CNTK {
         }
 
         m_rng.seed((unsigned long)seed);
-        Microsoft::MSR::CNTK::RandomShuffleMT(randomizedChunkIndices, m_rng);
+        if (numberOfShards > 1)
+            RandomizeChunksInShards(randomizedChunkIndices, numberOfShards, reshuffleFraction, m_rng);
+        else
+            Microsoft::MSR::CNTK::RandomShuffleMT(randomizedChunkIndices, m_rng);
 
         // Place randomized chunks on the timeline
         m_randomizedChunks.clear();
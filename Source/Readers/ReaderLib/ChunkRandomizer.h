@@ -5,8 +5,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include "DataDeserializer.h"
+#include "Config.h"
+#include "RandomOrdering.h"
 #include <random>
 
 namespace CNTK {
@@ -38,6 +41,72 @@ namespace CNTK {
         return !(a == b);
     }
 
+    // Configuration of the chunk affinity, read from the reader config section:
+    //   chunkAffinity                  - keep the chunks of every worker the same across sweeps (default: false),
+    //                                    so that a worker only reads (and caches) its 1/N share of the corpus.
+    //                                    Chunks are only randomized within the shard of the worker.
+    //   chunkAffinityReshuffleFraction - fraction of the chunks that are exchanged between the workers in every sweep (default: 0).
+    struct ChunkAffinityConfig
+    {
+        ChunkAffinityConfig() : m_enabled(false), m_reshuffleFraction(0) {}
+        explicit ChunkAffinityConfig(const Microsoft::MSR::CNTK::ConfigParameters& config);
+
+        bool m_enabled;
+        double m_reshuffleFraction;
+    };
+
+    // Randomizes the order of the chunks so that the chunk at position p belongs to the shard p % numberOfShards.
+    // The i-th shard owns the i-th contiguous range of the input chunks, apart from the reshuffleFraction of the chunks
+    // that are exchanged between the shards, so with the same number of shards the shards only change by that fraction.
+    // The sizes of the shards differ by at most one chunk, the larger ones come first.
+    template <class TChunk>
+    void RandomizeChunksInShards(std::vector<TChunk>& chunks, size_t numberOfShards, double reshuffleFraction, std::mt19937_64& rng)
+    {
+        using Microsoft::MSR::CNTK::RandMT;
+        using Microsoft::MSR::CNTK::RandomShuffleMT;
+
+        size_t numberOfChunks = chunks.size();
+        auto shardBegin = [=](size_t shard)
+        {
+            return shard * (numberOfChunks / numberOfShards) + std::min(shard, numberOfChunks % numberOfShards);
+        };
+
+        // Exchanging a random subset of the chunks among their positions, the sizes of the shards stay the same.
+        size_t numberOfExchanged = std::min((size_t)(reshuffleFraction * numberOfChunks + 0.5), numberOfChunks);
+        if (numberOfExchanged > 1)
+        {
+            std::vector<size_t> positions(numberOfChunks);
+            for (size_t i = 0; i < numberOfChunks; ++i)
+                positions[i] = i;
+            for (size_t i = 0; i < numberOfExchanged; ++i)
+                std::swap(positions[i], positions[RandMT(i, numberOfChunks, rng)]);
+
+            std::vector<TChunk> exchanged;
+            exchanged.reserve(numberOfExchanged);
+            for (size_t i = 0; i < numberOfExchanged; ++i)
+                exchanged.push_back(chunks[positions[i]]);
+            RandomShuffleMT(exchanged, rng);
+            for (size_t i = 0; i < numberOfExchanged; ++i)
+                chunks[positions[i]] = exchanged[i];
+        }
+
+        for (size_t shard = 0; shard < numberOfShards; ++shard)
+            RandomShuffleMT(chunks, shardBegin(shard), shardBegin(shard + 1), rng);
+
+        // Interleaving the shards.
+        std::vector<TChunk> result;
+        result.reserve(numberOfChunks);
+        for (size_t i = 0; result.size() < numberOfChunks; ++i)
+        {
+            for (size_t shard = 0; shard < numberOfShards; ++shard)
+            {
+                if (shardBegin(shard) + i < shardBegin(shard + 1))
+                    result.push_back(chunks[shardBegin(shard) + i]);
+            }
+        }
+        chunks.swap(result);
+    }
+
     // Information about randomized chunk.
     struct RandomizedChunk
     {
@@ -76,8 +145,9 @@ namespace CNTK {
         // Gets randomized chunks.
         const std::vector<RandomizedChunk>& GetRandomizedChunks() const;
 
-        // Randomizes chunks based on the seed.
-        void Randomize(size_t seed);
+        // Randomizes chunks based on the seed. With more than one shard the chunks are randomized
+        // with RandomizeChunksInShards, so that the chunk at position p belongs to the shard p % numberOfShards.
+        void Randomize(size_t seed, size_t numberOfShards = 1, double reshuffleFraction = 0);
 
         // Randomize by spraying original sequences over a window of "m_randomizationRange" samples.
         void RandomizeUsingWindowInSamples();
@@ -29,6 +29,19 @@ public:
         return m_streams;
     }
 
+    // Hints that the given chunks are going to be requested soon, in this order.
+    // Deserializers can start reading them in the background, by default the hint is ignored.
+    virtual void HintUpcomingChunks(const std::vector<ChunkIdType>& /*chunkIds*/)
+    {
+    }
+
+    // Returns true if GetChunk can be called from several threads at the same time,
+    // which is required to load chunks on more than one 'chunkPrefetchThreads'.
+    virtual bool SupportsConcurrentGetChunk() const
+    {
+        return false;
+    }
+
 protected:
     virtual bool GetSequenceInfoByKey(const SequenceKey&, SequenceInfo&)
     {
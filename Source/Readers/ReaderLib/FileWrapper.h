@@ -11,10 +11,14 @@
 
 #include <stdio.h>
 #ifdef __WINDOWS__
+#include <io.h>
+#include <windows.h>
 #endif
 #ifdef __unix__
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 #include <errno.h>
 #include <memory>
@@ -142,6 +146,80 @@ public:
             RuntimeError("Error reading file '%ls': %s.", m_filename.c_str(), strerror(errno));
     }
 
+    // Value returned by ReadAt() on an I/O error.
+    static const size_t ReadAtError = (size_t)-1;
+
+    // Reads size bytes at the given offset without using or moving the position of the stream, so that
+    // several threads can read different parts of the file at the same time. Data buffered by the stream is not seen,
+    // so positional reads should not be mixed with writes.
+    // On Windows the read moves the file pointer of the underlying handle, sequential reads have to seek first.
+    // Returns the number of bytes read, which is less than size if the end of the file is reached,
+    // or ReadAtError with errno set if the read fails.
+    inline size_t ReadAt(void* ptr, size_t size, int64_t offset)
+    {
+        char* buffer = (char*)ptr;
+        size_t total = 0;
+        while (total < size)
+        {
+#ifdef __WINDOWS__
+            HANDLE handle = (HANDLE)_get_osfhandle(_fileno(m_file.get()));
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = (DWORD)offset;
+            overlapped.OffsetHigh = (DWORD)(offset >> 32);
+            size_t remaining = size - total;
+            DWORD toRead = remaining < (1u << 30) ? (DWORD)remaining : (DWORD)(1u << 30);
+            DWORD read = 0;
+            if (!ReadFile(handle, buffer, toRead, &read, &overlapped))
+            {
+                if (GetLastError() == ERROR_HANDLE_EOF)
+                    break;
+                errno = EIO;
+                return ReadAtError;
+            }
+#else
+            ssize_t read = pread(fileno(m_file.get()), buffer, size - total, offset);
+            if (read < 0 && errno == EINTR)
+                continue;
+            if (read < 0)
+                return ReadAtError;
+#endif
+            if (read == 0)
+                break;
+            buffer += read;
+            offset += read;
+            total += read;
+        }
+        return total;
+    }
+
+    inline bool TryReadAt(void* ptr, size_t size, int64_t offset)
+    {
+        return ReadAt(ptr, size, offset) == size;
+    }
+
+    inline void ReadAtOrDie(void* ptr, size_t size, int64_t offset)
+    {
+        size_t read = ReadAt(ptr, size, offset);
+        if (read == ReadAtError)
+            RuntimeError("Error reading %zu bytes at position %lld in file '%ls': %s.",
+                size, (long long)offset, m_filename.c_str(), strerror(errno));
+        if (read != size)
+            RuntimeError("Unexpected end of file reading %zu bytes at position %lld in file '%ls': only %zu bytes available.",
+                size, (long long)offset, m_filename.c_str(), read);
+    }
+
+    // Hints that the given range of the file is going to be read soon, so that the operating system
+    // can start reading it in the background. Does nothing where no such hint is supported.
+    inline void AdviseWillNeed(int64_t offset, size_t size)
+    {
+#if defined(__unix__) && defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(fileno(m_file.get()), offset, size, POSIX_FADV_WILLNEED);
+#else
+        UNUSED(offset);
+        UNUSED(size);
+#endif
+    }
+
     inline bool TryWrite(const void* ptr, size_t size, size_t count)
     {
         size_t rc;
@@ -166,7 +244,7 @@ public:
 
     // This method should not be used if T has bare pointers as its members.
     template <typename T, typename std::enable_if<std::is_pod<T>::value>::type* = nullptr>
-    inline bool WriteOrDie(const T& value)
+    inline void WriteOrDie(const T& value)
     {
         WriteOrDie(&value, sizeof(value), 1);
     }
@@ -12,10 +12,9 @@
 namespace CNTK {
 
 using Microsoft::MSR::CNTK::MBLayout;
-using Microsoft::MSR::CNTK::MBLayoutPtr;
 using namespace std;
 
-MBLayoutPtr FramePacker::CreateMBLayout(const StreamBatch& batch)
+void FramePacker::InitMBLayout(const StreamBatch& batch, MBLayout& layout)
 {
     auto violation = find_if(batch.begin(), batch.end(), [](const SequenceDataPtr& s){ return s->m_numberOfSamples > 1; });
     if (violation != batch.end())
@@ -23,10 +22,8 @@ MBLayoutPtr FramePacker::CreateMBLayout(const StreamBatch& batch)
         RuntimeError("Detected a non-frame sequence of size %d in frame mode.", 
             (int)(*violation)->m_numberOfSamples);
     }
-    // Creating the minibatch layout.
-    MBLayoutPtr pMBLayout = make_shared<MBLayout>();
-    pMBLayout->InitAsFrameMode(batch.size());
-    return pMBLayout;
+    // Initializing the minibatch layout.
+    layout.InitAsFrameMode(batch.size());
 }
 
 }
@@ -23,7 +23,7 @@ public:
     {}
 
 protected:
-    MBLayoutPtr CreateMBLayout(const StreamBatch& batch) override;
+    void InitMBLayout(const StreamBatch& batch, MBLayout& layout) override;
 };
 
 typedef std::shared_ptr<FramePacker> FramePackerPtr;
@@ -23,7 +23,9 @@ IndexBuilder::IndexBuilder(const FileWrapper& input)
     m_isCacheEnabled(false),
     m_chunkSize(g_32MB),
     m_bufferSize(g_2MB),
-    m_primary(true)
+    m_primary(true),
+    m_numberOfThreads(0),
+    m_minScanRangeSize(g_32MB)
 {}
 
 shared_ptr<Index> IndexBuilder::Build()
@@ -218,28 +220,28 @@ static const char s_BOM[3] = { '\xEF', '\xBB', '\xBF' };
     if (m_fileSize == 0)
         RuntimeError("Input file is empty");
 
-    m_reader.reset(new BufferedFileReader(m_bufferSize, m_input));
+    BufferedFileReader reader(m_bufferSize, m_input);
 
     index->Reserve(m_fileSize);
 
     // skip BOM prefix at the very beginning of the input file if it's there.
     for (char ch : s_BOM) 
     {
-        if (!m_reader->Empty() && m_reader->Peek() == ch)
-            m_reader->Pop();
+        if (!reader.Empty() && reader.Peek() == ch)
+            reader.Pop();
         else break;
     }
 
     if (!isspace(m_streamPrefix))
     {
         // as long as the stream prefix is not a white space, it's safe to skip all leading spaces.
-        while (isspace(m_reader->Peek()) && m_reader->Pop()); 
+        while (isspace(reader.Peek()) && reader.Pop()); 
     }
 
-    if (m_reader->Empty())
+    if (reader.Empty())
         RuntimeError("Input file is empty");
 
-    if (m_skipSequenceIds || (!m_reader->Empty() && m_reader->Peek() == m_streamPrefix))
+    if (m_skipSequenceIds || (!reader.Empty() && reader.Peek() == m_streamPrefix))
     {
         // Skip sequence id parsing, treat lines as individual sequences
         // In this case the sequences do not have ids, they are assigned corresponding line numbers
@@ -248,105 +250,180 @@ static const char s_BOM[3] = { '\xEF', '\xBB', '\xBF' };
             RuntimeError("Corpus expects non-numeric sequence keys present but the input file does not have them."
                 "Please use the configuration to enable numeric keys instead.");
 
-        PopulateFromLines(index);
+        PopulateFromLines(index, reader.GetFileOffset(), reader.CurrentLineNumber());
     }
     else 
     {
-        PopulateImpl(index);
+        PopulateImpl(index, reader.GetFileOffset());
     }
 }
 
-void TextInputIndexBuilder::PopulateFromLines(shared_ptr<Index>& index)
+// Lines of a range of the input file, sequences are paired with their line numbers relative to the range start.
+struct LinesRange
 {
-    IndexedSequence sequence;
-    while (!m_reader->Empty())
+    size_t m_numberOfLines = 0;
+    vector<pair<size_t, IndexedSequence>> m_sequences;
+};
+
+void TextInputIndexBuilder::PopulateFromLines(shared_ptr<Index>& index, size_t startOffset, size_t startLineNumber)
+{
+    auto scanRange = [this](size_t rangeEnd, BufferedFileReader& reader, LinesRange& range)
     {
-        size_t offset = m_reader->GetFileOffset();
+        IndexedSequence sequence;
+        while (!reader.Empty())
+        {
+            size_t offset = reader.GetFileOffset();
+            if (offset >= rangeEnd)
+                break;
 
-        if (!FindMainStream())
-        { 
-            // skip lines that do not contain main stream name.
-            m_reader->TryMoveToNextLine();
-            continue;
-        }
+            size_t lineNumber = range.m_numberOfLines++;
 
-        sequence.SetNumberOfSamples(1).SetOffset(offset).SetKey(m_reader->CurrentLineNumber());
+            if (!FindMainStream(reader))
+            { 
+                // skip lines that do not contain main stream name.
+                reader.TryMoveToNextLine();
+                continue;
+            }
 
-        if (m_reader->TryMoveToNextLine())
-        {
-            sequence.SetSize(m_reader->GetFileOffset() - offset);
-            index->AddSequence(sequence);
-        } 
-        else  if (offset < m_fileSize)
-        {
-            // There's a number of characters, not terminated by a newline,
-            // add a sequence to the index, parser will have to deal with it.
-            sequence.SetSize(m_fileSize - offset);
-            index->AddSequence(sequence);
-            break;
+            sequence.SetNumberOfSamples(1).SetOffset(offset);
+
+            if (reader.TryMoveToNextLine())
+            {
+                sequence.SetSize(reader.GetFileOffset() - offset);
+                range.m_sequences.push_back(make_pair(lineNumber, sequence));
+            } 
+            else  if (offset < m_fileSize)
+            {
+                // There's a number of characters, not terminated by a newline,
+                // add a sequence to the index, parser will have to deal with it.
+                sequence.SetSize(m_fileSize - offset);
+                range.m_sequences.push_back(make_pair(lineNumber, sequence));
+                break;
+            }
         }
-    }
+    };
+
+    size_t lineNumber = startLineNumber;
+    auto mergeRange = [&index, &lineNumber](LinesRange& range)
+    {
+        for (auto& sequence : range.m_sequences)
+            index->AddSequence(sequence.second.SetKey(lineNumber + sequence.first));
+        lineNumber += range.m_numberOfLines;
+    };
+
+    ScanInParallel<LinesRange>(startOffset, m_fileSize, scanRange, mergeRange);
 }
 
-void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
+// A run of consecutive lines with the same sequence id.
+struct SequenceRun
 {
-    IndexedSequence sequence;
-    uint32_t numberOfSamples = 0;
-    bool foundMainStream = false;
-    size_t prevId = 0, nextId = 0, prevOffset = m_reader->GetFileOffset();
+    size_t m_id;
+    size_t m_offset;
+    uint32_t m_numberOfSamples;
+    bool m_foundMainStream;
+};
+
+// Sequence runs of a range of the input file. Lines at the beginning of the range that do not have an id
+// are leading lines, they continue the last run of the preceding range.
+struct SequenceRunsRange
+{
+    bool m_hasLeadingLines = false;
+    uint32_t m_leadingNumberOfSamples = 0;
+    bool m_leadingFoundMainStream = false;
+    vector<SequenceRun> m_runs;
+};
 
-    // Go ahead and read the id of the very first sequence.
-    if (!TryGetSequenceId(prevId))
+void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index, size_t startOffset)
+{
+    auto scanRange = [this](size_t rangeEnd, BufferedFileReader& reader, SequenceRunsRange& range)
     {
-        RuntimeError("Expected a sequence id at the offset %zu, none was found.", prevOffset);
-    }
+        size_t id = 0;
+        while (!reader.Empty())
+        {
+            auto offset = reader.GetFileOffset(); // a new line starts at this offset;
+            if (offset >= rangeEnd)
+                break;
+
+            if (TryGetSequenceId(reader, id) && (range.m_runs.empty() || id != range.m_runs.back().m_id))
+            {
+                // found a new sequence, which starts at the [offset] bytes into the file.
+                range.m_runs.push_back(SequenceRun{ id, offset, 0, false });
+            }
 
-    while (!m_reader->Empty())
+            bool foundMainStream = FindMainStream(reader);
+            if (range.m_runs.empty())
+            {
+                range.m_hasLeadingLines = true;
+                range.m_leadingNumberOfSamples += foundMainStream ? 1 : 0;
+                range.m_leadingFoundMainStream |= foundMainStream;
+            }
+            else if (foundMainStream)
+            {
+                range.m_runs.back().m_numberOfSamples++;
+                range.m_runs.back().m_foundMainStream = true;
+            }
+
+            reader.TryMoveToNextLine(); // ignore whatever is left on this line.
+        }
+    };
+
+    // The last run seen so far, it is added to the index once the offset of the next one is known.
+    bool hasPrevious = false;
+    SequenceRun previous{};
+    IndexedSequence sequence;
+    auto addPrevious = [&](size_t endOffset)
+    {
+        sequence.SetKey(previous.m_id)
+            .SetNumberOfSamples(previous.m_numberOfSamples)
+            .SetOffset(previous.m_offset)
+            .SetSize(endOffset - previous.m_offset);
+
+        if (previous.m_foundMainStream)
+            index->AddSequence(sequence);
+    };
+
+    auto mergeRange = [&](SequenceRunsRange& range)
     {
-        if (FindMainStream())
+        size_t first = 0;
+        if (hasPrevious)
         {
-            numberOfSamples++;
-            foundMainStream = true;
-        }
+            previous.m_numberOfSamples += range.m_leadingNumberOfSamples;
+            previous.m_foundMainStream |= range.m_leadingFoundMainStream;
 
-        m_reader->TryMoveToNextLine(); // ignore whatever is left on this line.
+            // The sequence of the preceding range continues into this one.
+            if (!range.m_runs.empty() && range.m_runs.front().m_id == previous.m_id)
+            {
+                previous.m_numberOfSamples += range.m_runs.front().m_numberOfSamples;
+                previous.m_foundMainStream |= range.m_runs.front().m_foundMainStream;
+                first = 1;
+            }
+        }
+        else if (range.m_hasLeadingLines)
+        {
+            RuntimeError("Expected a sequence id at the offset %zu, none was found.", startOffset);
+        }
 
-        auto offset = m_reader->GetFileOffset(); // a new line starts at this offset;
-        
-        if (TryGetSequenceId(nextId) && nextId != prevId)
+        for (size_t i = first; i < range.m_runs.size(); ++i)
         {
-            // found a new sequence, which starts at the [offset] bytes into the file
-            // adding the previous one to the index.
-            sequence.SetKey(prevId)
-                .SetNumberOfSamples(numberOfSamples)
-                .SetOffset(prevOffset)
-                .SetSize(offset - prevOffset);
-
-            prevId = nextId;
-            prevOffset = offset;
-            numberOfSamples = 0;
-            
-            if (foundMainStream)
-                index->AddSequence(sequence);
-            foundMainStream = false;
+            if (hasPrevious)
+                addPrevious(range.m_runs[i].m_offset);
+            previous = range.m_runs[i];
+            hasPrevious = true;
         }
-    }
+    };
 
-    if (prevOffset < m_fileSize)
-    {
-        sequence.SetKey(prevId)
-            .SetNumberOfSamples(numberOfSamples)
-            .SetOffset(prevOffset)
-            .SetSize(m_fileSize - prevOffset);
-        
-        if (foundMainStream)
-            index->AddSequence(sequence);
-    }
+    ScanInParallel<SequenceRunsRange>(startOffset, m_fileSize, scanRange, mergeRange);
+
+    if (!hasPrevious)
+        RuntimeError("Expected a sequence id at the offset %zu, none was found.", startOffset);
+
+    if (previous.m_offset < m_fileSize)
+        addPrevious(m_fileSize);
 }
 
-inline bool TextInputIndexBuilder::FindMainStream()
+inline bool TextInputIndexBuilder::FindMainStream(BufferedFileReader& reader)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
     
     if (m_mainStream.empty())
@@ -357,7 +434,7 @@ inline bool TextInputIndexBuilder::FindMainStream()
     int i = 0;
     do  
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (i == length)
         {
             // we found a match, check to see if it's followed by either a space, 
@@ -375,30 +452,30 @@ inline bool TextInputIndexBuilder::FindMainStream()
 
         if (c == g_eol)
             break;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // we hit either the EOL or the EOF, see if we have a match
     return (i == length);
 }
 
-inline bool TextInputIndexBuilder::TryGetSequenceId(size_t& id)
+inline bool TextInputIndexBuilder::TryGetSequenceId(BufferedFileReader& reader, size_t& id)
 {
     if (m_corpus && !m_corpus->IsNumericSequenceKeys())
-        return TryGetSymbolicSequenceId(id, m_corpus->KeyToId);
+        return TryGetSymbolicSequenceId(reader, id, m_corpus->KeyToId);
 
-    return TryGetNumericSequenceId(id);
+    return TryGetNumericSequenceId(reader, id);
 }
 
-inline bool TextInputIndexBuilder::TryGetNumericSequenceId(size_t& id)
+inline bool TextInputIndexBuilder::TryGetNumericSequenceId(BufferedFileReader& reader, size_t& id)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
 
     bool found = false;
     id = 0;
     do
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (!isdigit(c))
             // Stop as soon as there's a non-digit character
             return found;
@@ -409,16 +486,16 @@ inline bool TextInputIndexBuilder::TryGetNumericSequenceId(size_t& id)
             RuntimeError("Overflow while reading a numeric sequence id (%zu-bit value).", sizeof(id));
         
         found = true;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // reached EOF without hitting the pipe character,
     // ignore it for now, parser will have to deal with it.
     return false;
 }
 
-inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function<size_t(const string&)> keyToId)
+inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(BufferedFileReader& reader, size_t& id, function<size_t(const string&)> keyToId)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
 
     bool found = false;
@@ -427,7 +504,7 @@ inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function
     key.reserve(256);
     do
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (isspace(c))
         {
             if (found)
@@ -437,7 +514,7 @@ inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function
 
         key += c;
         found = true;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // reached EOF without hitting the pipe character,
     // ignore it for now, parser will have to deal with it.
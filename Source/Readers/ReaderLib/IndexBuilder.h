@@ -7,11 +7,15 @@
 
 #include <stdint.h>
 #include <vector>
+#include <functional>
+#include <future>
+#include <thread>
 #include <boost/noncopyable.hpp>
 #include "Index.h"
 #include "CorpusDescriptor.h"
 #include "BufferedFileReader.h"
 #include "FileWrapper.h"
+#include "ReaderConstants.h"
 
 namespace CNTK {
 
@@ -76,6 +80,12 @@ public:
 
     IndexBuilder& SetCachingEnabled(bool value) { m_isCacheEnabled = value; return *this; }
 
+    // Number of threads scanning the input in parallel, 0 (default) means one per hardware thread.
+    IndexBuilder& SetNumberOfThreads(size_t value) { m_numberOfThreads = value; return *this; }
+
+    // Minimum number of bytes of the input scanned by a single thread.
+    IndexBuilder& SetMinScanRangeSize(size_t value) { m_minScanRangeSize = value; return *this; }
+
     virtual std::wstring GetCacheFilename() = 0;
 
 protected:
@@ -85,6 +95,18 @@ protected:
 
     virtual void Populate(std::shared_ptr<Index>&) = 0;
 
+    // Splits the input bytes [begin, end) into ranges that are scanned in parallel, each by its own reader
+    // positioned at the first line that starts inside of the range (the first range is scanned from begin).
+    // A range owns whatever starts inside of it, scanRange(rangeEnd, reader, result) may read past the end
+    // of the range to finish the last item it owns. The results are passed to mergeRange in the order of the ranges,
+    // in batches of m_numberOfThreads ranges, so that only the results of one batch are kept in memory at a time.
+    // Inputs with symbolic keys that are not hashed are scanned sequentially: their ids are assigned
+    // in the order the keys are seen.
+    template <class RangeResult>
+    void ScanInParallel(size_t begin, size_t end,
+                        const std::function<void(size_t, BufferedFileReader&, RangeResult&)>& scanRange,
+                        const std::function<void(RangeResult&)>& mergeRange);
+
     FileWrapper m_input;
     CorpusDescriptorPtr m_corpus;
     size_t m_bufferSize;
@@ -93,6 +115,9 @@ protected:
 
     bool m_isCacheEnabled;
 
+    size_t m_numberOfThreads;
+    size_t m_minScanRangeSize;
+
     static const uint64_t s_version = 1;
 
 private:
@@ -103,6 +128,60 @@ private:
     static const uint64_t s_magic = 0x636e746b5f696478; // 'cntk_idx'
 };
 
+template <class RangeResult>
+void IndexBuilder::ScanInParallel(size_t begin, size_t end,
+                                  const std::function<void(size_t, BufferedFileReader&, RangeResult&)>& scanRange,
+                                  const std::function<void(RangeResult&)>& mergeRange)
+{
+    size_t numberOfThreads = m_numberOfThreads ? m_numberOfThreads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    size_t totalSize = end > begin ? end - begin : 0;
+    // Ranges are at most 256MB, which bounds the memory taken by the results of a batch.
+    size_t rangeSize = std::max<size_t>(std::min<size_t>((totalSize + numberOfThreads - 1) / numberOfThreads, g_256MB),
+                                        std::max<size_t>(m_minScanRangeSize, 1));
+    size_t numberOfRanges = std::max<size_t>((totalSize + rangeSize - 1) / rangeSize, 1);
+
+    if (numberOfRanges == 1 || (m_corpus && !m_corpus->IsNumericSequenceKeys() && !m_corpus->IsHashingEnabled()))
+    {
+        m_input.SeekOrDie(begin, SEEK_SET);
+        BufferedFileReader reader(m_bufferSize, m_input);
+        RangeResult result;
+        scanRange(end, reader, result);
+        mergeRange(result);
+        return;
+    }
+
+    for (size_t first = 0; first < numberOfRanges; first += numberOfThreads)
+    {
+        size_t last = std::min(numberOfRanges, first + numberOfThreads);
+        std::vector<RangeResult> results(last - first);
+        std::vector<std::future<void>> scans;
+        for (size_t range = first; range < last; ++range)
+        {
+            scans.push_back(std::async(std::launch::async, [&, range]()
+            {
+                size_t rangeBegin = begin + range * rangeSize;
+                size_t rangeEnd = std::min(end, rangeBegin + rangeSize);
+
+                // Each range is scanned through its own file handle.
+                auto file = FileWrapper::OpenOrDie(m_input.Filename(), L"rbS");
+                file.SeekOrDie(range == 0 ? rangeBegin : rangeBegin - 1, SEEK_SET);
+                BufferedFileReader reader(m_bufferSize, file);
+                if (range != 0)
+                    reader.TryMoveToNextLine();
+
+                scanRange(rangeEnd, reader, results[range - first]);
+            }));
+        }
+
+        // Futures of std::async wait for their tasks when destroyed, so all scans are done if one of them throws.
+        for (auto& scan : scans)
+            scan.get();
+
+        for (auto& result : results)
+            mergeRange(result);
+    }
+}
+
 // A helper class that does a pass over the input file building up
 // an index consisting of sequence and chunk descriptors (which among 
 // others specify size and file offset of the respective structure).
@@ -142,31 +221,31 @@ private:
     std::string m_mainStream;
     std::unique_ptr<KMP> m_nfa; 
 
-    std::unique_ptr<BufferedFileReader> m_reader;
-
     // Returns true if main stream name if found on the current line.
-    bool FindMainStream();
+    bool FindMainStream(BufferedFileReader& reader);
 
     // Invokes either TryGetNumericSequenceId or TryGetSymbolicSequenceId depending
     // on the specified corpus settings.
-    bool TryGetSequenceId(size_t& id);
+    bool TryGetSequenceId(BufferedFileReader& reader, size_t& id);
 
     // Tries to get numeric sequence id.
     // Throws an exception if a non-numerical is read until the pipe character or 
     // EOF is reached without hitting the pipe character.
     // Returns false if no numerical characters are found preceding the pipe.
     // Otherwise, writes sequence id value to the provided reference, returns true.
-    bool TryGetNumericSequenceId(size_t& id);
+    bool TryGetNumericSequenceId(BufferedFileReader& reader, size_t& id);
 
     // Same as above but for symbolic ids.
     // It reads a symbolic key and converts it to numeric id using provided keyToId function.
-    bool TryGetSymbolicSequenceId(size_t& id, std::function<size_t(const std::string&)> keyToId);
+    bool TryGetSymbolicSequenceId(BufferedFileReader& reader, size_t& id, std::function<size_t(const std::string&)> keyToId);
 
-    void PopulateImpl(std::shared_ptr<Index>& index);
+    // Parses input sequence by sequence, a sequence is made of consecutive lines with the same id,
+    // lines without an id belong to the preceding sequence.
+    void PopulateImpl(std::shared_ptr<Index>& index, size_t startOffset);
 
     // Parses input line by line, treating each line as an individual sequence.
     // Ignores sequence id information, using the line number instead as the id.
-    void PopulateFromLines(std::shared_ptr<Index>& index);
+    void PopulateFromLines(std::shared_ptr<Index>& index, size_t startOffset, size_t startLineNumber);
 };
 
 }
@@ -24,12 +24,15 @@ LTTumblingWindowRandomizer::LTTumblingWindowRandomizer(
     size_t randomizationRange,
     size_t seedOffset,
     bool multithreadedGetNextSequences,
-    size_t maxNumberOfInvalidSequences)
+    size_t maxNumberOfInvalidSequences,
+    const ChunkAffinityConfig& affinityConfig)
     : Base(deserializer, { { s_chunkPositionProperty, 0}, { s_sweepIndexProperty, 0} }, multithreadedGetNextSequences, maxNumberOfInvalidSequences),
   m_randomizationRange(randomizationRange),
   m_seedOffset(seedOffset),
   m_chunkPosition(0),
   m_sampleBasedRandomizationWindow(sampleBasedRandomizationWindow),
+  m_affinityConfig(affinityConfig),
+  m_numberOfShards(1),
   m_sweepCount(0)
 {
     RandomizeChunks(m_sweepCount);
@@ -45,7 +48,16 @@ void LTTumblingWindowRandomizer::RandomizeChunks(size_t sweepCount) const
 {
     m_prefetchedChunkDescriptions = m_originalChunkDescriptions;
     m_rng.seed((unsigned long)sweepCount + m_seedOffset);
-    RandomShuffleMT(m_prefetchedChunkDescriptions, m_rng);
+    m_numberOfShards = NumberOfShards();
+    if (m_numberOfShards > 1)
+        RandomizeChunksInShards(m_prefetchedChunkDescriptions, m_numberOfShards, m_affinityConfig.m_reshuffleFraction, m_rng);
+    else
+        RandomShuffleMT(m_prefetchedChunkDescriptions, m_rng);
+}
+
+size_t LTTumblingWindowRandomizer::NumberOfShards() const
+{
+    return m_affinityConfig.m_enabled ? std::max(Config().m_numberOfWorkers, (size_t)1) : 1;
 }
 
 void LTTumblingWindowRandomizer::Prefetch() const
@@ -53,6 +65,13 @@ void LTTumblingWindowRandomizer::Prefetch() const
     size_t position = m_chunkPosition;
     size_t sweepIndex = m_sweepCount;
 
+    // The number of workers is only known after the start of the epoch and can change later on.
+    // The chunks are randomized for the new number only at a sweep boundary, otherwise the chunk
+    // positions that have already been read in the current sweep would refer to different chunks.
+    // Mid-sweep the new number takes effect when the next sweep is randomized below.
+    if (position == 0 && m_numberOfShards != NumberOfShards())
+        RandomizeChunks(sweepIndex);
+
     // Prefetch does not change any state that cannot be recalculated,
     // only prefetches data.
     int64_t range = m_randomizationRange;
@@ -115,8 +134,10 @@ void LTTumblingWindowRandomizer::RefillSequenceWindow(SequenceWindow& window)
         if (IsEndOfSweep(s))
             m_sweepCount++;
 
+    // Chunks of other workers are only placeholders, which must not hide the chunk with id 0.
     for (const auto& c : m_prefetchedChunks)
-        window.m_dataChunks.insert(std::make_pair(std::get<0>(c).m_id, std::get<1>(c)));
+        if (std::get<1>(c))
+            window.m_dataChunks.insert(std::make_pair(std::get<0>(c).m_id, std::get<1>(c)));
 
     m_chunkPosition = (ChunkIdType)(m_chunkPosition + m_prefetchedChunks.size()) % m_originalChunkDescriptions.size();
 }
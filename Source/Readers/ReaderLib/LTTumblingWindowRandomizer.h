@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "LocalTimelineRandomizerBase.h"
+#include "ChunkRandomizer.h"
 
 namespace CNTK {
 
@@ -23,7 +24,8 @@ public:
         size_t randomizationRange,
         size_t seedOffset = 0,
         bool multithreadedGetNextSequences = false,
-        size_t maxNumberOfInvalidSequences= 0); // per worker
+        size_t maxNumberOfInvalidSequences= 0, // per worker
+        const ChunkAffinityConfig& affinityConfig = ChunkAffinityConfig());
 
     std::map<std::wstring, size_t> GetInnerState() override;
     void SetInnerState(const std::map<std::wstring, size_t>& state) override;
@@ -34,9 +36,13 @@ private:
     void RandomizeWindow(size_t sweepCount, size_t chunkPositionOfWindow, size_t sequencePositionInWindow) const;
     void RandomizeChunks(size_t sweepCount) const;
 
+    // Number of shards the chunks are randomized in, the number of workers with the chunk affinity, 1 otherwise.
+    size_t NumberOfShards() const;
+
     const size_t m_randomizationRange;
     const size_t m_seedOffset;
     const bool m_sampleBasedRandomizationWindow;
+    const ChunkAffinityConfig m_affinityConfig;
 
     // Current chunk position that the randomizer works with.
     ChunkIdType m_chunkPosition;
@@ -46,6 +52,7 @@ private:
 
     // Do not store in the checkpoint, can be recalculated based on other members.
     mutable std::mt19937_64 m_rng;
+    mutable size_t m_numberOfShards;
     mutable std::vector<ChunkInfo> m_prefetchedChunkDescriptions;
     mutable std::vector<SequenceInfo> m_prefetchedSequences;
     mutable std::vector<std::tuple<ChunkInfo, ChunkPtr>> m_prefetchedChunks;
@@ -0,0 +1,149 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdint.h>
+#include <string.h>
+#include "LZCompression.h"
+#include "DataDeserializer.h"
+
+namespace CNTK {
+
+// The compressed data is a series of sequences, each consisting of
+//  - a token byte: the number of literals in the upper 4 bits, the match length - c_minMatch in the lower 4 bits,
+//    with 15 meaning that the length continues in the following bytes (255 - add and continue, less - add and stop),
+//  - the literals,
+//  - the 2 byte little endian offset of the match backwards from the current output position.
+// The last sequence has only literals.
+static const size_t c_minMatch = 4;
+static const size_t c_maxOffset = 65535;
+static const size_t c_hashBits = 14;
+
+static inline void WriteLength(std::vector<char>& result, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        result.push_back((char)255);
+    result.push_back((char)length);
+}
+
+static inline void WriteSequence(std::vector<char>& result, const char* literals, size_t numLiterals, size_t offset, size_t matchLength)
+{
+    bool isLast = matchLength == 0;
+    size_t matchCode = isLast ? 0 : matchLength - c_minMatch;
+    result.push_back((char)(((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15)));
+    if (numLiterals >= 15)
+        WriteLength(result, numLiterals - 15);
+    result.insert(result.end(), literals, literals + numLiterals);
+    if (isLast)
+        return;
+
+    result.push_back((char)(offset & 0xFF));
+    result.push_back((char)(offset >> 8));
+    if (matchCode >= 15)
+        WriteLength(result, matchCode - 15);
+}
+
+static inline uint32_t Hash(const char* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return (value * 2654435761u) >> (32 - c_hashBits);
+}
+
+void LZCompress(const char* src, size_t size, std::vector<char>& result)
+{
+    result.clear();
+    result.reserve(size + size / 255 + 16);
+
+    // Position + 1 of the last occurrence of each hashed 4 byte sequence, 0 if none.
+    std::vector<size_t> lastPosition(1 << c_hashBits, 0);
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + c_minMatch <= size)
+    {
+        size_t& last = lastPosition[Hash(src + position)];
+        size_t candidate = last;
+        last = position + 1;
+        if (candidate == 0 || position + 1 - candidate > c_maxOffset || memcmp(src + candidate - 1, src + position, c_minMatch) != 0)
+        {
+            position++;
+            continue;
+        }
+
+        candidate--;
+        size_t matchLength = c_minMatch;
+        while (position + matchLength < size && src[candidate + matchLength] == src[position + matchLength])
+            matchLength++;
+
+        WriteSequence(result, src + anchor, position - anchor, position - candidate, matchLength);
+        position += matchLength;
+        anchor = position;
+    }
+
+    WriteSequence(result, src + anchor, size - anchor, 0, 0);
+}
+
+static inline size_t ReadLength(const unsigned char*& in, const unsigned char* end, size_t length)
+{
+    if (length < 15)
+        return length;
+
+    unsigned char b;
+    do
+    {
+        if (in == end)
+            RuntimeError("LZDecompress: Unexpected end of the compressed data.");
+        b = *in++;
+        length += b;
+    } while (b == 255);
+    return length;
+}
+
+void LZDecompress(const char* src, size_t size, char* dst, size_t dstSize)
+{
+    const unsigned char* in = (const unsigned char*)src;
+    const unsigned char* end = in + size;
+    char* out = dst;
+    char* outEnd = dst + dstSize;
+    for (;;)
+    {
+        if (in == end)
+            RuntimeError("LZDecompress: Unexpected end of the compressed data.");
+        unsigned char token = *in++;
+
+        size_t numLiterals = ReadLength(in, end, token >> 4);
+        if ((size_t)(end - in) < numLiterals || (size_t)(outEnd - out) < numLiterals)
+            RuntimeError("LZDecompress: Literals exceed the compressed or decompressed data.");
+        memcpy(out, in, numLiterals);
+        in += numLiterals;
+        out += numLiterals;
+
+        if (in == end)
+            break;
+
+        if (end - in < 2)
+            RuntimeError("LZDecompress: Unexpected end of the compressed data.");
+        size_t offset = in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        size_t matchLength = ReadLength(in, end, token & 0xF) + c_minMatch;
+        if (offset == 0 || offset > (size_t)(out - dst) || (size_t)(outEnd - out) < matchLength)
+            RuntimeError("LZDecompress: Invalid match in the compressed data.");
+
+        // Matches may overlap with their own output, so they are copied byte by byte unless they are far enough back.
+        const char* match = out - offset;
+        if (offset >= matchLength)
+            memcpy(out, match, matchLength);
+        else
+            for (size_t i = 0; i < matchLength; i++)
+                out[i] = match[i];
+        out += matchLength;
+    }
+
+    if (out != outEnd)
+        RuntimeError("LZDecompress: The decompressed data has %zu bytes instead of %zu.", (size_t)(out - dst), dstSize);
+}
+
+}
@@ -0,0 +1,24 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Byte-oriented LZ77 compression in the spirit of LZ4: it trades compression ratio for speed,
+// so that decompressing a cached chunk is much cheaper than deserializing it again.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+namespace CNTK {
+
+// Compresses size bytes of src into result (which is overwritten).
+// Incompressible input grows by at most size / 255 + 16 bytes.
+void LZCompress(const char* src, size_t size, std::vector<char>& result);
+
+// Decompresses size bytes of src into dst, which has to be exactly as large as the uncompressed data.
+// Throws if the compressed data is corrupted.
+void LZDecompress(const char* src, size_t size, char* dst, size_t dstSize);
+
+}
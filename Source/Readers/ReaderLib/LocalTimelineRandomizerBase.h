@@ -28,6 +28,10 @@ public:
 
     void SetConfiguration(const ReaderConfiguration& config) override
     {
+        // The outstanding prefetch reads the configuration, let it finish with the old one.
+        if (m_prefetch.valid())
+            m_prefetch.wait();
+
         *((ReaderConfiguration*)&m_config) = config;
     }
 
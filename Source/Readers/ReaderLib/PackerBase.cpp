@@ -11,12 +11,19 @@
 
 #include "PackerBase.h"
 #include "ReaderUtil.h"
+#include <algorithm>
 #include <set>
 
 namespace CNTK {
 
 using namespace std;
 
+void PackerBase::StreamBuffer::Reserve(size_t requiredSize)
+{
+    if (m_size < requiredSize)
+        Resize(std::max(requiredSize, m_size + m_size / 2));
+}
+
 // Resizing the buffer with the current memory provider.
 void PackerBase::StreamBuffer::Resize(size_t newSize)
 {
@@ -24,11 +24,21 @@ protected:
         MemoryProviderPtr m_memoryProvider;
         std::shared_ptr<char> m_data; // contiguous array of data.
 
+        // Layout and description of the minibatch that is packed into this buffer.
+        // They are reused together with the buffer, so that packing does not allocate memory once the buffer is large enough.
+        MBLayoutPtr m_layout;
+        StreamMinibatchPtr m_minibatch;
+
         StreamBuffer(MemoryProviderPtr m_memoryProvider) :
-            m_size(0), m_memoryProvider(m_memoryProvider), m_data(nullptr)
+            m_size(0), m_memoryProvider(m_memoryProvider), m_data(nullptr),
+            m_layout(std::make_shared<MBLayout>()), m_minibatch(std::make_shared<StreamMinibatch>())
         {
         }
 
+        // Makes sure the buffer has at least the required size, growing it geometrically to avoid
+        // reallocations when the size of minibatches changes. The content is not preserved.
+        void Reserve(size_t requiredSize);
+
         void Resize(size_t newSize);
     };
 
@@ -78,7 +88,7 @@ protected:
 
     // Indicates how many internal buffers with pinned memory are supported.
     // If N - then N sequential calls to PackMinibatch are valid, and N+1 call will overwrite 
-    // the memory of the first call.
+    // the memory of the first call. This also holds for the layouts of the minibatch.
     size_t m_numberOfBuffers;
 
     // Buffers for allocated data. Outer vector size == m_numberOfBuffers, 
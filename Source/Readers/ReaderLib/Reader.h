@@ -62,6 +62,8 @@ struct StreamMinibatch
                           // The size is (the number of rows * number of columns in the layout) * by the element size of the stream (float/double/etc.).
     MBLayoutPtr m_layout; // Layout of the data
     NDShape m_sampleShape;
+    std::shared_ptr<char> m_dataOwner; // Buffer that m_data points into, lets the consumer use the data in place instead of copying it.
+                                       // The packer overwrites the buffer when it is reused, see the number of buffers of the packer.
 };
 typedef std::shared_ptr<StreamMinibatch> StreamMinibatchPtr;
 
@@ -19,6 +19,8 @@ namespace CNTK {
 
     static size_t const g_64MB = 64 * g_1MB;
 
+    static size_t const g_256MB = 256 * g_1MB;
+
     static size_t const g_4GB = 0x100000000L;
 
     const static char g_eol = '\n';
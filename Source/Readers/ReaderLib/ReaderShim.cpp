@@ -44,6 +44,7 @@ ReaderShim<ElemType>::ReaderShim() :
     m_deviceId(CPUDEVICE),
     m_dataTransferers(2, DataTransfererPtr()),
     m_currentDataTransferIndex(0),
+    m_zeroCopyMinibatches(false),
     m_endOfEpoch(false),
     m_endOfSweep(false),
     m_reader(nullptr),
@@ -76,6 +77,13 @@ void ReaderShim<ElemType>::Init(const ConfigParameters& config)
     // otherwise deferring - synchronous execution during .get() call
     m_launchType = prefetch ? launch::async : launch::deferred;
 
+    // If set, dense minibatches on the CPU are handed to the network in the buffers of the packer instead of being copied.
+    // The packer cycles through its buffers, so a minibatch that the caller keeps in its own inputs stays intact only
+    // until the next minibatch has been fetched: the buffer is repacked by the prefetch that follows (with prefetch=false
+    // during the next-but-one GetMinibatch). Callers that keep a minibatch longer must copy it.
+    // The option is not exposed by the V2 MinibatchSource, whose Values are only valid until the next fetch anyway.
+    m_zeroCopyMinibatches = config(L"zeroCopyMinibatches", false);
+
     m_numParallelSequences = numberOfuttsPerMinibatchForAllEpochs[0];
 
     if (!m_reader)
@@ -359,14 +367,22 @@ bool ReaderShim<ElemType>::GetMinibatch(StreamMinibatchInputs& matrices)
 }
 
 template <class ElemType>
-void FillMatrixFromStream(StorageFormat type, Matrix<ElemType>* matrix, size_t numRows, const StreamMinibatchPtr& stream, DataTransferer* transferer)
+void FillMatrixFromStream(StorageFormat type, Matrix<ElemType>* matrix, size_t numRows, const StreamMinibatchPtr& stream, DataTransferer* transferer, bool borrowData)
 {
     size_t numCols = stream->m_layout->GetNumCols();
 
     if (type == StorageFormat::Dense)
     {
         auto data = reinterpret_cast<const ElemType*>(stream->m_data);
-        matrix->SetValue(numRows, numCols, matrix->GetDeviceId(), const_cast<ElemType*>(data), matrixFlagNormal, transferer);
+        if (borrowData && stream->m_dataOwner && matrix->GetDeviceId() == CPUDEVICE && matrix->GetMatrixType() == MatrixType::DENSE)
+        {
+            // The matrix uses the buffer of the packer, which is kept alive by the matrix. The packer reuses the buffer
+            // only after the next minibatch has been swapped into the network, so this does not interfere with the computation,
+            // but a minibatch held beyond that point sees the data of a later one (see zeroCopyMinibatches in Init).
+            matrix->BorrowBuffer(const_cast<ElemType*>(data), numRows, numCols, stream->m_dataOwner);
+        }
+        else
+            matrix->SetValue(numRows, numCols, matrix->GetDeviceId(), const_cast<ElemType*>(data), matrixFlagNormal, transferer);
     }
     else if (type == StorageFormat::SparseCSC)
     {
@@ -388,10 +404,7 @@ typename ReaderShim<ElemType>::PrefetchResult ReaderShim<ElemType>::PrefetchMini
 {
     PROFILE_SCOPE(profilerEvtPrefetchMinibatch);
 
-    // Resetting layouts.
-    for (auto& mx : m_prefetchBuffers)
-        mx.second.m_mbLayout = std::make_shared<MBLayout>();
-
+    // The layouts are taken from the minibatch below, they are not used if there is no data.
     Minibatch minibatch = m_reader->ReadMinibatch();
 
     // If there is no data we can simply return.
@@ -422,7 +435,7 @@ typename ReaderShim<ElemType>::PrefetchResult ReaderShim<ElemType>::PrefetchMini
         }
 
         size_t sampleSize = m_streams[streamId].m_sampleLayout.TotalSize();
-        FillMatrixFromStream(m_streams[streamId].m_storageFormat, mx.second.m_matrix.get(), sampleSize, stream, m_dataTransferers[currentDataTransferIndex].get());
+        FillMatrixFromStream(m_streams[streamId].m_storageFormat, mx.second.m_matrix.get(), sampleSize, stream, m_dataTransferers[currentDataTransferIndex].get(), m_zeroCopyMinibatches);
     }
 
     // Let's record that we started the copy, so that the main thread can wait afterwards.
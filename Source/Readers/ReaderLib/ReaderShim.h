@@ -135,6 +135,10 @@ private:
 
     size_t m_numParallelSequences;
 
+    // Whether the dense CPU matrices borrow the buffers of the packer instead of copying the minibatch.
+    // A borrowed minibatch is only valid until the next minibatch has been fetched.
+    bool m_zeroCopyMinibatches;
+
     std::unordered_map<std::wstring, size_t> m_nameToStreamId;
 
     std::vector<StreamInformation> m_streams;
@@ -16,9 +16,9 @@ namespace CNTK {
 
 using namespace Microsoft::MSR::CNTK;
 
-std::pair<vector<MBLayout::SequenceInfo>, size_t> SequencePacker::CreateSequenceInfos(const StreamBatch& batch)
+size_t SequencePacker::CreateSequenceInfos(const StreamBatch& batch)
 {
-    vector<MBLayout::SequenceInfo> infos;
+    m_sequenceInfos.clear();
     size_t maxNumSteps = 0;
     for (size_t index = 0; index < batch.size(); ++index)
     {
@@ -28,31 +28,25 @@ std::pair<vector<MBLayout::SequenceInfo>, size_t> SequencePacker::CreateSequence
         info.tBegin = 0;
         info.s = index;
         info.tEnd = batch[index]->m_numberOfSamples;
-        infos.push_back(info);
+        m_sequenceInfos.push_back(info);
 
         maxNumSteps = std::max(maxNumSteps, info.tEnd);
     }
-    return std::make_pair(infos, maxNumSteps);
+    return maxNumSteps;
 }
 
-MBLayoutPtr SequencePacker::CreateMBLayout(const StreamBatch& batch)
+void SequencePacker::InitMBLayout(const StreamBatch& batch, MBLayout& layout)
 {
-    auto infos = CreateSequenceInfos(batch);
-    MBLayoutPtr pMBLayout = make_shared<MBLayout>();
-    vector<pair<size_t, size_t>> placement;
-    vector<size_t> rowAllocations;
-    pMBLayout->InitAsPackedSequences(infos.first, placement, rowAllocations);
-    return pMBLayout;
+    CreateSequenceInfos(batch);
+    layout.InitAsPackedSequences(m_sequenceInfos, m_placement, m_rowAllocations);
 }
 
-MBLayoutPtr SequencePacker::CreateBinaryMBLayout(const StreamBatch& batch)
+void SequencePacker::InitBinaryMBLayout(const StreamBatch& batch, MBLayout& layout)
 {
-    auto infos = CreateSequenceInfos(batch);
-    auto layout = make_shared<MBLayout>();
-    layout->Init(infos.first.size(), infos.second, false);
-    for (const auto& info : infos.first)
-        layout->AddSequence(info, false);
-    return layout;
+    auto maxNumSteps = CreateSequenceInfos(batch);
+    layout.Init(m_sequenceInfos.size(), maxNumSteps, false);
+    for (const auto& info : m_sequenceInfos)
+        layout.AddSequence(info, false);
 }
 
 Minibatch SequencePacker::ReadMinibatch()
@@ -65,6 +59,7 @@ Minibatch SequencePacker::ReadMinibatch()
         return minibatch;
 
     auto& currentBuffer = m_streamBuffers[m_currentBufferIndex];
+    minibatch.m_data.reserve(batch.size());
 
     assert(m_outputStreamDescriptions.size() == batch.size());
     for (int streamIndex = 0; streamIndex < batch.size(); ++streamIndex)
@@ -91,8 +86,11 @@ Minibatch SequencePacker::ReadMinibatch()
 
         auto& buffer = currentBuffer[streamIndex];
 
-        auto streamMinibatch = std::make_shared<StreamMinibatch>();
+        // The minibatch description is reused with the buffer, the previous
+        // minibatch packed into this buffer is not valid anymore.
+        const auto& streamMinibatch = buffer.m_minibatch;
         streamMinibatch->m_data = buffer.m_data.get();
+        streamMinibatch->m_dataOwner = buffer.m_data;
         streamMinibatch->m_layout = pMBLayout;
         streamMinibatch->m_sampleShape = m_outputStreamDescriptions[streamIndex].m_sampleLayout;
 
@@ -160,12 +158,10 @@ MBLayoutPtr SequencePacker::PackDenseStream(const StreamBatch& batch, size_t str
     const auto& stream = m_inputStreamDescriptions[streamIndex];
     auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
     size_t sampleSize = GetSampleSize(m_outputStreamDescriptions[streamIndex]);
-    auto pMBLayout = CreateMBLayout(batch);
+    const auto& pMBLayout = buffer.m_layout;
+    InitMBLayout(batch, *pMBLayout);
     size_t requiredSize = pMBLayout->GetNumCols() * sampleSize;
-    if (buffer.m_size < requiredSize)
-    {
-        buffer.Resize(requiredSize);
-    }
+    buffer.Reserve(requiredSize);
 
     auto elementSize = DataTypeSize(stream.m_elementType);
 
@@ -249,7 +245,9 @@ MBLayoutPtr SequencePacker::PackSparseStream(const StreamBatch& batch, size_t st
     assert(stream.m_storageFormat == StorageFormat::SparseCSC);
     auto elementSize = DataTypeSize(stream.m_elementType);
     auto indexSize = sizeof(IndexType);
-    auto pMBLayout = CreateMBLayout(batch);
+    auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
+    const auto& pMBLayout = buffer.m_layout;
+    InitMBLayout(batch, *pMBLayout);
 
     // Compute the required buffer size:
     // size of nnz type + nnz * (size of the element type) + nnz * (size of the row index type) + 
@@ -259,30 +257,30 @@ MBLayoutPtr SequencePacker::PackSparseStream(const StreamBatch& batch, size_t st
         nnzCount * (elementSize + indexSize) +
         indexSize * (pMBLayout->GetNumCols() + 1);
 
-    auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
-    if (buffer.m_size < requiredSize)
-    {
-        buffer.Resize(requiredSize);
-    }
+    buffer.Reserve(requiredSize);
 
     auto* destination = buffer.m_data.get();
     // insert the nnzCount as the first element in the buffer.
     memcpy(destination, &nnzCount, sizeof(nnzCount));
 
-    // create two pointers to the memory blocks inside the buffer,
-    // one for data portion and another -- for indices.
+    // create three pointers to the memory blocks inside the buffer,
+    // one for data portion, one for indices and another -- for column offsets,
+    // so that the CSC matrix is built in place.
     auto* dataDst = destination + sizeof(nnzCount);
     auto* indicesDst = dataDst + elementSize* nnzCount;
+    auto* columnIndicesDst = reinterpret_cast<IndexType*>(indicesDst + indexSize * nnzCount);
     // column index for the current sample (= number of nnz value packed so far).
     IndexType columnOffset = 0;
-    // a vector to store column index for each sample in the resulting (packed) matrix.
-    vector<IndexType> sparseColumnIndices;
+    // number of columns of the resulting (packed) matrix stored so far.
+    size_t numberOfColumns = 0;
     // a vector to keep track of the offsets into each input sequence,
     // there an offset is the number of nnz values packed so far. Current sample
     // values/indices start of the offset position in the sequence data/index array
-    vector<IndexType>  sequenceOffsets(batch.size(), 0); 
+    auto& sequenceOffsets = m_sequenceOffsets;
+    sequenceOffsets.assign(batch.size(), 0);
 
-    vector<MBLayout::SequenceInfo> sequenceInfos(pMBLayout->GetAllSequences());
+    auto& sequenceInfos = m_sequenceInfos;
+    sequenceInfos.assign(pMBLayout->GetAllSequences().begin(), pMBLayout->GetAllSequences().end());
 
     // sort the vector in ascending order of the parallel sequence index.
     sort(sequenceInfos.begin(), sequenceInfos.end(),
@@ -303,7 +301,7 @@ MBLayoutPtr SequencePacker::PackSparseStream(const StreamBatch& batch, size_t st
             }
 
             // store the offset of the current column )...
-            sparseColumnIndices.push_back(columnOffset);
+            columnIndicesDst[numberOfColumns++] = columnOffset;
 
             auto seqId = sequenceInfo.seqId;
             if (seqId == GAP_SEQUENCE_ID)
@@ -348,15 +346,13 @@ MBLayoutPtr SequencePacker::PackSparseStream(const StreamBatch& batch, size_t st
     assert(indicesDst == dataDst + nnzCount * indexSize);
     // after we packed all samples, the column offset must be equal to the total nnz count.
     assert(columnOffset == nnzCount);
-    sparseColumnIndices.push_back(columnOffset);
+    columnIndicesDst[numberOfColumns++] = columnOffset;
     // check that the number of column indices == N + 1 (where N is the number of
     // column in the packed matrix)
-    assert((pMBLayout->GetNumCols() + 1) == sparseColumnIndices.size());
+    assert((pMBLayout->GetNumCols() + 1) == numberOfColumns);
 
-    // verify that there's enough space in the buffer for the array of column indices.
-    assert(indicesDst + sparseColumnIndices.size()*indexSize <= destination + requiredSize);
-    // copy column indices into the buffer.
-    memcpy(indicesDst, sparseColumnIndices.data(), sparseColumnIndices.size() * indexSize);
+    // verify that the array of column indices fits into the buffer.
+    assert(reinterpret_cast<char*>(columnIndicesDst + numberOfColumns) <= destination + requiredSize);
 
     return pMBLayout;
 }
@@ -372,11 +368,10 @@ MBLayoutPtr SequencePacker::PackBinaryStream(const StreamBatch& batch, size_t st
     auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
     size_t sampleSize = GetSampleSize(m_inputStreamDescriptions[streamIndex]);
 
-    auto pMBLayout = CreateBinaryMBLayout(batch);
+    const auto& pMBLayout = buffer.m_layout;
+    InitBinaryMBLayout(batch, *pMBLayout);
     size_t requiredSize = pMBLayout->GetNumCols() * sampleSize;
-
-    if (buffer.m_size < requiredSize)
-        buffer.Resize(requiredSize);
+    buffer.Reserve(requiredSize);
 
     auto elementSize = DataTypeSize(stream.m_elementType);
     const auto& sequenceInfos = pMBLayout->GetAllSequences();
@@ -35,15 +35,16 @@ protected:
     virtual MBLayoutPtr PackSparseStream(const StreamBatch& batch, size_t streamIndex);
     virtual MBLayoutPtr PackBinaryStream(const StreamBatch& batch, size_t streamIndex);
 
-    // Given a number of sequences, creates an MB layout that is used to guide
-    // the actual packing.
-    virtual MBLayoutPtr CreateMBLayout(const StreamBatch& batch);
-    virtual MBLayoutPtr CreateBinaryMBLayout(const StreamBatch& batch);
+    // Given a number of sequences, initializes the MB layout that is used to guide
+    // the actual packing. The layout is reused with the buffer of the stream.
+    virtual void InitMBLayout(const StreamBatch& batch, MBLayout& layout);
+    virtual void InitBinaryMBLayout(const StreamBatch& batch, MBLayout& layout);
 
     // Helper function to check and refresh the sample shape of input samples.
     void RefreshSampleShape(const std::vector<SequenceDataPtr>& minibatch, StreamInformation& outputStream);
 
-    std::pair<vector<MBLayout::SequenceInfo>,size_t> CreateSequenceInfos(const StreamBatch& batch);
+    // Fills m_sequenceInfos with a sequence per row, returns the maximum number of steps.
+    size_t CreateSequenceInfos(const StreamBatch& batch);
 
     // A flag indicating whether to use local timeline for data.
     bool m_useLocalTimeline;
@@ -54,6 +55,12 @@ protected:
     // A minibatch size for this worker in global samples.
     size_t m_globalMinibatchSizeInSamples;
 
+    // Temporary buffers kept between minibatches to avoid allocations while packing.
+    std::vector<MBLayout::SequenceInfo> m_sequenceInfos;
+    std::vector<std::pair<size_t, size_t>> m_placement;
+    std::vector<size_t> m_rowAllocations;
+    std::vector<IndexType> m_sequenceOffsets;
+
 };
 
 typedef std::shared_ptr<SequencePacker> SequencePackerPtr;
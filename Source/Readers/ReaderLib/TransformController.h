@@ -26,13 +26,14 @@ struct Transformation
 class TransformController : public SequenceEnumerator
 {
 public:
-    TransformController(const std::vector<Transformation>& transformations, SequenceEnumeratorPtr sequenceProvider, bool multiThreadedDeserialization=true)
+    TransformController(const std::vector<Transformation>& transformations, SequenceEnumeratorPtr sequenceProvider, bool multiThreadedDeserialization=true,
+                        bool fuseTransformations=false)
         : m_sequenceProvider(sequenceProvider), m_multiThreadedDeserialization(multiThreadedDeserialization)
     {
         // Applying transformations to stream descriptions,
         // i.e. a transformation can change a stream from dense to sparse.
         std::vector<StreamInformation> transformedStreams = m_sequenceProvider->GetStreamDescriptions();
-        for (auto& t : transformations)
+        for (auto& t : fuseTransformations ? Fuse(transformations) : transformations)
         {
             size_t streamId = GetStreamId(t.m_streamName, transformedStreams);
             m_transformations.push_back(std::make_pair(t, streamId));
@@ -113,6 +114,33 @@ public:
     }
 
 private:
+    // Replaces consecutive transformations of a stream with fused ones where the transformers support it.
+    static std::vector<Transformation> Fuse(const std::vector<Transformation>& transformations)
+    {
+        std::vector<Transformation> result;
+        for (size_t i = 0; i < transformations.size();)
+        {
+            std::vector<TransformerPtr> transformers;
+            for (size_t j = i; j < transformations.size() && transformations[j].m_streamName == transformations[i].m_streamName; ++j)
+                transformers.push_back(transformations[j].m_transformer);
+
+            TransformerPtr fused;
+            size_t numberOfFused = transformations[i].m_transformer->Fuse(transformers, fused);
+            if (numberOfFused > 0)
+            {
+                assert(fused != nullptr && numberOfFused <= transformers.size());
+                result.push_back(Transformation{ fused, transformations[i].m_streamName });
+                i += numberOfFused;
+            }
+            else
+            {
+                result.push_back(transformations[i]);
+                i++;
+            }
+        }
+        return result;
+    }
+
     size_t GetStreamId(const std::wstring streamName, const std::vector<StreamInformation>& streams) const
     {
         for (const auto& s : streams)
@@ -27,6 +27,15 @@ public:
     // This method should describe how input sequences is transformed to the output sequence.
     virtual SequenceDataPtr Transform(SequenceDataPtr inputSequence, int indexInBatch=0) = 0;
 
+    // Tries to fuse the transformer with the ones applied after it to the same stream, so that they are applied
+    // in a single step. 'transformers' starts with this transformer. Returns the number of transformers
+    // the fused transformer replaces, or 0 if the transformer cannot be fused.
+    // Called before the stream transformation.
+    virtual size_t Fuse(const std::vector<std::shared_ptr<Transformer>>& /*transformers*/, std::shared_ptr<Transformer>& /*fused*/)
+    {
+        return 0;
+    }
+
     virtual ~Transformer()
     {
     }
@@ -234,8 +234,10 @@ Minibatch TruncatedBPTTPacker::ReadMinibatch()
             result.m_endOfSweep |= PackSlot(streamIndex, slotIndex, sequenceId, mbSeqIdToCorpusSeqId);
         }
 
-        StreamMinibatchPtr m = make_shared<StreamMinibatch>();
-        m->m_data = m_streamBuffers[m_currentBufferIndex][streamIndex].m_data.get();
+        auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
+        const auto& m = buffer.m_minibatch;
+        m->m_data = buffer.m_data.get();
+        m->m_dataOwner = buffer.m_data;
         m->m_layout = m_currentLayouts[streamIndex];
         m->m_sampleShape = m_outputStreamDescriptions[streamIndex].m_sampleLayout;
         result.m_data.push_back(m);
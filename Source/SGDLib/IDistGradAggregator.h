@@ -19,6 +19,19 @@ public:
     // Returns a boolean indicating if any samples were processed
     virtual bool AggregateGradients(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool resetState) = 0;
 
+    // Bucketed aggregation overlapped with the backprop. BeginBucketedAggregation() is called before the backprop with the
+    // gradients and the order in which the backprop completes them, and returns false if the aggregator does not support it.
+    // Otherwise GradientReady() is called (possibly from several threads) as soon as a gradient is final, and
+    // AggregateGradients() with the same gradients completes the aggregation.
+    virtual bool BeginBucketedAggregation(const std::vector<Matrix<ElemType>*>& /*gradients*/, const std::vector<size_t>& /*completionOrder*/)
+    {
+        return false;
+    }
+
+    virtual void GradientReady(size_t /*gradientIndex*/)
+    {
+    }
+
     size_t NumProc()
     {
         return m_mpi->NumNodesInUse();
@@ -35,6 +48,27 @@ public:
     }
 
 protected:
+    // Aligns the blocks of a sparse block column gradient (e.g. of an embedding with sparse input) to the union of the
+    // columns that have a block on any worker. Afterwards the block values of all workers line up and are summed with a
+    // dense all-reduce of the first 'returned number' elements of Data(), the gradient stays sparse.
+    size_t AlignSparseBlockColumnGradient(Matrix<ElemType>& gradient)
+    {
+        std::vector<GPUSPARSE_INDEX_TYPE> col2BlockId(gradient.GetNumCols());
+        gradient.GetSparseBlockColumnCol2BlockId(col2BlockId.data());
+        m_mpi->AllReduce(col2BlockId.data(), col2BlockId.size(), MPI_MAX);
+
+        // the blocks are numbered in column order, such that the block ids are the same on all workers
+        size_t numBlocks = 0;
+        for (auto& blockId : col2BlockId)
+        {
+            if (blockId != SparseIndex_NotAssigned)
+                blockId = (GPUSPARSE_INDEX_TYPE)numBlocks++;
+        }
+
+        gradient.AdjustSparseBlockColumn(col2BlockId.data(), numBlocks, /*useBlockId2Col=*/ false);
+        return gradient.GetNumRows() * numBlocks;
+    }
+
     MPIWrapperPtr m_mpi;
 };
 
@@ -43,5 +77,6 @@ protected:
 protected:                                        \
     using IDistGradAggregator<ElemType>::m_mpi;   \
     using IDistGradAggregator<ElemType>::NumProc; \
-    using IDistGradAggregator<ElemType>::MyRank
+    using IDistGradAggregator<ElemType>::MyRank;  \
+    using IDistGradAggregator<ElemType>::AlignSparseBlockColumnGradient
 } } }
@@ -41,12 +41,25 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         size_t m_localSamplesProcessedSinceLastReport; 
         double m_accumulatedSecondsOnSyncPointInOneEpoch;
         size_t m_syncPointHitCounterInOneEpoch;
+        size_t m_numPipelinedBlocksInOneEpoch;
+        double m_accumulatedSecondsInFlightInOneEpoch;
+        double m_accumulatedSecondsWaitedInOneEpoch;
         Timer  m_Timer; 
 
+        // reporting condition: 
+        // 1. if m_reportFrequency == 0 , no reporting 
+        // 2. if m_reportFrequence >0   , report MA perf Stats every m_reportFrequency model aggregation are performed 
+        //                                and the first 5 perf stats within each epoch is always reported 
+        bool ShouldReport(size_t numSyncPerformed) const
+        {
+            return m_reportFrequency > 0 && (numSyncPerformed % m_reportFrequency == 0 || numSyncPerformed <= 5);
+        }
+
     public:
         MASGDPerfStats(size_t myRank, size_t numWorkers):
             m_numWorkers(numWorkers), m_myRank(myRank), m_numSyncPerformedInCurrentEpoch(0), m_reportFrequency(1), 
-            m_totalSamplesProcessedSinceLastReport(0), m_localSamplesProcessedSinceLastReport(0)
+            m_totalSamplesProcessedSinceLastReport(0), m_localSamplesProcessedSinceLastReport(0),
+            m_numPipelinedBlocksInOneEpoch(0), m_accumulatedSecondsInFlightInOneEpoch(0), m_accumulatedSecondsWaitedInOneEpoch(0)
         {
             m_Timer.Start();
         }
@@ -62,23 +75,28 @@ namespace Microsoft { namespace MSR { namespace CNTK {
             m_numSyncPerformedInCurrentEpoch = 0; 
             m_accumulatedSecondsOnSyncPointInOneEpoch = 0;
             m_syncPointHitCounterInOneEpoch = 0;
+            m_numPipelinedBlocksInOneEpoch = 0;
+            m_accumulatedSecondsInFlightInOneEpoch = 0;
+            m_accumulatedSecondsWaitedInOneEpoch = 0;
         }
         void OnEpochEnd()
         {
             m_Timer.Stop();
+            if (m_numPipelinedBlocksInOneEpoch > 0)
+            {
+                fprintf(stderr, "\t\t(model aggregation stats) %d blocks aggregated in the background this epoch: %.2f seconds in flight, %.2f seconds waited for, %.2f seconds hidden behind local training\n",
+                        (int)m_numPipelinedBlocksInOneEpoch,
+                        m_accumulatedSecondsInFlightInOneEpoch,
+                        m_accumulatedSecondsWaitedInOneEpoch,
+                        m_accumulatedSecondsInFlightInOneEpoch - m_accumulatedSecondsWaitedInOneEpoch);
+            }
         }
         void OnMAPerformed(size_t localSamplesProcessedSinceLastSync, size_t totalSamplesProcessedSinceLastSync, float secondsOnCommunication)
         {
             m_numSyncPerformedInCurrentEpoch++;
             m_totalSamplesProcessedSinceLastReport += totalSamplesProcessedSinceLastSync; 
             m_localSamplesProcessedSinceLastReport += localSamplesProcessedSinceLastSync; 
-            if ( m_reportFrequency > 0 && 
-                ( m_numSyncPerformedInCurrentEpoch % m_reportFrequency == 0 || m_numSyncPerformedInCurrentEpoch <=5 )
-               )
-                // reporting condition: 
-                // 1. if m_reportFrequency == 0 , no reporting 
-                // 2. if m_reportFrequence >0   , report MA perf Stats every m_reportFrequency model aggregation are performed 
-                //                                and the first 5 perf stats within each epoch is always reported 
+            if (ShouldReport(m_numSyncPerformedInCurrentEpoch))
             {
                 ReportMAPerfStats(m_totalSamplesProcessedSinceLastReport, 
                                   m_localSamplesProcessedSinceLastReport, 
@@ -88,6 +106,24 @@ namespace Microsoft { namespace MSR { namespace CNTK {
                 m_localSamplesProcessedSinceLastReport = 0; 
             }
         }
+        // A pipelined model aggregation has finished the aggregation of a block: it was in flight for secondsInFlight,
+        // while the local training of the next block was running, and the worker waited secondsWaited for its completion.
+        // Called before OnMAPerformed of the sync that applies the block.
+        void OnPipelinedBlockAggregated(double secondsInFlight, double secondsWaited)
+        {
+            m_numPipelinedBlocksInOneEpoch++;
+            m_accumulatedSecondsInFlightInOneEpoch += secondsInFlight;
+            m_accumulatedSecondsWaitedInOneEpoch += secondsWaited;
+            if (ShouldReport(m_numSyncPerformedInCurrentEpoch + 1))
+            {
+                fprintf(stderr, "\t\t(model aggregation stats) %d-th pipelined block: %.2f seconds in flight, waited %.2f seconds for it (%.1f%% hidden); accumulated wait = %.2f seconds\n",
+                        (int)m_numPipelinedBlocksInOneEpoch,
+                        secondsInFlight,
+                        secondsWaited,
+                        secondsInFlight > 0 ? 100.0 * (secondsInFlight - secondsWaited) / secondsInFlight : 0.0,
+                        m_accumulatedSecondsWaitedInOneEpoch);
+            }
+        }
         void OnArriveAtSyncPoint(double secondOnSyncPoint, bool printMessage)
         {
             if (printMessage)
@@ -1034,6 +1034,9 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
     }
 
     std::vector<Matrix<ElemType>*> learnParamsGradients;
+    // for the bucketed gradient aggregation: gradient index of every learnable node, and the order the backprop completes the gradients in
+    std::unordered_map<const ComputationNodeBase*, size_t> gradientIndexOfNode;
+    std::vector<size_t> gradientCompletionOrder;
     Profiler profiler(m_numMBsToCUDAProfile);
 
     // resetting this, so profiling is performed for one epoch only
@@ -1087,6 +1090,8 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
 
             if (m_bufferedAsyncGradientAggregation)
                 fprintf(stderr, ", BufferedAsyncGradientAggregation is ENABLED");
+            else if (m_gradientBucketSizeInBytes > 0)
+                fprintf(stderr, ", GradientBucketSize = %dKB", (int)(m_gradientBucketSizeInBytes / 1024));
         }
 
         if (useAsyncGradientAggregation)
@@ -1205,6 +1210,13 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         ComputationNetwork::BumpEvalTimeStamp(featureNodes);
         ComputationNetwork::BumpEvalTimeStamp(labelNodes);
 
+        // Aggregate the gradients in buckets as soon as the backprop has completed them, if the aggregator supports it.
+        // With sub-minibatches the gradients are only final after the last one has been accumulated.
+        // All workers have to take the same decision, including the ones that did not read any data: they join every
+        // bucket with zero gradients. Hence it must not depend on actualMBSize.
+        bool useBucketedAggregation = useGradientAggregation && !learnParamsGradients.empty() && numSubminibatchesNeeded <= 1 &&
+                                      m_distGradAgg->BeginBucketedAggregation(learnParamsGradients, gradientCompletionOrder);
+
         if (actualMBSize > 0)
         {
             assert(wasDataRead);
@@ -1233,6 +1245,13 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
             // We optionally break the minibatch into sub-minibatches.
             // This, when enabled, is used when a full minibatch does not fit into GPU RAM.
             size_t actualNumSubminibatches = numSubminibatchesNeeded <= 1 ? 1 : smbDispatcher.GetMinibatchIntoCache(*trainSetDataReader, *net, *inputMatrices, numSubminibatchesNeeded);
+
+            auto onNodeBackpropDone = [&](const ComputationNodeBasePtr& node)
+            {
+                auto gradientIndex = gradientIndexOfNode.find(node.get());
+                if (gradientIndex != gradientIndexOfNode.end())
+                    m_distGradAgg->GradientReady(gradientIndex->second);
+            };
             for (size_t ismb = 0; ismb < actualNumSubminibatches; ismb++)
             {
                 if (actualNumSubminibatches > 1)
@@ -1255,7 +1274,12 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                 // ===========================================================
 
                 if (learnRatePerSample > 0.01 * m_minLearnRate) // only compute gradient when learning rate is large enough
-                    net->Backprop(criterionNodes[0]);
+                {
+                    if (useBucketedAggregation)
+                        net->Backprop(criterionNodes[0], onNodeBackpropDone);
+                    else
+                        net->Backprop(criterionNodes[0]);
+                }
 
                 // house-keeping for sub-minibatching
                 if (actualNumSubminibatches > 1)
@@ -1320,9 +1344,28 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                             currParamsGradient->Resize(currParamsValues->GetNumRows(), currParamsValues->GetNumCols());
                         }
 
+                        gradientIndexOfNode[node.get()] = learnParamsGradients.size();
                         learnParamsGradients.push_back(currParamsGradient);
                     }
                 }
+
+                // the backprop completes the gradients in reverse evaluation order, the ones it does not reach come last
+                std::vector<bool> isInCompletionOrder(learnParamsGradients.size(), false);
+                const auto& evalOrder = net->GetEvalOrder(criterionNodes[0]);
+                for (auto nodeIter = evalOrder.rbegin(); nodeIter != evalOrder.rend(); nodeIter++)
+                {
+                    auto gradientIndex = gradientIndexOfNode.find(nodeIter->get());
+                    if (gradientIndex != gradientIndexOfNode.end() && !isInCompletionOrder[gradientIndex->second])
+                    {
+                        gradientCompletionOrder.push_back(gradientIndex->second);
+                        isInCompletionOrder[gradientIndex->second] = true;
+                    }
+                }
+                for (size_t i = 0; i < learnParamsGradients.size(); i++)
+                {
+                    if (!isInCompletionOrder[i])
+                        gradientCompletionOrder.push_back(i);
+                }
             }
 
             // hoist the criterion into CPU space for all-reduce
@@ -2292,7 +2335,7 @@ void SGD<ElemType>::InitDistGradAgg(int numEvalNodes, int numGradientBits, int d
         if (Globals::UseV2Aggregator()) // Currently used to check V2 against baselines.
             m_distGradAgg = std::make_shared<V2SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, ::CNTK::MPICommunicator(m_packThresholdSizeInBytes));
         else
-            m_distGradAgg = std::make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, m_packThresholdSizeInBytes);
+            m_distGradAgg = std::make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, m_packThresholdSizeInBytes, m_gradientBucketSizeInBytes);
     }
 
     m_gradHeader.reset(DistGradHeader::Create(numEvalNodes), [](DistGradHeader* ptr) { DistGradHeader::Destroy(ptr); });
@@ -2314,7 +2357,14 @@ void SGD<ElemType>::InitModelAggregationHandler(int traceLevel, DEVICEID_TYPE de
 #ifndef CNTK_PARALLEL_TRAINING_SUPPORT
         RuntimeError("Block Momentum is not supported in the main CNTK repo. You need to enable 1bit submodule.");
 #else
-        if (Globals::UseV2Aggregator())
+        if (m_pipelinedBlockMomentum)
+        {
+            m_pMASGDHelper = make_shared<PipelinedBlockMomentumSGD<ElemType>>(m_mpi, traceLevel, devID, 
+                                                                          m_useNesterovBlockMomentum, m_resetSGDMomentum, 
+                                                                          m_blockLearningRate, m_blockMomentumAsTimeConstant, 
+                                                                          m_modelAggregationBlockSize);
+        }
+        else if (Globals::UseV2Aggregator())
         {
             auto communicator = ::CNTK::MPICommunicator();
             m_pMASGDHelper = make_shared<V2BlockMomentumSGD<ElemType>>(
@@ -3129,9 +3179,11 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
     m_numGradientBits = vector<int>{8 * (int)sizeofElemType}; // means no quantization
     m_zeroThresholdFor1Bit = true;
     m_bufferedAsyncGradientAggregation = false;
+    m_gradientBucketSizeInBytes = 0;
     m_enableDistributedMBReading = false;
     m_parallelizationStartEpochNum = 0;
     m_modelAggregationBlockSize = 0; 
+    m_pipelinedBlockMomentum = false;
 
     if (configSGD.Exists(L"ParallelTrain"))
     {
@@ -3162,6 +3214,7 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
             m_numGradientBits = configDataParallelSGD(L"gradientBits", ConfigRecordType::Array(intargvector(vector<int>{defaultGradientBits})));
             m_zeroThresholdFor1Bit = configDataParallelSGD(L"useZeroThresholdFor1BitQuantization", true);
             m_bufferedAsyncGradientAggregation = configDataParallelSGD(L"useBufferedAsyncGradientAggregation", false);
+            m_gradientBucketSizeInBytes = configDataParallelSGD(L"gradientBucketSizeInKB", (size_t)0) * 1024;
             for (size_t i = 0; i < m_numGradientBits.size(); i++)
             {
                 if (m_numGradientBits[i] < 1 || m_numGradientBits[i] > defaultGradientBits)
@@ -3231,6 +3284,7 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
             m_resetSGDMomentum = configBMSGD(L"resetSGDMomentum", true);
             m_useNesterovBlockMomentum = configBMSGD(L"useNesterovMomentum", true);
             m_blockLearningRate = configBMSGD(L"blockLearningRate", 1.0); 
+            m_pipelinedBlockMomentum = configBMSGD(L"pipelinedAggregation", false);
 
             if (configBMSGD.Exists(L"blockMomentumPerSync") && configBMSGD.Exists(L"blockMomentumAsTimeConstant"))
             {
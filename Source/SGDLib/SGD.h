@@ -292,6 +292,8 @@ protected:
     // Data parallel SGD training parameters
     intargvector m_numGradientBits;
     bool m_bufferedAsyncGradientAggregation;
+    // Size of the buckets the gradients are aggregated in while the backprop is running, 0 to aggregate after the backprop
+    size_t m_gradientBucketSizeInBytes;
     bool m_zeroThresholdFor1Bit;
 
     // Parallel training related with MA / BM
@@ -300,6 +302,8 @@ protected:
     bool   m_useNesterovBlockMomentum;
     double m_blockLearningRate; 
     double m_blockMomentumAsTimeConstant;
+    // Aggregate the block gradients while the next block is trained and apply them one block late
+    bool   m_pipelinedBlockMomentum;
 
     bool m_needAveMultiplier;
     double m_L2RegWeight;
@@ -13,6 +13,7 @@
 #include "CUDAPageLockedMemAllocator.h"
 #include "NcclComm.h"
 #include <future>
+#include <mutex>
 #include "GPUDataTransferer.h"
 #include "TimerUtility.h"
 #include "MatrixQuantizerImpl.h"
@@ -25,9 +26,10 @@ class SimpleDistGradAggregator : public IDistGradAggregator<ElemType>
     UsingIDistGradAggregatorMembers;
 
 public:
-    SimpleDistGradAggregator(const MPIWrapperPtr& mpi, bool useAsyncAggregation, int deviceId, int syncStatsTrace, size_t packThresholdSizeInBytes = DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES)
+    SimpleDistGradAggregator(const MPIWrapperPtr& mpi, bool useAsyncAggregation, int deviceId, int syncStatsTrace, size_t packThresholdSizeInBytes = DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES,
+                             size_t bucketSizeInBytes = 0)
         : IDistGradAggregator<ElemType>(mpi), m_useAsyncAggregation(useAsyncAggregation), m_initialized(false), m_bufferedGradHeader(nullptr), m_syncStatsTrace(syncStatsTrace),
-        m_iterationCount(0), m_packThresholdSizeInBytes(packThresholdSizeInBytes)
+        m_iterationCount(0), m_packThresholdSizeInBytes(packThresholdSizeInBytes), m_bucketSizeInBytes(bucketSizeInBytes), m_bucketedAggregationInProgress(false), m_nextBucketToLaunch(0)
     {}
 
     ~SimpleDistGradAggregator()
@@ -50,10 +52,14 @@ public:
         if (m_nccl == nullptr)
             m_nccl.reset(new NcclComm(::CNTK::DeviceDescriptor::UseDefaultDevice().Id(), m_mpi));
 
-        ResetState(gradients, headerCPU->numEvalNode, resetState);
         bool showSyncPerfStats = (m_syncStatsTrace > 0) && ((m_iterationCount % m_syncStatsTrace) == 0);
         m_iterationCount++;
 
+        if (m_bucketedAggregationInProgress)
+            return EndBucketedAggregation(gradients, headerCPU, showSyncPerfStats);
+
+        ResetState(gradients, headerCPU->numEvalNode, resetState);
+
         if (m_useAsyncAggregation)
         {
             // If we are performing async gradient aggregation, let's wait for the pending gradient aggregation to finish
@@ -135,7 +141,241 @@ public:
         }
     }
 
+    // Gradients are grouped into buckets of up to m_bucketSizeInBytes in the order the backprop completes them,
+    // the all-reduce of a bucket is started as soon as all of its gradients are final.
+    // Not used with async aggregation, and on GPUs without NCCL or GPUDirect RDMA, where the gradients go through the CPU.
+    bool BeginBucketedAggregation(const std::vector<Matrix<ElemType>*>& gradients, const std::vector<size_t>& completionOrder) override
+    {
+        if (m_bucketSizeInBytes == 0 || m_useAsyncAggregation || m_mpi->NumNodesInUse() == 1 || gradients.empty())
+            return false;
+
+        // Sparse gradients are aggregated in AggregateGradients(), after the backprop.
+        for (auto gradient : gradients)
+        {
+            if (gradient->GetMatrixType() != DENSE)
+                return false;
+        }
+
+        if (m_nccl == nullptr)
+            m_nccl.reset(new NcclComm(::CNTK::DeviceDescriptor::UseDefaultDevice().Id(), m_mpi));
+
+        if (ShouldCopyDataToCPU(gradients[0]->GetDeviceId()))
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_bucketMutex);
+        if (m_buckets.empty())
+            CreateBuckets(gradients, completionOrder);
+
+        m_bucketGradients = gradients;
+        for (auto& bucket : m_buckets)
+            bucket.m_numPendingGradients = bucket.m_gradientIndices.size();
+        m_nextBucketToLaunch = 0;
+        m_bucketedAggregationInProgress = true;
+        return true;
+    }
+
+    void GradientReady(size_t gradientIndex) override
+    {
+        std::lock_guard<std::mutex> lock(m_bucketMutex);
+        if (!m_bucketedAggregationInProgress)
+            return;
+
+        auto& bucket = m_buckets[m_bucketOfGradient[gradientIndex]];
+        if (bucket.m_numPendingGradients == 0)
+            LogicError("GradientReady: gradient %d reported more than once.", (int)gradientIndex);
+
+        bucket.m_numPendingGradients--;
+        LaunchReadyBuckets(/*all =*/ false);
+    }
+
 private:
+    struct GradientBucket
+    {
+        std::vector<size_t> m_gradientIndices;
+        size_t m_numPendingGradients;
+        // Contiguous buffer the gradients are packed into, null if the bucket has a single gradient which is reduced in place.
+        std::unique_ptr<Matrix<ElemType>> m_buffer;
+        MPI_Request m_request;
+    };
+
+    void CreateBuckets(const std::vector<Matrix<ElemType>*>& gradients, const std::vector<size_t>& completionOrder)
+    {
+        if (completionOrder.size() != gradients.size())
+            LogicError("CreateBuckets: the completion order does not cover all gradients.");
+
+        m_bucketOfGradient.assign(gradients.size(), 0);
+        size_t bucketSizeInBytes = 0;
+        for (size_t i : completionOrder)
+        {
+            if (gradients[i]->GetMatrixType() != DENSE)
+                RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
+
+            size_t sizeInBytes = sizeof(ElemType) * gradients[i]->GetNumElements();
+            if (m_buckets.empty() || (bucketSizeInBytes > 0 && bucketSizeInBytes + sizeInBytes > m_bucketSizeInBytes))
+            {
+                m_buckets.push_back(GradientBucket());
+                bucketSizeInBytes = 0;
+            }
+
+            m_buckets.back().m_gradientIndices.push_back(i);
+            m_bucketOfGradient[i] = m_buckets.size() - 1;
+            bucketSizeInBytes += sizeInBytes;
+        }
+
+        for (auto& bucket : m_buckets)
+        {
+            if (bucket.m_gradientIndices.size() == 1)
+                continue;
+
+            size_t numElements = 0;
+            for (size_t i : bucket.m_gradientIndices)
+                numElements += gradients[i]->GetNumElements();
+            bucket.m_buffer.reset(new Matrix<ElemType>(1, numElements, gradients[0]->GetDeviceId()));
+        }
+    }
+
+    // Starts the all-reduce of the buckets in their order, all ranks have to start them in the same order.
+    // Called with m_bucketMutex held.
+    void LaunchReadyBuckets(bool all)
+    {
+        while (m_nextBucketToLaunch < m_buckets.size() && (all || m_buckets[m_nextBucketToLaunch].m_numPendingGradients == 0))
+            LaunchBucket(m_buckets[m_nextBucketToLaunch++]);
+    }
+
+    void LaunchBucket(GradientBucket& bucket)
+    {
+        Matrix<ElemType>* reductionBuffer = m_bucketGradients[bucket.m_gradientIndices[0]];
+        if (bucket.m_buffer)
+        {
+            size_t offset = 0;
+            for (size_t i : bucket.m_gradientIndices)
+            {
+                auto gradient = m_bucketGradients[i];
+                bucket.m_buffer->ColumnSlice(offset, gradient->GetNumElements()).AssignValuesOf(gradient->Reshaped(1, gradient->GetNumElements()));
+                offset += gradient->GetNumElements();
+            }
+            reductionBuffer = bucket.m_buffer.get();
+        }
+
+        if (m_nccl->IsSupported())
+        {
+            m_nccl->AllReduce(reductionBuffer->Data(), reductionBuffer->Data(), reductionBuffer->GetNumElements());
+            return;
+        }
+
+        // With GPUDirect RDMA MPI reads the GPU memory directly, so the gradients have to be computed by now.
+        int deviceId = reductionBuffer->GetDeviceId();
+        if (deviceId != CPUDEVICE)
+        {
+            std::unique_ptr<MatrixComputeStreamEvent> mainStreamSyncEvent(MatrixComputeStreamEvent::Create(deviceId));
+            mainStreamSyncEvent->SynchronizeEvent();
+        }
+
+        ElemType* data = reductionBuffer->Data();
+        m_mpi->Iallreduce(MPI_IN_PLACE, data, reductionBuffer->GetNumElements(), MPIWrapper::GetDataType(data), MPI_SUM, &bucket.m_request) || MpiFail("MPI_Iallreduce");
+    }
+
+    bool EndBucketedAggregation(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool showSyncPerfStats)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_bucketMutex);
+            if (gradients != m_bucketGradients)
+                LogicError("AggregateGradients: the gradients differ from the ones the bucketed aggregation was started with.");
+
+            // If the current node did not process any samples, its gradients should be zero'd.
+            // Nothing has been launched in that case, since there was no backprop.
+            if (headerCPU->numSamples == 0)
+            {
+                for (size_t b = m_nextBucketToLaunch; b < m_buckets.size(); ++b)
+                {
+                    for (size_t i : m_buckets[b].m_gradientIndices)
+                        gradients[i]->SetValue(0);
+                }
+            }
+
+            // The tail, and the gradients the backprop did not reach.
+            LaunchReadyBuckets(/*all =*/ true);
+            m_bucketedAggregationInProgress = false;
+        }
+
+        Timer aggregationTimer;
+        if (showSyncPerfStats)
+            aggregationTimer.Start();
+
+        AggregateHeader(headerCPU, (int)gradients.size());
+
+        if (m_nccl->IsSupported())
+        {
+            m_nccl->Sync();
+        }
+        else
+        {
+            for (auto& bucket : m_buckets)
+                m_mpi->Wait(&bucket.m_request, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+        }
+
+        for (auto& bucket : m_buckets)
+        {
+            if (!bucket.m_buffer)
+                continue;
+
+            size_t offset = 0;
+            for (size_t i : bucket.m_gradientIndices)
+            {
+                gradients[i]->AssignValuesOf(bucket.m_buffer->ColumnSlice(offset, gradients[i]->GetNumElements()).Reshaped(gradients[i]->GetNumRows(), gradients[i]->GetNumCols()));
+                offset += gradients[i]->GetNumElements();
+            }
+        }
+
+        if (showSyncPerfStats)
+        {
+            aggregationTimer.Stop();
+            fprintf(stderr, "Bucketed gradient aggregation wait time (%d buckets): %.6g\n", (int)m_buckets.size(), aggregationTimer.ElapsedSeconds());
+        }
+
+        return (headerCPU->numSamples != 0);
+    }
+
+    // Aggregates the headers on the main node and broadcasts the result.
+    void AggregateHeader(DistGradHeader* headerCPU, int tag)
+    {
+        if (m_mpi->IsMainNode() && m_recvHeaders.empty())
+        {
+            for (size_t i = 0; i < NumProc() - 1; ++i)
+                m_recvHeaders.push_back(DistGradHeader::Create(headerCPU->numEvalNode));
+        }
+
+        std::vector<MPI_Request> recvHeaderRequests(NumProc() - 1);
+        MPI_Request sendHeaderRequest;
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int source = (j >= MyRank()) ? (j + 1) : j;
+                m_mpi->Irecv(m_recvHeaders[j], m_recvHeaders[j]->Size(), MPI_CHAR, source, tag, &(recvHeaderRequests[j])) || MpiFail("MPI_Irecv");
+            }
+
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int idx = MPI_UNDEFINED;
+                m_mpi->Waitany(recvHeaderRequests.size(), recvHeaderRequests.data(), &idx, MPI_STATUS_IGNORE) || MpiFail("MPI_Waitany");
+                if (idx == MPI_UNDEFINED)
+                    break;
+
+                headerCPU->Aggregate(m_recvHeaders[idx], true);
+            }
+        }
+        else
+        {
+            m_mpi->Isend(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), tag, &sendHeaderRequest) || MpiFail("MPI_Isend");
+        }
+
+        m_mpi->Bcast(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank());
+
+        if (!m_mpi->IsMainNode())
+            m_mpi->Wait(&sendHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+    }
+
     std::shared_ptr<ElemType> AllocateIntermediateBuffer(int deviceID, size_t numElements)
     {
         assert(deviceID >= 0);
@@ -178,6 +418,20 @@ private:
             size_t packedGradientsSizeInElements = 0;
             for (size_t i = 0; i < gradients.size(); i++)
             {
+                // Sparse block column gradients stay sparse, they are aggregated separately, see AggregateSparseGradients().
+                // Other sparse formats are not supported.
+                if (gradients[i]->GetMatrixType() != DENSE)
+                {
+                    if (gradients[i]->GetFormat() != matrixFormatSparseBlockCol)
+                        RuntimeError("Gradient aggregation for sparse gradient matrices is currently only supported for the sparse block column format!");
+
+                    if (m_useAsyncAggregation)
+                        RuntimeError("Asynchronous aggregation of sparse gradient matrices is currently unsupported!");
+
+                    m_sparseGradientIndices.push_back(i);
+                    continue;
+                }
+
                 if (!m_useAsyncAggregation && sizeof(ElemType) * gradients[i]->GetNumElements() <= m_packThresholdSizeInBytes)
                 {
                     packedGradientsSizeInElements += gradients[i]->GetNumElements();
@@ -188,10 +442,6 @@ private:
                     m_gradientIndexToAggregate.push_back(i);
                 }
 
-                // Make sure none of the gradient matrixes are sparse - we currently do not support aggregation of sparse gradient matrices
-                if (gradients[i]->GetMatrixType() != DENSE)
-                    RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
-
                 if (m_useAsyncAggregation)
                     m_bufferedGradients[gradients[i]].reset(new Matrix<ElemType>(gradients[i]->GetNumRows(), gradients[i]->GetNumCols(), deviceId));
             }
@@ -211,7 +461,8 @@ private:
                 // Reuse "@param m_gradientIndexToAggregate" for following code, if no continous buffer allocated
                 for (size_t i = 0; i < gradients.size(); i++)
                 {
-                    m_gradientIndexToAggregate.push_back(i);
+                    if (gradients[i]->GetMatrixType() == DENSE)
+                        m_gradientIndexToAggregate.push_back(i);
                 }
             }
             else
@@ -419,6 +670,8 @@ private:
             }
         }
 
+        AggregateSparseGradients(gradients);
+
         // On the main node wait for the headers to arrive and aggregate
         if (m_mpi->IsMainNode())
         {
@@ -484,6 +737,48 @@ private:
         }
     }
 
+    // The blocks of the sparse block column gradients are aligned to the union of the columns touched on any worker,
+    // and only the values of these columns are all-reduced.
+    void AggregateSparseGradients(const std::vector<Matrix<ElemType>*>& gradients)
+    {
+        for (size_t i : m_sparseGradientIndices)
+        {
+            Matrix<ElemType>* gradient = gradients[i];
+            size_t numElements = AlignSparseBlockColumnGradient(*gradient);
+            if (numElements == 0)
+                continue;
+
+            ElemType* data = gradient->Data();
+            int deviceId = gradient->GetDeviceId();
+            if (m_nccl->IsSupported())
+            {
+                m_nccl->AllReduce(data, data, numElements);
+            }
+            else if (ShouldCopyDataToCPU(deviceId))
+            {
+                m_sparseGradientCPUBuffer.resize(numElements);
+#ifndef CPUONLY
+                cudaMemcpy(m_sparseGradientCPUBuffer.data(), data, numElements * sizeof(ElemType), cudaMemcpyDeviceToHost);
+#endif
+                m_mpi->AllReduce(m_sparseGradientCPUBuffer.data(), numElements);
+#ifndef CPUONLY
+                cudaMemcpy(data, m_sparseGradientCPUBuffer.data(), numElements * sizeof(ElemType), cudaMemcpyHostToDevice);
+#endif
+            }
+            else
+            {
+                // CPU, or GPUDirect RDMA which reads the GPU memory directly
+                if (deviceId != CPUDEVICE)
+                {
+                    std::unique_ptr<MatrixComputeStreamEvent> mainStreamSyncEvent(MatrixComputeStreamEvent::Create(deviceId));
+                    mainStreamSyncEvent->SynchronizeEvent();
+                }
+
+                m_mpi->AllReduce(data, numElements);
+            }
+        }
+    }
+
 private:
     std::unique_ptr<CUDAPageLockedMemAllocator> m_allocator;
 
@@ -509,6 +804,19 @@ private:
     std::vector<size_t> m_packedGradientsIndex;
     std::vector<size_t> m_gradientIndexToAggregate;
 
+    // Sparse block column gradients, aggregated without densifying them.
+    std::vector<size_t> m_sparseGradientIndices;
+    std::vector<ElemType> m_sparseGradientCPUBuffer;
+
+    // Bucketed aggregation overlapped with the backprop, disabled if the bucket size is 0 (tunable by "gradientBucketSizeInKB=[value]").
+    const size_t m_bucketSizeInBytes;
+    std::vector<GradientBucket> m_buckets;
+    std::vector<size_t> m_bucketOfGradient;
+    std::vector<Matrix<ElemType>*> m_bucketGradients;
+    bool m_bucketedAggregationInProgress;
+    size_t m_nextBucketToLaunch;
+    std::mutex m_bucketMutex;
+
     int m_syncStatsTrace;
 
     // Only used for controlling frequency of measuring/showing gradient aggregation perf stats
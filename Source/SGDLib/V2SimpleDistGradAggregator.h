@@ -128,9 +128,17 @@ private:
         int deviceId = gradients[0]->GetDeviceId();
         for (size_t i = 0; i < gradients.size(); i++)
         {
-            // Make sure none of the gradient matrixes are sparse - we currently do not support aggregation of sparse gradient matrices
+            // Sparse block column gradients stay sparse, other sparse formats are not supported
             if (gradients[i]->GetMatrixType() != DENSE)
-                RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
+            {
+                if (gradients[i]->GetFormat() != matrixFormatSparseBlockCol)
+                    RuntimeError("Gradient aggregation for sparse gradient matrices is currently only supported for the sparse block column format!");
+
+                if (m_useAsyncAggregation)
+                    RuntimeError("Asynchronous aggregation of sparse gradient matrices is currently unsupported!");
+
+                continue;
+            }
 
             if (m_useAsyncAggregation)
                 m_bufferedGradients[gradients[i]].reset(new Matrix<ElemType>(gradients[i]->GetNumRows(), gradients[i]->GetNumCols(), deviceId));
@@ -190,22 +198,43 @@ private:
         }
 
         // Prepare gradients.
+        // The blocks of sparse block column gradients are aligned to the union of the columns touched on any worker,
+        // after which only their block values are reduced like a dense gradient.
         std::vector<::CNTK::NDArrayViewPtr> valuesToAggregate;
-        if (m_nccl.IsSupported()) // nccl is only enabled if all ranks have net on GPUs.
-        {                         // we assume in this case all grad layers are on the GPU too.
-            m_nccl.AllReduce(gradients);
-        }
-        else
+        std::vector<Matrix<ElemType>*> denseGradients;
+        for (size_t i = 0; i < gradients.size(); ++i)
         {
-            for (size_t i = 0; i < gradients.size(); ++i)
+            size_t numElements = gradients[i]->GetNumElements();
+            if (gradients[i]->GetMatrixType() == DENSE)
+            {
+                denseGradients.push_back(gradients[i]);
+                if (m_nccl.IsSupported())
+                    continue;
+            }
+            else
             {
-                if (gradients[i]->Data() == nullptr) // Hack in case of eval.
+                numElements = AlignSparseBlockColumnGradient(*gradients[i]);
+                if (numElements == 0)
                     continue;
 
-                ::CNTK::NDShape shape{ gradients[i]->GetNumElements() };
-                auto data = ::CNTK::MakeSharedObject<::CNTK::NDArrayView>(::CNTK::AsDataType<ElemType>(), shape, gradients[i]->Data(), gradients[i]->GetNumElements() * sizeof(ElemType), ::CNTK::AsDeviceDescriptor(gradients[i]->GetDeviceId()));
-                valuesToAggregate.push_back(data);
+                if (m_nccl.IsSupported())
+                {
+                    m_nccl.AllReduce(gradients[i]->Data(), gradients[i]->Data(), numElements);
+                    continue;
+                }
             }
+
+            if (gradients[i]->Data() == nullptr) // Hack in case of eval.
+                continue;
+
+            ::CNTK::NDShape shape{ numElements };
+            auto data = ::CNTK::MakeSharedObject<::CNTK::NDArrayView>(::CNTK::AsDataType<ElemType>(), shape, gradients[i]->Data(), numElements * sizeof(ElemType), ::CNTK::AsDeviceDescriptor(gradients[i]->GetDeviceId()));
+            valuesToAggregate.push_back(data);
+        }
+
+        if (m_nccl.IsSupported()) // nccl is only enabled if all ranks have net on GPUs.
+        {                         // we assume in this case all grad layers are on the GPU too.
+            m_nccl.AllReduce(denseGradients);
         }
 
         // Prepare header.
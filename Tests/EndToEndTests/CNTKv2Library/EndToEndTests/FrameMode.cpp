@@ -114,6 +114,8 @@ void TestFrameMode()
 
     learners[L"gpu"] = [](LearnerPtr l) { return CreateQuantizedDataParallelDistributedLearner(QuantizedMPICommunicator(true, true, 32), l, 0); };
     learners[L"blockmomentum"] = [](LearnerPtr l) { return CreateBlockMomentumDistributedLearner(MPICommunicator(), l, 0, 1024); };
+    learners[L"hierarchical"] = [](LearnerPtr l) { return CreateDataParallelDistributedLearner(HierarchicalMPICommunicator(), l, 0); };
+    learners[L"sparsified"] = [](LearnerPtr l) { return CreateSparsifiedDataParallelDistributedLearner(MPICommunicator(), l, 0, 0.1); };
 
     // Create a set of devices.
     std::vector<DeviceDescriptor> devices;
@@ -231,3 +233,58 @@ void TestDistributedCheckpointing()
 
     sync->Barrier();
 }
+
+void TestHierarchicalAggregation()
+{
+    auto sync = MPICommunicator();
+    auto numWorkers = sync->Workers().size();
+    auto workerRank = sync->CurrentWorker().m_globalRank;
+
+    std::vector<DeviceDescriptor> devices;
+    if (ShouldRunOnCpu())
+        devices.push_back(DeviceDescriptor::CPUDevice());
+    if (ShouldRunOnGpu())
+        devices.push_back(DeviceDescriptor::GPUDevice(0));
+
+    // The test runs with 4 local workers. With ranksPerHost = 0 they share memory as a single host, with 1 every worker acts
+    // as a host of its own (flat all reduce), and with 2 there are two hosts of two workers, which runs the reduction within
+    // a host followed by the all reduce among the host leaders.
+    // The largest value does not fit into a single shared memory segment and is reduced in pieces.
+    for (auto device : devices)
+    for (size_t ranksPerHost : { 0, 1, 2 })
+    {
+        auto communicator = HierarchicalMPICommunicator(ranksPerHost);
+        std::vector<size_t> sizes = { 1, 1000, 5000001 };
+
+        std::vector<NDArrayViewPtr> values;
+        for (auto size : sizes)
+        {
+            auto floatValue = MakeSharedObject<NDArrayView>(DataType::Float, NDShape{ size }, DeviceDescriptor::CPUDevice());
+            auto doubleValue = MakeSharedObject<NDArrayView>(DataType::Double, NDShape{ size }, DeviceDescriptor::CPUDevice());
+            for (size_t i = 0; i < size; ++i)
+            {
+                floatValue->WritableDataBuffer<float>()[i] = (float)((workerRank + 1) * (i % 13));
+                doubleValue->WritableDataBuffer<double>()[i] = (double)((workerRank + 1) * (i % 13));
+            }
+            values.push_back(floatValue->DeepClone(device));
+            values.push_back(doubleValue->DeepClone(device));
+        }
+
+        communicator->AggregateInPlace(values, communicator->Workers());
+
+        double workerSum = numWorkers * (numWorkers + 1) / 2.0;
+        for (size_t j = 0; j < sizes.size(); ++j)
+        {
+            auto floatValue = values[2 * j]->DeepClone(DeviceDescriptor::CPUDevice());
+            auto doubleValue = values[2 * j + 1]->DeepClone(DeviceDescriptor::CPUDevice());
+            for (size_t i = 0; i < sizes[j]; ++i)
+            {
+                if (floatValue->DataBuffer<float>()[i] != (float)(workerSum * (i % 13)) ||
+                    doubleValue->DataBuffer<double>()[i] != workerSum * (i % 13))
+                    ReportFailure("Hierarchical aggregation on %S with %d ranks per host does not match expectation", device.AsString().c_str(), (int)ranksPerHost);
+            }
+        }
+    }
+
+    sync->Barrier();
+}
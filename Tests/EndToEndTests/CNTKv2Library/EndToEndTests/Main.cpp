@@ -22,6 +22,7 @@ void TrainSequenceToSequenceTranslator();
 void TrainTruncatedLSTMAcousticModelClassifier();
 void TestFrameMode();
 void TestDistributedCheckpointing();
+void TestHierarchicalAggregation();
 
 int main(int argc, char *argv[])
 {
@@ -45,7 +46,8 @@ int main(int argc, char *argv[])
 
     if (argc > 2)
     {
-        if (argc == 3 && !std::string(argv[1]).compare("Distribution")) {
+        std::string distributedTestName(argv[1]);
+        if (argc == 3 && (!distributedTestName.compare("Distribution") || !distributedTestName.compare("HierarchicalAggregation"))) {
             {
                 auto communicator = MPICommunicator();
                 std::string logFilename = argv[2] + std::to_string(communicator->CurrentWorker().m_globalRank);
@@ -57,9 +59,17 @@ int main(int argc, char *argv[])
                 }
             }
 
-            TestFrameMode();
+            if (!distributedTestName.compare("Distribution"))
+            {
+                TestFrameMode();
 
-            TestDistributedCheckpointing();
+                TestDistributedCheckpointing();
+            }
+            else
+            {
+                // Runs with 4 workers, so that they can be split into 2 emulated hosts.
+                TestHierarchicalAggregation();
+            }
 
             std::string testsPassedMsg = "\nCNTKv2Library-Distribution tests: Passed\n";
 
@@ -279,6 +279,69 @@ struct TensorTest
     }
 };
 
+// compare the hand-vectorized CPU tensor kernels (CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS) against the generic loops
+void VectorizedTensorOpsTest(const TensorShape& shape, int count)
+{
+    cout << "Testing vectorized tensor ops on [" << string(shape) << "]" << endl;
+    let savedFlags = CPUMatrix<float>::GetOptimizationFlags();
+
+    let numElements = shape.GetNumElements();
+    auto createTensor = [&](const TensorShape& tensorShape) -> TensorView<float>
+    {
+        auto sob = make_shared<Matrix<float>>(tensorShape.GetNumElements(), 1, CPUDEVICE);
+        randomInitializeMatrix<float>(*sob, -5, 10);
+        return TensorView<float>(sob, tensorShape);
+    };
+    let a = createTensor(shape);
+    let b = createTensor(shape);
+    let bias = createTensor(TensorShape(shape[0]));
+    SmallVector<size_t> reducedDims(shape.GetRank(), 1);
+    reducedDims[0] = shape[0];
+    let reducedShape = TensorShape(reducedDims);
+
+    struct Benchmark
+    {
+        const char* name;
+        function<void(TensorView<float>&)> fn;
+        bool isReduction;
+    };
+    vector<Benchmark> benchmarks =
+    {
+        { "Sigmoid", [&](TensorView<float>& r) { r.AssignSigmoidOf(a); }, false },
+        { "Tanh", [&](TensorView<float>& r) { r.AssignTanhOf(a); }, false },
+        { "Exp", [&](TensorView<float>& r) { r.AssignExpOf(a); }, false },
+        { "ReLU", [&](TensorView<float>& r) { r.AssignLinearRectifierOf(a); }, false },
+        { "Sum with bias (broadcasting)", [&](TensorView<float>& r) { r.AssignSumOf(a, bias); }, false },
+        { "Product, accumulating", [&](TensorView<float>& r) { r.AddElementwiseProductOf(a, b); }, false },
+        { "Sigmoid derivative", [&](TensorView<float>& r) { r.AssignElementwiseProductWithSigmoidDerivativeFromOutputOf(a, b); }, false },
+        { "Bias gradient (sum reduction)", [&](TensorView<float>& r) { r.DoCopyOf(0, a, 1); }, true },
+    };
+
+    for (const auto& benchmark : benchmarks)
+    {
+        double seconds[2];
+        shared_ptr<Matrix<float>> results[2];
+        for (int i = 0; i < 2; i++)
+        {
+            CPUMatrix<float>::SetOptimizationFlags(i == 0 ? (savedFlags & ~CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS) : (savedFlags | CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS));
+            auto result = benchmark.isReduction ? createTensor(reducedShape) : TensorView<float>(make_shared<Matrix<float>>(numElements, 1, CPUDEVICE), shape);
+            result.GetSOB().SetValue(0);
+            benchmark.fn(result); // warm-up
+            result.GetSOB().SetValue(0);
+            auto start = chrono::high_resolution_clock::now();
+            for (int iter = 0; iter < count; iter++)
+                benchmark.fn(result);
+            seconds[i] = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count() / count;
+            results[i] = result.GetSOBPtr();
+        }
+        let isSame = results[0]->IsEqualTo(*results[1], 1e-3f * count);
+        cout << benchmark.name << ": generic " << seconds[0] * 1e3 << " ms, vectorized " << seconds[1] * 1e3 << " ms, speed-up " << seconds[0] / seconds[1]
+             << (isSame ? "" : " --> FAILED (results differ)") << endl;
+    }
+
+    CPUMatrix<float>::SetOptimizationFlags(savedFlags);
+}
+
 template <class ElemType>
 void MandSTest(int count, int devId)
 {
@@ -338,6 +401,9 @@ void MandSTest(int count, int devId)
 
 int wmain()
 {
+    VectorizedTensorOpsTest(TensorShape{ 2048, 256 }, 100);
+    VectorizedTensorOpsTest(TensorShape{ 28, 28, 128, 32 }, 10);
+
     // MandSTest<float>(100, 2);
 
     /*cout<<endl<<"********************Matrix SquareMultiplyAndWeightedAdd10TimesAvg TEST********************"<<endl;
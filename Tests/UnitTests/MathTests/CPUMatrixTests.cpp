@@ -4,6 +4,7 @@
 //
 #include "stdafx.h"
 #include "../../../Source/Math/CPUMatrix.h"
+#include "../../../Source/Math/RNNCommon.h"
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -295,6 +296,34 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixMultiplyAndDiv, RandomSeedFixture)
     BOOST_CHECK(m3.IsEqualTo(m2));
 }
 
+// half GEMM accumulates in float over panels of the inner dimension; it must match the float GEMM up to the rounding of the result
+BOOST_FIXTURE_TEST_CASE(CPUMatrixHalfMultiplyAndWeightedAdd, RandomSeedFixture)
+{
+    const size_t m = 37, k = 600, n = 13;
+    auto toFloat = [](const CPUMatrix<half>& h)
+    {
+        SMatrix f(h.GetNumRows(), h.GetNumCols());
+        for (size_t i = 0; i < h.GetNumElements(); i++)
+            f.Data()[i] = (float)h.Data()[i];
+        return f;
+    };
+
+    for (bool transposeA : { false, true })
+    {
+        for (bool transposeB : { false, true })
+        {
+            CPUMatrix<half> a = CPUMatrix<half>::RandomUniform(transposeA ? k : m, transposeA ? m : k, -1, 1, IncrementCounter());
+            CPUMatrix<half> b = CPUMatrix<half>::RandomUniform(transposeB ? n : k, transposeB ? k : n, -1, 1, IncrementCounter());
+            CPUMatrix<half> c = CPUMatrix<half>::RandomUniform(m, n, -1, 1, IncrementCounter());
+            SMatrix cf = toFloat(c);
+
+            CPUMatrix<half>::MultiplyAndWeightedAdd(0.5f, a, transposeA, b, transposeB, 2.0f, c);
+            SMatrix::MultiplyAndWeightedAdd(0.5f, toFloat(a), transposeA, toFloat(b), transposeB, 2.0f, cf);
+            BOOST_CHECK(toFloat(c).IsEqualTo(cf, 0.02f));
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(CPUMatrixElementOperations, RandomSeedFixture)
 {
     // TODO: consider splitting this large test
@@ -1215,6 +1244,123 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixGatherFromTarget, RandomSeedFixture)
     BOOST_CHECK(m2.IsEqualTo(expect, 1e-6));
 }
 
+// reference for one LSTM direction over one (unpacked) sequence, using the cuDNN parameter layout
+static void ReferenceLSTM(const DMatrix& params, size_t offsetW, size_t offsetR, size_t offsetBiasW, size_t offsetBiasR, size_t inputDim, size_t hiddenDim,
+                          const vector<vector<double>>& x, bool goBackwards, vector<vector<double>>& h)
+{
+    auto sigmoid = [](double v) { return 1 / (1 + exp(-v)); };
+    const double* p = params.Data();
+    size_t numGates = 4 * hiddenDim;
+    vector<double> hPrev(hiddenDim, 0), c(hiddenDim, 0), z(numGates);
+    h.assign(x.size(), vector<double>(hiddenDim));
+    for (size_t step = 0; step < x.size(); step++)
+    {
+        size_t t = goBackwards ? x.size() - 1 - step : step;
+        for (size_t j = 0; j < numGates; j++)
+        {
+            z[j] = p[offsetBiasW + j] + p[offsetBiasR + j];
+            for (size_t i = 0; i < inputDim; i++)
+                z[j] += p[offsetW + j * inputDim + i] * x[t][i];
+            for (size_t i = 0; i < hiddenDim; i++)
+                z[j] += p[offsetR + j * hiddenDim + i] * hPrev[i];
+        }
+        for (size_t k = 0; k < hiddenDim; k++)
+        {
+            c[k] = sigmoid(z[k + hiddenDim]) * c[k] + sigmoid(z[k]) * tanh(z[k + 2 * hiddenDim]);
+            h[t][k] = hPrev[k] = sigmoid(z[k + 3 * hiddenDim]) * tanh(c[k]);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRNNForwardBidirectionalLSTM, RandomSeedFixture)
+{
+    const size_t inputDim = 3, hiddenDim = 2;
+    RnnAttributes attributes(/*bidirectional=*/true, /*numLayers=*/1, hiddenDim, L"lstm", /*axis=*/-1);
+    auto numParameters = attributes.GetNumParameters(inputDim);
+    DMatrix params(numParameters.first, numParameters.second);
+    params.SetUniformRandomValue(-0.5, 0.5, IncrementCounter());
+
+    // two sequences of length 3 and 1, in the dense cuDNN packing (time-major, longest first)
+    vector<size_t> lengths = { 3, 1 };
+    vector<size_t> numSequencesForFrame = { 2, 1, 1 };
+    DMatrix input(inputDim, 4);
+    input.SetUniformRandomValue(-1, 1, IncrementCounter());
+    vector<vector<vector<double>>> sequences(2);
+    for (size_t t = 0, col = 0; t < numSequencesForFrame.size(); t++)
+        for (size_t s = 0; s < numSequencesForFrame[t]; s++, col++)
+            sequences[s].push_back(vector<double>(input.Data() + col * inputDim, input.Data() + (col + 1) * inputDim));
+
+    DMatrix output(2 * hiddenDim, 4), reserve, workspace;
+    output.RNNForward(input, params, inputDim, 2 * hiddenDim, numSequencesForFrame, attributes, reserve, workspace);
+
+    // parameter layout: W, R for forward, then backward direction; then bW, bR for each
+    size_t sizeW = 4 * hiddenDim * inputDim, sizeR = 4 * hiddenDim * hiddenDim, sizeB = 4 * hiddenDim;
+    size_t offsetBias = 2 * (sizeW + sizeR);
+    for (size_t s = 0; s < sequences.size(); s++)
+    {
+        vector<vector<double>> forward, backward;
+        ReferenceLSTM(params, 0, sizeW, offsetBias, offsetBias + sizeB, inputDim, hiddenDim, sequences[s], false, forward);
+        ReferenceLSTM(params, sizeW + sizeR, 2 * sizeW + sizeR, offsetBias + 2 * sizeB, offsetBias + 3 * sizeB, inputDim, hiddenDim, sequences[s], true, backward);
+        for (size_t t = 0; t < lengths[s]; t++)
+        {
+            size_t col = (t == 0) ? s : t + 1;
+            for (size_t k = 0; k < hiddenDim; k++)
+            {
+                BOOST_CHECK_CLOSE(output(k, col), forward[t][k], 1e-8);
+                BOOST_CHECK_CLOSE(output(hiddenDim + k, col), backward[t][k], 1e-8);
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRNNBackwardGRU, RandomSeedFixture)
+{
+    const size_t inputDim = 3, hiddenDim = 2;
+    RnnAttributes attributes(/*bidirectional=*/true, /*numLayers=*/2, hiddenDim, L"gru", /*axis=*/-1);
+    auto numParameters = attributes.GetNumParameters(inputDim);
+    DMatrix params(numParameters.first, numParameters.second);
+    params.SetUniformRandomValue(-0.5, 0.5, IncrementCounter());
+    vector<size_t> numSequencesForFrame = { 3, 2, 2, 1 };
+    DMatrix input(inputDim, 8);
+    input.SetUniformRandomValue(-1, 1, IncrementCounter());
+    DMatrix outputGradient(2 * hiddenDim, 8);
+    outputGradient.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+    // objective: sum(output .* outputGradient)
+    auto objective = [&](const DMatrix& p, const DMatrix& x)
+    {
+        DMatrix output(2 * hiddenDim, 8), reserve, workspace;
+        output.RNNForward(x, p, inputDim, 2 * hiddenDim, numSequencesForFrame, attributes, reserve, workspace);
+        double sum = 0;
+        for (size_t i = 0; i < output.GetNumElements(); i++)
+            sum += output.Data()[i] * outputGradient.Data()[i];
+        return sum;
+    };
+
+    DMatrix output(2 * hiddenDim, 8), reserve, workspace;
+    output.RNNForward(input, params, inputDim, 2 * hiddenDim, numSequencesForFrame, attributes, reserve, workspace);
+    DMatrix inputGradient(inputDim, 8), paramsGradient(params.GetNumRows(), params.GetNumCols());
+    paramsGradient.SetValue(0);
+    output.RNNBackwardData(outputGradient, params, inputGradient, attributes, reserve, workspace);
+    output.RNNBackwardWeights(input, output, paramsGradient, attributes, reserve, workspace);
+
+    const double epsilon = 1e-6;
+    for (size_t i = 0; i < params.GetNumElements(); i++)
+    {
+        DMatrix plus(params), minus(params);
+        plus.Data()[i] += epsilon;
+        minus.Data()[i] -= epsilon;
+        BOOST_CHECK_SMALL((objective(plus, input) - objective(minus, input)) / (2 * epsilon) - paramsGradient.Data()[i], 1e-6);
+    }
+    for (size_t i = 0; i < input.GetNumElements(); i++)
+    {
+        DMatrix plus(input), minus(input);
+        plus.Data()[i] += epsilon;
+        minus.Data()[i] -= epsilon;
+        BOOST_CHECK_SMALL((objective(params, plus) - objective(params, minus)) / (2 * epsilon) - inputGradient.Data()[i], 1e-6);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
 } } }
@@ -116,6 +116,39 @@ BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixMultiplyAndAdd, RandomSeedFixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixAdjustCol2BlockId, RandomSeedFixture)
+{
+    const size_t m = 3;
+    const size_t n = 6;
+
+    // columns 4 and 1 have blocks, in this order
+    const size_t blockIds[] = { 4, 1 };
+    const double values[] = { 1, 2, 3, 4, 5, 6 };
+    SparseMatrix sm(MatrixFormat::matrixFormatSparseBlockCol);
+    sm.SetMatrixFromSBCFormat(blockIds, values, 2, m, n);
+
+    std::vector<GPUSPARSE_INDEX_TYPE> col2BlockId(n);
+    sm.GetCol2BlockId(col2BlockId.data());
+    const GPUSPARSE_INDEX_TYPE expectedCol2BlockId[] = { SparseIndex_NotAssigned, 1, SparseIndex_NotAssigned, SparseIndex_NotAssigned, 0, SparseIndex_NotAssigned };
+    BOOST_CHECK_EQUAL_COLLECTIONS(col2BlockId.begin(), col2BlockId.end(), expectedCol2BlockId, expectedCol2BlockId + n);
+
+    // union with column 2, numbered in column order
+    const GPUSPARSE_INDEX_TYPE newCol2BlockId[] = { SparseIndex_NotAssigned, 0, 1, SparseIndex_NotAssigned, 2, SparseIndex_NotAssigned };
+    sm.AdjustCol2BlockId(newCol2BlockId, 3);
+
+    BOOST_CHECK_EQUAL(sm.GetBlockSize(), 3);
+    for (size_t row = 0; row < m; row++)
+    {
+        BOOST_CHECK_EQUAL(sm(row, 1), values[m + row]);
+        BOOST_CHECK_EQUAL(sm(row, 2), 0);
+        BOOST_CHECK_EQUAL(sm(row, 4), values[row]);
+        BOOST_CHECK_EQUAL(sm(row, 0), 0);
+    }
+
+    sm.GetCol2BlockId(col2BlockId.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(col2BlockId.begin(), col2BlockId.end(), newCol2BlockId, newCol2BlockId + n);
+}
+
 BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixDoGatherColumnsOf, RandomSeedFixture)
 {
     const size_t m = 100;
@@ -421,6 +421,73 @@ BOOST_AUTO_TEST_CASE(ConvolutionBackwardKernel)
     }
 }
 
+BOOST_AUTO_TEST_CASE(DirectConvolutionForward)
+{
+    std::mt19937 rng(0);
+    boost::random::uniform_int_distribution<> batchSizeG(1, 8);
+    boost::random::normal_distribution<float> nd;
+
+    // The direct engine is CPU-only, so it is compared with the reference engine on CPU.
+    // Maps of 8x8 and larger use Winograd F(4x4, 3x3), smaller ones F(2x2, 3x3).
+    // Builds with MKL-DNN do not use the direct engine and fall back to the reference one.
+    int deviceId = -1;
+    auto engKind = (ConvolutionEngineKind)((int)ConvolutionEngineKind::Direct | (int)ConvolutionEngineKind::Reference);
+    for (size_t maxTempMem : {0, 1, 3})
+    {
+        for (size_t k : {1, 3})
+        {
+            for (auto inDims : std::vector<std::array<size_t, 3>>{ {5, 4, 1}, {7, 9, 3}, {8, 8, 2}, {13, 10, 4} })
+            {
+                for (size_t mapCount : {1, 5})
+                {
+                    for (bool pad : {false, true})
+                    {
+                        if (k == 1 && pad)
+                            continue;
+
+                        TensorShape inp(inDims[0], inDims[1], inDims[2]);
+                        TensorShape kernel(k, k, inDims[2]);
+                        TensorShape map(mapCount);
+                        TensorShape stride(1, 1, inDims[2]);
+                        auto g = std::make_shared<ConvolveGeometry>(inp, kernel, map, stride, ConvolveGeometry::BoolVec{true},
+                                                                    ConvolveGeometry::BoolVec{pad, pad, false}, TensorShape(0), TensorShape(0));
+
+                        auto baseEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, 0, PoolKind::None, ConvolutionEngineKind::Reference);
+                        auto testEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, maxTempMem, PoolKind::None, engKind);
+
+                        size_t n = batchSizeG(rng);
+                        vec buf(g->InputShape().GetNumElements() * n);
+                        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+                        SingleMatrix in(g->InputShape().GetNumElements(), n, buf.data(), deviceId, matrixFlagNormal);
+
+                        buf.resize(g->KernelShape().GetNumElements() * mapCount);
+                        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+                        SingleMatrix kern(mapCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+
+                        size_t crowOut = g->OutputShape().GetNumElements();
+                        SingleMatrix out(crowOut, n, deviceId);
+                        SingleMatrix outB(crowOut, n, deviceId);
+                        out.SetValue(std::numeric_limits<float>::quiet_NaN());
+
+                        SingleMatrix workspace(deviceId);
+                        SingleMatrix workspaceB(deviceId);
+
+                        testEng->Forward(in, kern, out, workspace);
+                        baseEng->Forward(in, kern, outB, workspaceB);
+
+                        std::stringstream tmsg;
+                        tmsg << "Geometry: " << (std::string)(*g) << ", Batch: " << n << ", MaxTempMem: " << maxTempMem;
+                        std::string emsg;
+
+                        BOOST_REQUIRE_MESSAGE(!out.HasNan("out"), "out has NaNs, " << tmsg.str());
+                        BOOST_REQUIRE_MESSAGE(CheckEqual(out, outB, emsg, Err<float>::Rel * 4, Err<float>::Abs * 14), "out are not equal, " << tmsg.str() << ". " << emsg);
+                    }
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(PoolingForward)
 {
     std::mt19937 rng(0);
@@ -84,6 +84,37 @@ BOOST_FIXTURE_TEST_CASE(MatrixMoveTest2, RandomSeedFixture)
     BOOST_CHECK_EQUAL(b.GetDeviceId(), 0);
 }
 
+BOOST_FIXTURE_TEST_CASE(MatrixBorrowBuffer, RandomSeedFixture)
+{
+    auto arena = make_shared<SingleMatrix>(100, 1, CPUDEVICE);
+    arena->SetValue(7.0f);
+    std::weak_ptr<SingleMatrix> weakArena = arena;
+
+    SingleMatrix a(CPUDEVICE);
+    a.BorrowBufferFrom(arena, 40, 60);
+    BOOST_CHECK(a.OwnBuffer()); // unlike an external buffer, a borrowed one can be resized
+
+    // resizing within the borrowed range stays in the arena
+    a.Resize(6, 10);
+    BOOST_CHECK(a.Data() == arena->Data() + 40);
+    a.SetValue(1.0f);
+    BOOST_CHECK_EQUAL(7.0f, arena->GetValue(39, 0));
+    BOOST_CHECK_EQUAL(1.0f, arena->GetValue(40, 0));
+    BOOST_CHECK_EQUAL(1.0f, arena->GetValue(99, 0));
+    a.Resize(5, 4);
+    BOOST_CHECK(a.Data() == arena->Data() + 40);
+
+    // the arena is kept alive by its borrowers
+    arena.reset();
+    BOOST_CHECK(!weakArena.expired());
+
+    // growing beyond the borrowed range moves the matrix to an allocation of its own and releases the arena
+    a.Resize(10, 10);
+    BOOST_CHECK(weakArena.expired());
+    a.SetValue(2.0f);
+    BOOST_CHECK_EQUAL(2.0f, a.GetValue(9, 9));
+}
+
 BOOST_FIXTURE_TEST_CASE(MatrixDeepCopy, RandomSeedFixture)
 {
     // This is deep copy, not move
@@ -5,6 +5,7 @@
 #include "stdafx.h"
 #include "../../../Source/Math/QuantizedOperations.h"
 #include "../../../Source/Math/Helpers.h"
+#include <random>
 
 using namespace Microsoft::MSR::CNTK;
 namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
@@ -50,6 +51,53 @@ BOOST_FIXTURE_TEST_CASE(MultiplyIntToShort, RandomSeedFixture)
         BOOST_CHECK_EQUAL(round(C_upd[i]), C_expected_upd[i]);
 }
 
+BOOST_FIXTURE_TEST_CASE(MultiplyInt8PerChannel, RandomSeedFixture)
+{
+    // op(A)[m,k]*op(B)[k,n] = C[m,n], with rows of op(A) of very different magnitude to exercise the per-channel weight scales
+    int m = 6, n = 4, k = 50;
+    std::mt19937 rng(1);
+    std::normal_distribution<float> distribution;
+    std::vector<float> A(m * k), B(k * n);
+    for (auto& a : A)
+        a = distribution(rng);
+    for (auto& b : B)
+        b = distribution(rng);
+
+    for (bool isAWeight : { true, false })
+        for (bool transA : { false, true })
+            for (bool transB : { false, true })
+            {
+                std::vector<float> weight = isAWeight ? A : B;
+                int weightRows = isAWeight ? (transA ? k : m) : (transB ? n : k);
+                int weightCols = (int)weight.size() / weightRows;
+                bool channelsAreRows = isAWeight ? !transA : transB;
+                for (int i = 0; i < weightRows; i++)
+                    for (int j = 0; j < weightCols; j++)
+                        weight[i + j * weightRows] *= (float)pow(10, (channelsAreRows ? i : j) % 3);
+
+                const auto& opA = isAWeight ? weight : A;
+                const auto& opB = isAWeight ? B : weight;
+                std::vector<float> C_expected(m * n), C(m * n);
+                for (int i = 0; i < m; i++)
+                    for (int j = 0; j < n; j++)
+                        for (int l = 0; l < k; l++)
+                            C_expected[i + j * m] += opA[transA ? l + i * k : i + l * m] * opB[transB ? j + l * n : l + j * k];
+
+                // Activation range is calibrated for B (4 covers the samples), or derived from A
+                Int8QuantizedMultiplier<float> mult(isAWeight, isAWeight ? 4.0f : 0.0f);
+                for (int pass = 0; pass < 2; pass++)
+                {
+                    mult.Multiply(m, n, k, const_cast<float*>(opA.data()), transA, const_cast<float*>(opB.data()), transB, C.data());
+
+                    for (int i = 0; i < m; i++)
+                        for (int j = 0; j < n; j++)
+                        {
+                            float channelScale = (float)pow(10, (isAWeight ? i : j) % 3);
+                            BOOST_CHECK_SMALL(C[i + j * m] - C_expected[i + j * m], 0.5f * channelScale);
+                        }
+                }
+            }
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
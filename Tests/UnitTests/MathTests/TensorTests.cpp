@@ -86,6 +86,64 @@ BOOST_AUTO_TEST_CASE(BiasGradient2)
     });
 }
 
+// the hand-vectorized CPU kernels (CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS) must match the generic loops
+BOOST_AUTO_TEST_CASE(VectorizedTensorOps)
+{
+    Test::TensorTest<float> tensorTester;
+    let savedFlags = CPUMatrix<float>::GetOptimizationFlags();
+
+    // run 'fn' with and without the vectorized kernels and compare
+    auto compare = [&](const char* what, double tolerance, const function<void(TensorView<float>&)>& fn)
+    {
+        fprintf(stderr, "===== Vectorized tensor test '%s'\n", what);
+        TensorView<float> results[2] = { tensorTester.CreateTensor(TensorShape{ 37, 65 }, 1, CPUDEVICE, true), tensorTester.CreateTensor(TensorShape{ 37, 65 }, 1, CPUDEVICE, true) };
+        for (int i = 0; i < 2; i++)
+        {
+            CPUMatrix<float>::SetOptimizationFlags(i == 0 ? 0 : CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS);
+            fn(results[i]);
+        }
+        BOOST_CHECK(results[0].GetSOB().IsEqualTo(results[1].GetSOB(), (float)tolerance));
+    };
+
+    let a = tensorTester.CreateTensor(TensorShape{ 37, 65 }, 2, CPUDEVICE);
+    let b = tensorTester.CreateTensor(TensorShape{ 37, 65 }, 3, CPUDEVICE);
+    let c = tensorTester.CreateTensor(TensorShape{ 37, 65 }, 4, CPUDEVICE);
+    let bias = tensorTester.CreateTensor(TensorShape{ 37 }, 5, CPUDEVICE);
+    let row = tensorTester.CreateTensor(TensorShape{ 1, 65 }, 6, CPUDEVICE);
+
+    for (auto op : { opCopy, opNegate, opAbs, opSigmoid, opTanh, opSqr, opSqrt, opExp, opLinearRectifier })
+        compare("unary", 1e-5, [&](TensorView<float>& result) { result.DoUnaryOpOf(0.5f, a, 2.0f, op, opSum); });
+    for (auto op : { opSum, opDifference, opElementwiseProduct, opElementwiseQuotient, opMax, opMin, opElementwiseProductWithSigmoidDerivativeFromOutput,
+                     opElementwiseProductWithTanhDerivativeFromOutput, opElementwiseProductWithLinearRectifierDerivativeFromOutput, opSqrOfDifference })
+    {
+        compare("binary", 0, [&](TensorView<float>& result) { result.DoBinaryOpOf(0, a, b, 1.0f, op, opSum); });
+        compare("binary with broadcasting", 0, [&](TensorView<float>& result) { result.DoBinaryOpOf(1.0f, a, bias, 1.0f, op, opSum); });
+        compare("binary with row broadcasting", 0, [&](TensorView<float>& result) { result.DoBinaryOpOf(0, row, b, 1.0f, op, opSum); });
+    }
+    for (auto op : { opCond, opCopyIfEqual, opClip, opElementwiseProductWithExpOfDiff })
+        compare("ternary", 1e-5, [&](TensorView<float>& result) { result.DoTernaryOpOf(0, a, b, c, 1.0f, op, opSum); });
+
+    // reductions, into a column (contiguous reduction dimension) and into a row (strided)
+    for (auto reductionOp : { opSum, opMax, opMin })
+    {
+        auto reduce = [&](const char* what, const TensorShape& shape)
+        {
+            TensorView<float> results[2] = { tensorTester.CreateTensor(shape, 1, CPUDEVICE, true), tensorTester.CreateTensor(shape, 1, CPUDEVICE, true) };
+            for (int i = 0; i < 2; i++)
+            {
+                CPUMatrix<float>::SetOptimizationFlags(i == 0 ? 0 : CPUMatrix<float>::OPT_VECTORIZED_TENSOR_OPS);
+                results[i].DoUnaryOpOf(0, a, 1.0f, opSqr, reductionOp);
+            }
+            fprintf(stderr, "===== Vectorized tensor test '%s'\n", what);
+            BOOST_CHECK(results[0].GetSOB().IsEqualTo(results[1].GetSOB(), 1e-5f));
+        };
+        reduce("reduction into a column", TensorShape{ 37 });
+        reduce("reduction into a row", TensorShape{ 1, 65 });
+    }
+
+    CPUMatrix<float>::SetOptimizationFlags(savedFlags);
+}
+
 BOOST_AUTO_TEST_CASE(ColumnSliceMultAndAdd)
 {
     ColumnSliceMultAndAddTest<float>(2048, 2048, 256, 0);
@@ -0,0 +1,178 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/LinearAlgebraNodes.h"
+#include "../../../Source/ComputationNetworkLib/NonlinearityNodes.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetwork.h"
+#include "../../../Source/ComputationNetworkLib/ComputationNetworkBuilder.h"
+#include "Globals.h"
+#include "TestHelpers.h"
+#include <memory>
+#include <cmath>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+// We perform test on CPU.
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// Extends fused elementwise node to provide access to protected members.
+template <class ElemType>
+class FusedElementwiseNodeTest : public FusedElementwiseNode<ElemType>
+{
+public:
+    FusedElementwiseNodeTest(const wstring& binaryOperation, const wstring& activation)
+        : FusedElementwiseNode<ElemType>(c_deviceId, L"FusedElementwiseNodeTest", binaryOperation, activation)
+    {
+    }
+
+    void AllocMatrices()
+    {
+        this->CreateValueMatrixIfNull();
+        this->CreateGradientMatrixIfNull();
+        this->Value().Resize(this->GetSampleLayout().GetNumElements(), this->GetMBLayout()->GetNumCols());
+        this->Gradient().Resize(this->GetSampleLayout().GetNumElements(), this->GetMBLayout()->GetNumCols());
+    }
+
+    Matrix<ElemType>& GetGradient() { return this->Gradient(); }
+};
+
+// reference implementation: activation (a op b), and the gradients w.r.t. a and b for an output gradient of 1
+static void FusedElementwiseReference(const wstring& binaryOperation, const wstring& activation, double a, double b,
+                                      double& value, double& gradientA, double& gradientB)
+{
+    bool isProduct = binaryOperation == L"ElementTimes";
+    double z = isProduct ? a * b : a + b;
+    double derivative; // of the activation at z
+    if (activation == L"RectifiedLinear")
+    {
+        value = z > 0 ? z : 0;
+        derivative = z > 0 ? 1 : 0;
+    }
+    else if (activation == L"Sigmoid")
+    {
+        value = 1 / (1 + exp(-z));
+        derivative = value * (1 - value);
+    }
+    else
+    {
+        value = tanh(z);
+        derivative = 1 - value * value;
+    }
+    gradientA = derivative * (isProduct ? b : 1);
+    gradientB = derivative * (isProduct ? a : 1);
+}
+
+template <class ElemType>
+void FusedElementwiseNodeForwardBackwardTestImpl(const wstring& binaryOperation, const wstring& activation)
+{
+    const size_t c_dim = 3;
+    const size_t c_minibatchSize = 2;
+    const float c_threshold = 1e-5f;
+    SmallVector<size_t> dims = { c_dim };
+    vector<ElemType> firstData{ -2.0f, -0.5f, 0.0f, 0.25f, 1.0f, 3.0f };
+    vector<ElemType> secondData{ 0.5f, -1.5f, 0.75f, -0.5f, 2.0f, -4.0f };
+    auto firstInput = make_shared<DummyNodeTest<ElemType>>(c_deviceId, c_minibatchSize, dims, firstData);
+    auto secondInput = make_shared<DummyNodeTest<ElemType>>(c_deviceId, c_minibatchSize, dims, secondData);
+
+    auto fusedNode = make_shared<FusedElementwiseNodeTest<ElemType>>(binaryOperation, activation);
+    fusedNode->AttachInputs({ firstInput, secondInput });
+    fusedNode->Validate(true);
+    fusedNode->AllocMatrices();
+
+    vector<ElemType> expectedValue(firstData.size()), expectedFirstGradient(firstData.size()), expectedSecondGradient(firstData.size());
+    for (size_t i = 0; i < firstData.size(); i++)
+    {
+        double value, gradientA, gradientB;
+        FusedElementwiseReference(binaryOperation, activation, firstData[i], secondData[i], value, gradientA, gradientB);
+        expectedValue[i] = (ElemType)value;
+        expectedFirstGradient[i] = (ElemType)gradientA;
+        expectedSecondGradient[i] = (ElemType)gradientB;
+    }
+
+    FrameRange fr;
+    fusedNode->ForwardProp(fr);
+    BOOST_REQUIRE_MESSAGE(AreEqual(fusedNode->Value().Data(), expectedValue.data(), expectedValue.size(), c_threshold),
+                          "Fused elementwise node output is invalid");
+
+    fusedNode->GetGradient().SetValue(1);
+    firstInput->GetGradient().SetValue(0);
+    secondInput->GetGradient().SetValue(0);
+    fusedNode->BackpropTo(0, fr);
+    fusedNode->BackpropTo(1, fr);
+    BOOST_REQUIRE_MESSAGE(AreEqual(firstInput->GetGradient().Data(), expectedFirstGradient.data(), expectedFirstGradient.size(), c_threshold),
+                          "Fused elementwise node gradient of first input is invalid");
+    BOOST_REQUIRE_MESSAGE(AreEqual(secondInput->GetGradient().Data(), expectedSecondGradient.data(), expectedSecondGradient.size(), c_threshold),
+                          "Fused elementwise node gradient of second input is invalid");
+}
+
+template <class ElemType>
+void FusedElementwiseNodeForwardBackwardTestImpl()
+{
+    for (auto binaryOperation : { L"Plus", L"ElementTimes" })
+        for (auto activation : { L"RectifiedLinear", L"Sigmoid", L"Tanh" })
+            FusedElementwiseNodeForwardBackwardTestImpl<ElemType>(binaryOperation, activation);
+}
+
+BOOST_AUTO_TEST_SUITE(FusedElementwiseNodeTestSuite)
+
+BOOST_AUTO_TEST_CASE(FusedElementwiseNodeForwardBackwardTest)
+{
+    FusedElementwiseNodeForwardBackwardTestImpl<float>();
+    FusedElementwiseNodeForwardBackwardTestImpl<double>();
+}
+
+BOOST_AUTO_TEST_CASE(FusedElementwiseNodeInvalidOperationTest)
+{
+    BOOST_REQUIRE_THROW(FusedElementwiseNode<float>(c_deviceId, L"fused", L"Minus", L"Sigmoid"), std::invalid_argument);
+    BOOST_REQUIRE_THROW(FusedElementwiseNode<float>(c_deviceId, L"fused", L"Plus", L"Exp"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(FuseElementwiseNodesInCompileNetworkTest)
+{
+    // out = RectifiedLinear (Plus (Times (W, x), b)), and a Sigmoid of a Plus that is also used elsewhere
+    auto net = make_shared<ComputationNetwork>(c_deviceId);
+    ComputationNetworkBuilder<float> builder(*net);
+    auto x = builder.CreateInputNode(L"x", 4);
+    auto W = builder.CreateLearnableParameter(L"W", 3, 4);
+    auto b = builder.CreateLearnableParameter(L"b", 3, 1);
+    auto plus = builder.Plus(builder.Times(W, x, 1, L"times"), b, L"plus");
+    auto relu = builder.RectifiedLinear(plus, L"relu");
+    auto sharedPlus = builder.Plus(relu, b, L"sharedPlus");
+    auto sigmoid = builder.Sigmoid(sharedPlus, L"sigmoid");
+    auto out = builder.Plus(sigmoid, sharedPlus, L"out");
+    net->AddToNodeGroup(L"output", out);
+
+    Globals::SetElementwiseNodeFusion(true);
+    try
+    {
+        net->CompileNetwork();
+    }
+    catch (...)
+    {
+        Globals::SetElementwiseNodeFusion(false);
+        throw;
+    }
+    Globals::SetElementwiseNodeFusion(false);
+
+    BOOST_REQUIRE_MESSAGE(!net->NodeNameExists(L"plus"), "Fused Plus node should have been removed from the network");
+    auto fusedNode = net->GetNodeFromName(L"relu");
+    BOOST_REQUIRE(fusedNode->OperationName() == OperationNameOf(FusedElementwiseNode));
+    BOOST_REQUIRE(fusedNode->Input(0)->NodeName() == L"times");
+    BOOST_REQUIRE(fusedNode->Input(1)->NodeName() == L"b");
+    BOOST_REQUIRE(net->GetNodeFromName(L"sharedPlus")->Input(0) == fusedNode);
+
+    // the Plus feeding the Sigmoid has a second consumer and must be kept
+    BOOST_REQUIRE(net->GetNodeFromName(L"sigmoid")->OperationName() == OperationNameOf(SigmoidNode));
+    BOOST_REQUIRE(net->GetNodeFromName(L"sharedPlus")->OperationName() == OperationNameOf(PlusNode));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} } } }
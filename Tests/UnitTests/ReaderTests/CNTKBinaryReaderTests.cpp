@@ -17,6 +17,12 @@ struct CNTKBinaryReaderFixture : ReaderFixture
         : ReaderFixture("/Data/CNTKBinaryReader/")
     {
     }
+
+    // Converts the data of the deserializers in the given test section into the CNTK binary format.
+    void ConvertToCBF(const string& testSectionName)
+    {
+        HelperConvertToCBF(testDataPath() + "/Config/CNTKBinaryReader/test.cntk", testSectionName);
+    }
 };
 
 BOOST_FIXTURE_TEST_SUITE(ReaderTestSuite, CNTKBinaryReaderFixture)
@@ -56,6 +62,38 @@ BOOST_AUTO_TEST_CASE(CNTKBinaryReader_MNIST_dense)
         1);
 };
 
+// Loads the chunks of the MNIST file with positional reads from several threads and with read ahead,
+// the result has to match the one of loading them one by one on the reader thread.
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_MNIST_dense_concurrent_chunk_loading)
+{
+    auto read = [this](const string& outputFile, const vector<wstring>& parameters)
+    {
+        HelperReadInAndWriteOut<double>(
+            testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+            outputFile,
+            "MNIST",
+            "reader",
+            3000, // epoch size
+            1000, // mb size
+            2,    // num epochs
+            1,
+            1,
+            0,
+            1,
+            false,
+            false,
+            false,
+            parameters);
+    };
+
+    const wstring fromDisk = L"MNIST=[reader=[randomize=true;randomizationWindow=2;keepDataInMemory=false]]";
+    string sequentialOutput = testDataPath() + "/Control/CNTKBinaryReader/MNIST_dense_sequential_loading_Output.txt";
+    string concurrentOutput = testDataPath() + "/Control/CNTKBinaryReader/MNIST_dense_concurrent_loading_Output.txt";
+    read(sequentialOutput, { fromDisk });
+    read(concurrentOutput, { fromDisk, L"chunkPrefetchThreads=4", L"chunkPrefetchDepth=4", L"chunkReadAheadDepth=2" });
+    CheckFilesEquivalent(sequentialOutput, concurrentOutput);
+};
+
 // 10 sequences with 10 samples each (no randomization)
 BOOST_AUTO_TEST_CASE(CNTKBinaryReader_10x10_dense)
 {
@@ -131,6 +169,86 @@ BOOST_AUTO_TEST_CASE(CNTKBinaryReader_50x20_jagged_sequences_sparse)
         true);
 };
 
+// The same data as in CNTKBinaryReader_Simple_dense, converted into a file with compressed chunks.
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_Simple_dense_compressed)
+{
+    ConvertToCBF("Simple_convert");
+    BOOST_SCOPE_EXIT(void) { boost::filesystem::remove("Simple_dense_compressed.bin"); } BOOST_SCOPE_EXIT_END
+
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+        testDataPath() + "/Control/CNTKTextFormatReader/Simple_dense.txt",
+        testDataPath() + "/Control/CNTKBinaryReader/Simple_dense_Output.txt",
+        "Simple_compressed",
+        "reader",
+        1000, // epoch size
+        250,  // mb size
+        10,   // num epochs
+        1,
+        1,
+        0,
+        1);
+};
+
+// The same data as in CNTKBinaryReader_10x10_sparse, converted into a file with compressed chunks.
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_10x10_sparse_compressed)
+{
+    ConvertToCBF("10x10_sparse_convert");
+    BOOST_SCOPE_EXIT(void) { boost::filesystem::remove("10x10_sparse_compressed.bin"); } BOOST_SCOPE_EXIT_END
+
+    HelperRunReaderTest<double>(
+        testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+        testDataPath() + "/Control/CNTKTextFormatReader/10x10_sparse.txt",
+        testDataPath() + "/Control/CNTKBinaryReader/10x10_sparse_Output.txt",
+        "10x10_sparse_compressed",
+        "reader",
+        100, // epoch size
+        100, // mb size
+        1, // num epochs
+        1,
+        0, // no labels
+        0,
+        1,
+        true);
+};
+
+// The text format data of CNTKTextFormatReader_Simple_dense converted into two shards, each worker reads its own shard.
+BOOST_AUTO_TEST_CASE(CNTKBinaryReader_Simple_dense_sharded)
+{
+    ConvertToCBF("Simple_text_convert");
+    BOOST_SCOPE_EXIT(void)
+    {
+        boost::filesystem::remove("Simple_dense_sharded.bin.0");
+        boost::filesystem::remove("Simple_dense_sharded.bin.1");
+    } BOOST_SCOPE_EXIT_END
+
+    HelperCheckShardsContainAllData<float>(
+        testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+        "Simple_text",
+        "Simple_sharded",
+        testDataPath() + "/Control/CNTKBinaryReader/Simple_dense_sharded_Output.txt",
+        2000, // mb size
+        2,    // num shards
+        1,
+        1);
+
+    // Each worker has to read its own shard.
+    BOOST_CHECK_THROW(
+        HelperReadInAndWriteOut<float>(
+            testDataPath() + "/Config/CNTKBinaryReader/test.cntk",
+            testDataPath() + "/Control/CNTKBinaryReader/Simple_dense_sharded_Output.txt",
+            "Simple_sharded",
+            "reader",
+            1000, // epoch size
+            250,  // mb size
+            1,    // num epochs
+            1,
+            1,
+            0,
+            1),
+        std::invalid_argument);
+};
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } } } }
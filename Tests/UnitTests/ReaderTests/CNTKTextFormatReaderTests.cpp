@@ -4,6 +4,8 @@
 //
 #include "stdafx.h"
 #include <algorithm>
+#include <chrono>
+#include <random>
 #ifdef _WIN32
 #include <io.h>
 #else // On Linux
@@ -86,6 +88,37 @@ BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_Simple_dense)
     };
     test({});
     test({ L"defMBSize=true" });
+    test({ L"zeroCopyMinibatches=true" });
+};
+
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_Simple_dense_zero_copy_minibatch_lifetime)
+{
+    // With zero copy minibatches a minibatch that was swapped out into its own inputs still references a buffer
+    // of the packer, it must stay intact while the next minibatch is fetched.
+    auto reader = GetDataReader(testDataPath() + "/Config/CNTKTextFormatReader/dense.cntk",
+        "Simple", "reader", { L"zeroCopyMinibatches=true", L"prefetch=false" });
+    auto first = CreateStreamMinibatchInputs<float>(1, 1);
+    auto second = CreateStreamMinibatchInputs<float>(1, 1);
+
+    auto copyValues = [](const Matrix<float>& matrix)
+    {
+        unique_ptr<float[]> values(matrix.CopyToArray());
+        return vector<float>(values.get(), values.get() + matrix.GetNumElements());
+    };
+
+    reader->StartMinibatchLoop(250, 0, first->GetStreamDescriptions(), 1000);
+    BOOST_REQUIRE(reader->GetMinibatch(*first));
+    auto expectedFeatures = copyValues(first->GetInputMatrix<float>(L"features"));
+    auto expectedLabels = copyValues(first->GetInputMatrix<float>(L"labels"));
+
+    BOOST_REQUIRE(reader->GetMinibatch(*second));
+    auto actualFeatures = copyValues(first->GetInputMatrix<float>(L"features"));
+    auto actualLabels = copyValues(first->GetInputMatrix<float>(L"labels"));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(actualFeatures.begin(), actualFeatures.end(), expectedFeatures.begin(), expectedFeatures.end());
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(actualLabels.begin(), actualLabels.end(), expectedLabels.begin(), expectedLabels.end());
+
+    // Make sure the second minibatch was not packed into the buffer of the first one.
+    BOOST_REQUIRE(copyValues(second->GetInputMatrix<float>(L"features")) != expectedFeatures);
 };
 
 BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_Simple_dense_single_stream)
@@ -370,6 +403,7 @@ BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_50x20_jagged_sequences_dense)
 
     test({});
     test({ L"defMBSize=true" });
+    test({ L"zeroCopyMinibatches=true" });
 };
 
 // 1 single sample sequence
@@ -903,6 +937,88 @@ BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_extra_input_should_be_ignored)
     }
 };
 
+// Reports the parsing throughput (in MB/s) on a large input with a dense and a sparse stream,
+// and checks that the parsed values are those that were written.
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_parsing_throughput)
+{
+    vector<StreamDescriptor> streams(2);
+    streams[0].m_alias = "A";
+    streams[0].m_name = L"A";
+    streams[0].m_storageFormat = StorageFormat::Dense;
+    streams[0].m_sampleDimension = 100;
+
+    streams[1].m_alias = "B";
+    streams[1].m_name = L"B";
+    streams[1].m_storageFormat = StorageFormat::SparseCSC;
+    streams[1].m_sampleDimension = 10000;
+
+    const size_t numberOfRows = 10000, nnzPerRow = 20;
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> valueDistribution(-100, 100);
+    std::uniform_int_distribution<size_t> indexDistribution(0, streams[1].m_sampleDimension - 1);
+
+    // A single sequence, so that the parser reports it only once.
+    string filename = "parsing_throughput.txt";
+    vector<float> denseValues, sparseValues;
+    vector<SparseIndexType> sparseIndices;
+    {
+        std::ofstream file(filename, std::ofstream::out | std::ofstream::binary);
+        char buffer[32];
+        auto writeValue = [&](vector<float>& values)
+        {
+            int length = snprintf(buffer, sizeof(buffer), "%.7g", valueDistribution(rng));
+            values.push_back(static_cast<float>(strtod(buffer, nullptr)));
+            file.write(buffer, length);
+        };
+
+        for (size_t row = 0; row < numberOfRows; row++)
+        {
+            file << "0\t|A";
+            for (size_t i = 0; i < streams[0].m_sampleDimension; i++)
+            {
+                file << ' ';
+                writeValue(denseValues);
+            }
+
+            file << "\t|B";
+            for (size_t i = 0; i < nnzPerRow; i++)
+            {
+                sparseIndices.push_back(static_cast<SparseIndexType>(indexDistribution(rng)));
+                file << ' ' << sparseIndices.back() << ':';
+                writeValue(sparseValues);
+            }
+            file << '\n';
+        }
+    }
+
+    double sizeInMB = boost::filesystem::file_size(filename) / (1024.0 * 1024.0);
+    vector<SequenceDataPtr> data;
+    {
+        CNTKTextFormatReaderTestRunner<float> testRunner(filename, streams, 0);
+
+        auto start = std::chrono::steady_clock::now();
+        testRunner.LoadChunk();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        fprintf(stderr, "Parsed %.1f MB of dense and sparse text input at %.1f MB/s.\n", sizeInMB, sizeInMB / elapsed.count());
+
+        testRunner.m_chunk->GetSequence(0, data);
+    }
+    boost::filesystem::remove(filename);
+
+    BOOST_REQUIRE_EQUAL(data.size(), 2);
+    BOOST_REQUIRE_EQUAL(data[0]->m_numberOfSamples, numberOfRows);
+    BOOST_REQUIRE_EQUAL(data[1]->m_numberOfSamples, numberOfRows);
+
+    auto dense = reinterpret_cast<const float*>(data[0]->GetDataBuffer());
+    BOOST_REQUIRE(std::equal(denseValues.begin(), denseValues.end(), dense));
+
+    auto sparse = static_pointer_cast<SparseSequenceData>(data[1]);
+    BOOST_REQUIRE_EQUAL(sparse->m_totalNnzCount, sparseValues.size());
+    BOOST_REQUIRE(std::equal(sparseValues.begin(), sparseValues.end(), reinterpret_cast<const float*>(sparse->GetDataBuffer())));
+    BOOST_REQUIRE(std::equal(sparseIndices.begin(), sparseIndices.end(), sparse->m_indices));
+};
+
 // 100 sequences with N samples for each of 3 inputs, where N is chosen at random
 // from [1, 100] for each sequence
 BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_100x100x3)
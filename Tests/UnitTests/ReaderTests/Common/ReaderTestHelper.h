@@ -482,6 +482,80 @@ struct ReaderFixture
         
     }
 
+    // Helper function to convert the data of the deserializers in the given test section into the CNTK binary format.
+    // configFileName       : the file name for the config file
+    // testSectionName      : the section name of the conversion inside the config file, see CBFConverter
+    void HelperConvertToCBF(
+        const string& configFileName,
+        const string& testSectionName,
+        std::vector<std::wstring> additionalConfigParameters = {})
+    {
+        std::wstring configFileCommand(L"configFile=" + msra::strfun::utf16(configFileName));
+        std::wstring cntk(L"CNTK");
+        std::vector<wchar_t*> arg{ &cntk[0], &configFileCommand[0] };
+        for (auto& p : additionalConfigParameters)
+        {
+            arg.push_back(&p[0]);
+        }
+
+        ConfigParameters config;
+        const std::string rawConfigString = ConfigParameters::ParseCommandLine((int)arg.size(), &arg[0], config);
+        config.ResolveVariables(rawConfigString);
+        const ConfigParameters convertConfig = config(testSectionName);
+
+        typedef void (*ConvertToCBFProc)(const ConfigParameters* config);
+        Plugin plugin;
+        auto convert = (ConvertToCBFProc)plugin.Load(L"CompositeDataReader", "ConvertToCBF");
+        convert(&convertConfig);
+    }
+
+    // Helper function to check that the shards of a file written by the CBF converter together contain
+    // the same data as the reader of the original data. Each shard is read by the worker of the same rank,
+    // one sweep of the shard. The order of the samples differs, so the sorted outputs are compared.
+    // The minibatch size has to be large enough to read a sweep in m_maxMiniBatchCount minibatches.
+    // configFileName       : the file name for the config file
+    // referenceSectionName : the section name of the reader of the original data
+    // shardedSectionName   : the section name of the CNTKBinaryReader of the shards
+    // testDataFilePath     : the file path for writing the minibatch data of the shards, the original data
+    //                        is written to <testDataFilePath>.reference
+    // numShards            : the number of shards, i.e. of workers
+    template <class ElemType>
+    void HelperCheckShardsContainAllData(
+        string configFileName,
+        string referenceSectionName,
+        string shardedSectionName,
+        string testDataFilePath,
+        size_t mbSize,
+        size_t numShards,
+        size_t numFeatureFiles,
+        size_t numLabelFiles,
+        std::vector<std::wstring> additionalConfigParameters = {})
+    {
+        const string referenceFilePath = testDataFilePath + ".reference";
+        HelperReadInAndWriteOut<ElemType>(configFileName, referenceFilePath, referenceSectionName, "reader",
+            requestDataSize, mbSize, 1, numFeatureFiles, numLabelFiles, 0, 1,
+            false, false, true, additionalConfigParameters);
+
+        {
+            ofstream output(testDataFilePath, ios::out);
+            for (size_t shard = 0; shard < numShards; ++shard)
+            {
+                const string shardFilePath = testDataFilePath + "." + std::to_string(shard);
+                HelperReadInAndWriteOut<ElemType>(configFileName, shardFilePath, shardedSectionName, "reader",
+                    requestDataSize, mbSize, 1, numFeatureFiles, numLabelFiles, shard, numShards,
+                    false, false, true, additionalConfigParameters);
+
+                ifstream input(shardFilePath);
+                BOOST_REQUIRE_MESSAGE(input.peek() != ifstream::traits_type::eof(), "Shard " << shard << " is empty");
+                output << input.rdbuf();
+            }
+        }
+
+        SortLinesInFile(referenceFilePath);
+        SortLinesInFile(testDataFilePath);
+        CheckFilesEquivalent(referenceFilePath, testDataFilePath);
+    }
+
     // Helper function to run a Reader test and catch an expected exception.
     // configFileName       : the file name for the config file
     // testSectionName      : the section name for the test inside the config file
@@ -3,6 +3,7 @@
 // Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
 //
 #include "stdafx.h"
+#include <boost/scope_exit.hpp>
 #include "Common/ReaderTestHelper.h"
 #include "CPUMatrix.h"
 
@@ -402,6 +403,60 @@ BOOST_AUTO_TEST_CASE(HTKDeserializersSimpleDataLoop1)
         true);
 };
 
+BOOST_AUTO_TEST_CASE(HTKDeserializersSimpleDataLoop1_concurrent_chunk_loading)
+{
+    // The HTK and MLF chunks are loaded on several threads through the bundler, which must not change the data.
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/HTKDeserializersSimpleDataLoop1_Config.cntk",
+        testDataPath() + "/Control/HTKMLFReaderSimpleDataLoop1_5_11_Control.txt",
+        testDataPath() + "/Control/HTKMLFReaderSimpleDataLoop1_concurrent_Output.txt",
+        "Simple_Test",
+        "reader",
+        500,
+        250,
+        2,
+        1,
+        1,
+        0,
+        1,
+        false,
+        false,
+        true,
+        { L"chunkPrefetchThreads=4", L"chunkPrefetchDepth=4" },
+        true);
+};
+
+// The HTK and MLF data converted into three shards of the CNTK binary format, each worker reads its own shard.
+BOOST_AUTO_TEST_CASE(HTKDeserializersConvertedToShards)
+{
+    // A few utterances, so that the output of a whole sweep stays small.
+    {
+        ifstream scp("glob_0000.scp");
+        ofstream subset("HTKDeserializersSharded.scp");
+        string line;
+        for (size_t i = 0; i < 10 && getline(scp, line); ++i)
+            subset << line << "\n";
+    }
+    BOOST_SCOPE_EXIT(void)
+    {
+        boost::filesystem::remove("HTKDeserializersSharded.scp");
+        for (size_t shard = 0; shard < 3; ++shard)
+            boost::filesystem::remove("HTKDeserializersSharded.bin." + std::to_string(shard));
+    } BOOST_SCOPE_EXIT_END
+
+    HelperConvertToCBF(testDataPath() + "/Config/HTKDeserializersSharded_Config.cntk", "Simple_Convert");
+
+    HelperCheckShardsContainAllData<float>(
+        testDataPath() + "/Config/HTKDeserializersSharded_Config.cntk",
+        "Simple_Test",
+        "Simple_Sharded",
+        testDataPath() + "/Control/HTKDeserializersSharded_Output.txt",
+        10000, // mb size
+        3,     // num shards
+        1,
+        1);
+};
+
 BOOST_AUTO_TEST_CASE(HTKDeserializersSimpleDataLoop5)
 {
     HelperRunReaderTest<float>(
@@ -3,6 +3,8 @@
 // Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
 //
 #include "stdafx.h"
+#include <set>
+#include <boost/scope_exit.hpp>
 #include "Common/ReaderTestHelper.h"
 
 using namespace Microsoft::MSR::CNTK;
@@ -87,6 +89,191 @@ BOOST_AUTO_TEST_CASE(ImageSimpleCompositeAndBase64)
     });
 };
 
+BOOST_AUTO_TEST_CASE(ImageReaderSimpleFusedTransforms)
+{
+    // Crop, scale, mean and transpose fused into a single pass give the same output for the uniformly colored images.
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/ImageReaderSimple_Config.cntk",
+        testDataPath() + "/Control/ImageReaderSimple_Control.txt",
+        testDataPath() + "/Control/ImageReaderSimpleFused_Output.txt",
+        "Simple_Test",
+        "reader",
+        4,
+        4,
+        1,
+        1,
+        0,
+        0,
+        1,
+        false,
+        false,
+        true,
+        { L"FuseTransforms=true" });
+
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/ImageReaderSimple_Config.cntk",
+        testDataPath() + "/Control/ImageSimpleCompositeAndBase64_Control.txt",
+        testDataPath() + "/Control/ImageSimpleCompositeFused_Output.txt",
+        "Composite_Test",
+        "reader",
+        4,
+        4,
+        1,
+        1,
+        1,
+        0,
+        1,
+        false,
+        true,
+        true,
+        { L"FuseTransforms=true" });
+
+    // For images with gradients and a mean image that varies by pixel and channel, the fused transformer only differs
+    // from the separate ones in the rounding of the scaled pixels to uchar, which the fused one skips.
+    auto read = [this](bool fuse, const std::string& outputFile)
+    {
+        HelperReadInAndWriteOut<float>(
+            testDataPath() + "/Config/ImageReaderSimple_Config.cntk",
+            testDataPath() + "/Control/" + outputFile,
+            "Composite_Test",
+            "reader",
+            3,
+            3,
+            1,
+            1,
+            1,
+            0,
+            1,
+            false,
+            true,
+            true,
+            {
+                L"MapFile=\"$RootDir$/ImageReaderReducedDecoding_map.txt\"",
+                L"MeanFile=\"$RootDir$/ImageReaderFused_mean.xml\"",
+                fuse ? L"FuseTransforms=true" : L"FuseTransforms=false"
+            });
+
+        std::ifstream stream(testDataPath() + "/Control/" + outputFile);
+        return std::vector<double>{ std::istream_iterator<double>(stream), std::istream_iterator<double>() };
+    };
+
+    const auto separate = read(false, "ImageReaderGradientMean_Output.txt");
+    const auto fused = read(true, "ImageReaderGradientMeanFused_Output.txt");
+    BOOST_REQUIRE_EQUAL(separate.size(), fused.size());
+    BOOST_REQUIRE_GT(std::set<double>(separate.begin(), separate.end()).size(), separate.size() / 2);
+
+    for (size_t i = 0; i < separate.size(); ++i)
+        BOOST_REQUIRE_SMALL(fused[i] - separate[i], 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(ImageSimpleCompositeDecodedImageCache)
+{
+    // The first run builds the cache of decoded images, the second one reads them from the memory mapped cache.
+    const std::string cacheFile = "ImageSimpleComposite_DecodedImageCache.bin";
+    boost::filesystem::remove(cacheFile);
+
+    for (size_t run = 0; run < 2; ++run)
+    {
+        HelperRunReaderTest<float>(
+            testDataPath() + "/Config/ImageReaderSimple_Config.cntk",
+            testDataPath() + "/Control/ImageSimpleCompositeAndBase64_Control.txt",
+            testDataPath() + "/Control/ImageSimpleCompositeDecodedImageCache_Output.txt",
+            "Composite_Test",
+            "reader",
+            4,
+            4,
+            1,
+            1,
+            1,
+            0,
+            1,
+            false,
+            true,
+            true,
+            { L"ReducedDecoding=true", L"DecodedImageCache=" + std::wstring(cacheFile.begin(), cacheFile.end()) });
+
+        BOOST_REQUIRE(boost::filesystem::exists(cacheFile));
+    }
+
+    boost::filesystem::remove(cacheFile);
+}
+
+BOOST_AUTO_TEST_CASE(ImageReducedDecodingAndDecodedImageCache)
+{
+    // The shorter sides of the images are 64, 40 and 24 pixels and the images are scaled to 4x8,
+    // so they are decoded reduced by 8, 4 and 2 respectively.
+    const std::string cacheFile = "ImageReducedDecoding_DecodedImageCache.bin";
+    boost::filesystem::remove(cacheFile);
+    BOOST_SCOPE_EXIT(&cacheFile) { boost::filesystem::remove(cacheFile); } BOOST_SCOPE_EXIT_END
+
+    auto read = [this](bool reducedDecoding, const std::string& cache, size_t epochSize, const std::string& outputFile)
+    {
+        HelperReadInAndWriteOut<float>(
+            testDataPath() + "/Config/ImageReaderSimple_Config.cntk",
+            testDataPath() + "/Control/" + outputFile,
+            "Composite_Test",
+            "reader",
+            epochSize,
+            3,
+            1,
+            1,
+            1,
+            0,
+            1,
+            false,
+            true,
+            true,
+            {
+                L"MapFile=\"$RootDir$/ImageReaderReducedDecoding_map.txt\"",
+                reducedDecoding ? L"ReducedDecoding=true" : L"ReducedDecoding=false",
+                L"DecodedImageCache=" + std::wstring(cache.begin(), cache.end())
+            });
+        return testDataPath() + "/Control/" + outputFile;
+    };
+
+    // Number of images in the cache file, see DecodedImageCache.
+    auto numberOfCachedImages = [&cacheFile]()
+    {
+        std::ifstream file(cacheFile, std::ios::binary);
+        file.seekg(24);
+        uint64_t numberOfImages = 0;
+        file.read((char*)&numberOfImages, sizeof(numberOfImages));
+        return numberOfImages;
+    };
+
+    const auto full = read(false, "", 3, "ImageReducedDecoding_Full_Output.txt");
+    const auto reduced = read(true, "", 3, "ImageReducedDecoding_Output.txt");
+
+    // The reduced images are scaled to almost the same pixels, but not exactly, otherwise the reduction has not been used.
+    {
+        std::ifstream fullStream(full), reducedStream(reduced);
+        std::vector<double> fullValues{ std::istream_iterator<double>(fullStream), std::istream_iterator<double>() };
+        std::vector<double> reducedValues{ std::istream_iterator<double>(reducedStream), std::istream_iterator<double>() };
+        BOOST_REQUIRE_EQUAL(fullValues.size(), reducedValues.size());
+        BOOST_REQUIRE(!fullValues.empty());
+
+        double maxDifference = 0;
+        for (size_t i = 0; i < fullValues.size(); ++i)
+            maxDifference = std::max(maxDifference, std::abs(fullValues[i] - reducedValues[i]));
+        BOOST_REQUIRE_GT(maxDifference, 0);
+        BOOST_REQUIRE_LE(maxDifference, 24);
+    }
+
+    // A run that stops after the first image leaves a partial cache, which the next run extends.
+    read(true, cacheFile, 1, "ImageReducedDecoding_Partial_Output.txt");
+    BOOST_REQUIRE(boost::filesystem::exists(cacheFile));
+    BOOST_REQUIRE_GE(numberOfCachedImages(), 1);
+    BOOST_REQUIRE_LT(numberOfCachedImages(), 3);
+
+    // The extending run serves the cached image from the mapped partial cache, the last run reads all images from the cache.
+    for (size_t run = 0; run < 2; ++run)
+    {
+        const auto cached = read(true, cacheFile, 3, "ImageReducedDecoding_Cached_Output.txt");
+        BOOST_REQUIRE_EQUAL(numberOfCachedImages(), 3);
+        CheckFilesEquivalent(reduced, cached);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(InvalidImageSimpleCompositeAndBase64)
 {
     auto test = [this](std::vector<std::wstring> additionalParameters)
@@ -217,6 +404,31 @@ BOOST_AUTO_TEST_CASE(ImageAndImageReaderSimple)
           L"SecondMapFile=\"$RootDir$/ImageReaderSimple_map.txt\"" });
 }
 
+BOOST_AUTO_TEST_CASE(ImageAndImageReaderSimple_concurrent_chunk_loading)
+{
+    // The chunks of both image deserializers are loaded on several threads through the bundler.
+    HelperRunReaderTest<float>(
+        testDataPath() + "/Config/ImageDeserializers.cntk",
+        testDataPath() + "/Control/ImageAndImageReaderSimple_Control.txt",
+        testDataPath() + "/Control/ImageAndImageReaderSimple_concurrent_Output.txt",
+        "ImageAndImageReaderSimple_Test",
+        "reader",
+        4,
+        4,
+        1,
+        2,
+        2,
+        0,
+        1,
+        false,
+        false,
+        true,
+        { L"MapFile=\"$RootDir$/ImageReaderSimple_map.txt\"",
+          L"SecondMapFile=\"$RootDir$/ImageReaderSimple_map.txt\"",
+          L"chunkPrefetchThreads=4",
+          L"chunkPrefetchDepth=4" });
+}
+
 BOOST_AUTO_TEST_CASE(ImageReaderBadMap)
 {
     BOOST_REQUIRE_EXCEPTION(
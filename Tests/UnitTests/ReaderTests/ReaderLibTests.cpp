@@ -9,7 +9,9 @@
 #include <set>
 #include "NoRandomizer.h"
 #include "LTNoRandomizer.h"
+#include "LTTumblingWindowRandomizer.h"
 #include "DataDeserializer.h"
+#include "DataDeserializerBase.h"
 #include "BlockRandomizer.h"
 #include "CorpusDescriptor.h"
 #include "FramePacker.h"
@@ -18,6 +20,10 @@
 #include "CudaMemoryProvider.h"
 #include "HeapMemoryProvider.h"
 #include "BufferedFileReader.h"
+#include "FileWrapper.h"
+#include "ChunkCache.h"
+#include "Bundler.h"
+#include "LZCompression.h"
 
 #pragma warning(push)
 // disable warning about possible mod 0 operation in uniform_int_distribution
@@ -85,21 +91,21 @@ public:
     ~MockChunk() override {};
 };
 
-class MockDeserializer : public DataDeserializer
+class MockDeserializer : public DataDeserializerBase
 {
 private:
     uint32_t m_sequenceLength;
     size_t m_numChunks;
     size_t m_numSequencesPerChunk;
     vector<SequenceInfo> m_descriptions;
-    vector<StreamInformation> m_streams;
     NDShape m_sampleShape;
     vector<ChunkInfo> m_chunkDescriptions;
     vector<vector<float>> m_sequenceData;
 
 public:
     MockDeserializer(size_t numChunks, size_t numSequencesPerChunks, const vector<float>& data, uint32_t sequenceLength = 1)
-        : m_numChunks(numChunks),
+        : DataDeserializerBase(true),
+          m_numChunks(numChunks),
           m_numSequencesPerChunk(numSequencesPerChunks),
           m_sampleShape(NDShape(1)),
           m_sequenceLength(sequenceLength)
@@ -142,11 +148,6 @@ public:
         m_streams.push_back(si);
     };
 
-    vector<StreamInformation> StreamInfos() override
-    {
-        return m_streams;
-    }
-
     virtual ChunkPtr GetChunk(ChunkIdType chunkId) override
     {
         assert(chunkId < m_numChunks);
@@ -161,6 +162,11 @@ public:
         throw logic_error("Not implemented");
     }
 
+    virtual bool SupportsConcurrentGetChunk() const override
+    {
+        return true;
+    }
+
     virtual std::vector<ChunkInfo> ChunkInfos() override
     {
         return m_chunkDescriptions;
@@ -863,6 +869,387 @@ BOOST_AUTO_TEST_CASE(RandomizerChaosMonkey)
     RandomizerChaosMonkeyTest(norandomizer, sweepSize, 44);
 }
 
+BOOST_AUTO_TEST_CASE(BlockRandomizerPrefetchWindow)
+{
+    const size_t chunkSizeInSamples = 100;
+    const size_t sweepNumberOfSamples = 5000;
+    const size_t randomizationWindow = chunkSizeInSamples * 5;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, 5);
+    size_t numberOfChunks = deserializer->ChunkInfos().size();
+
+    auto expected = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true, false);
+
+    // Deep prefetch on several threads, unbounded and with a budget of about two chunks.
+    ChunkPrefetchConfig config;
+    config.m_depth = 8;
+    config.m_numberOfThreads = 4;
+    auto unbounded = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true, false, 0, true, 0, config);
+    config.m_maxSizeInBytes = 2 * chunkSizeInSamples * sizeof(float) + 1;
+    auto bounded = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true, false, 0, true, 0, config);
+
+    for (size_t sweep = 0; sweep < 3; ++sweep)
+    {
+        auto expectedSweep = ReadFullSweep(expected, sweep, sweepNumberOfSamples);
+        auto unboundedSweep = ReadFullSweep(unbounded, sweep, sweepNumberOfSamples);
+        auto boundedSweep = ReadFullSweep(bounded, sweep, sweepNumberOfSamples);
+        BOOST_REQUIRE(unboundedSweep == expectedSweep);
+        BOOST_REQUIRE(boundedSweep == expectedSweep);
+    }
+
+    for (auto randomizer : { expected, unbounded, bounded })
+    {
+        const auto& statistics = randomizer->GetChunkLoadStatistics();
+        BOOST_REQUIRE(statistics.m_numberOfChunks >= 3 * numberOfChunks);
+        BOOST_REQUIRE(statistics.m_numberOfPrefetchedChunks > 0);
+        BOOST_REQUIRE(statistics.m_numberOfPrefetchedChunks < statistics.m_numberOfChunks);
+        BOOST_REQUIRE(statistics.m_maxLoadTimeInSeconds <= statistics.m_totalLoadTimeInSeconds);
+    }
+
+    // Stale prefetches are dropped when the worker configuration changes.
+    vector<float> data(1000);
+    iota(data.begin(), data.end(), 0.0f);
+    auto mockDeserializer = make_shared<MockDeserializer>(100, 10, data, 3);
+    BlockRandomizer chaos(0, 18, mockDeserializer, true, false, 0, true, 0, config);
+    RandomizerChaosMonkeyTest(chaos, data.size() * 3, 45);
+}
+
+// Forwards to another deserializer and records the chunks it is told about in advance and the chunks it loads.
+class ReadAheadRecordingDeserializer : public DataDeserializerBase
+{
+public:
+    ReadAheadRecordingDeserializer(DataDeserializerPtr deserializer) : DataDeserializerBase(true), m_deserializer(deserializer)
+    {}
+
+    std::vector<StreamInformation> StreamInfos() override { return m_deserializer->StreamInfos(); }
+    std::vector<ChunkInfo> ChunkInfos() override { return m_deserializer->ChunkInfos(); }
+    void SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& result) override { m_deserializer->SequenceInfosForChunk(chunkId, result); }
+    bool GetSequenceInfo(const SequenceInfo& primary, SequenceInfo& result) override { return m_deserializer->GetSequenceInfo(primary, result); }
+
+    ChunkPtr GetChunk(ChunkIdType chunkId) override
+    {
+        m_loaded.push_back(chunkId);
+        return m_deserializer->GetChunk(chunkId);
+    }
+
+    void HintUpcomingChunks(const std::vector<ChunkIdType>& chunkIds) override
+    {
+        m_hinted.insert(m_hinted.end(), chunkIds.begin(), chunkIds.end());
+        m_numberOfLoadedAtHint.insert(m_numberOfLoadedAtHint.end(), chunkIds.size(), m_loaded.size());
+    }
+
+    void Clear()
+    {
+        m_hinted.clear();
+        m_loaded.clear();
+        m_numberOfLoadedAtHint.clear();
+    }
+
+    vector<ChunkIdType> m_hinted;
+    vector<ChunkIdType> m_loaded;
+    vector<size_t> m_numberOfLoadedAtHint;
+
+private:
+    DataDeserializerPtr m_deserializer;
+};
+
+BOOST_AUTO_TEST_CASE(BlockRandomizerReadAhead)
+{
+    const size_t chunkSizeInSamples = 100;
+    const size_t sweepNumberOfSamples = 2000;
+    const size_t randomizationWindow = chunkSizeInSamples * 3;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, 5);
+    size_t numberOfChunks = deserializer->ChunkInfos().size();
+
+    // Chunks are loaded on the calling thread, in the order the randomizer needs them.
+    auto expected = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, false, false);
+    auto recording = make_shared<ReadAheadRecordingDeserializer>(deserializer);
+    ChunkPrefetchConfig config;
+    config.m_readAheadDepth = 2;
+    auto readAhead = make_shared<BlockRandomizer>(0, randomizationWindow, recording, false, false, 0, true, 0, config);
+
+    for (size_t sweep = 0; sweep < 2; ++sweep)
+    {
+        recording->Clear();
+        BOOST_REQUIRE(ReadFullSweep(readAhead, sweep, sweepNumberOfSamples) == ReadFullSweep(expected, sweep, sweepNumberOfSamples));
+
+        // Every chunk past the first window is hinted once, before it is loaded.
+        BOOST_REQUIRE(recording->m_hinted.size() >= numberOfChunks / 2);
+        BOOST_REQUIRE_EQUAL(set<ChunkIdType>(recording->m_hinted.begin(), recording->m_hinted.end()).size(), recording->m_hinted.size());
+        for (size_t i = 0; i < recording->m_hinted.size(); ++i)
+        {
+            auto firstLoad = find(recording->m_loaded.begin(), recording->m_loaded.end(), recording->m_hinted[i]);
+            BOOST_REQUIRE(firstLoad != recording->m_loaded.end());
+            BOOST_REQUIRE((size_t)(firstLoad - recording->m_loaded.begin()) >= recording->m_numberOfLoadedAtHint[i]);
+        }
+    }
+
+    // Without a read ahead depth the deserializer is not told anything.
+    recording->Clear();
+    auto noReadAhead = make_shared<BlockRandomizer>(0, randomizationWindow, recording, false, false);
+    ReadFullSweep(noReadAhead, 0, sweepNumberOfSamples);
+    BOOST_REQUIRE(recording->m_hinted.empty());
+}
+
+BOOST_AUTO_TEST_CASE(BlockRandomizerRejectsConcurrentLoadingOfUnsupportedDeserializer)
+{
+    auto deserializer = make_shared<SequentialDeserializer>(0, 100, 1000, 5);
+    auto recording = make_shared<ReadAheadRecordingDeserializer>(deserializer);
+    ChunkPrefetchConfig config;
+    config.m_numberOfThreads = 2;
+
+    // The recording deserializer does not support concurrent GetChunk calls.
+    BOOST_REQUIRE_THROW(BlockRandomizer(0, 300, recording, true, false, 0, true, 0, config), std::invalid_argument);
+    BlockRandomizer(0, 300, deserializer, true, false, 0, true, 0, config);
+
+    // Without prefetch the chunks are loaded on the calling thread, so the number of threads does not matter.
+    BlockRandomizer(0, 300, recording, false, false, 0, true, 0, config);
+}
+
+// A sequential deserializer that finds its sequences by the key of the primary one, so that it can be bundled.
+class KeyedSequentialDeserializer : public SequentialDeserializer
+{
+public:
+    KeyedSequentialDeserializer(size_t seed, size_t chunkSizeInSamples, size_t sweepNumberOfSamples, uint32_t maxSequenceLength)
+        : SequentialDeserializer(seed, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength)
+    {}
+
+    bool GetSequenceInfo(const SequenceInfo& primary, SequenceInfo& result) override
+    {
+        auto found = Corpus().find(primary.m_key.m_sequence);
+        if (found == Corpus().end())
+            return false;
+
+        const auto& info = found->second;
+        result = SequenceInfo{ info.id, (uint32_t)info.size, (ChunkIdType)info.chunkId, primary.m_key };
+        return true;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(BlockRandomizerLoadsChunksConcurrentlyThroughBundlerAndChunkCache)
+{
+    const size_t chunkSizeInSamples = 100;
+    const size_t sweepNumberOfSamples = 3000;
+    const size_t randomizationWindow = chunkSizeInSamples * 5;
+    auto primary = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, 5);
+    auto secondary = make_shared<KeyedSequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, 5);
+    auto corpus = make_shared<CorpusDescriptor>(true);
+    ConfigParameters readerConfig;
+
+    auto bundler = make_shared<Bundler>(readerConfig, corpus, primary, vector<DataDeserializerPtr>{ primary, secondary }, false);
+    auto cache = make_shared<ChunkCache>(bundler);
+    BOOST_REQUIRE(bundler->SupportsConcurrentGetChunk());
+    BOOST_REQUIRE(cache->SupportsConcurrentGetChunk());
+
+    ChunkPrefetchConfig config;
+    config.m_depth = 8;
+    config.m_numberOfThreads = 4;
+    auto expected = make_shared<BlockRandomizer>(0, randomizationWindow, primary, true, false);
+    auto bundled = make_shared<BlockRandomizer>(0, randomizationWindow, bundler, true, false, 0, true, 0, config);
+    auto cached = make_shared<BlockRandomizer>(0, randomizationWindow, cache, true, false, 0, true, 0, config);
+
+    // Reads the values of all streams of a sweep.
+    auto readSweep = [](const shared_ptr<BlockRandomizer>& randomizer, size_t sweep, size_t numberOfStreams)
+    {
+        EpochConfiguration epochConfig;
+        epochConfig.m_numberOfWorkers = 1;
+        epochConfig.m_workerRank = 0;
+        epochConfig.m_minibatchSizeInSamples = 1;
+        epochConfig.m_totalEpochSizeInSamples = ((size_t)-1) >> 2;
+        epochConfig.m_epochIndex = sweep;
+        randomizer->StartEpoch(epochConfig);
+
+        vector<vector<float>> values(numberOfStreams);
+        Sequences sequences;
+        do
+        {
+            sequences = randomizer->GetNextSequences(1, 1);
+            for (size_t stream = 0; stream < sequences.m_data.size(); ++stream)
+            {
+                BOOST_REQUIRE(stream < numberOfStreams);
+                for (const auto& s : sequences.m_data[stream])
+                {
+                    auto data = (const float*)s->GetDataBuffer();
+                    values[stream].insert(values[stream].end(), data, data + s->m_numberOfSamples);
+                }
+            }
+        } while (!sequences.m_endOfEpoch);
+        return values;
+    };
+
+    for (size_t sweep = 0; sweep < 3; ++sweep)
+    {
+        auto expectedSweep = readSweep(expected, sweep, 1).front();
+        BOOST_REQUIRE(CheckFullSweep(sweepNumberOfSamples, expectedSweep));
+        for (const auto& randomizer : { bundled, cached })
+        {
+            auto actualSweep = readSweep(randomizer, sweep, 2);
+            BOOST_REQUIRE(actualSweep[0] == expectedSweep);
+            BOOST_REQUIRE(actualSweep[1] == expectedSweep);
+        }
+    }
+
+    // A single deserializer without support for concurrent loading disables it for the bundle and the cache around it.
+    auto recording = make_shared<ReadAheadRecordingDeserializer>(secondary);
+    auto partlySupported = make_shared<Bundler>(readerConfig, corpus, primary, vector<DataDeserializerPtr>{ primary, recording }, false);
+    BOOST_REQUIRE(!partlySupported->SupportsConcurrentGetChunk());
+    BOOST_REQUIRE(!make_shared<ChunkCache>(partlySupported)->SupportsConcurrentGetChunk());
+    BOOST_REQUIRE_THROW(BlockRandomizer(0, randomizationWindow, partlySupported, true, false, 0, true, 0, config), std::invalid_argument);
+}
+
+// Reads a sweep on every worker, returns the original chunks every worker has read from.
+static vector<set<size_t>> ReadSweepOnWorkers(vector<shared_ptr<BlockRandomizer>>& workers, size_t sweep, size_t sweepSize, size_t sequencesPerChunk)
+{
+    vector<set<size_t>> chunks(workers.size());
+    set<float> values;
+    for (size_t rank = 0; rank < workers.size(); ++rank)
+    {
+        EpochConfiguration config;
+        config.m_numberOfWorkers = workers.size();
+        config.m_workerRank = rank;
+        config.m_minibatchSizeInSamples = sequencesPerChunk;
+        config.m_totalEpochSizeInSamples = sweepSize;
+        config.m_epochIndex = sweep;
+        workers[rank]->StartEpoch(config);
+
+        Sequences sequences;
+        do
+        {
+            sequences = workers[rank]->GetNextSequences(sequencesPerChunk, sequencesPerChunk);
+            for (const auto& s : sequences.m_data.empty() ? vector<SequenceDataPtr>() : sequences.m_data[0])
+            {
+                float value = *(const float*)s->GetDataBuffer();
+                BOOST_REQUIRE(values.insert(value).second);
+                chunks[rank].insert((size_t)value / sequencesPerChunk);
+            }
+        } while (!sequences.m_endOfEpoch);
+    }
+
+    // Every sequence of the sweep is read by exactly one worker.
+    BOOST_REQUIRE_EQUAL(values.size(), sweepSize);
+    return chunks;
+}
+
+BOOST_AUTO_TEST_CASE(BlockRandomizerChunkAffinity)
+{
+    const size_t numberOfChunks = 10, sequencesPerChunk = 10, numberOfWorkers = 2;
+    vector<float> data(numberOfChunks * sequencesPerChunk);
+    iota(data.begin(), data.end(), 0.0f);
+    auto deserializer = make_shared<MockDeserializer>(numberOfChunks, sequencesPerChunk, data);
+
+    auto createWorkers = [&](double reshuffleFraction)
+    {
+        ChunkAffinityConfig affinity;
+        affinity.m_enabled = true;
+        affinity.m_reshuffleFraction = reshuffleFraction;
+        vector<shared_ptr<BlockRandomizer>> workers;
+        for (size_t i = 0; i < numberOfWorkers; ++i)
+            workers.push_back(make_shared<BlockRandomizer>(0, 2 * sequencesPerChunk, deserializer, true, false, 0, true, 0, ChunkPrefetchConfig(), affinity));
+        return workers;
+    };
+
+    // Without reshuffling every worker reads the same contiguous range of chunks in every sweep.
+    auto workers = createWorkers(0);
+    for (size_t sweep = 0; sweep < 4; ++sweep)
+    {
+        auto chunks = ReadSweepOnWorkers(workers, sweep, data.size(), sequencesPerChunk);
+        BOOST_CHECK(chunks[0] == set<size_t>({ 0, 1, 2, 3, 4 }));
+        BOOST_CHECK(chunks[1] == set<size_t>({ 5, 6, 7, 8, 9 }));
+    }
+
+    // With reshuffling the shards keep their sizes, but change between the sweeps.
+    workers = createWorkers(0.4);
+    bool changed = false;
+    for (size_t sweep = 0; sweep < 4; ++sweep)
+    {
+        auto chunks = ReadSweepOnWorkers(workers, sweep, data.size(), sequencesPerChunk);
+        BOOST_CHECK_EQUAL(chunks[0].size(), numberOfChunks / numberOfWorkers);
+        BOOST_CHECK_EQUAL(chunks[1].size(), numberOfChunks / numberOfWorkers);
+        changed |= chunks[0] != set<size_t>({ 0, 1, 2, 3, 4 });
+    }
+    BOOST_CHECK(changed);
+}
+
+BOOST_AUTO_TEST_CASE(LTTumblingWindowRandomizerChunkAffinityWithChangingNumberOfWorkers)
+{
+    const size_t numberOfChunks = 12, sequencesPerChunk = 5, numberOfWorkers = 3, numberOfSweeps = 4;
+    vector<float> data(numberOfChunks * sequencesPerChunk);
+    iota(data.begin(), data.end(), 0.0f);
+
+    ChunkAffinityConfig affinity;
+    affinity.m_enabled = true;
+
+    // Every worker starts alone, as when distributed reading starts after some samples,
+    // and switches to its rank in the middle of the first sweep.
+    vector<vector<vector<float>>> values(numberOfSweeps, vector<vector<float>>(numberOfWorkers));
+    for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+    {
+        auto deserializer = make_shared<MockDeserializer>(numberOfChunks, sequencesPerChunk, data);
+        auto randomizer = make_shared<LTTumblingWindowRandomizer>(deserializer, false, 2, 0, false, 0, affinity);
+
+        EpochConfiguration config;
+        config.m_numberOfWorkers = 1;
+        config.m_workerRank = 0;
+        config.m_minibatchSizeInSamples = 1;
+        config.m_totalEpochSizeInSamples = data.size() * numberOfSweeps;
+        config.m_totalEpochSizeInSweeps = numberOfSweeps;
+        config.m_epochIndex = 0;
+        randomizer->StartEpoch(config);
+
+        size_t sweep = 0;
+        Sequences sequences;
+        for (size_t i = 0; !sequences.m_endOfEpoch; ++i)
+        {
+            if (i == data.size() / 2)
+            {
+                config.m_numberOfWorkers = numberOfWorkers;
+                config.m_workerRank = rank;
+                randomizer->SetConfiguration(config);
+            }
+
+            sequences = randomizer->GetNextSequences(1, 1);
+            if (sequences.m_endOfSweep)
+                sweep++;
+            for (const auto& s : sequences.m_data.empty() ? vector<SequenceDataPtr>() : sequences.m_data[0])
+            {
+                BOOST_REQUIRE_LT(sweep, numberOfSweeps);
+                values[sweep][rank].push_back(*(const float*)s->GetDataBuffer());
+            }
+        }
+    }
+
+    // The windows read before the switch are read by all workers, but the chunks of the
+    // rest of the sweep are not randomized again, so none of them is skipped or read twice by a worker.
+    set<float> firstSweep;
+    for (const auto& workerValues : values[0])
+    {
+        BOOST_REQUIRE_EQUAL(set<float>(workerValues.begin(), workerValues.end()).size(), workerValues.size());
+        firstSweep.insert(workerValues.begin(), workerValues.end());
+    }
+    BOOST_REQUIRE_EQUAL(firstSweep.size(), data.size());
+
+    // From the next sweep on every sequence is read by exactly one worker, which keeps its range of the chunks.
+    const size_t chunksPerWorker = numberOfChunks / numberOfWorkers;
+    for (size_t sweep = 1; sweep < numberOfSweeps; ++sweep)
+    {
+        set<float> sweepValues;
+        for (size_t rank = 0; rank < numberOfWorkers; ++rank)
+        {
+            set<size_t> chunks;
+            for (float value : values[sweep][rank])
+            {
+                BOOST_REQUIRE(sweepValues.insert(value).second);
+                chunks.insert((size_t)value / sequencesPerChunk);
+            }
+
+            set<size_t> expected;
+            for (size_t chunk = rank * chunksPerWorker; chunk < (rank + 1) * chunksPerWorker; ++chunk)
+                expected.insert(chunk);
+            BOOST_CHECK(chunks == expected);
+        }
+        BOOST_REQUIRE_EQUAL(sweepValues.size(), data.size());
+    }
+}
+
 void BlockRandomizerOneEpochLegacyRandomizationTest(bool prefetch)
 {
     vector<float> data(10);
@@ -1305,6 +1692,146 @@ BOOST_AUTO_TEST_CASE(CheckNoDegenerateMinibatches)
     }
 }
 
+static vector<float> ReadChunkValues(DataDeserializerPtr deserializer, ChunkIdType chunkId)
+{
+    vector<SequenceInfo> infos;
+    deserializer->SequenceInfosForChunk(chunkId, infos);
+    auto chunk = deserializer->GetChunk(chunkId);
+
+    vector<float> values;
+    vector<SequenceDataPtr> sequences;
+    for (const auto& info : infos)
+    {
+        sequences.clear();
+        chunk->GetSequence(info.m_indexInChunk, sequences);
+        BOOST_REQUIRE_EQUAL(sequences.size(), 1);
+        BOOST_REQUIRE_EQUAL(sequences[0]->m_numberOfSamples, info.m_numberOfSamples);
+        const float* data = (const float*)sequences[0]->GetDataBuffer();
+        values.insert(values.end(), data, data + sequences[0]->m_numberOfSamples);
+    }
+    return values;
+}
+
+BOOST_AUTO_TEST_CASE(LZCompressionRoundTrip)
+{
+    std::mt19937 rng(0);
+    for (size_t size : { 0, 1, 17, 4096, 100000 })
+    {
+        // Runs of repeated bytes mixed with random ones.
+        vector<char> data(size);
+        for (size_t i = 0; i < size; ++i)
+            data[i] = (i > 16 && rng() % 4 != 0) ? data[i - 1 - rng() % 16] : (char)rng();
+
+        vector<char> compressed;
+        LZCompress(data.data(), data.size(), compressed);
+        BOOST_REQUIRE(compressed.size() <= size + size / 255 + 16);
+
+        vector<char> decompressed(size);
+        LZDecompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+        BOOST_REQUIRE(data == decompressed);
+
+        if (size > 1)
+            BOOST_REQUIRE_THROW(LZDecompress(compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size()), std::runtime_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(FileWrapperPositionalReads)
+{
+    const wstring filename = L"FileWrapperPositionalReads.bin";
+    const size_t fileSize = 10000;
+    vector<char> content(fileSize);
+    std::mt19937 rng(0);
+    for (auto& c : content)
+        c = (char)rng();
+    {
+        auto file = FileWrapper::OpenOrDie(filename, L"wb");
+        file.WriteOrDie(content.data(), 1, content.size());
+    }
+
+    {
+        auto file = FileWrapper::OpenOrDie(filename, L"rb");
+        file.AdviseWillNeed(0, fileSize);
+
+        // Positional reads give the same bytes as seeking and reading sequentially.
+        for (auto range : vector<pair<size_t, size_t>>{ { 0, 1 }, { 0, fileSize }, { 1, 4095 }, { 4095, 2 }, { 5000, 3000 }, { fileSize - 1, 1 } })
+        {
+            vector<char> positional(range.second), sequential(range.second);
+            BOOST_REQUIRE_EQUAL(file.ReadAt(positional.data(), positional.size(), range.first), range.second);
+            file.SeekOrDie(range.first, SEEK_SET);
+            file.ReadOrDie(sequential.data(), 1, sequential.size());
+            BOOST_REQUIRE(positional == sequential);
+            BOOST_REQUIRE(equal(positional.begin(), positional.end(), content.begin() + range.first));
+        }
+
+        // A read crossing the end of the file returns the bytes that are there, and is reported as end of file.
+        vector<char> buffer(100);
+        BOOST_REQUIRE_EQUAL(file.ReadAt(buffer.data(), buffer.size(), fileSize - 10), 10u);
+        BOOST_REQUIRE(equal(buffer.begin(), buffer.begin() + 10, content.end() - 10));
+        BOOST_REQUIRE_EQUAL(file.ReadAt(buffer.data(), buffer.size(), fileSize), 0u);
+        BOOST_REQUIRE(!file.TryReadAt(buffer.data(), buffer.size(), fileSize - 10));
+        BOOST_REQUIRE(file.TryReadAt(buffer.data(), 10, fileSize - 10));
+        try
+        {
+            file.ReadAtOrDie(buffer.data(), buffer.size(), fileSize - 10);
+            BOOST_FAIL("ReadAtOrDie did not fail at the end of the file.");
+        }
+        catch (const std::runtime_error& e)
+        {
+            BOOST_REQUIRE(string(e.what()).find("Unexpected end of file") != string::npos);
+        }
+    }
+    _wunlink(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(ChunkCacheBoundedAndSpilled)
+{
+    const size_t sweepSize = 2000;
+    const size_t numberOfSweeps = 4;
+    auto deserializer = make_shared<SequentialDeserializer>(0, 100, sweepSize, 5);
+    size_t numberOfChunks = deserializer->ChunkInfos().size();
+
+    // Size of all chunks, serialized and compressed.
+    ChunkCacheConfig config;
+    config.m_compress = true;
+    auto unbounded = make_shared<ChunkCache>(deserializer, config);
+    for (ChunkIdType i = 0; i < numberOfChunks; ++i)
+        ReadChunkValues(unbounded, i);
+    size_t totalSize = unbounded->GetSizeInBytes();
+    BOOST_REQUIRE_EQUAL(unbounded->GetNumberOfMisses(), numberOfChunks);
+
+    // Caches that fit about a third of the chunks.
+    config.m_maxSizeInBytes = totalSize / 3;
+    auto dropping = make_shared<ChunkCache>(deserializer, config);
+    config.m_spillDirectory = L".";
+    auto spilling = make_shared<ChunkCache>(deserializer, config);
+
+    std::mt19937 rng(0);
+    vector<ChunkIdType> chunkIds(numberOfChunks);
+    std::iota(chunkIds.begin(), chunkIds.end(), 0);
+    for (size_t sweep = 0; sweep < numberOfSweeps; ++sweep)
+    {
+        std::shuffle(chunkIds.begin(), chunkIds.end(), rng);
+        for (auto chunkId : chunkIds)
+        {
+            auto expected = ReadChunkValues(deserializer, chunkId);
+            BOOST_REQUIRE(ReadChunkValues(dropping, chunkId) == expected);
+            BOOST_REQUIRE(ReadChunkValues(spilling, chunkId) == expected);
+            BOOST_REQUIRE(dropping->GetSizeInBytes() <= config.m_maxSizeInBytes);
+            BOOST_REQUIRE(spilling->GetSizeInBytes() <= config.m_maxSizeInBytes);
+        }
+    }
+
+    // Chunks are deserialized only once when spilled; otherwise the cache still serves a part of every sweep
+    // in spite of the sweep being larger than the cache.
+    BOOST_REQUIRE_EQUAL(spilling->GetNumberOfMisses(), numberOfChunks);
+    BOOST_REQUIRE(dropping->GetNumberOfMisses() < numberOfSweeps * numberOfChunks - (numberOfSweeps - 1) * numberOfChunks / 6);
+
+    // The randomizer gets all samples of every sweep from the cache.
+    auto randomizer = make_shared<BlockRandomizer>(0, 3, spilling, false);
+    for (size_t sweep = 0; sweep < 2; ++sweep)
+        ReadFullSweep(randomizer, sweep, sweepSize);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(PackerTests)
@@ -4,12 +4,14 @@
 //
 
 #include <chrono>
+#include <random>
 #include "stdafx.h"
 #include "BufferedFileReader.h"
 #include "FileWrapper.h"
 #include "Index.h"
 #include "Platform.h"
 #include "IndexBuilder.h"
+#include "MLFIndexBuilder.h"
 #include "ReaderUtil.h"
 #include "Common/ReaderTestHelper.h"
 #include <boost/algorithm/string/replace.hpp>
@@ -354,8 +356,8 @@ static void CheckIdentical(const shared_ptr<Index>& index1, const shared_ptr<Ind
         Check(chunk1, chunk2.NumberOfSequences(), chunk2.NumberOfSamples(), chunk2.StartOffset(), chunk2.SizeInBytes());
         for (int j = 0; j < chunk1.NumberOfSequences(); j++)
         {
-            auto& seq1 = chunk1[i];
-            auto& seq2 = chunk2[i];
+            auto& seq1 = chunk1[j];
+            auto& seq2 = chunk2[j];
             Check(seq1, seq2.m_key, seq2.NumberOfSamples(), seq2.OffsetInChunk(), seq2.SizeInBytes());
         }
     }
@@ -714,6 +716,103 @@ BOOST_AUTO_TEST_CASE(Index_with_multi_line_sequences)
     }
 }
 
+BOOST_AUTO_TEST_CASE(Index_built_in_parallel)
+{
+    // Multi-line sequences, lines without ids and without the main stream, so that
+    // scan ranges start in the middle of sequences and in the middle of lines.
+    std::mt19937 rng(17);
+    string input;
+    for (size_t id = 0; id < 300; id++)
+    {
+        size_t numberOfLines = 1 + rng() % 5;
+        for (size_t line = 0; line < numberOfLines; line++)
+        {
+            if (line == 0 || rng() % 3 != 0)
+                input += to_string(id);
+            input += (rng() % 4 != 0) ? "\t|x 1 2 3" : "\t|y 4";
+            input += string(rng() % 40, ' ');
+            input += "\n";
+        }
+        if (rng() % 10 == 0)
+            input += "\n";
+    }
+    input += "300 |x 5";
+
+    for (bool skipSequenceIds : { false, true })
+    {
+        auto sequential = GetIndexBuilder(input)->SetSkipSequenceIds(skipSequenceIds).SetMainStream("x").SetChunkSize(1024).Build();
+        BOOST_REQUIRE(sequential->NumberOfSequences() > 100);
+
+        // The input is split into one range per thread, unless the ranges would be smaller than the minimum size.
+        for (size_t rangeSize : { 1, 333, 4096 })
+        {
+            for (size_t numberOfThreads : { 2, 5, 16, 100 })
+            {
+                auto parallel = GetIndexBuilder(input)->SetSkipSequenceIds(skipSequenceIds).SetMainStream("x").SetChunkSize(1024)
+                    .SetNumberOfThreads(numberOfThreads).SetMinScanRangeSize(rangeSize).SetBufferSize(rangeSize < 64 ? 5 : 79).Build();
+                CheckIdentical(parallel, sequential);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MLFIndex_built_in_parallel)
+{
+    // Utterances of different lengths, blank lines and MLF headers between utterances,
+    // so that scan ranges start in the middle of utterances and in the middle of lines.
+    std::mt19937 rng(23);
+    string input = "#!MLF!#\n";
+    for (size_t id = 0; id < 300; id++)
+    {
+        input += "\"" + to_string(id) + ".lab\"\n";
+        size_t numberOfFrames = 0;
+        size_t numberOfLines = 1 + rng() % 6;
+        for (size_t line = 0; line < numberOfLines; line++)
+        {
+            size_t length = 1 + rng() % 10;
+            input += to_string(numberOfFrames * 100000) + " " + to_string((numberOfFrames + length) * 100000) + " s" + to_string(rng() % 3) + " " + to_string(rng() % 100);
+            input += string(rng() % 3, ' ');
+            input += (rng() % 2 == 0) ? "\r\n" : "\n";
+            numberOfFrames += length;
+        }
+        input += ".\n";
+        if (rng() % 10 == 0)
+            input += "\n";
+        if (rng() % 20 == 0)
+            input += "#!MLF!#\n";
+    }
+
+    auto corpus = make_shared<CorpusDescriptor>(true);
+    auto build = [&input, &corpus](size_t numberOfThreads, size_t rangeSize, size_t bufferSize)
+    {
+        std::wstring filename = L"mlf.test.tmp";
+        CreateTestFile(input, filename);
+        shared_ptr<Index> index;
+        {
+            auto f = FileWrapper::OpenOrDie(filename, L"rb");
+            MLFIndexBuilder builder(f, corpus);
+            builder.SetChunkSize(1024).SetNumberOfThreads(numberOfThreads).SetMinScanRangeSize(rangeSize).SetBufferSize(bufferSize);
+            index = builder.Build();
+        }
+        _wunlink(filename.c_str());
+        return index;
+    };
+
+    auto sequential = build(1, 1, 79);
+    BOOST_REQUIRE_EQUAL(sequential->NumberOfSequences(), 300);
+    BOOST_REQUIRE(sequential->NumberOfChunks() > 10);
+
+    // The input is split into one range per thread, unless the ranges would be smaller than the minimum size.
+    for (size_t rangeSize : { 1, 333, 4096 })
+    {
+        for (size_t numberOfThreads : { 2, 5, 16, 100 })
+        {
+            auto parallel = build(numberOfThreads, rangeSize, rangeSize < 64 ? 5 : 79);
+            CheckIdentical(parallel, sequential);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(Index_non_primary)
 {
     auto size = s_textData.size();
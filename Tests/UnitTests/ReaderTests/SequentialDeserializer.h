@@ -8,7 +8,7 @@
 #include <random>
 #include <boost/random/uniform_int_distribution.hpp>
 #include "NoRandomizer.h"
-#include "DataDeserializer.h"
+#include "DataDeserializerBase.h"
 #include "BlockRandomizer.h"
 #include <thread>
 #include <chrono>
@@ -36,7 +36,7 @@ namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
     // A mock deserializer that produces N sequential samples
     // with value from 0 .. N-1
 
-    class SequentialDeserializer : public DataDeserializer
+    class SequentialDeserializer : public DataDeserializerBase
     {
     public:
         struct MockSequenceInfo
@@ -101,7 +101,8 @@ namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
             size_t chunkSizeInSamples,
             size_t sweepNumberOfSamples,
             uint32_t maxSequenceLength)
-            : m_sampleShape(NDShape({ 1 }))
+            : DataDeserializerBase(true),
+              m_sampleShape(NDShape({ 1 }))
         {
             std::mt19937_64 engine(seed);
             boost::random::uniform_int_distribution<int> length(1, maxSequenceLength);
@@ -188,6 +189,11 @@ namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
             throw logic_error("Not implemented");
         }
 
+        bool SupportsConcurrentGetChunk() const override
+        {
+            return true;
+        }
+
         virtual std::vector<ChunkInfo> ChunkInfos() override
         {
             std::vector<ChunkInfo> result;
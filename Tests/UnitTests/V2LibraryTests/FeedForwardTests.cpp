@@ -5,6 +5,7 @@
 #include "stdafx.h"
 #include "CNTKLibrary.h"
 #include <functional>
+#include <thread>
 #include "Common.h"
 
 using namespace CNTK;
@@ -450,6 +451,176 @@ void TestTimesReduceSequenceAxis(
     }
 }
 
+// evaluates a multi-tower network serially and with concurrent node execution, and checks that both give the same results
+void TestParallelNodeExecution(const DeviceDescriptor& device)
+{
+    using namespace std::placeholders;
+
+    const size_t inputDim = 37;
+    const size_t towerDim = 64;
+    const size_t numTowers = 4;
+    const size_t numSamples = 9;
+
+    auto inputVar = InputVariable({ inputDim }, DataType::Float, /*needsGradient =*/ true, L"features");
+    FunctionPtr towerSum;
+    for (size_t i = 0; i < numTowers; ++i)
+    {
+        auto tower = FullyConnectedDNNLayer(FullyConnectedDNNLayer(inputVar, towerDim, device, std::bind(Sigmoid, _1, L""), L"", (unsigned long)i + 1), towerDim, device, std::bind(Tanh, _1, L""), L"", (unsigned long)i + 11);
+        towerSum = towerSum ? Plus(towerSum, tower) : tower;
+    }
+    auto serialModel = ReduceSum(towerSum, Axis::AllAxes(), L"loss");
+    auto parallelModel = serialModel->Clone(ParameterCloningMethod::Clone);
+
+    std::vector<float> inputData(inputDim * numSamples);
+    for (size_t i = 0; i < inputData.size(); ++i)
+        inputData[i] = ((float)rand()) / RAND_MAX;
+    NDShape inputShape = inputVar.Shape().AppendShape({ 1, numSamples });
+    ValuePtr inputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(inputShape, inputData.data(), inputData.size(), DeviceDescriptor::CPUDevice(), true));
+
+    auto forwardBackward = [&](const FunctionPtr& model, ValuePtr& outputValue, ValuePtr& inputGradientValue)
+    {
+        auto modelInput = model->Arguments()[0];
+        std::unordered_map<Variable, ValuePtr> outputs = { { model->Output(), nullptr } };
+        auto backpropState = model->Forward({ { modelInput, inputValue } }, outputs, device, { model->Output() });
+        outputValue = outputs[model->Output()];
+
+        std::vector<float> rootGradientsData(model->Output().Shape().TotalSize(), 1);
+        ValuePtr rootGradientValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(model->Output().Shape(), rootGradientsData.data(), rootGradientsData.size(), DeviceDescriptor::CPUDevice(), true));
+        std::unordered_map<Variable, ValuePtr> inputGradients = { { modelInput, nullptr } };
+        model->Backward(backpropState, { { model->Output(), rootGradientValue } }, inputGradients);
+        inputGradientValue = inputGradients[modelInput];
+    };
+
+    ValuePtr serialOutput, serialInputGradient, parallelOutput, parallelInputGradient;
+    forwardBackward(serialModel, serialOutput, serialInputGradient);
+
+    // the setting takes effect when the underlying network allocates its matrices, i.e. on first evaluation
+    auto savedNumThreads = Internal::GetParallelNodeExecutionThreads();
+    Internal::SetParallelNodeExecutionThreads(4);
+    forwardBackward(parallelModel, parallelOutput, parallelInputGradient);
+    Internal::SetParallelNodeExecutionThreads(savedNumThreads);
+
+    BOOST_TEST(Internal::AreEqual(*serialOutput, *parallelOutput, relativeTolerance, absoluteTolerance), "Forward results differ between serial and parallel node execution");
+    BOOST_TEST(Internal::AreEqual(*serialInputGradient, *parallelInputGradient, relativeTolerance, absoluteTolerance), "Backprop results differ between serial and parallel node execution");
+}
+
+// evaluates a network with and without the memory arena of the matrix pool and checks that both give the same results;
+// the arena is sized for fewer columns than the minibatch has, so that some buffers have to move out of it
+void TestMemoryArena(const DeviceDescriptor& device)
+{
+    using namespace std::placeholders;
+
+    const size_t inputDim = 29;
+    const size_t hiddenDim = 48;
+    const size_t numSamples = 7;
+
+    auto inputVar = InputVariable({ inputDim }, DataType::Float, /*needsGradient =*/ true, L"features");
+    auto hidden = FullyConnectedDNNLayer(inputVar, hiddenDim, device, std::bind(Sigmoid, _1, L""), L"", 1);
+    hidden = FullyConnectedDNNLayer(hidden, hiddenDim, device, std::bind(Tanh, _1, L""), L"", 2);
+    hidden = Plus(hidden, FullyConnectedDNNLayer(inputVar, hiddenDim, device, std::bind(ReLU, _1, L""), L"", 3));
+    auto model = ReduceSum(ElementTimes(hidden, hidden), Axis::AllAxes(), L"loss");
+
+    std::vector<float> inputData(inputDim * numSamples);
+    for (size_t i = 0; i < inputData.size(); ++i)
+        inputData[i] = ((float)rand()) / RAND_MAX;
+    NDShape inputShape = inputVar.Shape().AppendShape({ 1, numSamples });
+    ValuePtr inputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(inputShape, inputData.data(), inputData.size(), DeviceDescriptor::CPUDevice(), true));
+
+    auto forwardBackward = [&](size_t arenaColumns, ValuePtr& outputValue, ValuePtr& inputGradientValue)
+    {
+        // the setting takes effect when the underlying network allocates its matrices, i.e. on first evaluation of a fresh clone
+        auto clone = model->Clone(ParameterCloningMethod::Share);
+        auto savedArenaColumns = Internal::GetMemoryArenaMinibatchColumns();
+        Internal::SetMemoryArenaMinibatchColumns(arenaColumns);
+
+        auto modelInput = clone->Arguments()[0];
+        std::unordered_map<Variable, ValuePtr> outputs = { { clone->Output(), nullptr } };
+        auto backpropState = clone->Forward({ { modelInput, inputValue } }, outputs, device, { clone->Output() });
+        outputValue = outputs[clone->Output()];
+
+        std::vector<float> rootGradientsData(clone->Output().Shape().TotalSize(), 1);
+        ValuePtr rootGradientValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(clone->Output().Shape(), rootGradientsData.data(), rootGradientsData.size(), DeviceDescriptor::CPUDevice(), true));
+        std::unordered_map<Variable, ValuePtr> inputGradients = { { modelInput, nullptr } };
+        clone->Backward(backpropState, { { clone->Output(), rootGradientValue } }, inputGradients);
+        inputGradientValue = inputGradients[modelInput];
+
+        Internal::SetMemoryArenaMinibatchColumns(savedArenaColumns);
+    };
+
+    ValuePtr referenceOutput, referenceInputGradient;
+    forwardBackward(0, referenceOutput, referenceInputGradient);
+    for (size_t arenaColumns : { numSamples, numSamples / 2 })
+    {
+        ValuePtr arenaOutput, arenaInputGradient;
+        forwardBackward(arenaColumns, arenaOutput, arenaInputGradient);
+        BOOST_TEST(Internal::AreEqual(*referenceOutput, *arenaOutput, relativeTolerance, absoluteTolerance), "Forward results differ with the memory arena");
+        BOOST_TEST(Internal::AreEqual(*referenceInputGradient, *arenaInputGradient, relativeTolerance, absoluteTolerance), "Backprop results differ with the memory arena");
+    }
+}
+
+// evaluates a network from several threads through a ConcurrentEvaluator and checks the results against
+// a plain evaluation of the network
+void TestConcurrentEvaluator(const DeviceDescriptor& device)
+{
+    using namespace std::placeholders;
+
+    const size_t inputDim = 29;
+    const size_t hiddenDim = 48;
+    const size_t numSamples = 7;
+    const size_t maxConcurrency = 3;
+    const size_t numThreads = 6;
+    const size_t numRequestsPerThread = 4;
+
+    auto inputVar = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto hidden = FullyConnectedDNNLayer(inputVar, hiddenDim, device, std::bind(Sigmoid, _1, L""), L"", 1);
+    auto model = FullyConnectedDNNLayer(hidden, hiddenDim, device, std::bind(Tanh, _1, L""), L"", 2);
+
+    std::vector<ValuePtr> inputValues, referenceOutputs;
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        std::vector<float> inputData(inputDim * numSamples);
+        for (size_t j = 0; j < inputData.size(); ++j)
+            inputData[j] = ((float)rand()) / RAND_MAX;
+        NDShape inputShape = inputVar.Shape().AppendShape({ 1, numSamples });
+        inputValues.push_back(MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(inputShape, inputData.data(), inputData.size(), DeviceDescriptor::CPUDevice(), true)->DeepClone(device)));
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { model->Output(), nullptr } };
+        model->Evaluate({ { inputVar, inputValues.back() } }, outputs, device);
+        referenceOutputs.push_back(outputs[model->Output()]->DeepClone());
+    }
+
+    auto evaluator = CreateConcurrentEvaluator(model, maxConcurrency, device);
+    std::vector<std::vector<ValuePtr>> results(numThreads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            for (size_t j = 0; j < numRequestsPerThread; ++j)
+            {
+                // every other request supplies its own output storage
+                ValuePtr outputValue;
+                if (j % 2)
+                    outputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(DataType::Float, referenceOutputs[i]->Shape(), device));
+
+                std::unordered_map<Variable, ValuePtr> outputs = { { model->Output(), outputValue } };
+                evaluator->Evaluate({ { inputVar, inputValues[i] } }, outputs);
+                results[i].push_back(outputs[model->Output()]);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    BOOST_TEST(evaluator->NumInstances() <= maxConcurrency, "ConcurrentEvaluator created more evaluation instances than allowed");
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        for (const auto& result : results[i])
+            BOOST_TEST(Internal::AreEqual(*referenceOutputs[i], *result, relativeTolerance, absoluteTolerance), "ConcurrentEvaluator results differ from Function::Evaluate");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE(FeedForwardSuite)
 
 BOOST_AUTO_TEST_CASE(FFTimesAndPlusInCPU)
@@ -510,6 +681,30 @@ BOOST_AUTO_TEST_CASE(FFNetworkCreationInCPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(FFParallelNodeExecutionInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestParallelNodeExecution(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(FFMemoryArenaInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestMemoryArena(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(FFMemoryArenaInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestMemoryArena(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(FFConcurrentEvaluatorInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestConcurrentEvaluator(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}
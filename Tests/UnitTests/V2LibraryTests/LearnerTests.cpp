@@ -350,6 +350,166 @@ void TestSweepBasedSchedule()
     }
 }
 
+// Communicator of a worker whose peers have nothing to contribute: aggregations leave the values as they are,
+// concatenations fill in zeros for the other workers.
+class SingleContributorCommunicator : public DistributedCommunicator
+{
+private:
+    std::unordered_set<DistributedWorkerDescriptor> m_workers;
+    DistributedWorkerDescriptor m_self;
+
+public:
+    SingleContributorCommunicator(size_t numWorkers)
+    {
+        for (size_t i = 0; i < numWorkers; i++)
+        {
+            DistributedWorkerDescriptor desc;
+            desc.m_hostId = L"SingleContributorCommunicator";
+            desc.m_globalRank = i;
+            m_workers.insert(desc);
+        }
+        m_self.m_hostId = L"SingleContributorCommunicator";
+        m_self.m_globalRank = 0;
+    }
+
+    virtual const std::unordered_set<DistributedWorkerDescriptor>& Workers() const override
+    {
+        return m_workers;
+    }
+
+    virtual const DistributedWorkerDescriptor& CurrentWorker() const override
+    {
+        return m_self;
+    }
+
+    virtual DistributedCommunicatorPtr SubGroup(const std::unordered_set<DistributedWorkerDescriptor>&) const override
+    {
+        return nullptr;
+    }
+
+    virtual void Concatenate(const std::vector<ValuePtr>&, std::vector<ValuePtr>&, const std::unordered_set<DistributedWorkerDescriptor>&) override
+    {
+        NOT_IMPLEMENTED;
+    }
+
+    virtual void Concatenate(const std::vector<NDArrayViewPtr>& input, std::vector<NDArrayViewPtr>& output, const std::unordered_set<DistributedWorkerDescriptor>&) override
+    {
+        output.clear();
+        for (const auto& in : input)
+        {
+            auto size = in->Shape().TotalSize();
+            auto out = std::make_shared<NDArrayView>(0, in->GetDataType(), NDShape{ size * m_workers.size() }, DeviceDescriptor::CPUDevice());
+            if (in->GetDataType() == DataType::Float)
+                std::copy(in->DataBuffer<float>(), in->DataBuffer<float>() + size, out->WritableDataBuffer<float>());
+            else
+                std::copy(in->DataBuffer<double>(), in->DataBuffer<double>() + size, out->WritableDataBuffer<double>());
+            output.push_back(out);
+        }
+    }
+
+    virtual void Gather(const Dictionary&, std::vector<DictionaryPtr>&, const std::unordered_set<DistributedWorkerDescriptor>&) override
+    {
+        NOT_IMPLEMENTED;
+    }
+
+    virtual void AggregateInPlace(const std::vector<NDArrayViewPtr>&, const std::unordered_set<DistributedWorkerDescriptor>&) override
+    {}
+
+    virtual void AllReduceSparseBlockColumn(std::vector<NDArrayViewPtr>&) override
+    {}
+
+    virtual void Aggregate(const std::vector<NDArrayViewPtr>& values, std::vector<NDArrayViewPtr>& outputValues, const std::unordered_set<DistributedWorkerDescriptor>&) override
+    {
+        outputValues.clear();
+        for (const auto& v : values)
+            outputValues.push_back(v->DeepClone());
+    }
+
+    virtual void Barrier() override
+    {}
+};
+
+template <typename ElementType>
+void DistributedUpdate(const DistributedLearnerPtr& learner, const Parameter& parameter, vector<ElementType> gradient)
+{
+    unordered_map<Parameter, NDArrayViewPtr> gradientValues{
+        { parameter, std::make_shared<NDArrayView>(parameter.Shape(), gradient.data(), gradient.size(), DeviceDescriptor::CPUDevice()) } };
+    MinibatchInfo info{ false, false, 1,
+        std::make_shared<NDArrayView>(0.0, NDShape{}, DeviceDescriptor::CPUDevice()),
+        std::make_shared<NDArrayView>(0.0, NDShape{}, DeviceDescriptor::CPUDevice()) };
+    learner->Update(gradientValues, info);
+}
+
+template <typename ElementType>
+vector<ElementType> ParameterValue(const Parameter& parameter)
+{
+    auto value = parameter.Value();
+    return vector<ElementType>(value->DataBuffer<ElementType>(), value->DataBuffer<ElementType>() + value->Shape().TotalSize());
+}
+
+void TestSparsifiedDistributedLearnerTopKWithErrorFeedback()
+{
+    auto device = DeviceDescriptor::CPUDevice();
+    auto parameter = CreateParameters<float>(NDShape{ 8 }, 1, device)[0];
+    auto initialValue = ParameterValue<float>(parameter);
+
+    // Buckets of 8 entries with a density of 0.25: two entries of the bucket are sent per minibatch.
+    auto learner = CreateSparsifiedDataParallelDistributedLearner(std::make_shared<SingleContributorCommunicator>(2),
+        SGDLearner({ parameter }, TrainingParameterPerSampleSchedule(1.0)), 0, 0.25, 0.0, 8);
+
+    DistributedUpdate<float>(learner, parameter, { 1, -5, 2, 0.5f, 3, -0.25f, 0, 4 });
+    vector<float> expected = initialValue;
+    expected[1] += 5;
+    expected[7] -= 4;
+    if (ParameterValue<float>(parameter) != expected)
+        ReportFailure("The sparsified learner did not apply the two largest entries of the first gradient.");
+
+    // The entries 2 and 3 that were held back are larger than everything of the second gradient, they are sent now.
+    DistributedUpdate<float>(learner, parameter, { 0.5f, 0, 0, 0, 0, 0, 0, 1.5f });
+    expected[2] -= 2;
+    expected[4] -= 3;
+    if (ParameterValue<float>(parameter) != expected)
+        ReportFailure("The sparsified learner did not carry the residual of the first gradient into the second minibatch.");
+
+    // Residual now: { 1.5, 0, 0, 0.5, 0, -0.25, 0, 1.5 }, the first two largest entries are sent.
+    DistributedUpdate<float>(learner, parameter, { 0, 0, 0, 0, 0, 0, 0, 0 });
+    expected[0] -= 1.5f;
+    expected[7] -= 1.5f;
+    if (ParameterValue<float>(parameter) != expected)
+        ReportFailure("The sparsified learner did not send the accumulated residual.");
+
+    // Checkpointing drops the residual.
+    learner->CreateCheckpoint();
+    DistributedUpdate<float>(learner, parameter, { 0, 0, 0, 0, 0, 0, 0, 0 });
+    if (ParameterValue<float>(parameter) != expected)
+        ReportFailure("The sparsified learner kept its residual over a checkpoint.");
+}
+
+template <typename ElementType>
+void TestSparsifiedDistributedLearnerWithFullDensity(size_t numMinibatches)
+{
+    auto device = DeviceDescriptor::CPUDevice();
+    NDShape shape = { 3, 7 };
+    auto sparsifiedParameter = CreateParameters<ElementType>(shape, 1, device)[0];
+    auto denseParameter = CreateParameters<ElementType>(shape, 1, device)[0];
+
+    auto momentum = MomentumAsTimeConstantSchedule(10);
+    auto sparsified = CreateSparsifiedDataParallelDistributedLearner(std::make_shared<SingleContributorCommunicator>(2),
+        MomentumSGDLearner({ sparsifiedParameter }, TrainingParameterPerSampleSchedule(0.1), momentum), 0, 1.0, 0.0, 5);
+    auto dense = CreateDataParallelDistributedLearner(std::make_shared<SingleContributorCommunicator>(2),
+        MomentumSGDLearner({ denseParameter }, TrainingParameterPerSampleSchedule(0.1), momentum), 0);
+
+    for (size_t i = 0; i < numMinibatches; i++)
+    {
+        NDArrayViewPtr gradient = NDArrayView::RandomUniform<ElementType>(shape, -1.0, 1.0, (unsigned long)i, device);
+        vector<ElementType> values(gradient->DataBuffer<ElementType>(), gradient->DataBuffer<ElementType>() + shape.TotalSize());
+        DistributedUpdate<ElementType>(sparsified, sparsifiedParameter, values);
+        DistributedUpdate<ElementType>(dense, denseParameter, values);
+        if (ParameterValue<ElementType>(sparsifiedParameter) != ParameterValue<ElementType>(denseParameter))
+            ReportFailure("The sparsified learner with a density of 1 differs from the data parallel learner in minibatch %d.", (int)i);
+    }
+}
+
 struct LearnerSuiteFixture
 {
     LearnerSuiteFixture()
@@ -500,6 +660,17 @@ BOOST_AUTO_TEST_CASE(TestResettingLearningRate)
     }
 }
 
+BOOST_AUTO_TEST_CASE(SparsifiedDistributedLearnerTopKWithErrorFeedback)
+{
+    TestSparsifiedDistributedLearnerTopKWithErrorFeedback();
+}
+
+BOOST_AUTO_TEST_CASE(SparsifiedDistributedLearnerWithFullDensity)
+{
+    TestSparsifiedDistributedLearnerWithFullDensity<float>(numMinibatches + 1);
+    TestSparsifiedDistributedLearnerWithFullDensity<double>(numMinibatches + 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}
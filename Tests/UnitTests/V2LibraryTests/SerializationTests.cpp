@@ -957,6 +957,42 @@ void TestLoadingModelFromMemoryBufferWithException()
     delete[] modelBuffer;
 }
 
+void TestMemoryMappedModelSaveAndLoad(const DeviceDescriptor& device)
+{
+    auto file = L"TestMemoryMappedModelSaveAndLoad.out";
+    if ((_wunlink(file) != 0) && (errno != ENOENT))
+        BOOST_ERROR("Error deleting temporary test file 'TestMemoryMappedModelSaveAndLoad.out'.");
+
+    auto inputVar = InputVariable({ 20 }, DataType::Float, L"features");
+    auto function = BuildFFClassifierNet(inputVar, 5, device);
+
+    Internal::EnableMemoryMappedModels();
+    FunctionPtr mappedFunction, reloadedFunction;
+    try
+    {
+        function->Save(file);
+        mappedFunction = Function::Load(file, device);
+
+        // the parameters of a memory-mapped model are copy-on-write and never modify the file
+        for (auto& parameter : mappedFunction->Parameters())
+            parameter.SetValue(MakeSharedObject<NDArrayView>(0.0f, parameter.Shape(), device));
+        reloadedFunction = Function::Load(file, device);
+    }
+    catch (...)
+    {
+        Internal::DisableMemoryMappedModels();
+        throw;
+    }
+    Internal::DisableMemoryMappedModels();
+
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestMemoryMappedModelSaveAndLoad: original and memory-mapped functions are not identical.");
+
+    // models saved with aligned tensor sections can also be read without a memory mapping
+    if (!AreEqual(function, Function::Load(file, device)))
+        BOOST_ERROR("TestMemoryMappedModelSaveAndLoad: original and reloaded functions are not identical.");
+}
+
 BOOST_AUTO_TEST_SUITE(SerializationSuite)
 
 BOOST_AUTO_TEST_CASE(LoadingModelFromMemoryBuffer)
@@ -1019,6 +1055,11 @@ BOOST_AUTO_TEST_CASE(FunctionSerializationInCPU)
     TestFunctionSerialization(DeviceDescriptor::CPUDevice());
 }
 
+BOOST_AUTO_TEST_CASE(MemoryMappedModelSaveAndLoadInCPU)
+{
+    TestMemoryMappedModelSaveAndLoad(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(ModelSerializationDuringTrainingInCPU)
 {
     TestModelSerializationDuringTraining(DeviceDescriptor::CPUDevice());
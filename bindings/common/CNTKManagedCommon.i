@@ -310,6 +310,13 @@ IGNORE_FUNCTION CNTK::Internal::PrintBuiltInfo;
 IGNORE_FUNCTION CNTK::Internal::PrintGpuInfo;
 IGNORE_FUNCTION CNTK::Internal::SetMPIPackThreshold;
 IGNORE_FUNCTION CNTK::Internal::GetMPIPackThreshold;
+IGNORE_FUNCTION CNTK::Internal::SetParallelNodeExecutionThreads;
+IGNORE_FUNCTION CNTK::Internal::GetParallelNodeExecutionThreads;
+IGNORE_FUNCTION CNTK::Internal::SetMemoryArenaMinibatchColumns;
+IGNORE_FUNCTION CNTK::Internal::GetMemoryArenaMinibatchColumns;
+IGNORE_FUNCTION CNTK::Internal::EnableMemoryMappedModels;
+IGNORE_FUNCTION CNTK::Internal::DisableMemoryMappedModels;
+IGNORE_FUNCTION CNTK::Internal::AreMemoryMappedModelsEnabled;
 IGNORE_FUNCTION CNTK::Internal::ToDictionary;
 IGNORE_CLASS CNTK::Internal::TensorBoardFileWriter;
 // suppress SWIG warning 302: Identifier redefined.
@@ -558,6 +565,7 @@ IGNORE_FUNCTION CNTK::CreateCompositeMinibatchSource;
 IGNORE_FUNCTION CNTK::TextFormatMinibatchSource;
 IGNORE_STRUCT CNTK::HTKFeatureConfiguration;
 IGNORE_FUNCTION CNTK::ComputeInputPerDimMeansAndInvStdDevs;
+IGNORE_FUNCTION CNTK::QuantizeForInt8Inference;
 IGNORE_CLASS CNTK::ProgressWriter;
 IGNORE_FUNCTION CNTK::DeviceKindName;
 IGNORE_FUNCTION CNTK::VariableKindName;
@@ -676,6 +684,8 @@ MAKE_GETTER(CNTK::Axis, StaticAxisIndex);
 %rename (toString) CNTK::NDArrayView::AsString;
 IGNORE_CLASS CNTK::Evaluator;
 IGNORE_FUNCTION CNTK::CreateEvaluator;
+IGNORE_CLASS CNTK::ConcurrentEvaluator;
+IGNORE_FUNCTION CNTK::CreateConcurrentEvaluator;
 #else
 %rename(SequenceIsFirst) CNTK::Sequence::IsFirst;
 %rename(SequenceIsLast) CNTK::Sequence::IsLast;
@@ -79,11 +79,6 @@ def distributed_worker(outdir, gpu, mode, config):
     if gpu:
         # test with only one GPU
         C.try_set_default_device(C.gpu(0))
-    else:
-        # CPU sparse aggregation is not implemented, so turn it off
-        # note we only need to explicitly do this when running with CPU device on a GPU build
-        # For CPU build it's disabled by default
-        C.cntk_py.use_sparse_gradient_aggregation_in_data_parallel_sgd(False)
 
     trainer = SimpleTrainer(mode, config)
     for batch in range(NUM_BATCHES):
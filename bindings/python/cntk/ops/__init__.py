@@ -2244,9 +2244,10 @@ def element_select(flag, value_if_true, value_if_false, name=''):
 def optimized_rnnstack(operand, weights, hidden_size, num_layers,
                        bidirectional=False, recurrent_op='lstm', name=''):
     '''
-    An RNN implementation that uses the primitives in cuDNN.
-    If cuDNN is not available it fails. You can use :class:`~cntk.misc.optimized_rnnstack_converter.convert_optimized_rnnstack`
-    to convert a model to GEMM-based implementation when no cuDNN.
+    An RNN implementation that uses the primitives in cuDNN on GPU, and an equivalent
+    native implementation with the same parameter layout on CPU. You can also use
+    :class:`~cntk.misc.optimized_rnnstack_converter.convert_optimized_rnnstack`
+    to convert a model to a GEMM-based implementation built from regular layers.
 
     Args:
         operand: input of the optimized RNN stack.
@@ -145,6 +145,29 @@ def data_parallel_distributed_learner(learner, distributed_after=0, num_quantiza
             distributed_after,
             use_async_buffered_parameter_update)
 
+@typemap
+def sparsified_data_parallel_distributed_learner(learner, density, threshold=0.0, bucket_size=64 * 1024, distributed_after=0):
+    '''
+    Creates a data parallel distributed learner that exchanges only the gradient entries with the largest magnitude.
+    The entries that are not sent are accumulated locally and added to the next gradients (error feedback).
+
+    Args:
+        learner: a local learner (i.e. sgd)
+        density (float): fraction of the entries of every bucket that are sent, in (0, 1]
+        threshold (float): if positive, only the selected entries with at least this magnitude are sent
+        bucket_size (int): number of gradient elements the entries are selected from at a time
+        distributed_after (int): number of samples after which distributed training starts
+    Returns:
+        a distributed learner instance
+    '''
+    return cntk_py.create_sparsified_data_parallel_distributed_learner(
+        cntk_py.mpicommunicator(),
+        learner,
+        distributed_after,
+        density,
+        threshold,
+        bucket_size)
+
 @typemap
 def block_momentum_distributed_learner(learner, block_size, block_momentum_as_time_constant=None, use_nestrov_momentum=True, reset_sgd_momentum_after_aggregation=True, block_learning_rate=1.0, distributed_after=0):
     '''